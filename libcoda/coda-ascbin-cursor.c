@@ -30,7 +30,9 @@
  */
 
 #include "coda-ascbin.h"
+#include "coda-bin-internal.h"
 #include "coda-definition.h"
+#include "coda-statistics.h"
 
 #include <assert.h>
 #include <ctype.h>
@@ -57,6 +59,7 @@ static int get_relative_field_bit_offset_by_index(const coda_cursor *cursor, lon
         *rel_bit_offset = field->bit_offset;
         return 0;
     }
+    coda_statistics_add(cursor->product, num_offset_calculations, 1);
 
     if (field->bit_offset_expr != NULL)
     {
@@ -171,6 +174,7 @@ static int get_next_relative_field_bit_offset(const coda_cursor *cursor, int64_t
         }
         return 0;
     }
+    coda_statistics_add(cursor->product, num_offset_calculations, 1);
 
     prev_bit_offset = cursor->stack[cursor->n - 1].bit_offset - cursor->stack[cursor->n - 2].bit_offset;
 
@@ -227,6 +231,21 @@ static int get_next_relative_field_bit_offset(const coda_cursor *cursor, int64_t
     return 0;
 }
 
+/* cursor should point to an array with at least one element for this function */
+static int get_first_element_bit_size(const coda_cursor *cursor, int64_t *bit_size)
+{
+    coda_type_array *array = (coda_type_array *)coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
+    coda_cursor element_cursor;
+
+    element_cursor = *cursor;
+    element_cursor.n++;
+    element_cursor.stack[element_cursor.n - 1].type = (coda_dynamic_type *)array->base_type;
+    element_cursor.stack[element_cursor.n - 1].index = 0;
+    element_cursor.stack[element_cursor.n - 1].bit_offset = cursor->stack[cursor->n - 1].bit_offset;
+
+    return coda_cursor_get_bit_size(&element_cursor, bit_size);
+}
+
 int coda_ascbin_cursor_set_product(coda_cursor *cursor, coda_product *product)
 {
     cursor->product = product;
@@ -456,8 +475,24 @@ int coda_ascbin_cursor_goto_array_element(coda_cursor *cursor, int num_subs, con
         /* if the array base type is simple, do a calculated index calculation. */
         cursor->stack[cursor->n - 1].bit_offset += offset_elements * array->base_type->bit_size;
     }
+    else if (array->has_uniform_element_size && coda_option_use_fast_size_expressions && offset_elements > 0)
+    {
+        int64_t bit_size;
+
+        coda_statistics_add(cursor->product, num_offset_calculations, 1);
+        /* all elements have the size of the first element */
+        cursor->stack[cursor->n - 1].type = (coda_dynamic_type *)array->base_type;
+        cursor->stack[cursor->n - 1].index = 0;
+        if (coda_cursor_get_bit_size(cursor, &bit_size) != 0)
+        {
+            cursor->n--;
+            return -1;
+        }
+        cursor->stack[cursor->n - 1].bit_offset += offset_elements * bit_size;
+    }
     else        /* not a simple base type, so walk the elements. */
     {
+        coda_statistics_add(cursor->product, num_offset_calculations, 1);
         for (i = 0; i < offset_elements; i++)
         {
             int64_t bit_size;
@@ -510,8 +545,24 @@ int coda_ascbin_cursor_goto_array_element_by_index(coda_cursor *cursor, long ind
         /* if the array base type is simple, do a calculated index calculation. */
         cursor->stack[cursor->n - 1].bit_offset += index * array->base_type->bit_size;
     }
+    else if (array->has_uniform_element_size && coda_option_use_fast_size_expressions && index > 0)
+    {
+        int64_t bit_size;
+
+        coda_statistics_add(cursor->product, num_offset_calculations, 1);
+        /* all elements have the size of the first element */
+        cursor->stack[cursor->n - 1].type = (coda_dynamic_type *)array->base_type;
+        cursor->stack[cursor->n - 1].index = 0;
+        if (coda_cursor_get_bit_size(cursor, &bit_size) != 0)
+        {
+            cursor->n--;
+            return -1;
+        }
+        cursor->stack[cursor->n - 1].bit_offset += index * bit_size;
+    }
     else        /* not a simple base type, so walk the elements. */
     {
+        coda_statistics_add(cursor->product, num_offset_calculations, 1);
         for (i = 0; i < index; i++)
         {
             int64_t bit_size;
@@ -604,6 +655,28 @@ int coda_ascbin_cursor_get_bit_size(const coda_cursor *cursor, int64_t *bit_size
     }
     else
     {
+        coda_size_cache *size_cache = NULL;
+
+        /* sizes of nested variable sized data elements are needed over and over again, so remember them per product
+         * (sizes are not shared with calculations that should not use fast size expressions, since for inconsistent
+         * products these can give different results)
+         */
+        if (coda_option_use_fast_size_expressions &&
+            (cursor->product->format == coda_format_ascii || cursor->product->format == coda_format_binary))
+        {
+            size_cache = ((coda_bin_product *)cursor->product)->size_cache;
+        }
+        if (size_cache != NULL)
+        {
+            if (coda_size_cache_find(size_cache, cursor, bit_size))
+            {
+                coda_statistics_add(cursor->product, num_bit_size_cache_hits, 1);
+                return 0;
+            }
+            coda_statistics_add(cursor->product, num_bit_size_cache_misses, 1);
+        }
+        coda_statistics_add(cursor->product, num_size_calculations, 1);
+
         switch (type->type_class)
         {
             case coda_record_class:
@@ -735,6 +808,16 @@ int coda_ascbin_cursor_get_bit_size(const coda_cursor *cursor, int64_t *bit_size
                         /* the basetype has a constant size. */
                         *bit_size = num_elements * array->base_type->bit_size;
                     }
+                    else if (array->has_uniform_element_size && coda_option_use_fast_size_expressions)
+                    {
+                        int64_t element_bit_size;
+
+                        if (get_first_element_bit_size(cursor, &element_bit_size) != 0)
+                        {
+                            return -1;
+                        }
+                        *bit_size = num_elements * element_bit_size;
+                    }
                     else
                     {
                         coda_cursor array_cursor;
@@ -768,11 +851,34 @@ int coda_ascbin_cursor_get_bit_size(const coda_cursor *cursor, int64_t *bit_size
                 assert(0);
                 exit(1);
         }
+
+        if (size_cache != NULL)
+        {
+            coda_size_cache_add(size_cache, cursor, *bit_size);
+        }
     }
 
     return 0;
 }
 
+/* Give the operating system a hint about the data of the current element and the (num_elements - 1) array elements
+ * that follow it.
+ * For elements that have a variable size, the size of the current element is used as estimate for the others.
+ */
+int coda_ascbin_cursor_prefetch(const coda_cursor *cursor, long num_elements)
+{
+    int64_t bit_offset = cursor->stack[cursor->n - 1].bit_offset;
+    int64_t bit_size;
+
+    if (coda_cursor_get_bit_size(cursor, &bit_size) != 0)
+    {
+        return -1;
+    }
+    bit_size = (bit_offset & 0x7) + num_elements * bit_size;
+
+    return coda_bin_product_prefetch(cursor->product, bit_offset >> 3, (bit_size + 7) >> 3);
+}
+
 int coda_ascbin_cursor_get_num_elements(const coda_cursor *cursor, long *num_elements)
 {
     coda_type *type = coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
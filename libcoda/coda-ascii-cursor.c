@@ -35,6 +35,7 @@
 #include "coda-read-bytes-in-bounds.h"
 #include "coda-read-array.h"
 #include "coda-read-partial-array.h"
+#include "coda-statistics.h"
 #include "coda-transpose-array.h"
 #include "coda-ascbin.h"
 #include "ipow.h"
@@ -572,53 +573,71 @@ long coda_ascii_parse_double(const char *buffer, long buffer_length, double *dst
     return buffer_length - length;
 }
 
+static int init_asciilines_type(coda_ascii_product *product_file)
+{
+    coda_type_array *array;
+    coda_type_text *asciiline;
+
+    array = coda_type_array_new(coda_format_ascii);
+    if (array == NULL)
+    {
+        return -1;
+    }
+    if (coda_type_array_add_fixed_dimension(array, product_file->num_asciilines) != 0)
+    {
+        coda_type_release((coda_type *)array);
+        return -1;
+    }
+    asciiline = coda_type_text_new(coda_format_ascii);
+    if (asciiline == NULL)
+    {
+        coda_type_release((coda_type *)array);
+        return -1;
+    }
+    coda_type_text_set_special_text_type(asciiline, ascii_text_line_with_eol);
+    if (coda_type_array_set_base_type(array, (coda_type *)asciiline) != 0)
+    {
+        coda_type_release((coda_type *)array);
+        coda_type_release((coda_type *)asciiline);
+        return -1;
+    }
+
+    coda_atomic_store_ptr(&product_file->asciilines, (coda_type *)array);
+
+    return 0;
+}
+
 int coda_ascii_cursor_set_asciilines(coda_cursor *cursor, coda_product *product)
 {
     coda_ascii_product *product_file = (coda_ascii_product *)product;
+    coda_type *asciilines;
 
-    if (product_file->asciiline_end_offset == NULL)
+    if (coda_ascii_init_asciilines(product) != 0)
     {
-        if (coda_ascii_init_asciilines(product) != 0)
-        {
-            return -1;
-        }
+        return -1;
     }
 
-    if (product_file->asciilines == NULL)
+    asciilines = coda_atomic_load_ptr(&product_file->asciilines);
+    if (asciilines == NULL)
     {
-        coda_type_array *array;
-        coda_type_text *asciiline;
+        int result = 0;
 
-        array = coda_type_array_new(coda_format_ascii);
-        if (array == NULL)
+        coda_lazy_init_lock();
+        if (product_file->asciilines == NULL)
         {
-            return -1;
+            result = init_asciilines_type(product_file);
         }
-        if (coda_type_array_add_fixed_dimension(array, product_file->num_asciilines) != 0)
+        coda_lazy_init_unlock();
+        if (result != 0)
         {
-            coda_type_release((coda_type *)array);
             return -1;
         }
-        asciiline = coda_type_text_new(coda_format_ascii);
-        if (asciiline == NULL)
-        {
-            coda_type_release((coda_type *)array);
-            return -1;
-        }
-        coda_type_text_set_special_text_type(asciiline, ascii_text_line_with_eol);
-        if (coda_type_array_set_base_type(array, (coda_type *)asciiline) != 0)
-        {
-            coda_type_release((coda_type *)array);
-            coda_type_release((coda_type *)asciiline);
-            return -1;
-        }
-
-        product_file->asciilines = (coda_type *)array;
+        asciilines = product_file->asciilines;
     }
 
     cursor->product = product;
     cursor->n = 1;
-    cursor->stack[0].type = (coda_dynamic_type *)product_file->asciilines;
+    cursor->stack[0].type = (coda_dynamic_type *)asciilines;
     cursor->stack[0].index = -1;        /* there is no index for the root of the product */
     cursor->stack[0].bit_offset = 0;
     return 0;
@@ -665,6 +684,7 @@ int coda_ascii_cursor_get_bit_size(const coda_cursor *cursor, int64_t *bit_size)
     {
         return coda_ascbin_cursor_get_bit_size(cursor, bit_size);
     }
+    coda_statistics_add(cursor->product, num_size_calculations, 1);
 
     if (get_bit_size_boundary(cursor, &bit_size_boundary, -1) != 0)
     {
@@ -896,12 +916,9 @@ int coda_ascii_cursor_get_bit_size(const coda_cursor *cursor, int64_t *bit_size)
                     return -1;
                 }
 
-                if (((coda_ascii_product *)cursor->product)->asciiline_end_offset == NULL)
+                if (coda_ascii_init_asciilines(cursor->product) != 0)
                 {
-                    if (coda_ascii_init_asciilines(cursor->product) != 0)
-                    {
-                        return -1;
-                    }
+                    return -1;
                 }
                 if (((coda_ascii_product *)cursor->product)->num_asciilines == 0)
                 {
@@ -1457,6 +1474,32 @@ int coda_ascii_cursor_read_bytes(const coda_cursor *cursor, uint8_t *dst, int64_
     return read_bytes(cursor->product, (cursor->stack[cursor->n - 1].bit_offset >> 3) + offset, length, dst);
 }
 
+int coda_ascii_cursor_get_data_pointer(const coda_cursor *cursor, const uint8_t **data, int64_t *byte_size,
+                                       coda_endianness *endianness)
+{
+    int64_t bit_size;
+
+    if (cursor->stack[cursor->n - 1].bit_offset & 0x7)
+    {
+        coda_set_error(CODA_ERROR_PRODUCT, "product error detected (ascii text does not start at byte boundary)");
+        return -1;
+    }
+    if (coda_ascii_cursor_get_bit_size(cursor, &bit_size) != 0)
+    {
+        return -1;
+    }
+    /* ascii data has no byte ordering, so just report the native byte ordering */
+#ifdef WORDS_BIGENDIAN
+    *endianness = coda_big_endian;
+#else
+    *endianness = coda_little_endian;
+#endif
+    *byte_size = bit_size >> 3;
+
+    return coda_bin_product_get_data_pointer(cursor->product, cursor->stack[cursor->n - 1].bit_offset >> 3,
+                                             *byte_size, data);
+}
+
 int coda_ascii_cursor_read_int8_array(const coda_cursor *cursor, int8_t *dst, coda_array_ordering array_ordering)
 {
     coda_type_array *type = (coda_type_array *)coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
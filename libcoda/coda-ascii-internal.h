@@ -33,6 +33,7 @@
 #define CODA_ASCII_INTERNAL_H
 
 #include "coda-ascii.h"
+#include "coda-bin-internal.h"
 
 typedef enum eol_type_enum
 {
@@ -54,10 +55,20 @@ struct coda_ascii_product_struct
     int64_t **product_variable;
     int64_t mem_size;
     const uint8_t *mem_ptr;
+#ifdef ENABLE_STATISTICS
+    coda_statistics statistics;
+#endif
 
     /* fields shared with 'bin' product */
+    int64_t file_offset;        /* offset of the product data within the file (only non-zero for zip entries) */
     int use_mmap;       /* indicates whether to use mem_ptr (or the file descriptor 'fd') */
     int fd;     /* file handle when not using mem_ptr */
+    coda_bin_cache *cache;      /* block cache for reads using 'fd' (NULL if disabled) */
+    coda_inflate_index *inflate_index;  /* decompression index for gzip compressed files (NULL if not compressed) */
+    coda_mutex *lock;   /* serializes access to 'cache', 'inflate_index' and the file position of 'fd' */
+    void (*free_mem_ptr) (void *);      /* release function for mem_ptr of products opened from memory */
+    coda_size_cache *size_cache;        /* memo of dynamically calculated bit sizes (NULL if disabled) */
+    coda_bin_reader *reader;    /* reused for batched reads using 'fd' (NULL if not (yet) created) */
 #ifdef WIN32
     HANDLE file;
     HANDLE file_mapping;
@@ -33,6 +33,7 @@
 #include "coda-bin-internal.h"
 #include "coda-definition.h"
 #include "coda-read-bytes.h"
+#include "coda-statistics.h"
 
 #include <assert.h>
 #include <errno.h>
@@ -72,10 +73,23 @@ int coda_ascii_reopen_with_definition(coda_product **product, const coda_product
     (*product)->mem_size = 0;
     product_file->mem_ptr = (*(coda_bin_product **)product)->mem_ptr;
     (*product)->mem_ptr = NULL;
+    coda_statistics_init(product_file);
 
+    product_file->file_offset = (*(coda_bin_product **)product)->file_offset;
     product_file->use_mmap = (*(coda_bin_product **)product)->use_mmap;
     product_file->fd = (*(coda_bin_product **)product)->fd;
     (*(coda_bin_product **)product)->fd = -1;
+    product_file->cache = (*(coda_bin_product **)product)->cache;
+    (*(coda_bin_product **)product)->cache = NULL;
+    product_file->inflate_index = (*(coda_bin_product **)product)->inflate_index;
+    (*(coda_bin_product **)product)->inflate_index = NULL;
+    product_file->lock = (*(coda_bin_product **)product)->lock;
+    (*(coda_bin_product **)product)->lock = NULL;
+    product_file->free_mem_ptr = (*(coda_bin_product **)product)->free_mem_ptr;
+    (*(coda_bin_product **)product)->free_mem_ptr = NULL;
+    product_file->size_cache = NULL;
+    product_file->reader = (*(coda_bin_product **)product)->reader;
+    (*(coda_bin_product **)product)->reader = NULL;
 
 #ifdef WIN32
     product_file->file = (*(coda_bin_product **)product)->file;
@@ -102,6 +116,14 @@ int coda_ascii_reopen_with_definition(coda_product **product, const coda_product
     coda_close(*product);
     *product = (coda_product *)product_file;
 
+    if (coda_option_bit_size_cache_max_entries > 0)
+    {
+        if (coda_size_cache_new(coda_option_bit_size_cache_max_entries, &product_file->size_cache) != 0)
+        {
+            return -1;
+        }
+    }
+
     return 0;
 }
 
@@ -172,7 +194,7 @@ static int verify_eol_type(coda_ascii_product *product_file, eol_type end_of_lin
     return 0;
 }
 
-int coda_ascii_init_asciilines(coda_product *product)
+static int init_asciilines(coda_product *product)
 {
     char buffer[ASCII_PARSE_BLOCK_SIZE + 1];
     coda_ascii_product *product_file = (coda_ascii_product *)product;
@@ -184,15 +206,6 @@ int coda_ascii_init_asciilines(coda_product *product)
 
     assert(product_file->num_asciilines == -1);
 
-    if (!product_file->use_mmap)
-    {
-        if (lseek(product_file->fd, 0, SEEK_SET) < 0)
-        {
-            coda_set_error(CODA_ERROR_FILE_READ, "could not move to start of file (%s)", strerror(errno));
-            return -1;
-        }
-    }
-
     for (;;)
     {
         int64_t blocksize = ASCII_PARSE_BLOCK_SIZE;
@@ -306,8 +319,31 @@ int coda_ascii_init_asciilines(coda_product *product)
     }
 
     product_file->num_asciilines = num_asciilines;
-    product_file->asciiline_end_offset = asciiline_end_offset;
     product_file->lastline_ending = lastline_ending;
+    coda_atomic_store_ptr(&product_file->asciiline_end_offset, asciiline_end_offset);
 
     return 0;
 }
+
+/* Determine the end offsets of all lines in the file (if this was not done already).
+ * This is done only once per product, also when multiple threads access the product at the same time.
+ */
+int coda_ascii_init_asciilines(coda_product *product)
+{
+    coda_ascii_product *product_file = (coda_ascii_product *)product;
+    int result = 0;
+
+    if (coda_atomic_load_ptr(&product_file->asciiline_end_offset) != NULL)
+    {
+        return 0;
+    }
+
+    coda_lazy_init_lock();
+    if (product_file->num_asciilines == -1)
+    {
+        result = init_asciilines(product);
+    }
+    coda_lazy_init_unlock();
+
+    return result;
+}
@@ -59,6 +59,8 @@ int coda_ascii_cursor_read_char(const coda_cursor *cursor, char *dst);
 int coda_ascii_cursor_read_string(const coda_cursor *cursor, char *dst, long dst_length);
 int coda_ascii_cursor_read_bits(const coda_cursor *cursor, uint8_t *dst, int64_t bit_offset, int64_t bit_length);
 int coda_ascii_cursor_read_bytes(const coda_cursor *cursor, uint8_t *dst, int64_t offset, int64_t length);
+int coda_ascii_cursor_get_data_pointer(const coda_cursor *cursor, const uint8_t **data, int64_t *byte_size,
+                                       coda_endianness *endianness);
 
 int coda_ascii_cursor_read_int8_array(const coda_cursor *cursor, int8_t *dst, coda_array_ordering array_ordering);
 int coda_ascii_cursor_read_uint8_array(const coda_cursor *cursor, uint8_t *dst, coda_array_ordering array_ordering);
@@ -37,6 +37,7 @@
 #include "coda-read-partial-array.h"
 #include "coda-transpose-array.h"
 #include "coda-ascbin.h"
+#include "coda-statistics.h"
 
 #include <assert.h>
 #include <ctype.h>
@@ -74,6 +75,7 @@ int coda_bin_cursor_get_bit_size(const coda_cursor *cursor, int64_t *bit_size)
             }
             else
             {
+                coda_statistics_add(cursor->product, num_size_calculations, 1);
                 if (coda_expression_eval_integer(type->size_expr, cursor, bit_size) != 0)
                 {
                     coda_add_error_message(" for size expression");
@@ -635,7 +637,7 @@ int coda_bin_cursor_read_int64(const coda_cursor *cursor, int64_t *dst)
         if (value & (((uint64_t)1) << (bit_size - 1)))
         {
             /* sign bit is set -> set higher significant bits to 1 as well */
-            *dst = (int64_t)(value | ~((1 << bit_size) - 1));
+            *dst = (int64_t)(value | ~((((uint64_t)1) << bit_size) - 1));
         }
     }
 
@@ -894,12 +896,185 @@ int coda_bin_cursor_read_bytes(const coda_cursor *cursor, uint8_t *dst, int64_t
     return read_bytes(cursor->product, (cursor->stack[cursor->n - 1].bit_offset >> 3) + offset, length, dst);
 }
 
+int coda_bin_cursor_get_data_pointer(const coda_cursor *cursor, const uint8_t **data, int64_t *byte_size,
+                                     coda_endianness *endianness)
+{
+    coda_type *type = coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
+    int64_t bit_size;
+
+    if (cursor->stack[cursor->n - 1].bit_offset & 0x7)
+    {
+        coda_set_error(CODA_ERROR_INVALID_TYPE, "data does not start at a byte boundary");
+        return -1;
+    }
+    if (coda_bin_cursor_get_bit_size(cursor, &bit_size) != 0)
+    {
+        return -1;
+    }
+    if (bit_size & 0x7)
+    {
+        coda_set_error(CODA_ERROR_INVALID_TYPE, "data does not end at a byte boundary");
+        return -1;
+    }
+
+    if (type->type_class == coda_array_class)
+    {
+        type = ((coda_type_array *)type)->base_type;
+    }
+    if ((type->type_class == coda_integer_class || type->type_class == coda_real_class) &&
+        type->format == coda_format_binary)
+    {
+        *endianness = ((coda_type_number *)type)->endianness;
+    }
+    else
+    {
+#ifdef WORDS_BIGENDIAN
+        *endianness = coda_big_endian;
+#else
+        *endianness = coda_little_endian;
+#endif
+    }
+    *byte_size = bit_size >> 3;
+
+    return coda_bin_product_get_data_pointer(cursor->product, cursor->stack[cursor->n - 1].bit_offset >> 3,
+                                             *byte_size, data);
+}
+
+/* number of array elements that read_packed_integer_array() unpacks at once */
+#define PACKED_ARRAY_BLOCK_SIZE 512
+
+/* Arrays of binary integers that do not consist of whole aligned bytes are read by unpacking all bits at once.
+ * Integers of more than 8 bits are only read this way if they are big endian (only then they form a single continuous
+ * big endian bit string).
+ */
+static int is_packed_integer_array(const coda_cursor *cursor, const coda_type_array *type)
+{
+    coda_type_number *base_type = (coda_type_number *)type->base_type;
+
+    if (base_type->type_class != coda_integer_class || base_type->format != coda_format_binary ||
+        base_type->bit_size < 1 || base_type->bit_size > 64)
+    {
+        return 0;
+    }
+    if (base_type->bit_size > 8 && base_type->endianness != coda_big_endian)
+    {
+        return 0;
+    }
+
+    return (base_type->bit_size & 0x7) != 0 || (cursor->stack[cursor->n - 1].bit_offset & 0x7) != 0;
+}
+
+static int read_packed_integer_array(const coda_cursor *cursor, long offset, long length, coda_native_type read_type,
+                                     uint8_t *dst)
+{
+    coda_type_array *type = (coda_type_array *)coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
+    int bit_size = (int)type->base_type->bit_size;
+    int64_t bit_offset = cursor->stack[cursor->n - 1].bit_offset + offset * bit_size;
+    uint64_t buffer[PACKED_ARRAY_BLOCK_SIZE];
+    uint64_t sign_bit = (uint64_t)1 << (bit_size - 1);
+    uint64_t sign_extension = (bit_size == 64 ? 0 : ~(uint64_t)0 << bit_size);
+    int is_signed;
+    long i;
+
+    is_signed = (read_type == coda_native_type_int8 || read_type == coda_native_type_int16 ||
+                 read_type == coda_native_type_int32 || read_type == coda_native_type_int64);
+
+    while (length > 0)
+    {
+        long block_length = length < PACKED_ARRAY_BLOCK_SIZE ? length : PACKED_ARRAY_BLOCK_SIZE;
+
+        if (read_packed_bits(cursor->product, bit_offset, bit_size, block_length, buffer) != 0)
+        {
+            return -1;
+        }
+        if (is_signed && sign_extension != 0)
+        {
+            for (i = 0; i < block_length; i++)
+            {
+                if (buffer[i] & sign_bit)
+                {
+                    /* sign bit is set -> set higher significant bits to 1 as well */
+                    buffer[i] |= sign_extension;
+                }
+            }
+        }
+        switch (read_type)
+        {
+            case coda_native_type_int8:
+            case coda_native_type_uint8:
+                for (i = 0; i < block_length; i++)
+                {
+                    ((uint8_t *)dst)[i] = (uint8_t)buffer[i];
+                }
+                dst += block_length * sizeof(uint8_t);
+                break;
+            case coda_native_type_int16:
+            case coda_native_type_uint16:
+                for (i = 0; i < block_length; i++)
+                {
+                    ((uint16_t *)dst)[i] = (uint16_t)buffer[i];
+                }
+                dst += block_length * sizeof(uint16_t);
+                break;
+            case coda_native_type_int32:
+            case coda_native_type_uint32:
+                for (i = 0; i < block_length; i++)
+                {
+                    ((uint32_t *)dst)[i] = (uint32_t)buffer[i];
+                }
+                dst += block_length * sizeof(uint32_t);
+                break;
+            case coda_native_type_int64:
+            case coda_native_type_uint64:
+                memcpy(dst, buffer, block_length * sizeof(uint64_t));
+                dst += block_length * sizeof(uint64_t);
+                break;
+            default:
+                assert(0);
+                exit(1);
+        }
+        bit_offset += block_length * bit_size;
+        length -= block_length;
+    }
+
+    return 0;
+}
+
+static int read_full_packed_integer_array(const coda_cursor *cursor, coda_native_type read_type, uint8_t *dst,
+                                          int basic_type_size, coda_array_ordering array_ordering)
+{
+    long num_elements;
+
+    if (coda_cursor_get_num_elements(cursor, &num_elements) != 0)
+    {
+        return -1;
+    }
+    if (read_packed_integer_array(cursor, 0, num_elements, read_type, dst) != 0)
+    {
+        return -1;
+    }
+    if (array_ordering != coda_array_ordering_c)
+    {
+        if (transpose_array(cursor, dst, basic_type_size) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 int coda_bin_cursor_read_int8_array(const coda_cursor *cursor, int8_t *dst, coda_array_ordering array_ordering)
 {
     coda_type_array *type = (coda_type_array *)coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_full_packed_integer_array(cursor, coda_native_type_int8, (uint8_t *)dst, sizeof(int8_t),
+                                                  array_ordering);
+        }
         return read_array(cursor, (read_function)&coda_bin_cursor_read_int8, (uint8_t *)dst, sizeof(int8_t),
                           array_ordering);
     }
@@ -926,6 +1101,11 @@ int coda_bin_cursor_read_uint8_array(const coda_cursor *cursor, uint8_t *dst, co
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_full_packed_integer_array(cursor, coda_native_type_uint8, (uint8_t *)dst, sizeof(uint8_t),
+                                                  array_ordering);
+        }
         return read_array(cursor, (read_function)&coda_bin_cursor_read_uint8, (uint8_t *)dst, sizeof(uint8_t),
                           array_ordering);
     }
@@ -952,6 +1132,11 @@ int coda_bin_cursor_read_int16_array(const coda_cursor *cursor, int16_t *dst, co
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_full_packed_integer_array(cursor, coda_native_type_int16, (uint8_t *)dst, sizeof(int16_t),
+                                                  array_ordering);
+        }
         return read_array(cursor, (read_function)&coda_bin_cursor_read_int16, (uint8_t *)dst, sizeof(int16_t),
                           array_ordering);
     }
@@ -978,6 +1163,11 @@ int coda_bin_cursor_read_uint16_array(const coda_cursor *cursor, uint16_t *dst,
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_full_packed_integer_array(cursor, coda_native_type_uint16, (uint8_t *)dst, sizeof(uint16_t),
+                                                  array_ordering);
+        }
         return read_array(cursor, (read_function)&coda_bin_cursor_read_uint16, (uint8_t *)dst, sizeof(uint16_t),
                           array_ordering);
     }
@@ -1004,6 +1194,11 @@ int coda_bin_cursor_read_int32_array(const coda_cursor *cursor, int32_t *dst, co
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_full_packed_integer_array(cursor, coda_native_type_int32, (uint8_t *)dst, sizeof(int32_t),
+                                                  array_ordering);
+        }
         return read_array(cursor, (read_function)&coda_bin_cursor_read_int32, (uint8_t *)dst, sizeof(int32_t),
                           array_ordering);
     }
@@ -1030,6 +1225,11 @@ int coda_bin_cursor_read_uint32_array(const coda_cursor *cursor, uint32_t *dst,
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_full_packed_integer_array(cursor, coda_native_type_uint32, (uint8_t *)dst, sizeof(uint32_t),
+                                                  array_ordering);
+        }
         return read_array(cursor, (read_function)&coda_bin_cursor_read_uint32, (uint8_t *)dst, sizeof(uint32_t),
                           array_ordering);
     }
@@ -1056,6 +1256,11 @@ int coda_bin_cursor_read_int64_array(const coda_cursor *cursor, int64_t *dst, co
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_full_packed_integer_array(cursor, coda_native_type_int64, (uint8_t *)dst, sizeof(int64_t),
+                                                  array_ordering);
+        }
         return read_array(cursor, (read_function)&coda_bin_cursor_read_int64, (uint8_t *)dst, sizeof(int64_t),
                           array_ordering);
     }
@@ -1082,6 +1287,11 @@ int coda_bin_cursor_read_uint64_array(const coda_cursor *cursor, uint64_t *dst,
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_full_packed_integer_array(cursor, coda_native_type_uint64, (uint8_t *)dst, sizeof(uint64_t),
+                                                  array_ordering);
+        }
         return read_array(cursor, (read_function)&coda_bin_cursor_read_uint64, (uint8_t *)dst, sizeof(uint64_t),
                           array_ordering);
     }
@@ -1186,6 +1396,10 @@ int coda_bin_cursor_read_int8_partial_array(const coda_cursor *cursor, long offs
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_packed_integer_array(cursor, offset, length, coda_native_type_int8, (uint8_t *)dst);
+        }
         return read_partial_array(cursor, (read_function)&coda_bin_cursor_read_int8, offset, length, (uint8_t *)dst,
                                   sizeof(int8_t));
     }
@@ -1200,6 +1414,10 @@ int coda_bin_cursor_read_uint8_partial_array(const coda_cursor *cursor, long off
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_packed_integer_array(cursor, offset, length, coda_native_type_uint8, (uint8_t *)dst);
+        }
         return read_partial_array(cursor, (read_function)&coda_bin_cursor_read_uint8, offset, length, (uint8_t *)dst,
                                   sizeof(uint8_t));
     }
@@ -1214,6 +1432,10 @@ int coda_bin_cursor_read_int16_partial_array(const coda_cursor *cursor, long off
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_packed_integer_array(cursor, offset, length, coda_native_type_int16, (uint8_t *)dst);
+        }
         return read_partial_array(cursor, (read_function)&coda_bin_cursor_read_int16, offset, length, (uint8_t *)dst,
                                   sizeof(int16_t));
     }
@@ -1228,6 +1450,10 @@ int coda_bin_cursor_read_uint16_partial_array(const coda_cursor *cursor, long of
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_packed_integer_array(cursor, offset, length, coda_native_type_uint16, (uint8_t *)dst);
+        }
         return read_partial_array(cursor, (read_function)&coda_bin_cursor_read_uint16, offset, length, (uint8_t *)dst,
                                   sizeof(uint16_t));
     }
@@ -1242,6 +1468,10 @@ int coda_bin_cursor_read_int32_partial_array(const coda_cursor *cursor, long off
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_packed_integer_array(cursor, offset, length, coda_native_type_int32, (uint8_t *)dst);
+        }
         return read_partial_array(cursor, (read_function)&coda_bin_cursor_read_int32, offset, length, (uint8_t *)dst,
                                   sizeof(int32_t));
     }
@@ -1256,6 +1486,10 @@ int coda_bin_cursor_read_uint32_partial_array(const coda_cursor *cursor, long of
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_packed_integer_array(cursor, offset, length, coda_native_type_uint32, (uint8_t *)dst);
+        }
         return read_partial_array(cursor, (read_function)&coda_bin_cursor_read_uint32, offset, length, (uint8_t *)dst,
                                   sizeof(uint32_t));
     }
@@ -1270,6 +1504,10 @@ int coda_bin_cursor_read_int64_partial_array(const coda_cursor *cursor, long off
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_packed_integer_array(cursor, offset, length, coda_native_type_int64, (uint8_t *)dst);
+        }
         return read_partial_array(cursor, (read_function)&coda_bin_cursor_read_int64, offset, length, (uint8_t *)dst,
                                   sizeof(int64_t));
     }
@@ -1284,6 +1522,10 @@ int coda_bin_cursor_read_uint64_partial_array(const coda_cursor *cursor, long of
 
     if (type->base_type->format == coda_format_binary)
     {
+        if (is_packed_integer_array(cursor, type))
+        {
+            return read_packed_integer_array(cursor, offset, length, coda_native_type_uint64, (uint8_t *)dst);
+        }
         return read_partial_array(cursor, (read_function)&coda_bin_cursor_read_uint64, offset, length, (uint8_t *)dst,
                                   sizeof(uint64_t));
     }
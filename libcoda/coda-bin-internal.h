@@ -33,6 +33,42 @@
 #define CODA_BIN_INTERNAL_H
 
 #include "coda-bin.h"
+#include "coda-inflate.h"
+#include "coda-size-cache.h"
+#include "coda-thread.h"
+
+/* cache of fixed size file blocks with least-recently-used replacement (only used when not using mmap) */
+typedef struct coda_bin_cache_struct
+{
+    int64_t block_size;
+    long num_blocks;    /* maximum number of blocks in the cache */
+    long max_readahead; /* maximum number of blocks that are read at once for sequential access */
+    uint8_t *data;      /* block data (num_blocks * block_size bytes) */
+    uint8_t *buffer;    /* read buffer (max_readahead * block_size bytes) */
+    int64_t *block_id;  /* file block number of each cache slot (-1 if the slot is unused) */
+    long *lru_prev;     /* previous (i.e. more recently used) slot */
+    long *lru_next;     /* next (i.e. less recently used) slot */
+    long lru_head;      /* most recently used slot */
+    long lru_tail;      /* least recently used slot */
+    long hash_size;
+    long *hash_bucket;  /* first slot for each hash bucket (-1 if empty) */
+    long *hash_next;    /* next slot in the same hash bucket (-1 if last) */
+    int64_t next_block_id;      /* block number that would continue the current sequential read pattern */
+    long readahead;     /* number of blocks to read on the next sequential cache miss */
+    int64_t num_hits;
+    int64_t num_misses;
+} coda_bin_cache;
+
+/* a single read operation of a batch (see coda_bin_product_read_batch()) */
+typedef struct coda_bin_read_request_struct
+{
+    int64_t byte_offset;
+    int64_t length;
+    void *dst;
+} coda_bin_read_request;
+
+/* state that is kept between batches of reads (such as an io_uring instance); see coda_bin_product_read_batch() */
+typedef struct coda_bin_reader_struct coda_bin_reader;
 
 struct coda_bin_product_struct
 {
@@ -46,10 +82,20 @@ struct coda_bin_product_struct
     int64_t **product_variable;
     int64_t mem_size;
     const uint8_t *mem_ptr;
+#ifdef ENABLE_STATISTICS
+    coda_statistics statistics;
+#endif
 
     /* 'bin' product specific fields */
+    int64_t file_offset;        /* offset of the product data within the file (only non-zero for zip entries) */
     int use_mmap;       /* indicates whether to use mem_ptr (or the file descriptor 'fd') */
     int fd;     /* file handle when not using mem_ptr */
+    coda_bin_cache *cache;      /* block cache for reads using 'fd' (NULL if disabled) */
+    coda_inflate_index *inflate_index;  /* decompression index for gzip compressed files (NULL if not compressed) */
+    coda_mutex *lock;   /* serializes access to 'cache', 'inflate_index' and the file position of 'fd' */
+    void (*free_mem_ptr) (void *);      /* release function for mem_ptr of products opened from memory */
+    coda_size_cache *size_cache;        /* memo of dynamically calculated bit sizes (NULL if disabled) */
+    coda_bin_reader *reader;    /* reused for batched reads using 'fd' (NULL if not (yet) created) */
 #ifdef WIN32
     HANDLE file;
     HANDLE file_mapping;
@@ -57,7 +103,13 @@ struct coda_bin_product_struct
 };
 typedef struct coda_bin_product_struct coda_bin_product;
 
-int coda_bin_product_open(coda_bin_product *product);
+int coda_bin_product_open(coda_bin_product *product, const char *filename, int64_t uncompressed_size);
 int coda_bin_product_close(coda_bin_product *product);
+int coda_bin_product_get_data_pointer(coda_product *product, int64_t byte_offset, int64_t length, const uint8_t **data);
+int coda_bin_product_prefetch(coda_product *product, int64_t byte_offset, int64_t length);
+int coda_bin_product_read(coda_product *product, int64_t byte_offset, int64_t length, void *dst);
+int coda_bin_product_read_batch(coda_product *product, long num_requests, const coda_bin_read_request *request);
+void coda_bin_reader_delete(coda_bin_reader *reader);
+void coda_bin_product_get_cache_statistics(coda_product *product, int64_t *num_hits, int64_t *num_misses);
 
 #endif
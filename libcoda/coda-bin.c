@@ -31,6 +31,8 @@
 
 #include "coda-bin-internal.h"
 #include "coda-definition.h"
+#include "coda-statistics.h"
+#include "ziparchive.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -49,16 +51,436 @@
 #endif
 
 
-int coda_bin_product_open(coda_bin_product *product)
+/* maximum number of blocks that the block cache reads with a single read operation */
+#define MAX_CACHE_READAHEAD 16
+
+/* number of cache blocks for gzip compressed files if the block cache option is disabled */
+#define DEFAULT_GZIP_CACHE_NUM_BLOCKS 32
+
+static void cache_delete(coda_bin_cache *cache)
+{
+    if (cache->data != NULL)
+    {
+        free(cache->data);
+    }
+    if (cache->buffer != NULL)
+    {
+        free(cache->buffer);
+    }
+    if (cache->block_id != NULL)
+    {
+        free(cache->block_id);
+    }
+    if (cache->lru_prev != NULL)
+    {
+        free(cache->lru_prev);
+    }
+    if (cache->lru_next != NULL)
+    {
+        free(cache->lru_next);
+    }
+    if (cache->hash_bucket != NULL)
+    {
+        free(cache->hash_bucket);
+    }
+    if (cache->hash_next != NULL)
+    {
+        free(cache->hash_next);
+    }
+    free(cache);
+}
+
+static coda_bin_cache *cache_new(int64_t block_size, long num_blocks)
+{
+    coda_bin_cache *cache;
+    long i;
+
+    cache = (coda_bin_cache *)malloc(sizeof(coda_bin_cache));
+    if (cache == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(coda_bin_cache), __FILE__, __LINE__);
+        return NULL;
+    }
+    cache->block_size = block_size;
+    cache->num_blocks = num_blocks;
+    cache->max_readahead = num_blocks / 2;
+    if (cache->max_readahead > MAX_CACHE_READAHEAD)
+    {
+        cache->max_readahead = MAX_CACHE_READAHEAD;
+    }
+    if (cache->max_readahead < 1)
+    {
+        cache->max_readahead = 1;
+    }
+    cache->data = NULL;
+    cache->buffer = NULL;
+    cache->block_id = NULL;
+    cache->lru_prev = NULL;
+    cache->lru_next = NULL;
+    cache->lru_head = 0;
+    cache->lru_tail = num_blocks - 1;
+    cache->hash_size = 1;
+    while (cache->hash_size < 2 * num_blocks)
+    {
+        cache->hash_size <<= 1;
+    }
+    cache->hash_bucket = NULL;
+    cache->hash_next = NULL;
+    cache->next_block_id = 0;
+    cache->readahead = 1;
+    cache->num_hits = 0;
+    cache->num_misses = 0;
+
+    cache->data = malloc((size_t)(num_blocks * block_size));
+    if (cache->data == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)(num_blocks * block_size), __FILE__, __LINE__);
+        cache_delete(cache);
+        return NULL;
+    }
+    cache->buffer = malloc((size_t)(cache->max_readahead * block_size));
+    if (cache->buffer == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)(cache->max_readahead * block_size), __FILE__, __LINE__);
+        cache_delete(cache);
+        return NULL;
+    }
+    cache->block_id = malloc(num_blocks * sizeof(int64_t));
+    cache->lru_prev = malloc(num_blocks * sizeof(long));
+    cache->lru_next = malloc(num_blocks * sizeof(long));
+    cache->hash_next = malloc(num_blocks * sizeof(long));
+    cache->hash_bucket = malloc(cache->hash_size * sizeof(long));
+    if (cache->block_id == NULL || cache->lru_prev == NULL || cache->lru_next == NULL || cache->hash_next == NULL ||
+        cache->hash_bucket == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate block cache administration) "
+                       "(%s:%u)", __FILE__, __LINE__);
+        cache_delete(cache);
+        return NULL;
+    }
+    for (i = 0; i < num_blocks; i++)
+    {
+        cache->block_id[i] = -1;
+        cache->lru_prev[i] = i - 1;
+        cache->lru_next[i] = (i < num_blocks - 1 ? i + 1 : -1);
+        cache->hash_next[i] = -1;
+    }
+    for (i = 0; i < cache->hash_size; i++)
+    {
+        cache->hash_bucket[i] = -1;
+    }
+
+    return cache;
+}
+
+static long cache_hash(const coda_bin_cache *cache, int64_t block_id)
+{
+    uint64_t h = (uint64_t)block_id * 0x9E3779B97F4A7C15ULL;
+
+    return (long)((h >> 32) & (cache->hash_size - 1));
+}
+
+static long cache_find(const coda_bin_cache *cache, int64_t block_id)
+{
+    long slot;
+
+    slot = cache->hash_bucket[cache_hash(cache, block_id)];
+    while (slot != -1 && cache->block_id[slot] != block_id)
+    {
+        slot = cache->hash_next[slot];
+    }
+
+    return slot;
+}
+
+/* make 'slot' the most recently used slot */
+static void cache_touch(coda_bin_cache *cache, long slot)
+{
+    if (slot == cache->lru_head)
+    {
+        return;
+    }
+    /* unlink */
+    cache->lru_next[cache->lru_prev[slot]] = cache->lru_next[slot];
+    if (cache->lru_next[slot] != -1)
+    {
+        cache->lru_prev[cache->lru_next[slot]] = cache->lru_prev[slot];
+    }
+    else
+    {
+        cache->lru_tail = cache->lru_prev[slot];
+    }
+    /* insert at head */
+    cache->lru_prev[slot] = -1;
+    cache->lru_next[slot] = cache->lru_head;
+    cache->lru_prev[cache->lru_head] = slot;
+    cache->lru_head = slot;
+}
+
+/* reuse the least recently used slot for block 'block_id' and return the slot */
+static long cache_replace(coda_bin_cache *cache, int64_t block_id)
+{
+    long slot = cache->lru_tail;
+    long bucket;
+
+    if (cache->block_id[slot] != -1)
+    {
+        long *link;
+
+        /* remove the old block from its hash bucket */
+        link = &cache->hash_bucket[cache_hash(cache, cache->block_id[slot])];
+        while (*link != slot)
+        {
+            link = &cache->hash_next[*link];
+        }
+        *link = cache->hash_next[slot];
+    }
+    cache->block_id[slot] = block_id;
+    bucket = cache_hash(cache, block_id);
+    cache->hash_next[slot] = cache->hash_bucket[bucket];
+    cache->hash_bucket[bucket] = slot;
+    cache_touch(cache, slot);
+
+    return slot;
+}
+
+#ifndef WIN32
+/* returns the distance between the start of the product data in the file and the preceding page boundary */
+static int64_t get_map_offset(const coda_bin_product *product)
+{
+    long page_size;
+
+    if (product->file_offset == 0)
+    {
+        return 0;
+    }
+    page_size = sysconf(_SC_PAGESIZE);
+    if (page_size <= 0)
+    {
+        page_size = 65536;
+    }
+
+    return product->file_offset % page_size;
+}
+#endif
+
+static int read_from_file(coda_bin_product *product, int64_t byte_offset, int64_t length, void *dst)
+{
+    coda_statistics_add(product, num_file_reads, 1);
+    coda_statistics_add(product, num_file_bytes_read, length);
+    if (product->inflate_index != NULL)
+    {
+        return coda_inflate_index_read(product->inflate_index, byte_offset, length, dst);
+    }
+#if HAVE_PREAD
+    if (pread(product->fd, dst, (size_t)length, (off_t)(product->file_offset + byte_offset)) < 0)
+    {
+        coda_set_error(CODA_ERROR_FILE_READ, "could not read from file (%s)", strerror(errno));
+        return -1;
+    }
+#else
+    if (lseek(product->fd, (off_t)(product->file_offset + byte_offset), SEEK_SET) < 0)
+    {
+        char byte_offset_str[21];
+
+        coda_str64(product->file_offset + byte_offset, byte_offset_str);
+        coda_set_error(CODA_ERROR_FILE_READ, "could not move to byte position %s (%s)", byte_offset_str,
+                       strerror(errno));
+        return -1;
+    }
+    if (read(product->fd, dst, (size_t)length) < 0)
+    {
+        coda_set_error(CODA_ERROR_FILE_READ, "could not read from file (%s)", strerror(errno));
+        return -1;
+    }
+#endif
+
+    return 0;
+}
+
+/* read block 'block_id' into the cache and return its slot.
+ * If the block continues a sequential read pattern, the blocks that follow it are read as well (using a single read
+ * operation), where the number of blocks that are read ahead doubles with each sequential miss.
+ */
+static long cache_load(coda_bin_product *product, int64_t block_id)
+{
+    coda_bin_cache *cache = product->cache;
+    int64_t block_offset = block_id * cache->block_size;
+    int64_t read_length;
+    long num_blocks = 1;
+    long slot = -1;
+    long i;
+
+    cache->num_misses++;
+    coda_statistics_add(product, num_block_cache_misses, 1);
+    if (block_id == cache->next_block_id)
+    {
+        num_blocks = cache->readahead;
+        if (cache->readahead < cache->max_readahead)
+        {
+            cache->readahead *= 2;
+            if (cache->readahead > cache->max_readahead)
+            {
+                cache->readahead = cache->max_readahead;
+            }
+        }
+    }
+    else
+    {
+        cache->readahead = 1;
+    }
+    /* don't read beyond the end of the file or reread blocks that are already in the cache */
+    for (i = 1; i < num_blocks; i++)
+    {
+        if ((block_id + i) * cache->block_size >= product->file_size || cache_find(cache, block_id + i) != -1)
+        {
+            num_blocks = i;
+            break;
+        }
+    }
+
+    read_length = num_blocks * cache->block_size;
+    if (block_offset + read_length > product->file_size)
+    {
+        read_length = product->file_size - block_offset;
+    }
+    if (read_from_file(product, block_offset, read_length, cache->buffer) != 0)
+    {
+        return -1;
+    }
+
+    /* store the blocks such that the requested block becomes the most recently used one */
+    for (i = num_blocks - 1; i >= 0; i--)
+    {
+        int64_t length = cache->block_size;
+
+        if (i == num_blocks - 1)
+        {
+            length = read_length - i * cache->block_size;
+        }
+        slot = cache_replace(cache, block_id + i);
+        memcpy(cache->data + slot * cache->block_size, cache->buffer + i * cache->block_size, (size_t)length);
+    }
+    cache->next_block_id = block_id + num_blocks;
+
+    return slot;
+}
+
+static int read_from_cache(coda_bin_product *product_file, int64_t byte_offset, int64_t length, void *dst)
+{
+    coda_bin_cache *cache = product_file->cache;
+    uint8_t *buffer = (uint8_t *)dst;
+
+    while (length > 0)
+    {
+        int64_t block_id = byte_offset / cache->block_size;
+        int64_t block_offset = byte_offset - block_id * cache->block_size;
+        int64_t block_length = cache->block_size - block_offset;
+        long slot;
+
+        slot = cache_find(cache, block_id);
+        if (slot == -1)
+        {
+            slot = cache_load(product_file, block_id);
+            if (slot == -1)
+            {
+                return -1;
+            }
+        }
+        else
+        {
+            cache->num_hits++;
+            coda_statistics_add(product_file, num_block_cache_hits, 1);
+            cache_touch(cache, slot);
+        }
+        if (block_length > length)
+        {
+            block_length = length;
+        }
+        memcpy(buffer, cache->data + slot * cache->block_size + block_offset, (size_t)block_length);
+        buffer += block_length;
+        byte_offset += block_length;
+        length -= block_length;
+    }
+
+    return 0;
+}
+
+/* Read data from a product that is accessed using a file descriptor (i.e. that is not memory mapped).
+ * The caller should make sure that the requested range is within the bounds of the file.
+ * Small reads are served from the block cache if the product has one. Reads of a block or more are always passed
+ * on directly to the file.
+ * This function can be called concurrently for the same product. Only reads that use shared state (the block cache,
+ * the decompression index, or the file position when pread() is not available) are serialized.
+ */
+int coda_bin_product_read(coda_product *product, int64_t byte_offset, int64_t length, void *dst)
+{
+    coda_bin_product *product_file = (coda_bin_product *)product;
+    int result;
+
+    if (product_file->cache == NULL || length >= product_file->cache->block_size)
+    {
+#if HAVE_PREAD
+        if (product_file->inflate_index == NULL)
+        {
+            return read_from_file(product_file, byte_offset, length, dst);
+        }
+#endif
+        coda_mutex_lock(product_file->lock);
+        result = read_from_file(product_file, byte_offset, length, dst);
+        coda_mutex_unlock(product_file->lock);
+        return result;
+    }
+
+    coda_mutex_lock(product_file->lock);
+    result = read_from_cache(product_file, byte_offset, length, dst);
+    coda_mutex_unlock(product_file->lock);
+
+    return result;
+}
+
+/* Retrieve the hit/miss counters of the block cache of a product (both are 0 if there is no cache) */
+void coda_bin_product_get_cache_statistics(coda_product *product, int64_t *num_hits, int64_t *num_misses)
+{
+    coda_bin_cache *cache = ((coda_bin_product *)product)->cache;
+
+    *num_hits = 0;
+    *num_misses = 0;
+    if (cache != NULL)
+    {
+        coda_mutex_lock(((coda_bin_product *)product)->lock);
+        *num_hits = cache->num_hits;
+        *num_misses = cache->num_misses;
+        coda_mutex_unlock(((coda_bin_product *)product)->lock);
+    }
+}
+
+/* Open the file 'filename' and provide access to the product->file_size bytes at offset product->file_offset in that
+ * file (the file offset is only non-zero for products that are stored inside a zip file).
+ * If 'uncompressed_size' is >= 0, these bytes are a raw deflate stream that decompresses to 'uncompressed_size' bytes
+ * (as is the case for compressed zip entries). Otherwise, if the data is a gzip file it will be decompressed
+ * transparently (if enabled).
+ * In both cases product->file_size will be set to the uncompressed size.
+ */
+int coda_bin_product_open(coda_bin_product *product, const char *filename, int64_t uncompressed_size)
 {
     product->use_mmap = 0;
     product->fd = -1;
+    product->cache = NULL;
+    product->inflate_index = NULL;
+    product->lock = NULL;
+    product->free_mem_ptr = NULL;
+    product->size_cache = NULL;
+    product->reader = NULL;
 #ifdef WIN32
     product->file_mapping = INVALID_HANDLE_VALUE;
     product->file = INVALID_HANDLE_VALUE;
 #endif
 
-    if (coda_option_use_mmap && product->file_size > 0)
+    if (coda_option_use_mmap && product->file_size > 0 && uncompressed_size < 0)
     {
         /* Perform an mmap() of the file, filling the following fields:
          *   product->use_mem_ptr = 1
@@ -68,13 +490,13 @@ int coda_bin_product_open(coda_bin_product *product)
          */
 #ifdef WIN32
         product->use_mmap = 1;
-        product->file = CreateFile(product->filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        product->file = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
                                    FILE_ATTRIBUTE_NORMAL, NULL);
         if (product->file == INVALID_HANDLE_VALUE)
         {
             if (GetLastError() == ERROR_FILE_NOT_FOUND)
             {
-                coda_set_error(CODA_ERROR_FILE_NOT_FOUND, "could not find %s", product->filename);
+                coda_set_error(CODA_ERROR_FILE_NOT_FOUND, "could not find %s", filename);
             }
             else
             {
@@ -85,11 +507,11 @@ int coda_bin_product_open(coda_bin_product *product)
                                   MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPTSTR)&lpMsgBuf, 0, NULL) == 0)
                 {
                     /* Set error without additional information */
-                    coda_set_error(CODA_ERROR_FILE_OPEN, "could not open file %s", product->filename);
+                    coda_set_error(CODA_ERROR_FILE_OPEN, "could not open file %s", filename);
                 }
                 else
                 {
-                    coda_set_error(CODA_ERROR_FILE_OPEN, "could not open file %s (%s)", product->filename,
+                    coda_set_error(CODA_ERROR_FILE_OPEN, "could not open file %s (%s)", filename,
                                    (LPCTSTR) lpMsgBuf);
                     LocalFree(lpMsgBuf);
                 }
@@ -99,7 +521,7 @@ int coda_bin_product_open(coda_bin_product *product)
 
         /* Try to do file mapping */
         product->file_mapping = CreateFileMapping(product->file, NULL, PAGE_READONLY, 0,
-                                                  (int32_t)product->file_size, 0);
+                                                  (int32_t)(product->file_offset + product->file_size), 0);
         if (product->file_mapping == NULL)
         {
             LPVOID lpMsgBuf;
@@ -109,11 +531,11 @@ int coda_bin_product_open(coda_bin_product *product)
                               MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPTSTR)&lpMsgBuf, 0, NULL) == 0)
             {
                 /* Set error without additional information */
-                coda_set_error(CODA_ERROR_FILE_OPEN, "could not map file %s into memory", product->filename);
+                coda_set_error(CODA_ERROR_FILE_OPEN, "could not map file %s into memory", filename);
             }
             else
             {
-                coda_set_error(CODA_ERROR_FILE_OPEN, "could not map file %s into memory (%s)", product->filename,
+                coda_set_error(CODA_ERROR_FILE_OPEN, "could not map file %s into memory (%s)", filename,
                                (LPCTSTR) lpMsgBuf);
                 LocalFree(lpMsgBuf);
             }
@@ -121,6 +543,10 @@ int coda_bin_product_open(coda_bin_product *product)
         }
 
         product->mem_ptr = (uint8_t *)MapViewOfFile(product->file_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (product->mem_ptr != NULL)
+        {
+            product->mem_ptr += product->file_offset;
+        }
         if (product->mem_ptr == NULL)
         {
             LPVOID lpMsgBuf;
@@ -130,44 +556,57 @@ int coda_bin_product_open(coda_bin_product *product)
                               MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPTSTR)&lpMsgBuf, 0, NULL) == 0)
             {
                 /* Set error without additional information */
-                coda_set_error(CODA_ERROR_FILE_OPEN, "could not map file %s into memory", product->filename);
+                coda_set_error(CODA_ERROR_FILE_OPEN, "could not map file %s into memory", filename);
             }
             else
             {
-                coda_set_error(CODA_ERROR_FILE_OPEN, "could not map file %s into memory (%s)", product->filename,
+                coda_set_error(CODA_ERROR_FILE_OPEN, "could not map file %s into memory (%s)", filename,
                                (LPCTSTR) lpMsgBuf);
                 LocalFree(lpMsgBuf);
             }
             return -1;
         }
 #else
+        int64_t map_offset = get_map_offset(product);
         int fd;
 
         product->use_mmap = 1;
-        fd = open(product->filename, O_RDONLY);
+        fd = open(filename, O_RDONLY);
         if (fd < 0)
         {
-            coda_set_error(CODA_ERROR_FILE_OPEN, "could not open file %s (%s)", product->filename, strerror(errno));
+            coda_set_error(CODA_ERROR_FILE_OPEN, "could not open file %s (%s)", filename, strerror(errno));
             return -1;
         }
 
-        product->mem_ptr = (uint8_t *)mmap(0, product->file_size, PROT_READ, MAP_SHARED, fd, 0);
+        /* the offset for mmap() needs to be page aligned */
+        product->mem_ptr = (uint8_t *)mmap(0, product->file_size + map_offset, PROT_READ, MAP_SHARED, fd,
+                                           (off_t)(product->file_offset - map_offset));
         if (product->mem_ptr == (uint8_t *)MAP_FAILED)
         {
-            coda_set_error(CODA_ERROR_FILE_OPEN, "could not map file %s into memory (%s)", product->filename,
+            coda_set_error(CODA_ERROR_FILE_OPEN, "could not map file %s into memory (%s)", filename,
                            strerror(errno));
             product->mem_ptr = NULL;
             close(fd);
             return -1;
         }
 
+        product->mem_ptr += map_offset;
+
         /* close file descriptor (the file handle is not needed anymore) */
         close(fd);
 #endif
         product->mem_size = product->file_size;
+
+        if (coda_option_decompress_gzip && coda_inflate_is_gzip(product->mem_ptr, product->mem_size))
+        {
+            /* compressed data can not be accessed directly, so use a file descriptor instead */
+            coda_bin_product_close(product);
+            product->mem_size = 0;
+        }
     }
-    else
+    if (!product->use_mmap)
     {
+        long num_cache_blocks = coda_option_block_cache_num_blocks;
         int open_flags;
 
         /* Perform a normal open of the file, filling the following fields:
@@ -178,10 +617,69 @@ int coda_bin_product_open(coda_bin_product *product)
 #ifdef WIN32
         open_flags |= _O_BINARY;
 #endif
-        product->fd = open(product->filename, open_flags);
+        product->fd = open(filename, open_flags);
         if (product->fd < 0)
         {
-            coda_set_error(CODA_ERROR_FILE_OPEN, "could not open file %s (%s)", product->filename, strerror(errno));
+            coda_set_error(CODA_ERROR_FILE_OPEN, "could not open file %s (%s)", filename, strerror(errno));
+            return -1;
+        }
+
+        if (uncompressed_size >= 0)
+        {
+            if (coda_inflate_index_new(product->fd, NULL, product->file_offset, product->file_size, 0,
+                                       uncompressed_size, &product->inflate_index) != 0)
+            {
+                close(product->fd);
+                product->fd = -1;
+                return -1;
+            }
+        }
+        else if (coda_option_decompress_gzip && product->file_size >= 2)
+        {
+            uint8_t magic[2];
+
+            if (read_from_file(product, 0, 2, magic) != 0)
+            {
+                close(product->fd);
+                product->fd = -1;
+                return -1;
+            }
+            if (coda_inflate_is_gzip(magic, 2))
+            {
+                /* an index file is only possible if the gzip file is not embedded in another file */
+                if (coda_inflate_index_new(product->fd, product->file_offset == 0 ? filename : NULL,
+                                           product->file_offset, product->file_size, 1, -1,
+                                           &product->inflate_index) != 0)
+                {
+                    close(product->fd);
+                    product->fd = -1;
+                    return -1;
+                }
+            }
+        }
+        if (product->inflate_index != NULL)
+        {
+            /* from now on the product is accessed as if it was the uncompressed file */
+            product->file_size = coda_inflate_index_get_size(product->inflate_index);
+            /* decompressing from an access point is expensive, so always keep recently decompressed data */
+            if (num_cache_blocks == 0)
+            {
+                num_cache_blocks = DEFAULT_GZIP_CACHE_NUM_BLOCKS;
+            }
+        }
+
+        if (num_cache_blocks > 0 && product->file_size > 0)
+        {
+            product->cache = cache_new(coda_option_block_cache_block_size, num_cache_blocks);
+            if (product->cache == NULL)
+            {
+                coda_bin_product_close(product);
+                return -1;
+            }
+        }
+        if (coda_mutex_new(&product->lock) != 0)
+        {
+            coda_bin_product_close(product);
             return -1;
         }
     }
@@ -196,7 +694,7 @@ int coda_bin_product_close(coda_bin_product *product)
 #ifdef WIN32
         if (product->mem_ptr != NULL)
         {
-            UnmapViewOfFile(product->mem_ptr);
+            UnmapViewOfFile(product->mem_ptr - product->file_offset);
             product->mem_ptr = NULL;
         }
         if (product->file_mapping != INVALID_HANDLE_VALUE)
@@ -212,25 +710,140 @@ int coda_bin_product_close(coda_bin_product *product)
 #else
         if (product->mem_ptr != NULL)
         {
-            munmap((void *)product->mem_ptr, product->file_size);
+            int64_t map_offset = get_map_offset(product);
+
+            munmap((void *)(product->mem_ptr - map_offset), product->file_size + map_offset);
             product->mem_ptr = NULL;
         }
 #endif
         product->use_mmap = 0;
     }
+    else if (product->fd < 0 && product->mem_ptr != NULL)
+    {
+        /* product was opened from memory */
+        if (product->free_mem_ptr != NULL)
+        {
+            product->free_mem_ptr((void *)product->mem_ptr);
+        }
+        product->mem_ptr = NULL;
+    }
     else
     {
+        if (product->inflate_index != NULL)
+        {
+            coda_inflate_index_delete(product->inflate_index);
+            product->inflate_index = NULL;
+        }
         if (product->fd >= 0)
         {
             close(product->fd);
             product->fd = -1;
         }
+        if (product->cache != NULL)
+        {
+            cache_delete(product->cache);
+            product->cache = NULL;
+        }
+        if (product->reader != NULL)
+        {
+            coda_bin_reader_delete(product->reader);
+            product->reader = NULL;
+        }
+        if (product->lock != NULL)
+        {
+            coda_mutex_delete(product->lock);
+            product->lock = NULL;
+        }
+    }
+    if (product->size_cache != NULL)
+    {
+        coda_size_cache_delete(product->size_cache);
+        product->size_cache = NULL;
     }
 
     return 0;
 }
 
-int coda_bin_open(const char *filename, int64_t file_size, coda_product **product)
+/* Provide direct access to a block of product data.
+ * This is only possible if the product data is available in memory (i.e. when the product is memory mapped).
+ * The returned pointer remains valid until the product is closed.
+ */
+int coda_bin_product_get_data_pointer(coda_product *product, int64_t byte_offset, int64_t length, const uint8_t **data)
+{
+    if (product->mem_ptr == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "direct access to product data is only possible if the product is "
+                       "memory mapped");
+        return -1;
+    }
+    if (byte_offset < 0 || length < 0 || ((uint64_t)byte_offset + length) > ((uint64_t)product->mem_size))
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_BOUNDS_READ, "trying to read beyond the end of the file");
+        return -1;
+    }
+    *data = product->mem_ptr + byte_offset;
+    coda_statistics_add(product, num_reads, 1);
+    coda_statistics_add(product, num_bytes_read, length);
+    coda_statistics_add(product, num_memory_reads, 1);
+    coda_statistics_add(product, num_memory_bytes_read, length);
+
+    return 0;
+}
+
+/* Tell the operating system that a block of product data will be needed soon.
+ * This is only a hint, so any failures are silently ignored.
+ */
+int coda_bin_product_prefetch(coda_product *product, int64_t byte_offset, int64_t length)
+{
+    coda_bin_product *product_file = (coda_bin_product *)product;
+
+    if (byte_offset < 0 || byte_offset >= product_file->file_size || length <= 0)
+    {
+        return 0;
+    }
+    if (byte_offset + length > product_file->file_size)
+    {
+        length = product_file->file_size - byte_offset;
+    }
+    coda_statistics_add(product, num_prefetches, 1);
+
+    if (product_file->use_mmap)
+    {
+#if defined(HAVE_POSIX_MADVISE) && !defined(WIN32)
+        if (product_file->mem_ptr != NULL)
+        {
+            long page_size = sysconf(_SC_PAGESIZE);
+            int64_t page_offset = 0;
+
+            /* the start address for madvise needs to be page aligned */
+            if (page_size > 0)
+            {
+                page_offset = (int64_t)((size_t)(product_file->mem_ptr + byte_offset) % page_size);
+            }
+            posix_madvise((void *)(product_file->mem_ptr + byte_offset - page_offset), (size_t)(length + page_offset),
+                          POSIX_MADV_WILLNEED);
+        }
+#endif
+    }
+    else
+    {
+#ifdef HAVE_POSIX_FADVISE
+        if (product_file->fd >= 0 && product_file->inflate_index == NULL)
+        {
+            posix_fadvise(product_file->fd, (off_t)(product_file->file_offset + byte_offset), (off_t)length,
+                          POSIX_FADV_WILLNEED);
+        }
+#endif
+    }
+
+    return 0;
+}
+
+/* create a raw product for the file_size bytes at file_offset in the file 'data_filename'
+ * (see coda_bin_product_open())
+ */
+static int open_raw_product(const char *filename, const char *data_filename, int64_t file_offset, int64_t file_size,
+                            int64_t uncompressed_size, coda_product **product)
 {
     coda_bin_product *product_file;
 
@@ -250,9 +863,17 @@ int coda_bin_open(const char *filename, int64_t file_size, coda_product **produc
     product_file->product_variable = NULL;
     product_file->mem_size = 0;
     product_file->mem_ptr = NULL;
+    coda_statistics_init(product_file);
 
+    product_file->file_offset = file_offset;
     product_file->use_mmap = 0;
     product_file->fd = -1;
+    product_file->cache = NULL;
+    product_file->inflate_index = NULL;
+    product_file->lock = NULL;
+    product_file->free_mem_ptr = NULL;
+    product_file->size_cache = NULL;
+    product_file->reader = NULL;
 
     product_file->root_type = (coda_dynamic_type *)coda_type_raw_file_singleton();
     if (product_file->root_type == NULL)
@@ -270,8 +891,164 @@ int coda_bin_open(const char *filename, int64_t file_size, coda_product **produc
         return -1;
     }
 
-    if (coda_bin_product_open(product_file) != 0)
+    if (coda_bin_product_open(product_file, data_filename, uncompressed_size) != 0)
+    {
+        coda_bin_close((coda_product *)product_file);
+        return -1;
+    }
+
+    *product = (coda_product *)product_file;
+
+    return 0;
+}
+
+int coda_bin_open(const char *filename, int64_t file_size, coda_product **product)
+{
+    return open_raw_product(filename, filename, 0, file_size, -1, product);
+}
+
+static void handle_ziparchive_error(const char *message, ...)
+{
+    va_list ap;
+
+    coda_set_error(CODA_ERROR_FILE_OPEN, NULL);
+    va_start(ap, message);
+    coda_set_error_message_vargs(message, ap);
+    va_end(ap);
+}
+
+/* Open an entry of a zip file as a raw product, where the first 'zip_filename_length' characters of 'filename' are
+ * the name of the zip file and the part after the subsequent '/' is the name of the entry within the zip file.
+ * Entries that are stored without compression are accessed directly in the zip file (using mmap if enabled).
+ * Compressed entries are decompressed on demand.
+ */
+int coda_bin_open_zip_entry(const char *filename, long zip_filename_length, coda_product **product)
+{
+    char *zip_filename;
+    za_file *zf;
+    za_entry *entry;
+    int64_t data_offset;
+    int64_t data_size;
+    int64_t uncompressed_size = -1;
+
+    zip_filename = malloc(zip_filename_length + 1);
+    if (zip_filename == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       zip_filename_length + 1, __FILE__, __LINE__);
+        return -1;
+    }
+    memcpy(zip_filename, filename, zip_filename_length);
+    zip_filename[zip_filename_length] = '\0';
+
+    zf = za_open(zip_filename, handle_ziparchive_error);
+    if (zf == NULL)
     {
+        free(zip_filename);
+        return -1;
+    }
+    entry = za_get_entry_by_name(zf, &filename[zip_filename_length + 1]);
+    if (entry == NULL)
+    {
+        coda_set_error(CODA_ERROR_FILE_NOT_FOUND, "could not find %s in zip file %s",
+                       &filename[zip_filename_length + 1], zip_filename);
+        za_close(zf);
+        free(zip_filename);
+        return -1;
+    }
+    data_offset = za_get_entry_data_offset(entry);
+    if (data_offset < 0)
+    {
+        za_close(zf);
+        free(zip_filename);
+        return -1;
+    }
+    if (za_is_entry_compressed(entry))
+    {
+        data_size = za_get_entry_compressed_size(entry);
+        uncompressed_size = za_get_entry_uncompressed_size(entry);
+    }
+    else
+    {
+        data_size = za_get_entry_uncompressed_size(entry);
+    }
+    if (data_size < 0 || data_offset + data_size > za_get_file_size(zf))
+    {
+        coda_set_error(CODA_ERROR_FILE_OPEN, "data of %s lies outside zip file %s", &filename[zip_filename_length + 1],
+                       zip_filename);
+        za_close(zf);
+        free(zip_filename);
+        return -1;
+    }
+    za_close(zf);
+
+    if (open_raw_product(filename, zip_filename, data_offset, data_size, uncompressed_size, product) != 0)
+    {
+        free(zip_filename);
+        return -1;
+    }
+    free(zip_filename);
+
+    return 0;
+}
+
+/* Create a raw product for data that is already in memory.
+ * If free_buffer is not NULL, the product takes ownership of the buffer (also when this function fails) and will call
+ * free_buffer(buffer) when the product is closed.
+ */
+int coda_bin_open_memory(const char *name, const uint8_t *buffer, int64_t size, void (*free_buffer) (void *),
+                         coda_product **product)
+{
+    coda_bin_product *product_file;
+
+    product_file = (coda_bin_product *)malloc(sizeof(coda_bin_product));
+    if (product_file == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(coda_bin_product), __FILE__, __LINE__);
+        if (free_buffer != NULL)
+        {
+            free_buffer((void *)buffer);
+        }
+        return -1;
+    }
+    product_file->filename = NULL;
+    product_file->file_size = size;
+    product_file->format = coda_format_binary;
+    product_file->root_type = NULL;
+    product_file->product_definition = NULL;
+    product_file->product_variable_size = NULL;
+    product_file->product_variable = NULL;
+    product_file->mem_size = size;
+    product_file->mem_ptr = buffer;
+    coda_statistics_init(product_file);
+
+    product_file->file_offset = 0;
+    product_file->use_mmap = 0;
+    product_file->fd = -1;
+    product_file->cache = NULL;
+    product_file->inflate_index = NULL;
+    product_file->lock = NULL;
+    product_file->free_mem_ptr = free_buffer;
+    product_file->size_cache = NULL;
+    product_file->reader = NULL;
+#ifdef WIN32
+    product_file->file_mapping = INVALID_HANDLE_VALUE;
+    product_file->file = INVALID_HANDLE_VALUE;
+#endif
+
+    product_file->root_type = (coda_dynamic_type *)coda_type_raw_file_singleton();
+    if (product_file->root_type == NULL)
+    {
+        coda_bin_close((coda_product *)product_file);
+        return -1;
+    }
+
+    product_file->filename = strdup(name);
+    if (product_file->filename == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate filename string) (%s:%u)",
+                       __FILE__, __LINE__);
         coda_bin_close((coda_product *)product_file);
         return -1;
     }
@@ -292,6 +1069,14 @@ int coda_bin_reopen_with_definition(coda_product **product, const coda_product_d
     product_file->root_type = (coda_dynamic_type *)definition->root_type;
     product_file->product_definition = definition;
 
+    if (product_file->size_cache == NULL && coda_option_bit_size_cache_max_entries > 0)
+    {
+        if (coda_size_cache_new(coda_option_bit_size_cache_max_entries, &product_file->size_cache) != 0)
+        {
+            return -1;
+        }
+    }
+
     return 0;
 }
 
@@ -35,6 +35,9 @@
 #include "coda-internal.h"
 
 int coda_bin_open(const char *filename, int64_t file_size, coda_product **product);
+int coda_bin_open_zip_entry(const char *filename, long zip_filename_length, coda_product **product);
+int coda_bin_open_memory(const char *name, const uint8_t *buffer, int64_t size, void (*free_buffer) (void *),
+                         coda_product **product);
 int coda_bin_reopen_with_definition(coda_product **product, const coda_product_definition *definition);
 int coda_bin_close(coda_product *product);
 
@@ -56,6 +59,8 @@ int coda_bin_cursor_read_char(const coda_cursor *cursor, char *dst);
 int coda_bin_cursor_read_string(const coda_cursor *cursor, char *dst, long dst_size);
 int coda_bin_cursor_read_bits(const coda_cursor *cursor, uint8_t *dst, int64_t bit_offset, int64_t bit_length);
 int coda_bin_cursor_read_bytes(const coda_cursor *cursor, uint8_t *dst, int64_t offset, int64_t length);
+int coda_bin_cursor_get_data_pointer(const coda_cursor *cursor, const uint8_t **data, int64_t *byte_size,
+                                     coda_endianness *endianness);
 
 int coda_bin_cursor_read_int8_array(const coda_cursor *cursor, int8_t *dst, coda_array_ordering array_ordering);
 int coda_bin_cursor_read_uint8_array(const coda_cursor *cursor, uint8_t *dst, coda_array_ordering array_ordering);
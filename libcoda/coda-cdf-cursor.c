@@ -222,26 +222,57 @@ static int read_array(const coda_cursor *cursor, void *dst)
         type_class = variable->base_type->definition->type_class;
     }
 
-    for (i = 0; i < variable->num_records; i++)
+    /* TODO: handle sparse records */
+    for (i = 0; i < variable->num_runs; i++)
+    {
+        if (variable->run[i].first != (i == 0 ? 0 : variable->run[i - 1].last + 1))
+        {
+            break;
+        }
+    }
+    if (variable->num_records > 0 && (i < variable->num_runs || variable->num_runs == 0 ||
+                                      variable->run[variable->num_runs - 1].last != variable->num_records - 1))
+    {
+        coda_set_error(CODA_ERROR_UNSUPPORTED_PRODUCT, "Missing record not supported for CDF variable");
+        return -1;
+    }
+    if (variable->data != NULL)
+    {
+        for (i = 0; i < variable->num_runs; i++)
+        {
+            coda_cdf_record_run *run = &variable->run[i];
+
+            memcpy(&((uint8_t *)dst)[run->first * record_size], &variable->data[run->offset],
+                   (size_t)(run->last - run->first + 1) * record_size);
+        }
+    }
+    else if (variable->num_runs > 0)
     {
-        /* TODO: handle sparse records */
-        if (variable->offset[i] < 0)
+        coda_bin_read_request *request;
+
+        /* read all runs of records at once */
+        request = malloc(variable->num_runs * sizeof(coda_bin_read_request));
+        if (request == NULL)
         {
-            coda_set_error(CODA_ERROR_UNSUPPORTED_PRODUCT, "Missing record not supported for CDF variable");
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           variable->num_runs * sizeof(coda_bin_read_request), __FILE__, __LINE__);
             return -1;
         }
-        if (variable->data != NULL)
+        for (i = 0; i < variable->num_runs; i++)
         {
-            memcpy(&((uint8_t *)dst)[i * record_size], &variable->data[variable->offset[i]], record_size);
+            coda_cdf_record_run *run = &variable->run[i];
+
+            request[i].byte_offset = run->offset;
+            request[i].length = (int64_t)(run->last - run->first + 1) * record_size;
+            request[i].dst = &((uint8_t *)dst)[run->first * record_size];
         }
-        else
+        if (coda_bin_product_read_batch(((coda_cdf_product *)cursor->product)->raw_product, variable->num_runs,
+                                        request) != 0)
         {
-            if (read_bytes(((coda_cdf_product *)cursor->product)->raw_product, variable->offset[i], record_size,
-                           &((uint8_t *)dst)[i * record_size]) != 0)
-            {
-                return -1;
-            }
+            free(request);
+            return -1;
         }
+        free(request);
     }
     if (type_class != coda_text_class)
     {
@@ -288,9 +319,8 @@ static int read_partial_array(const coda_cursor *cursor, long offset, long lengt
 {
     coda_cdf_variable *variable = (coda_cdf_variable *)cursor->stack[cursor->n - 1].type;
     coda_type_class type_class;
-    long record_size = variable->num_values_per_record * variable->value_size;
-    int record_from_id, record_to_id;
-    int64_t target_offset;
+    int64_t element_id;
+    int run_id;
     int i;
 
     assert(variable->tag == tag_cdf_variable);
@@ -303,46 +333,56 @@ static int read_partial_array(const coda_cursor *cursor, long offset, long lengt
         type_class = variable->base_type->definition->type_class;
     }
 
-    record_from_id = offset / variable->num_values_per_record;
-    record_to_id = (offset + length) / variable->num_values_per_record;
-    target_offset = 0;
-
-    for (i = record_from_id; i <= record_to_id; i++)
+    if (length <= 0)
     {
-        int64_t local_offset = 0;       /* byte offset within record */
-        int64_t local_size = record_size;       /* amount of bytes to read */
+        return 0;
+    }
 
-        /* TODO: handle sparse records */
-        if (variable->offset[i] < 0)
-        {
-            coda_set_error(CODA_ERROR_UNSUPPORTED_PRODUCT, "Missing record not supported for CDF variable");
-            return -1;
-        }
+    /* TODO: handle sparse records */
+    run_id = coda_cdf_variable_find_record_run(variable, (int32_t)(offset / variable->num_values_per_record));
+    if (run_id < 0)
+    {
+        coda_set_error(CODA_ERROR_UNSUPPORTED_PRODUCT, "Missing record not supported for CDF variable");
+        return -1;
+    }
+    element_id = offset;
+    while (element_id < offset + length)
+    {
+        coda_cdf_record_run *run = &variable->run[run_id];
+        int64_t run_first_element = (int64_t)run->first * variable->num_values_per_record;
+        int64_t end_element_id = (int64_t)(run->last + 1) * variable->num_values_per_record;
+        int64_t source_offset;
+        int64_t size;
 
-        if (offset + length < (i + 1) * variable->num_values_per_record)
-        {
-            local_size = (offset + length - i * variable->num_values_per_record) * variable->value_size;
-        }
-        if (offset > i * variable->num_values_per_record)
+        if (end_element_id > offset + length)
         {
-            local_offset = (offset - i * variable->num_values_per_record) * variable->value_size;
-            local_size -= local_offset;
+            end_element_id = offset + length;
         }
-
+        source_offset = run->offset + (element_id - run_first_element) * variable->value_size;
+        size = (end_element_id - element_id) * variable->value_size;
         if (variable->data != NULL)
         {
-            memcpy(&((uint8_t *)dst)[target_offset], &variable->data[variable->offset[i] + local_offset],
-                   (size_t)local_size);
+            memcpy(&((uint8_t *)dst)[(element_id - offset) * variable->value_size], &variable->data[source_offset],
+                   (size_t)size);
         }
         else
         {
-            if (read_bytes(((coda_cdf_product *)cursor->product)->raw_product, variable->offset[i] + local_offset,
-                           local_size, &((uint8_t *)dst)[target_offset]) != 0)
+            if (read_bytes(((coda_cdf_product *)cursor->product)->raw_product, source_offset, size,
+                           &((uint8_t *)dst)[(element_id - offset) * variable->value_size]) != 0)
+            {
+                return -1;
+            }
+        }
+        element_id = end_element_id;
+        if (element_id < offset + length)
+        {
+            run_id++;
+            if (run_id == variable->num_runs || variable->run[run_id].first != run->last + 1)
             {
+                coda_set_error(CODA_ERROR_UNSUPPORTED_PRODUCT, "Missing record not supported for CDF variable");
                 return -1;
             }
         }
-        target_offset += local_size;
     }
     if (type_class != coda_text_class)
     {
@@ -393,6 +433,7 @@ static int read_basic_type(const coda_cursor *cursor, void *dst, long size_bound
     int record_id;
     int element_id;
     int value_size;
+    int run_id;
     int64_t offset;
 
     if (((coda_cdf_type *)cursor->stack[cursor->n - 1].type)->tag == tag_cdf_basic_type)
@@ -415,12 +456,15 @@ static int read_basic_type(const coda_cursor *cursor, void *dst, long size_bound
     value_size = variable->value_size;
 
     /* TODO: handle sparse records */
-    if (variable->offset[record_id] < 0)
+    run_id = coda_cdf_variable_find_record_run(variable, record_id);
+    if (run_id < 0)
     {
         coda_set_error(CODA_ERROR_UNSUPPORTED_PRODUCT, "Missing record not supported for CDF variable");
         return -1;
     }
-    offset = variable->offset[record_id] + element_id * variable->value_size;
+    offset = variable->run[run_id].offset +
+        ((int64_t)(record_id - variable->run[run_id].first) * variable->num_values_per_record + element_id) *
+        variable->value_size;
     if (size_boundary >= 0 && size_boundary < value_size)
     {
         value_size = size_boundary;
@@ -528,6 +572,137 @@ int coda_cdf_cursor_read_string(const coda_cursor *cursor, char *dst, long dst_s
     return 0;
 }
 
+int coda_cdf_cursor_get_data_pointer(const coda_cursor *cursor, const uint8_t **data, int64_t *byte_size,
+                                     coda_endianness *endianness)
+{
+    coda_cdf_variable *variable = (coda_cdf_variable *)cursor->stack[cursor->n - 1].type;
+    long num_elements = 1;
+    long index = 0;
+    int record_from_id;
+    int record_to_id;
+    int run_id;
+    int64_t offset;
+
+    if (((coda_cdf_type *)cursor->stack[cursor->n - 1].type)->tag == tag_cdf_time)
+    {
+        coda_set_error(CODA_ERROR_INVALID_TYPE, "can not provide direct access to data of special type");
+        return -1;
+    }
+    if (((coda_cdf_type *)cursor->stack[cursor->n - 1].type)->tag == tag_cdf_basic_type)
+    {
+        variable = (coda_cdf_variable *)cursor->stack[cursor->n - 2].type;
+        index = cursor->stack[cursor->n - 1].index;
+    }
+    else if (variable->definition->type_class == coda_array_class)
+    {
+        num_elements = variable->definition->num_elements;
+    }
+    assert(variable->tag == tag_cdf_variable);
+
+    *byte_size = (int64_t)num_elements * variable->value_size;
+    if (num_elements == 0)
+    {
+        *data = NULL;
+        *endianness = ((coda_cdf_product *)cursor->product)->endianness;
+        return 0;
+    }
+
+    record_from_id = index / variable->num_values_per_record;
+    record_to_id = (index + num_elements - 1) / variable->num_values_per_record;
+    run_id = coda_cdf_variable_find_record_run(variable, record_from_id);
+    if (run_id < 0 && variable->sparse_rec_method == 0)
+    {
+        coda_set_error(CODA_ERROR_UNSUPPORTED_PRODUCT, "Missing record not supported for CDF variable");
+        return -1;
+    }
+    /* for variables with sparse records, records that are not in the file are virtual (padded or copied from the
+     * previous record), so we can only provide access if all requested records are stored in a single run */
+    if (run_id < 0 || record_to_id > variable->run[run_id].last)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "data is not stored contiguously");
+        return -1;
+    }
+    offset = variable->run[run_id].offset + (index - (int64_t)variable->run[run_id].first *
+                                             variable->num_values_per_record) * variable->value_size;
+    *endianness = ((coda_cdf_product *)cursor->product)->endianness;
+
+    if (variable->data != NULL)
+    {
+        /* (decompressed) variable data is kept in memory */
+        *data = (const uint8_t *)&variable->data[offset];
+        return 0;
+    }
+    return coda_bin_product_get_data_pointer(((coda_cdf_product *)cursor->product)->raw_product, offset, *byte_size,
+                                             data);
+}
+
+/* Give the operating system a hint about the data of the current element and the (num_elements - 1) array elements
+ * that follow it.
+ */
+int coda_cdf_cursor_prefetch(const coda_cursor *cursor, long num_elements)
+{
+    coda_cdf_variable *variable = (coda_cdf_variable *)cursor->stack[cursor->n - 1].type;
+    long index = 0;
+    int record_from_id;
+    int record_to_id;
+    int run_from_id;
+    int run_to_id;
+    int64_t from_offset;
+    int64_t to_offset;
+
+    if (variable->tag != tag_cdf_variable)
+    {
+        if (cursor->n < 2 || cursor->stack[cursor->n - 2].type->backend != coda_backend_cdf)
+        {
+            return 0;
+        }
+        variable = (coda_cdf_variable *)cursor->stack[cursor->n - 2].type;
+        index = cursor->stack[cursor->n - 1].index;
+    }
+    else
+    {
+        num_elements = variable->definition->num_elements;
+    }
+    assert(variable->tag == tag_cdf_variable);
+
+    if (variable->data != NULL)
+    {
+        /* (decompressed) variable data is kept in memory */
+        return 0;
+    }
+    if (index + num_elements > variable->definition->num_elements)
+    {
+        num_elements = variable->definition->num_elements - index;
+    }
+    if (num_elements <= 0)
+    {
+        return 0;
+    }
+
+    record_from_id = index / variable->num_values_per_record;
+    record_to_id = (index + num_elements - 1) / variable->num_values_per_record;
+    run_from_id = coda_cdf_variable_find_record_run(variable, record_from_id);
+    run_to_id = coda_cdf_variable_find_record_run(variable, record_to_id);
+    if (run_from_id < 0 || run_to_id < 0)
+    {
+        /* missing records */
+        return 0;
+    }
+    from_offset = variable->run[run_from_id].offset +
+        (index - (int64_t)variable->run[run_from_id].first * variable->num_values_per_record) * variable->value_size;
+    to_offset = variable->run[run_to_id].offset +
+        (index + num_elements - (int64_t)variable->run[run_to_id].first * variable->num_values_per_record) *
+        variable->value_size;
+    if (to_offset <= from_offset)
+    {
+        /* records are not stored in order; only prefetch the first element */
+        to_offset = from_offset + variable->value_size;
+    }
+
+    return coda_bin_product_prefetch(((coda_cdf_product *)cursor->product)->raw_product, from_offset,
+                                     to_offset - from_offset);
+}
+
 int coda_cdf_cursor_read_int8_array(const coda_cursor *cursor, int8_t *dst)
 {
     return read_array(cursor, dst);
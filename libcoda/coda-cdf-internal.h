@@ -60,6 +60,14 @@ typedef struct coda_cdf_time_struct
     int32_t data_type;
 } coda_cdf_time;
 
+/* a range of records that are stored contiguously */
+typedef struct coda_cdf_record_run_struct
+{
+    int32_t first;
+    int32_t last;
+    int64_t offset;     /* file offset of record 'first' - will be offset into 'data' if 'data != NULL' */
+} coda_cdf_record_run;
+
 typedef struct coda_cdf_variable_struct
 {
     coda_backend backend;
@@ -71,7 +79,9 @@ typedef struct coda_cdf_variable_struct
     int num_values_per_record;
     int value_size;
     int sparse_rec_method;      /* 0: no sparse records, 1: padded sparse records, 2: previous sparse records */
-    int64_t *offset;    /* file offset for each record - will be offset into 'data' if 'data != NULL' */
+    int num_runs;
+    int max_num_runs;
+    coda_cdf_record_run *run;   /* ordered by record index; records that are not in a run are missing */
     int8_t *data;
 } coda_cdf_variable;
 
@@ -87,6 +97,9 @@ typedef struct coda_cdf_product_struct
     int64_t **product_variable;
     int64_t mem_size;
     uint8_t *mem_ptr;
+#ifdef ENABLE_STATISTICS
+    coda_statistics statistics;
+#endif
 
     /* 'cdf' product specific fields */
     coda_product *raw_product;
@@ -105,6 +118,9 @@ coda_dynamic_type *coda_cdf_variable_new(int32_t data_type, int32_t max_rec, int
                                          coda_array_ordering array_ordering, int32_t num_elements,
                                          int sparse_rec_method, coda_cdf_variable **variable);
 
+int coda_cdf_variable_add_record_run(coda_cdf_variable *variable, int32_t first, int32_t last, int64_t offset);
+int coda_cdf_variable_find_record_run(const coda_cdf_variable *variable, int32_t record_id);
+
 int coda_cdf_variable_add_attribute(coda_cdf_variable *type, const char *real_name, coda_dynamic_type *attribute_type,
                                     int update_definition);
 
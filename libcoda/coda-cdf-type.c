@@ -33,6 +33,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 void coda_cdf_type_delete(coda_dynamic_type *type)
 {
@@ -61,9 +62,9 @@ void coda_cdf_type_delete(coda_dynamic_type *type)
                 {
                     coda_dynamic_type_delete((coda_dynamic_type *)variable->base_type);
                 }
-                if (variable->offset != NULL)
+                if (variable->run != NULL)
                 {
-                    free(variable->offset);
+                    free(variable->run);
                 }
                 if (variable->data != NULL)
                 {
@@ -283,7 +284,9 @@ coda_dynamic_type *coda_cdf_variable_new(int32_t data_type, int32_t max_rec, int
     type->num_values_per_record = 1;
     type->value_size = -1;
     type->sparse_rec_method = sparse_rec_method;
-    type->offset = NULL;
+    type->num_runs = 0;
+    type->max_num_runs = 0;
+    type->run = NULL;
     type->data = NULL;
 
     if (!rec_varys)
@@ -385,19 +388,6 @@ coda_dynamic_type *coda_cdf_variable_new(int32_t data_type, int32_t max_rec, int
         }
     }
 
-    type->offset = malloc(type->num_records * sizeof(int64_t));
-    if (type->offset == NULL)
-    {
-        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       type->num_records * sizeof(int64_t), __FILE__, __LINE__);
-        coda_cdf_type_delete((coda_dynamic_type *)type);
-        return NULL;
-    }
-    for (i = 0; i < type->num_records; i++)
-    {
-        type->offset[i] = -1;
-    }
-
     *variable = type;
 
     if (is_scalar && time_type != -1)
@@ -416,6 +406,193 @@ coda_dynamic_type *coda_cdf_variable_new(int32_t data_type, int32_t max_rec, int
     return (coda_dynamic_type *)type;
 }
 
+static int grow_record_runs(coda_cdf_variable *variable)
+{
+    if (variable->num_runs == variable->max_num_runs)
+    {
+        int max_num_runs = (variable->max_num_runs == 0 ? BLOCK_SIZE : 2 * variable->max_num_runs);
+        coda_cdf_record_run *run;
+
+        run = realloc(variable->run, max_num_runs * sizeof(coda_cdf_record_run));
+        if (run == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (long)max_num_runs * sizeof(coda_cdf_record_run), __FILE__, __LINE__);
+            return -1;
+        }
+        variable->run = run;
+        variable->max_num_runs = max_num_runs;
+    }
+
+    return 0;
+}
+
+/* Remove records 'first' up to and including 'last' from the existing runs (trimming or splitting runs as needed) */
+static int remove_records_from_runs(coda_cdf_variable *variable, int32_t first, int32_t last, int64_t record_size)
+{
+    int index = 0;
+
+    while (index < variable->num_runs)
+    {
+        coda_cdf_record_run *run = &variable->run[index];
+
+        if (run->last < first || run->first > last)
+        {
+            index++;
+            continue;
+        }
+        if (run->first < first && run->last > last)
+        {
+            /* split the run in a part before and a part after the removed records */
+            if (grow_record_runs(variable) != 0)
+            {
+                return -1;
+            }
+            run = &variable->run[index];
+            memmove(&variable->run[index + 1], &variable->run[index],
+                    (variable->num_runs - index) * sizeof(coda_cdf_record_run));
+            variable->num_runs++;
+            run[0].last = first - 1;
+            run[1].offset += (last + 1 - run[1].first) * record_size;
+            run[1].first = last + 1;
+            return 0;
+        }
+        if (run->first < first)
+        {
+            run->last = first - 1;
+            index++;
+        }
+        else if (run->last > last)
+        {
+            run->offset += (last + 1 - run->first) * record_size;
+            run->first = last + 1;
+            index++;
+        }
+        else
+        {
+            memmove(&variable->run[index], &variable->run[index + 1],
+                    (variable->num_runs - index - 1) * sizeof(coda_cdf_record_run));
+            variable->num_runs--;
+        }
+    }
+
+    return 0;
+}
+
+/* Register that records 'first' up to and including 'last' are stored contiguously starting at 'offset'.
+ * Records beyond the number of records of the variable are ignored. If records were already registered by an earlier
+ * run, the new run takes precedence (i.e. the last entry for a record wins). A run that directly continues an
+ * existing run (both in record index and in storage) is merged with it.
+ */
+int coda_cdf_variable_add_record_run(coda_cdf_variable *variable, int32_t first, int32_t last, int64_t offset)
+{
+    int64_t record_size = (int64_t)variable->num_values_per_record * variable->value_size;
+    coda_cdf_record_run *run;
+    int index;
+
+    if (last >= variable->num_records)
+    {
+        last = variable->num_records - 1;
+    }
+    if (first < 0 || first > last)
+    {
+        return 0;
+    }
+
+    /* runs are normally added in order of record index, so search for the insert position from the end */
+    index = variable->num_runs;
+    while (index > 0 && variable->run[index - 1].first > first)
+    {
+        index--;
+    }
+    if ((index > 0 && variable->run[index - 1].last >= first) ||
+        (index < variable->num_runs && variable->run[index].first <= last))
+    {
+        /* records overlap with earlier entries; the new entry overrides them */
+        if (remove_records_from_runs(variable, first, last, record_size) != 0)
+        {
+            return -1;
+        }
+        index = variable->num_runs;
+        while (index > 0 && variable->run[index - 1].first > first)
+        {
+            index--;
+        }
+    }
+
+    if (index > 0)
+    {
+        run = &variable->run[index - 1];
+        if (run->last + 1 == first && run->offset + (run->last - run->first + 1) * record_size == offset)
+        {
+            run->last = last;
+            if (index < variable->num_runs && last + 1 == variable->run[index].first &&
+                run->offset + (last - run->first + 1) * record_size == variable->run[index].offset)
+            {
+                /* the run now also connects to the next run */
+                run->last = variable->run[index].last;
+                memmove(&variable->run[index], &variable->run[index + 1],
+                        (variable->num_runs - index - 1) * sizeof(coda_cdf_record_run));
+                variable->num_runs--;
+            }
+            return 0;
+        }
+    }
+    if (index < variable->num_runs)
+    {
+        run = &variable->run[index];
+        if (last + 1 == run->first && offset + (last - first + 1) * record_size == run->offset)
+        {
+            run->first = first;
+            run->offset = offset;
+            return 0;
+        }
+    }
+
+    if (grow_record_runs(variable) != 0)
+    {
+        return -1;
+    }
+    if (index < variable->num_runs)
+    {
+        memmove(&variable->run[index + 1], &variable->run[index],
+                (variable->num_runs - index) * sizeof(coda_cdf_record_run));
+    }
+    variable->run[index].first = first;
+    variable->run[index].last = last;
+    variable->run[index].offset = offset;
+    variable->num_runs++;
+
+    return 0;
+}
+
+/* Returns the index of the run that contains the given record, or -1 if the record is missing */
+int coda_cdf_variable_find_record_run(const coda_cdf_variable *variable, int32_t record_id)
+{
+    int low = 0;
+    int high = variable->num_runs - 1;
+
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+
+        if (record_id < variable->run[middle].first)
+        {
+            high = middle - 1;
+        }
+        else if (record_id > variable->run[middle].last)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            return middle;
+        }
+    }
+
+    return -1;
+}
+
 int coda_cdf_variable_add_attribute(coda_cdf_variable *type, const char *real_name, coda_dynamic_type *attribute_type,
                                     int update_definition)
 {
@@ -35,6 +35,7 @@
 #include "coda-swap2.h"
 #include "coda-swap4.h"
 #include "coda-swap8.h"
+#include "coda-statistics.h"
 
 #ifdef HAVE_SYS_MMAN_H
 #include <sys/mman.h>
@@ -593,15 +594,9 @@ static int read_VR(coda_cdf_product *product_file, coda_cdf_variable *variable,
     }
     if (record_type == 7)
     {
-        int i;
-
-        if (last >= variable->num_records)
+        if (coda_cdf_variable_add_record_run(variable, first, last, offset + 12) != 0)
         {
-            last = variable->num_records - 1;
-        }
-        for (i = first; i <= last; i++)
-        {
-            variable->offset[i] = offset + 12 + (i - first) * variable->num_values_per_record * variable->value_size;
+            return -1;
         }
     }
     else if (record_type == 13)
@@ -611,7 +606,6 @@ static int read_VR(coda_cdf_product *product_file, coda_cdf_variable *variable,
         z_stream zs;
         int partial_read = 0;
         int result;
-        int i;
 
         if (first >= variable->num_records)
         {
@@ -722,9 +716,11 @@ static int read_VR(coda_cdf_product *product_file, coda_cdf_variable *variable,
             }
             return -1;
         }
-        for (i = first; i <= last; i++)
+        if (coda_cdf_variable_add_record_run(variable, first, last,
+                                             (int64_t)first * variable->num_values_per_record *
+                                             variable->value_size) != 0)
         {
-            variable->offset[i] = i * variable->num_values_per_record * variable->value_size;
+            return -1;
         }
     }
     else
@@ -782,33 +778,51 @@ static int read_VXR(coda_cdf_product *product_file, coda_cdf_variable *variable,
 #endif
     offset += 28;
 
-    for (i = 0; i < nused_entries; i++)
+    if (nused_entries > 0)
     {
-        int32_t vr_first;
-        int32_t vr_last;
-        int64_t vr_offset;
+        uint8_t *entries;
 
-        if (read_bytes(product_file->raw_product, offset + i * 4, 4, &vr_first) < 0)
+        if (nused_entries > n_entries)
         {
+            coda_set_error(CODA_ERROR_PRODUCT, "CDF file has invalid number of used entries (%d) for VXR record",
+                           nused_entries);
             return -1;
         }
-        if (read_bytes(product_file->raw_product, offset + (i + n_entries) * 4, 4, &vr_last) < 0)
+
+        /* read the First, Last, and Offset arrays of the entries at once */
+        entries = malloc(16 * (size_t)n_entries);
+        if (entries == NULL)
         {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           16 * (long)n_entries, __FILE__, __LINE__);
             return -1;
         }
-        if (read_bytes(product_file->raw_product, offset + (i + n_entries) * 8, 8, &vr_offset) < 0)
+        if (read_bytes(product_file->raw_product, offset, 16 * (int64_t)n_entries, entries) < 0)
         {
+            free(entries);
             return -1;
         }
+        for (i = 0; i < nused_entries; i++)
+        {
+            int32_t vr_first;
+            int32_t vr_last;
+            int64_t vr_offset;
+
+            memcpy(&vr_first, &entries[i * 4], 4);
+            memcpy(&vr_last, &entries[(i + n_entries) * 4], 4);
+            memcpy(&vr_offset, &entries[(i + n_entries) * 8], 8);
 #ifndef WORDS_BIGENDIAN
-        swap_int32(&vr_first);
-        swap_int32(&vr_last);
-        swap_int64(&vr_offset);
+            swap_int32(&vr_first);
+            swap_int32(&vr_last);
+            swap_int64(&vr_offset);
 #endif
-        if (read_VR(product_file, variable, vr_offset, vr_first, vr_last) != 0)
-        {
-            return -1;
+            if (read_VR(product_file, variable, vr_offset, vr_first, vr_last) != 0)
+            {
+                free(entries);
+                return -1;
+            }
         }
+        free(entries);
     }
 
     if (read_VXR(product_file, variable, vxr_next, first, last) != 0)
@@ -1325,6 +1339,7 @@ int coda_cdf_reopen(coda_product **product)
     product_file->product_variable = NULL;
     product_file->mem_size = 0;
     product_file->mem_ptr = NULL;
+    coda_statistics_init(product_file);
 
     product_file->raw_product = *product;
 
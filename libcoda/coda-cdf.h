@@ -60,6 +60,9 @@ int coda_cdf_cursor_read_float(const coda_cursor *cursor, float *dst);
 int coda_cdf_cursor_read_double(const coda_cursor *cursor, double *dst);
 int coda_cdf_cursor_read_char(const coda_cursor *cursor, char *dst);
 int coda_cdf_cursor_read_string(const coda_cursor *cursor, char *dst, long dst_size);
+int coda_cdf_cursor_get_data_pointer(const coda_cursor *cursor, const uint8_t **data, int64_t *byte_size,
+                                     coda_endianness *endianness);
+int coda_cdf_cursor_prefetch(const coda_cursor *cursor, long num_elements);
 
 int coda_cdf_cursor_read_int8_array(const coda_cursor *cursor, int8_t *dst);
 int coda_cdf_cursor_read_uint8_array(const coda_cursor *cursor, uint8_t *dst);
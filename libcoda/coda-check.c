@@ -39,6 +39,597 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+typedef struct check_pool_struct check_pool;
+
+static int check_data(coda_cursor *cursor, coda_type **definition, int read_check, int size_check, int64_t *bit_size,
+                      check_pool *pool, void (*callbackfunc) (coda_cursor *, const char *, void *), void *userdata);
+
+#ifdef HAVE_PTHREAD
+
+/* minimum number of elements that a top-level array should have before it is checked in parallel */
+#define MIN_PARALLEL_ARRAY_ELEMENTS 64
+/* number of element ranges per thread in which a top-level array is split (to balance the load over threads) */
+#define RANGES_PER_THREAD 4
+
+/* location of a cursor, such that it can be reconstructed for another product handle of the same file */
+typedef struct check_path_struct
+{
+    int depth;
+    long index[CODA_CURSOR_MAXDEPTH];
+    coda_type_class type_class[CODA_CURSOR_MAXDEPTH];
+} check_path;
+
+typedef struct check_error_struct
+{
+    int has_path;
+    check_path path;
+    char *message;
+} check_error;
+
+/* range of array elements that is checked by a single thread */
+typedef struct check_range_struct
+{
+    long first_index;
+    long num_elements;
+    int64_t first_bit_offset;
+    int64_t bit_size;
+    int num_errors;
+    check_error *error;
+    long out_of_memory_size;    /* size of a failed allocation while collecting errors (0 if none failed) */
+    int result;
+    int error_code;
+    char *error_message;
+} check_range;
+
+static void get_check_path(const coda_cursor *cursor, check_path *path)
+{
+    int i;
+
+    path->depth = cursor->n;
+    for (i = 0; i < cursor->n; i++)
+    {
+        path->index[i] = cursor->stack[i].index;
+        path->type_class[i] = coda_get_type_for_dynamic_type(cursor->stack[i].type)->type_class;
+    }
+}
+
+static int goto_check_path(coda_cursor *cursor, coda_product *product, const check_path *path)
+{
+    int i;
+
+    if (coda_cursor_set_product(cursor, product) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < path->depth; i++)
+    {
+        coda_type_class type_class;
+
+        if (i > 0)
+        {
+            if (path->index[i] == -1)
+            {
+                if (coda_cursor_goto_attributes(cursor) != 0)
+                {
+                    return -1;
+                }
+            }
+            else if (path->type_class[i - 1] == coda_record_class)
+            {
+                if (coda_cursor_goto_record_field_by_index(cursor, path->index[i]) != 0)
+                {
+                    return -1;
+                }
+            }
+            else
+            {
+                if (coda_cursor_goto_array_element_by_index(cursor, path->index[i]) != 0)
+                {
+                    return -1;
+                }
+            }
+        }
+        /* check_data() replaces special types by their base type before traversing into them */
+        if (coda_cursor_get_type_class(cursor, &type_class) != 0)
+        {
+            return -1;
+        }
+        if (type_class == coda_special_class && path->type_class[i] != coda_special_class)
+        {
+            if (coda_cursor_use_base_type_of_special_type(cursor) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void collect_range_error(coda_cursor *cursor, const char *message, void *userdata)
+{
+    check_range *range = (check_range *)userdata;
+    check_error *error;
+
+    if (range->out_of_memory_size != 0)
+    {
+        /* the check of this range will fail anyway */
+        return;
+    }
+    if (range->num_errors % BLOCK_SIZE == 0)
+    {
+        check_error *new_error;
+
+        new_error = realloc(range->error, (range->num_errors + BLOCK_SIZE) * sizeof(check_error));
+        if (new_error == NULL)
+        {
+            /* the callback can not return an error, so remember the failure for check_range_for_product() */
+            range->out_of_memory_size = (long)((range->num_errors + BLOCK_SIZE) * sizeof(check_error));
+            return;
+        }
+        range->error = new_error;
+    }
+    error = &range->error[range->num_errors];
+    error->message = strdup(message);
+    if (error->message == NULL)
+    {
+        range->out_of_memory_size = (long)strlen(message) + 1;
+        return;
+    }
+    error->has_path = (cursor != NULL);
+    if (cursor != NULL)
+    {
+        get_check_path(cursor, &error->path);
+    }
+    range->num_errors++;
+}
+
+static void check_range_done(check_range *range)
+{
+    int i;
+
+    for (i = 0; i < range->num_errors; i++)
+    {
+        free(range->error[i].message);
+    }
+    if (range->error != NULL)
+    {
+        free(range->error);
+    }
+    if (range->error_message != NULL)
+    {
+        free(range->error_message);
+    }
+}
+
+struct check_pool_struct
+{
+    coda_thread_settings settings;
+    char *filename;
+    char *product_class;
+    char *product_type;
+    int version;
+    int num_threads;
+    int num_running_threads;
+    pthread_t *thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t task_available;
+    pthread_cond_t task_done;
+    int terminate;
+
+    /* current task (only modified by the main thread while no ranges are being processed) */
+    check_path array_path;
+    coda_type *base_definition;
+    int read_check;
+    int size_check;
+    int num_ranges;
+    check_range *range;
+    int next_range;
+    int num_ranges_done;
+};
+
+static void check_range_for_product(check_pool *pool, check_range *range, coda_product *product)
+{
+    coda_type *base_definition = pool->base_definition;
+    coda_cursor cursor;
+    long i;
+
+    range->bit_size = 0;
+    if (goto_check_path(&cursor, product, &pool->array_path) != 0)
+    {
+        range->result = -1;
+        return;
+    }
+    if (range->first_bit_offset >= 0)
+    {
+        /* jump directly to the first element using the offset that was determined by the calling thread */
+        if (coda_cursor_goto_first_array_element(&cursor) != 0)
+        {
+            range->result = -1;
+            return;
+        }
+        cursor.stack[cursor.n - 1].index = range->first_index;
+        cursor.stack[cursor.n - 1].bit_offset = range->first_bit_offset;
+    }
+    else if (coda_cursor_goto_array_element_by_index(&cursor, range->first_index) != 0)
+    {
+        range->result = -1;
+        return;
+    }
+    for (i = 0; i < range->num_elements; i++)
+    {
+        int64_t sub_bit_size;
+
+        if (check_data(&cursor, &base_definition, pool->read_check, pool->size_check, &sub_bit_size, NULL,
+                       collect_range_error, range) != 0)
+        {
+            range->result = -1;
+            return;
+        }
+        if (range->out_of_memory_size != 0)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           range->out_of_memory_size, __FILE__, __LINE__);
+            range->result = -1;
+            return;
+        }
+        if (pool->size_check)
+        {
+            range->bit_size += sub_bit_size;
+        }
+        if (i < range->num_elements - 1)
+        {
+            if (coda_cursor_goto_next_array_element(&cursor) != 0)
+            {
+                range->result = -1;
+                return;
+            }
+        }
+    }
+}
+
+static void process_ranges(check_pool *pool, coda_product *product, int open_error_code, const char *open_error_message)
+{
+    /* the mutex is locked when this function is called and will still be locked when it returns */
+    while (pool->next_range < pool->num_ranges)
+    {
+        check_range *range = &pool->range[pool->next_range];
+
+        pool->next_range++;
+        pthread_mutex_unlock(&pool->mutex);
+        if (product != NULL)
+        {
+            check_range_for_product(pool, range, product);
+            if (range->result != 0)
+            {
+                range->error_code = coda_errno;
+                range->error_message = strdup(coda_errno_to_string(coda_errno));
+                coda_set_error(CODA_SUCCESS, NULL);
+            }
+        }
+        else
+        {
+            range->result = -1;
+            range->error_code = open_error_code;
+            range->error_message = strdup(open_error_message);
+        }
+        pthread_mutex_lock(&pool->mutex);
+        pool->num_ranges_done++;
+        pthread_cond_signal(&pool->task_done);
+    }
+}
+
+static void *check_worker(void *userdata)
+{
+    check_pool *pool = (check_pool *)userdata;
+    coda_product *product = NULL;
+    char *open_error_message = NULL;
+    int open_error_code = CODA_SUCCESS;
+    int initialized = 0;
+
+    if (coda_thread_init(&pool->settings) == 0)
+    {
+        initialized = 1;
+        if (coda_open_as(pool->filename, pool->product_class, pool->product_type, pool->version, &product) != 0)
+        {
+            product = NULL;
+        }
+    }
+    if (product == NULL)
+    {
+        open_error_code = coda_errno;
+        open_error_message = strdup(coda_errno_to_string(coda_errno));
+        coda_set_error(CODA_SUCCESS, NULL);
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    while (!pool->terminate)
+    {
+        process_ranges(pool, product, open_error_code, open_error_message);
+        pthread_cond_wait(&pool->task_available, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (product != NULL)
+    {
+        coda_close(product);
+    }
+    if (open_error_message != NULL)
+    {
+        free(open_error_message);
+    }
+    if (initialized)
+    {
+        coda_done();
+    }
+
+    return NULL;
+}
+
+static void check_pool_delete(check_pool *pool)
+{
+    if (pool->thread != NULL)
+    {
+        int i;
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->terminate = 1;
+        pthread_cond_broadcast(&pool->task_available);
+        pthread_mutex_unlock(&pool->mutex);
+        for (i = 0; i < pool->num_running_threads; i++)
+        {
+            pthread_join(pool->thread[i], NULL);
+        }
+        free(pool->thread);
+    }
+    pthread_cond_destroy(&pool->task_done);
+    pthread_cond_destroy(&pool->task_available);
+    pthread_mutex_destroy(&pool->mutex);
+    coda_thread_settings_done(&pool->settings);
+    if (pool->filename != NULL)
+    {
+        free(pool->filename);
+    }
+    if (pool->product_class != NULL)
+    {
+        free(pool->product_class);
+    }
+    if (pool->product_type != NULL)
+    {
+        free(pool->product_type);
+    }
+    free(pool);
+}
+
+static int check_pool_new(coda_product *product, int num_threads, check_pool **new_pool)
+{
+    const char *product_class;
+    const char *product_type;
+    check_pool *pool;
+
+    pool = (check_pool *)malloc(sizeof(check_pool));
+    if (pool == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)sizeof(check_pool), __FILE__, __LINE__);
+        return -1;
+    }
+    memset(pool, 0, sizeof(check_pool));
+    pool->num_threads = num_threads;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->task_available, NULL);
+    pthread_cond_init(&pool->task_done, NULL);
+    if (coda_thread_settings_get(&pool->settings) != 0)
+    {
+        check_pool_delete(pool);
+        return -1;
+    }
+    if (coda_get_product_class(product, &product_class) != 0 || coda_get_product_type(product, &product_type) != 0 ||
+        coda_get_product_version(product, &pool->version) != 0)
+    {
+        check_pool_delete(pool);
+        return -1;
+    }
+    pool->filename = strdup(product->filename);
+    if (pool->filename == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                       __LINE__);
+        check_pool_delete(pool);
+        return -1;
+    }
+    if (product_class != NULL && product_type != NULL)
+    {
+        pool->product_class = strdup(product_class);
+        pool->product_type = strdup(product_type);
+        if (pool->product_class == NULL || pool->product_type == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                           __LINE__);
+            check_pool_delete(pool);
+            return -1;
+        }
+    }
+    else
+    {
+        pool->version = -1;
+    }
+
+    *new_pool = pool;
+
+    return 0;
+}
+
+/* for arrays with variable sized elements, walk the elements once to determine the bit offset at which each range
+ * starts, so the threads don't each have to walk the array up to their first element
+ * (errors are ignored here; they will be reported by the threads that check the ranges)
+ */
+static void determine_range_offsets(const coda_cursor *cursor, check_range *range, int num_ranges)
+{
+    coda_cursor element_cursor;
+    long index = 0;
+    int i;
+
+    element_cursor = *cursor;
+    if (coda_cursor_goto_first_array_element(&element_cursor) != 0)
+    {
+        coda_set_error(CODA_SUCCESS, NULL);
+        return;
+    }
+    if (coda_get_type_for_dynamic_type(element_cursor.stack[element_cursor.n - 1].type)->bit_size >= 0)
+    {
+        /* elements have a fixed size, so locating an element by index is cheap */
+        return;
+    }
+    for (i = 0; i < num_ranges; i++)
+    {
+        while (index < range[i].first_index)
+        {
+            if (coda_cursor_goto_next_array_element(&element_cursor) != 0)
+            {
+                /* leave it to the threads to report the error */
+                coda_set_error(CODA_SUCCESS, NULL);
+                return;
+            }
+            index++;
+        }
+        range[i].first_bit_offset = element_cursor.stack[element_cursor.n - 1].bit_offset;
+    }
+}
+
+/* check the elements of an array by dividing them in ranges that are checked in parallel by the threads of the pool
+ * (the calling thread also processes ranges using its own product handle).
+ * Errors are passed on to callbackfunc in the same order as a sequential check would have reported them.
+ */
+static int check_array_parallel(check_pool *pool, coda_cursor *cursor, coda_type **base_definition, int read_check,
+                                int size_check, long num_elements, int64_t *bit_size,
+                                void (*callbackfunc) (coda_cursor *, const char *, void *), void *userdata)
+{
+    check_range *range;
+    long range_size;
+    int num_ranges;
+    int result = 0;
+    int i;
+
+    if (pool->thread == NULL)
+    {
+        pool->thread = malloc((pool->num_threads - 1) * sizeof(pthread_t));
+        if (pool->thread == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (long)((pool->num_threads - 1) * sizeof(pthread_t)), __FILE__, __LINE__);
+            return -1;
+        }
+        for (i = 0; i < pool->num_threads - 1; i++)
+        {
+            if (pthread_create(&pool->thread[pool->num_running_threads], NULL, check_worker, pool) == 0)
+            {
+                pool->num_running_threads++;
+            }
+        }
+    }
+
+    num_ranges = pool->num_threads * RANGES_PER_THREAD;
+    if (num_ranges > num_elements)
+    {
+        num_ranges = (int)num_elements;
+    }
+    range = malloc(num_ranges * sizeof(check_range));
+    if (range == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)(num_ranges * sizeof(check_range)), __FILE__, __LINE__);
+        return -1;
+    }
+    memset(range, 0, num_ranges * sizeof(check_range));
+    range_size = num_elements / num_ranges;
+    for (i = 0; i < num_ranges; i++)
+    {
+        range[i].first_index = i * range_size;
+        range[i].num_elements = (i == num_ranges - 1 ? num_elements - i * range_size : range_size);
+        range[i].first_bit_offset = -1;
+    }
+    if (cursor->product->format == coda_format_ascii || cursor->product->format == coda_format_binary)
+    {
+        /* for variable sized elements, locating an element by index requires a walk from the start of the array.
+         * We therefore determine the start offsets of all ranges in a single pass here.
+         */
+        determine_range_offsets(cursor, range, num_ranges);
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    get_check_path(cursor, &pool->array_path);
+    pool->base_definition = *base_definition;
+    pool->read_check = read_check;
+    pool->size_check = size_check;
+    pool->range = range;
+    pool->num_ranges = num_ranges;
+    pool->next_range = 0;
+    pool->num_ranges_done = 0;
+    pthread_cond_broadcast(&pool->task_available);
+    /* the calling thread takes part in the processing using its own product handle */
+    process_ranges(pool, cursor->product, CODA_SUCCESS, NULL);
+    while (pool->num_ranges_done < pool->num_ranges)
+    {
+        pthread_cond_wait(&pool->task_done, &pool->mutex);
+    }
+    pool->range = NULL;
+    pool->num_ranges = 0;
+    pool->next_range = 0;
+    pool->num_ranges_done = 0;
+    pthread_mutex_unlock(&pool->mutex);
+
+    /* merge the results of all ranges in order */
+    *bit_size = 0;
+    for (i = 0; i < num_ranges; i++)
+    {
+        int j;
+
+        for (j = 0; j < range[i].num_errors; j++)
+        {
+            coda_cursor error_cursor;
+
+            if (range[i].error[j].has_path &&
+                goto_check_path(&error_cursor, cursor->product, &range[i].error[j].path) == 0)
+            {
+                callbackfunc(&error_cursor, range[i].error[j].message, userdata);
+            }
+            else
+            {
+                coda_set_error(CODA_SUCCESS, NULL);
+                callbackfunc(cursor, range[i].error[j].message, userdata);
+            }
+        }
+        if (range[i].result != 0)
+        {
+            if (range[i].error_message != NULL)
+            {
+                coda_set_error(range[i].error_code, "%s", range[i].error_message);
+            }
+            else
+            {
+                coda_set_error(range[i].error_code, NULL);
+            }
+            result = -1;
+            break;
+        }
+        *bit_size += range[i].bit_size;
+    }
+
+    for (i = 0; i < num_ranges; i++)
+    {
+        check_range_done(&range[i]);
+    }
+    free(range);
+
+    return result;
+}
+
+#endif
 
 static int check_definition(coda_cursor *cursor, coda_type **definition,
                             void (*callbackfunc) (coda_cursor *, const char *, void *), void *userdata)
@@ -295,7 +886,7 @@ static int check_definition(coda_cursor *cursor, coda_type **definition,
 }
 
 static int check_data(coda_cursor *cursor, coda_type **definition, int read_check, int size_check, int64_t *bit_size,
-                      void (*callbackfunc) (coda_cursor *, const char *, void *), void *userdata)
+                      check_pool *pool, void (*callbackfunc) (coda_cursor *, const char *, void *), void *userdata)
 {
     coda_type_class type_class;
     int skip_mem_size_check = 0;
@@ -590,7 +1181,8 @@ static int check_data(coda_cursor *cursor, coda_type **definition, int read_chec
         {
             return -1;
         }
-        if (check_data(cursor, &attributes_definition, read_check, 0, &attribute_size, callbackfunc, userdata) != 0)
+        if (check_data(cursor, &attributes_definition, read_check, 0, &attribute_size, NULL, callbackfunc, userdata) !=
+            0)
         {
             return -1;
         }
@@ -625,6 +1217,22 @@ static int check_data(coda_cursor *cursor, coda_type **definition, int read_chec
                     {
                         return -1;
                     }
+#ifdef HAVE_PTHREAD
+                    /* only split top-level arrays (the root array or arrays directly below the root) over threads */
+                    if (pool != NULL && cursor->n <= 2 && num_elements >= MIN_PARALLEL_ARRAY_ELEMENTS)
+                    {
+                        if (check_array_parallel(pool, cursor, &base_definition, read_check, size_check, num_elements,
+                                                 &sub_bit_size, callbackfunc, userdata) != 0)
+                        {
+                            return -1;
+                        }
+                        if (size_check)
+                        {
+                            *bit_size += sub_bit_size;
+                        }
+                    }
+                    else
+#endif
                     if (num_elements > 0)
                     {
                         if (coda_cursor_goto_first_array_element(cursor) != 0)
@@ -633,7 +1241,7 @@ static int check_data(coda_cursor *cursor, coda_type **definition, int read_chec
                         }
                         for (i = 0; i < num_elements; i++)
                         {
-                            if (check_data(cursor, &base_definition, read_check, size_check, &sub_bit_size,
+                            if (check_data(cursor, &base_definition, read_check, size_check, &sub_bit_size, NULL,
                                            callbackfunc, userdata) != 0)
                             {
                                 return -1;
@@ -707,7 +1315,7 @@ static int check_data(coda_cursor *cursor, coda_type **definition, int read_chec
                                     }
                                 }
                                 if (check_data(cursor, &field_definition, read_check, size_check, &sub_bit_size,
-                                               callbackfunc, userdata) != 0)
+                                               pool, callbackfunc, userdata) != 0)
                                 {
                                     return -1;
                                 }
@@ -788,7 +1396,7 @@ static int check_data(coda_cursor *cursor, coda_type **definition, int read_chec
                     {
                         return -1;
                     }
-                    if (check_data(cursor, &base_definition, read_check, size_check, bit_size, callbackfunc,
+                    if (check_data(cursor, &base_definition, read_check, size_check, bit_size, pool, callbackfunc,
                                    userdata) != 0)
                     {
                         return -1;
@@ -870,8 +1478,8 @@ static int check_data(coda_cursor *cursor, coda_type **definition, int read_chec
     return 0;
 }
 
-LIBCODA_API int coda_product_check(coda_product *product, int full_read_check,
-                                   void (*callbackfunc) (coda_cursor *, const char *, void *), void *userdata)
+static int product_check(coda_product *product, int full_read_check, check_pool *pool,
+                         void (*callbackfunc) (coda_cursor *, const char *, void *), void *userdata)
 {
     coda_type *definition = NULL;
     coda_cursor cursor;
@@ -926,7 +1534,7 @@ LIBCODA_API int coda_product_check(coda_product *product, int full_read_check,
     }
     else
     {
-        if (check_data(&cursor, &definition, full_read_check, size_check, &calculated_file_size, callbackfunc,
+        if (check_data(&cursor, &definition, full_read_check, size_check, &calculated_file_size, pool, callbackfunc,
                        userdata) != 0)
         {
             return -1;
@@ -956,3 +1564,43 @@ LIBCODA_API int coda_product_check(coda_product *product, int full_read_check,
 
     return 0;
 }
+
+LIBCODA_API int coda_product_check(coda_product *product, int full_read_check,
+                                   void (*callbackfunc) (coda_cursor *, const char *, void *), void *userdata)
+{
+    return product_check(product, full_read_check, NULL, callbackfunc, userdata);
+}
+
+/* Same as coda_product_check(), but top-level arrays of the product (the root array or arrays that are fields of
+ * the root record) are divided into ranges of elements that are checked in parallel using num_threads threads.
+ * Each worker thread initializes CODA and opens the product itself, using the definition path and options of the
+ * calling thread. Errors are passed to callbackfunc from the calling thread in the same order as coda_product_check()
+ * would report them. If CODA is built without thread support or if the product was opened from memory this function
+ * behaves as coda_product_check().
+ */
+LIBCODA_API int coda_product_check_parallel(coda_product *product, int full_read_check, int num_threads,
+                                            void (*callbackfunc) (coda_cursor *, const char *, void *),
+                                            void *userdata)
+{
+#ifdef HAVE_PTHREAD
+    check_pool *pool;
+    int result;
+
+    if (num_threads <= 1 || product->filename == NULL || coda_product_is_in_memory(product))
+    {
+        return product_check(product, full_read_check, NULL, callbackfunc, userdata);
+    }
+    if (check_pool_new(product, num_threads, &pool) != 0)
+    {
+        return -1;
+    }
+    result = product_check(product, full_read_check, pool, callbackfunc, userdata);
+    check_pool_delete(pool);
+
+    return result;
+#else
+    (void)num_threads;
+
+    return product_check(product, full_read_check, NULL, callbackfunc, userdata);
+#endif
+}
@@ -1749,6 +1749,289 @@ static int read_char_partial_array(const coda_cursor *cursor, long offset, long
     exit(1);
 }
 
+/* maximum stride in the last dimension of a hyperslab for which the elements in between are read along */
+#define MAX_HYPERSLAB_GATHER_STRIDE 16
+
+typedef int (*read_partial_array_function) (const coda_cursor *, long, long, void *);
+
+/* Returns whether the backend can read the hyperslab itself. This is the case for netCDF, HDF4, and HDF5 if no type
+ * conversion is needed (i.e. if the elements are read using the read type of the array elements).
+ */
+static int use_backend_hyperslab(const coda_cursor *cursor, coda_type *type, coda_native_type native_type)
+{
+    coda_type *base_type = ((coda_type_array *)type)->base_type;
+    coda_native_type read_type;
+    coda_conversion *conversion;
+
+    switch (cursor->stack[cursor->n - 1].type->backend)
+    {
+        case coda_backend_netcdf:
+        case coda_backend_hdf4:
+            break;
+        case coda_backend_hdf5:
+            if (base_type->type_class == coda_text_class)
+            {
+                return 0;
+            }
+            break;
+        default:
+            return 0;
+    }
+    if (base_type->type_class != coda_integer_class && base_type->type_class != coda_real_class &&
+        base_type->type_class != coda_text_class)
+    {
+        return 0;
+    }
+    if (get_array_element_unconverted_read_type(type, &read_type, &conversion) != 0)
+    {
+        return 0;
+    }
+
+    return read_type == native_type && conversion == NULL;
+}
+
+static int read_backend_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                  const long stride[], void *dst)
+{
+    switch (cursor->stack[cursor->n - 1].type->backend)
+    {
+        case coda_backend_netcdf:
+            return coda_netcdf_cursor_read_hyperslab(cursor, start, count, stride, dst);
+        case coda_backend_hdf4:
+#ifdef HAVE_HDF4
+            return coda_hdf4_cursor_read_hyperslab(cursor, start, count, stride, dst);
+#else
+            coda_set_error(CODA_ERROR_NO_HDF4_SUPPORT, NULL);
+            return -1;
+#endif
+        case coda_backend_hdf5:
+#ifdef HAVE_HDF5
+            return coda_hdf5_cursor_read_hyperslab(cursor, start, count, stride, dst);
+#else
+            coda_set_error(CODA_ERROR_NO_HDF5_SUPPORT, NULL);
+            return -1;
+#endif
+        default:
+            break;
+    }
+
+    assert(0);
+    exit(1);
+}
+
+/* Read a hyperslab using partial array reads.
+ * Trailing dimensions that are read completely are merged with the dimension before them (if that dimension has a
+ * stride of 1) such that each partial array read covers a run of consecutive array elements that is as long as
+ * possible. For a small stride in the last dimension the whole range that covers the strided elements is read, after
+ * which only the selected elements are kept.
+ */
+static int read_hyperslab_runs(const coda_cursor *cursor, int num_dims, const long dim[], const long start[],
+                               const long count[], const long stride[], read_partial_array_function read_partial_array,
+                               int element_size, uint8_t *dst)
+{
+    long multiplier[CODA_MAX_NUM_DIMS];
+    long index[CODA_MAX_NUM_DIMS];
+    uint8_t *buffer = NULL;
+    long run_length;    /* number of consecutive array elements that are read with a single partial array read */
+    long run_offset;    /* offset of the run relative to the position that is determined by the outer dims */
+    long run_stride = 1;        /* only every run_stride-th element of a run is kept */
+    long run_count;     /* number of elements that are kept from each run */
+    int num_outer_dims;
+    int i;
+
+    if (num_dims == 0)
+    {
+        return read_partial_array(cursor, 0, 1, dst);
+    }
+
+    multiplier[num_dims - 1] = 1;
+    for (i = num_dims - 1; i > 0; i--)
+    {
+        multiplier[i - 1] = multiplier[i] * dim[i];
+    }
+
+    i = num_dims - 1;
+    while (i > 0 && start[i] == 0 && count[i] == dim[i] && stride[i] == 1)
+    {
+        i--;
+    }
+    if (stride[i] == 1)
+    {
+        run_length = count[i] * multiplier[i];
+        run_offset = start[i] * multiplier[i];
+        run_count = run_length;
+        num_outer_dims = i;
+    }
+    else if (i == num_dims - 1 && stride[i] <= MAX_HYPERSLAB_GATHER_STRIDE)
+    {
+        run_length = (count[i] - 1) * stride[i] + 1;
+        run_offset = start[i];
+        run_stride = stride[i];
+        run_count = count[i];
+        num_outer_dims = i;
+        buffer = (uint8_t *)malloc(run_length * element_size);
+        if (buffer == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           run_length * element_size, __FILE__, __LINE__);
+            return -1;
+        }
+    }
+    else
+    {
+        run_length = multiplier[i];
+        run_offset = 0;
+        run_count = run_length;
+        num_outer_dims = i + 1;
+    }
+
+    for (i = 0; i < num_outer_dims; i++)
+    {
+        index[i] = 0;
+    }
+    for (;;)
+    {
+        long offset = run_offset;
+
+        for (i = 0; i < num_outer_dims; i++)
+        {
+            offset += (start[i] + index[i] * stride[i]) * multiplier[i];
+        }
+        if (buffer != NULL)
+        {
+            long j;
+
+            if (read_partial_array(cursor, offset, run_length, buffer) != 0)
+            {
+                free(buffer);
+                return -1;
+            }
+            for (j = 0; j < run_count; j++)
+            {
+                memcpy(&dst[j * element_size], &buffer[j * run_stride * element_size], element_size);
+            }
+        }
+        else if (read_partial_array(cursor, offset, run_length, dst) != 0)
+        {
+            return -1;
+        }
+        dst += run_count * element_size;
+
+        /* advance to the next run */
+        for (i = num_outer_dims - 1; i >= 0; i--)
+        {
+            index[i]++;
+            if (index[i] < count[i])
+            {
+                break;
+            }
+            index[i] = 0;
+        }
+        if (i < 0)
+        {
+            break;
+        }
+    }
+
+    if (buffer != NULL)
+    {
+        free(buffer);
+    }
+
+    return 0;
+}
+
+static int read_hyperslab(const coda_cursor *cursor, const long start[], const long count[], const long stride[],
+                          coda_native_type native_type, read_partial_array_function read_partial_array,
+                          int element_size, void *dst, coda_array_ordering array_ordering)
+{
+    long local_stride[CODA_MAX_NUM_DIMS];
+    long dim[CODA_MAX_NUM_DIMS];
+    coda_type *type;
+    long num_elements = 1;
+    int num_dims;
+    int i;
+
+    if (cursor == NULL || cursor->n <= 0 || cursor->stack[cursor->n - 1].type == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid cursor argument (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (dst == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "dst argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    type = coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
+    if (type->type_class != coda_array_class)
+    {
+        coda_set_error(CODA_ERROR_INVALID_TYPE, "cursor does not refer to an array (current type is %s)",
+                       coda_type_get_class_name(type->type_class));
+        return -1;
+    }
+    if (coda_cursor_get_array_dim(cursor, &num_dims, dim) != 0)
+    {
+        return -1;
+    }
+    if (num_dims > 0 && (start == NULL || count == NULL))
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "%s argument is NULL (%s:%u)", start == NULL ? "start" : "count",
+                       __FILE__, __LINE__);
+        return -1;
+    }
+
+    /* the hyperslab is always verified, since it determines which parts of the product are read */
+    for (i = 0; i < num_dims; i++)
+    {
+        local_stride[i] = (stride == NULL ? 1 : stride[i]);
+        if (start[i] < 0 || count[i] < 0 || local_stride[i] < 1)
+        {
+            coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid hyperslab for dimension %d (start = %ld, count = %ld, "
+                           "stride = %ld)", i, start[i], count[i], local_stride[i]);
+            return -1;
+        }
+        if (count[i] > 0 && start[i] + (count[i] - 1) * local_stride[i] >= dim[i])
+        {
+            coda_set_error(CODA_ERROR_ARRAY_OUT_OF_BOUNDS, "hyperslab for dimension %d (start = %ld, count = %ld, "
+                           "stride = %ld) exceeds array range [0:%ld)", i, start[i], count[i], local_stride[i],
+                           dim[i]);
+            return -1;
+        }
+        num_elements *= count[i];
+    }
+    if (num_elements == 0)
+    {
+        return 0;
+    }
+
+    if (num_dims > 0 && use_backend_hyperslab(cursor, type, native_type))
+    {
+        if (read_backend_hyperslab(cursor, start, count, local_stride, dst) != 0)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        if (read_hyperslab_runs(cursor, num_dims, dim, start, count, local_stride, read_partial_array, element_size,
+                                (uint8_t *)dst) != 0)
+        {
+            return -1;
+        }
+    }
+
+    if (array_ordering == coda_array_ordering_fortran && num_dims > 1)
+    {
+        if (transpose_array_with_dims(num_dims, count, dst, element_size) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 /** \addtogroup coda_cursor
  * @{
  */
@@ -2885,6 +3168,84 @@ LIBCODA_API int coda_cursor_read_bytes(const coda_cursor *cursor, uint8_t *dst,
     return -1;
 }
 
+/** Get direct access to the data of the data element that the cursor points to.
+ * This function provides a pointer to the data as it is stored in the product, without copying it. This is only
+ * possible if the product is memory mapped (see coda_set_option_use_mmap()) and if the data is stored contiguously and
+ * starts and ends at a byte boundary. The function works for ASCII, binary, netCDF, and CDF products. For all other
+ * formats (and for data that is not stored contiguously, such as netCDF record variables that are interleaved with
+ * other record variables or CDF variables with sparse records) the function will return an error.
+ * The data is provided as it is stored in the product. This means that no conversions are applied and that
+ * multi-byte numerical values are stored with the byte ordering given by \a big_endian (which can differ from the byte
+ * ordering of the platform). For ASCII and text data \a big_endian will be set according to the byte ordering of the
+ * platform.
+ * The returned pointer will remain valid until the product is closed with coda_close(). The data pointed to should
+ * never be modified.
+ * \param cursor Pointer to a CODA cursor.
+ * \param data Pointer to the variable where the pointer to the data will be stored.
+ * \param byte_size Pointer to the variable where the size of the data in bytes will be stored.
+ * \param big_endian Pointer to the variable where the byte ordering of the data will be stored (1: big endian,
+ * 0: little endian).
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_get_data_pointer(const coda_cursor *cursor, const uint8_t **data, int64_t *byte_size,
+                                             int *big_endian)
+{
+    coda_endianness endianness = coda_big_endian;
+    int result = -1;
+
+    if (cursor == NULL || cursor->n <= 0 || cursor->stack[cursor->n - 1].type == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid cursor argument (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (data == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "data argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (byte_size == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "byte_size argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (big_endian == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "big_endian argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    switch (cursor->stack[cursor->n - 1].type->backend)
+    {
+        case coda_backend_ascii:
+            result = coda_ascii_cursor_get_data_pointer(cursor, data, byte_size, &endianness);
+            break;
+        case coda_backend_binary:
+            result = coda_bin_cursor_get_data_pointer(cursor, data, byte_size, &endianness);
+            break;
+        case coda_backend_netcdf:
+            result = coda_netcdf_cursor_get_data_pointer(cursor, data, byte_size, &endianness);
+            break;
+        case coda_backend_cdf:
+            result = coda_cdf_cursor_get_data_pointer(cursor, data, byte_size, &endianness);
+            break;
+        case coda_backend_memory:
+        case coda_backend_hdf4:
+        case coda_backend_hdf5:
+        case coda_backend_grib:
+            coda_set_error(CODA_ERROR_INVALID_TYPE, "direct access to data is not supported for this data");
+            return -1;
+    }
+    if (result != 0)
+    {
+        return -1;
+    }
+    *big_endian = (endianness == coda_big_endian);
+
+    return 0;
+}
+
 /** Retrieve a data array as type \c int8 from the product file. The values are stored in \a dst.
  * The cursor must point to an array with a base type that has one of the following read types to succeed:
  * - \c int8
@@ -5600,6 +5961,317 @@ LIBCODA_API int coda_cursor_read_char_partial_array(const coda_cursor *cursor, l
     return 0;
 }
 
+/** Retrieve a hyperslab of a data array as type \c int8 from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_int8_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_int8_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                const long stride[], int8_t *dst, coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_int8,
+                          (read_partial_array_function)&coda_cursor_read_int8_partial_array, sizeof(int8_t), dst,
+                          array_ordering);
+}
+
+/** Retrieve a hyperslab of a data array as type \c uint8 from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_uint8_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_uint8_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                 const long stride[], uint8_t *dst, coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_uint8,
+                          (read_partial_array_function)&coda_cursor_read_uint8_partial_array, sizeof(uint8_t), dst,
+                          array_ordering);
+}
+
+/** Retrieve a hyperslab of a data array as type \c int16 from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_int16_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_int16_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                 const long stride[], int16_t *dst, coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_int16,
+                          (read_partial_array_function)&coda_cursor_read_int16_partial_array, sizeof(int16_t), dst,
+                          array_ordering);
+}
+
+/** Retrieve a hyperslab of a data array as type \c uint16 from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_uint16_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_uint16_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                  const long stride[], uint16_t *dst,
+                                                  coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_uint16,
+                          (read_partial_array_function)&coda_cursor_read_uint16_partial_array, sizeof(uint16_t), dst,
+                          array_ordering);
+}
+
+/** Retrieve a hyperslab of a data array as type \c int32 from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_int32_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_int32_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                 const long stride[], int32_t *dst, coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_int32,
+                          (read_partial_array_function)&coda_cursor_read_int32_partial_array, sizeof(int32_t), dst,
+                          array_ordering);
+}
+
+/** Retrieve a hyperslab of a data array as type \c uint32 from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_uint32_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_uint32_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                  const long stride[], uint32_t *dst,
+                                                  coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_uint32,
+                          (read_partial_array_function)&coda_cursor_read_uint32_partial_array, sizeof(uint32_t), dst,
+                          array_ordering);
+}
+
+/** Retrieve a hyperslab of a data array as type \c int64 from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_int64_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_int64_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                 const long stride[], int64_t *dst, coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_int64,
+                          (read_partial_array_function)&coda_cursor_read_int64_partial_array, sizeof(int64_t), dst,
+                          array_ordering);
+}
+
+/** Retrieve a hyperslab of a data array as type \c uint64 from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_uint64_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_uint64_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                  const long stride[], uint64_t *dst,
+                                                  coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_uint64,
+                          (read_partial_array_function)&coda_cursor_read_uint64_partial_array, sizeof(uint64_t), dst,
+                          array_ordering);
+}
+
+/** Retrieve a hyperslab of a data array as type \c float from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_float_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_float_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                 const long stride[], float *dst, coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_float,
+                          (read_partial_array_function)&coda_cursor_read_float_partial_array, sizeof(float), dst,
+                          array_ordering);
+}
+
+/** Retrieve a hyperslab of a data array as type \c double from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_double_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_double_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                  const long stride[], double *dst, coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_double,
+                          (read_partial_array_function)&coda_cursor_read_double_partial_array, sizeof(double), dst,
+                          array_ordering);
+}
+
+/** Retrieve a hyperslab of a data array as type \c char from the product file. The values are stored in \a dst.
+ * The hyperslab is defined per array dimension by the index of the first element (\a start), the number of elements
+ * (\a count), and the distance between elements (\a stride). The cursor must point to an array with a base type that
+ * has one of the read types that is supported by coda_cursor_read_char_partial_array().
+ * \a dst should be able to hold the product of all \a count values.
+ * Each run of consecutive array elements of the hyperslab is read at once. For netCDF, HDF4, and HDF5 data that does
+ * not require a type conversion the selection is passed on to the backend, which can then read the whole hyperslab
+ * with a single operation.
+ * \note Hyperslab reading is not supported for HDF5 and HDF4 attributes and HDF4 Vdata.
+ * \param cursor Pointer to a CODA cursor.
+ * \param start Index of the first element to read for each dimension.
+ * \param count Number of elements to read for each dimension.
+ * \param stride Distance between the elements to read for each dimension (a NULL pointer means that all strides are 1).
+ * \param dst Pointer to the variable where the values read from the product will be stored.
+ * \param array_ordering Specifies array storage ordering for \a dst: must be #coda_array_ordering_c or
+ * #coda_array_ordering_fortran.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_read_char_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                                const long stride[], char *dst, coda_array_ordering array_ordering)
+{
+    return read_hyperslab(cursor, start, count, stride, coda_native_type_char,
+                          (read_partial_array_function)&coda_cursor_read_char_partial_array, sizeof(char), dst,
+                          array_ordering);
+}
+
 /** Retrieve complex data as type \c double from the product file.
  * The real and imaginary values are stored consecutively in \a dst.
  * The cursor must point to data with special type #coda_special_complex to succeed.
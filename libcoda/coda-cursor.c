@@ -220,6 +220,41 @@ int coda_cursor_compare(const coda_cursor *cursor1, const coda_cursor *cursor2)
     return 0;
 }
 
+/* give the operating system a hint about the data of the current element and the (num_elements - 1) array elements
+ * that follow it */
+static int prefetch(const coda_cursor *cursor, long num_elements)
+{
+    switch (cursor->stack[cursor->n - 1].type->backend)
+    {
+        case coda_backend_ascii:
+        case coda_backend_binary:
+            return coda_ascbin_cursor_prefetch(cursor, num_elements);
+        case coda_backend_memory:
+        case coda_backend_hdf4:
+        case coda_backend_hdf5:
+        case coda_backend_grib:
+            /* prefetching is not supported */
+            break;
+        case coda_backend_cdf:
+            return coda_cdf_cursor_prefetch(cursor, num_elements);
+        case coda_backend_netcdf:
+            return coda_netcdf_cursor_prefetch(cursor, num_elements);
+    }
+
+    return 0;
+}
+
+/* prefetch the current and the next block of elements; failures are ignored since this is only a hint, and the error
+ * state that is visible to the user is left untouched */
+static void auto_prefetch(const coda_cursor *cursor)
+{
+    coda_save_error_state();
+    if (prefetch(cursor, 2 * coda_option_auto_prefetch) != 0)
+    {
+        coda_restore_error_state();
+    }
+}
+
 /** \addtogroup coda_cursor
  * @{
  */
@@ -1086,6 +1121,11 @@ LIBCODA_API int coda_cursor_goto_array_element_by_index(coda_cursor *cursor, lon
         coda_mem_cursor_update_offset(cursor);
     }
 
+    if (coda_option_auto_prefetch > 0 && cursor->stack[cursor->n - 1].index % coda_option_auto_prefetch == 0)
+    {
+        auto_prefetch(cursor);
+    }
+
     if (coda_option_bypass_special_types &&
         coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type)->type_class == coda_special_class)
     {
@@ -1213,6 +1253,11 @@ LIBCODA_API int coda_cursor_goto_next_array_element(coda_cursor *cursor)
         coda_mem_cursor_update_offset(cursor);
     }
 
+    if (coda_option_auto_prefetch > 0 && cursor->stack[cursor->n - 1].index % coda_option_auto_prefetch == 0)
+    {
+        auto_prefetch(cursor);
+    }
+
     if (coda_option_bypass_special_types &&
         coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type)->type_class == coda_special_class)
     {
@@ -2244,4 +2289,90 @@ LIBCODA_API int coda_cursor_get_array_dim(const coda_cursor *cursor, int *num_di
     exit(1);
 }
 
+
+/** Give the operating system a hint that the data at the current cursor position will be read soon.
+ * This allows the operating system to start reading the data from disk in the background (using madvise() for memory
+ * mapped files and posix_fadvise() otherwise), so that a subsequent read of the data does not have to wait for the
+ * disk.
+ * Prefetching is only a hint. It has no effect for in-memory data, for formats that are accessed via external
+ * libraries (such as HDF4 and HDF5), or on systems that do not support it. Failures to perform the prefetch are
+ * therefore not reported.
+ * \see coda_cursor_prefetch_range(), coda_set_option_auto_prefetch()
+ * \param cursor Pointer to a valid CODA cursor.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_prefetch(const coda_cursor *cursor)
+{
+    if (cursor == NULL || cursor->n <= 0 || cursor->stack[cursor->n - 1].type == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid cursor argument (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    return prefetch(cursor, 1);
+}
+
+/** Give the operating system a hint that a range of array elements will be read soon.
+ * The cursor should point to an array. The range consists of the \a length array elements starting at index
+ * \a offset (using the same one dimensional indexing as coda_cursor_goto_array_element_by_index()).
+ * For arrays whose elements have a variable size (e.g. records that contain variable sized arrays) the size of
+ * the element at \a offset is used as estimate for the size of all elements in the range.
+ * \see coda_cursor_prefetch()
+ * \param cursor Pointer to a CODA cursor that references an array.
+ * \param offset Index of the first array element of the range.
+ * \param length Number of array elements in the range.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_cursor_prefetch_range(const coda_cursor *cursor, long offset, long length)
+{
+    coda_cursor element_cursor;
+    coda_type *type;
+    long num_elements;
+
+    if (cursor == NULL || cursor->n <= 0 || cursor->stack[cursor->n - 1].type == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid cursor argument (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    type = coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
+    if (type->type_class != coda_array_class)
+    {
+        coda_set_error(CODA_ERROR_INVALID_TYPE, "cursor does not refer to an array (current type is %s)",
+                       coda_type_get_class_name(type->type_class));
+        return -1;
+    }
+    if (coda_cursor_get_num_elements(cursor, &num_elements) != 0)
+    {
+        return -1;
+    }
+    if (length <= 0)
+    {
+        return 0;
+    }
+    if (offset < 0 || offset >= num_elements)
+    {
+        coda_set_error(CODA_ERROR_ARRAY_OUT_OF_BOUNDS, "array offset (%ld) exceeds array range [0:%ld)", offset,
+                       num_elements);
+        return -1;
+    }
+    if (offset + length > num_elements)
+    {
+        coda_set_error(CODA_ERROR_ARRAY_OUT_OF_BOUNDS, "array offset (%ld) + length (%ld) exceeds array range "
+                       "[0:%ld)", offset, length, num_elements);
+        return -1;
+    }
+
+    element_cursor = *cursor;
+    if (coda_cursor_goto_array_element_by_index(&element_cursor, offset) != 0)
+    {
+        return -1;
+    }
+
+    return prefetch(&element_cursor, length);
+}
+
 /** @} */
@@ -182,6 +182,8 @@ struct node_info_struct
     coda_format format;
     int format_set;
 
+    long line_number;   /* line at which the element starts */
+
     /* handlers for sub elements */
     init_handler init_sub_element[num_xml_elements];
     add_element_to_parent_handler add_element_to_parent[num_xml_elements];
@@ -197,6 +199,8 @@ struct parser_info_struct
     hashtable *hash_data;
     char *buffer;
     za_file *zf;
+    zip_entry_type entry_type;
+    char *entry_name;
     const char *entry_base_name;
     coda_product_class *product_class;
     coda_product_definition *product_definition;
@@ -778,6 +782,29 @@ static int dummy_init(parser_info *info, const char **attr)
     return 0;
 }
 
+/* parse an expression and, if expression profiling is enabled, record where in the definition it came from */
+static int expression_from_string(parser_info *info, const char *exprstring, coda_expression **expr)
+{
+    if (coda_expression_from_string(exprstring, expr) != 0)
+    {
+        return -1;
+    }
+    if (coda_option_profile_expressions)
+    {
+        /* named types can be used by multiple products, so only attribute them to the product class */
+        if (coda_expression_set_source(*expr, info->product_class,
+                                       info->entry_type == ze_type ? NULL : info->product_definition,
+                                       info->entry_name, info->node->line_number,
+                                       xml_element_name(info->node->tag)) != 0)
+        {
+            coda_expression_delete(*expr);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 static int bool_expression_finalise(parser_info *info)
 {
     coda_expression_type result_type;
@@ -796,7 +823,7 @@ static int bool_expression_finalise(parser_info *info)
         coda_set_error(CODA_ERROR_DATA_DEFINITION, "empty boolean expression");
         return -1;
     }
-    if (coda_expression_from_string(info->node->char_data, &expr) != 0)
+    if (expression_from_string(info, info->node->char_data, &expr) != 0)
     {
         return -1;
     }
@@ -845,7 +872,7 @@ static int integer_expression_finalise(parser_info *info)
         coda_set_error(CODA_ERROR_DATA_DEFINITION, "empty integer expression");
         return -1;
     }
-    if (coda_expression_from_string(info->node->char_data, &expr) != 0)
+    if (expression_from_string(info, info->node->char_data, &expr) != 0)
     {
         return -1;
     }
@@ -894,7 +921,7 @@ static int integer_constant_or_expression_finalise(parser_info *info)
         coda_set_error(CODA_ERROR_DATA_DEFINITION, "empty integer expression");
         return -1;
     }
-    if (coda_expression_from_string(info->node->char_data, &expr) != 0)
+    if (expression_from_string(info, info->node->char_data, &expr) != 0)
     {
         return -1;
     }
@@ -955,7 +982,7 @@ static int optional_integer_constant_or_expression_finalise(parser_info *info)
         info->node->empty = 1;
         return 0;
     }
-    if (coda_expression_from_string(info->node->char_data, &expr) != 0)
+    if (expression_from_string(info, info->node->char_data, &expr) != 0)
     {
         return -1;
     }
@@ -1125,7 +1152,7 @@ static int void_expression_finalise(parser_info *info)
         coda_set_error(CODA_ERROR_DATA_DEFINITION, "empty void expression");
         return -1;
     }
-    if (coda_expression_from_string(info->node->char_data, &expr) != 0)
+    if (expression_from_string(info, info->node->char_data, &expr) != 0)
     {
         return -1;
     }
@@ -2511,7 +2538,7 @@ static int cd_match_expression_finalise(parser_info *info)
         return -1;
     }
 
-    if (coda_expression_from_string(info->node->char_data, &expr) != 0)
+    if (expression_from_string(info, info->node->char_data, &expr) != 0)
     {
         return -1;
     }
@@ -3586,7 +3613,7 @@ static int cd_time_init(parser_info *info, const char **attr)
         }
     }
 
-    if (coda_expression_from_string(timeformat, &expr) != 0)
+    if (expression_from_string(info, timeformat, &expr) != 0)
     {
         coda_type_release(base_type);
         return -1;
@@ -3885,6 +3912,7 @@ static int push_node(parser_info *info, xml_element_tag tag, const char **attr)
     node->finalise_element = NULL;
     node->free_data = NULL;
     node->format_set = 0;
+    node->line_number = (long)XML_GetCurrentLineNumber(info->parser);
     memset(node->init_sub_element, 0, num_xml_elements * sizeof(init_handler));
     memset(node->add_element_to_parent, 0, num_xml_elements * sizeof(add_element_to_parent_handler));
     node->parent = info->node;
@@ -4034,6 +4062,7 @@ static void parser_info_init(parser_info *info)
     info->hash_data = NULL;
     info->buffer = NULL;
     info->zf = NULL;
+    info->entry_name = NULL;
     info->product_class = NULL;
     info->product_definition = NULL;
     info->product_class_revision = 0;
@@ -4074,6 +4103,10 @@ static void parser_info_delete(parser_info *info)
     {
         free(info->buffer);
     }
+    if (info->entry_name != NULL)
+    {
+        free(info->entry_name);
+    }
     info->zf = NULL;
 }
 
@@ -4140,10 +4173,11 @@ static int parse_entry(za_file *zf, zip_entry_type type, const char *name, coda_
         free(entry_name);
         return -1;
     }
-    free(entry_name);
 
     parser_info_init(&info);
     info.zf = zf;
+    info.entry_type = type;
+    info.entry_name = entry_name;
     info.entry_base_name = name;
     info.product_class = current_product_class;
     info.product_definition = current_product_definition;
@@ -31,6 +31,7 @@
 
 #include "coda-internal.h"
 #include "coda-definition.h"
+#include "coda-thread.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -132,10 +133,28 @@ int coda_product_variable_validate(coda_product_variable *product_variable)
     return 0;
 }
 
-static int init_product_variable(coda_product *product, int index)
+/* a product variable that is being initialized by the current thread */
+typedef struct pending_product_variable_struct
 {
+    coda_product *product;
+    long index;
+    long size;
+    int64_t *value;
+    struct pending_product_variable_struct *next;
+} pending_product_variable;
+
+/* The init expression of a product variable (and the init expressions of product variables that it depends on) can
+ * access the product variable before it is fully initialized. Such accesses are resolved using this list, since the
+ * product variable itself only becomes visible (also to other threads) once its initialization has completed.
+ */
+static THREAD_LOCAL pending_product_variable *pending_product_variables = NULL;
+
+static int init_product_variable(coda_product *product, long index)
+{
+    pending_product_variable pending;
     coda_cursor cursor;
     int64_t value = 1;
+    int result;
 
     /* initialize the product variable */
 
@@ -154,27 +173,81 @@ static int init_product_variable(coda_product *product, int index)
         }
     }
 
-    product->product_variable_size[index] = (int)value;
-    product->product_variable[index] = (int64_t *)malloc((size_t)value * sizeof(int64_t));
-    if (product->product_variable[index] == NULL)
+    pending.product = product;
+    pending.index = index;
+    pending.size = (long)value;
+    pending.value = (int64_t *)malloc((size_t)value * sizeof(int64_t));
+    if (pending.value == NULL)
     {
         coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
                        (long)value * sizeof(int64_t), __FILE__, __LINE__);
         return -1;
     }
-    memset(product->product_variable[index], 0, (size_t)value * sizeof(int64_t));
-    if (coda_expression_eval_void(product->product_definition->product_variable[index]->init_expr, &cursor) != 0)
+    memset(pending.value, 0, (size_t)value * sizeof(int64_t));
+
+    pending.next = pending_product_variables;
+    pending_product_variables = &pending;
+    result = coda_expression_eval_void(product->product_definition->product_variable[index]->init_expr, &cursor);
+    pending_product_variables = pending.next;
+    if (result != 0)
     {
         coda_add_error_message(" while initializing product variable %s",
                                product->product_definition->product_variable[index]->name);
+        free(pending.value);
         return -1;
     }
 
+    product->product_variable_size[index] = pending.size;
+    coda_atomic_store_ptr(&product->product_variable[index], pending.value);
+
+    return 0;
+}
+
+/* Retrieve the (initialized) value array of a product variable.
+ * Each product variable is initialized only once, also when multiple threads access the product at the same time.
+ */
+static int get_product_variable(coda_product *product, long index, int64_t **value, long *size)
+{
+    int64_t *product_variable;
+
+    product_variable = coda_atomic_load_ptr(&product->product_variable[index]);
+    if (product_variable == NULL)
+    {
+        pending_product_variable *pending;
+        int result = 0;
+
+        for (pending = pending_product_variables; pending != NULL; pending = pending->next)
+        {
+            if (pending->product == product && pending->index == index)
+            {
+                *value = pending->value;
+                *size = pending->size;
+                return 0;
+            }
+        }
+
+        coda_lazy_init_lock();
+        if (product->product_variable[index] == NULL)
+        {
+            result = init_product_variable(product, index);
+        }
+        coda_lazy_init_unlock();
+        if (result != 0)
+        {
+            return -1;
+        }
+        product_variable = product->product_variable[index];
+    }
+
+    *value = product_variable;
+    *size = product->product_variable_size[index];
+
     return 0;
 }
 
 int coda_product_variable_get_size(coda_product *product, const char *name, long *size)
 {
+    int64_t *value;
     long index;
 
     assert(product != NULL && name != NULL && size != NULL);
@@ -189,21 +262,14 @@ int coda_product_variable_get_size(coda_product *product, const char *name, long
         return -1;
     }
 
-    if (product->product_variable[index] == NULL)
-    {
-        if (init_product_variable(product, index) != 0)
-        {
-            return -1;
-        }
-    }
-    *size = product->product_variable_size[index];
-
-    return 0;
+    return get_product_variable(product, index, &value, size);
 }
 
 int coda_product_variable_get_pointer(coda_product *product, const char *name, long i, int64_t **ptr)
 {
+    int64_t *value;
     long index;
+    long size;
 
     assert(product != NULL && name != NULL && ptr != NULL);
 
@@ -216,21 +282,18 @@ int coda_product_variable_get_pointer(coda_product *product, const char *name, l
         return -1;
     }
 
-    if (product->product_variable[index] == NULL)
+    if (get_product_variable(product, index, &value, &size) != 0)
     {
-        if (init_product_variable(product, index) != 0)
-        {
-            return -1;
-        }
+        return -1;
     }
-    if (i < 0 || i >= product->product_variable_size[index])
+    if (i < 0 || i >= size)
     {
         coda_set_error(CODA_ERROR_DATA_DEFINITION, "request for index (%ld) exceeds size of product variable %s",
                        i, name);
         return -1;
     }
 
-    *ptr = &(product->product_variable[index][i]);
+    *ptr = &value[i];
 
     return 0;
 }
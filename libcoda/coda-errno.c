@@ -44,6 +44,8 @@
 #define MAX_ERROR_INFO_LENGTH	4096
 
 static THREAD_LOCAL char coda_error_message_buffer[MAX_ERROR_INFO_LENGTH + 1];
+static THREAD_LOCAL char coda_saved_error_message_buffer[MAX_ERROR_INFO_LENGTH + 1];
+static THREAD_LOCAL int coda_saved_errno = CODA_SUCCESS;
 
 /** \defgroup coda_error CODA Error
  * With a few exceptions almost all CODA functions return an integer that indicate whether the function was able to
@@ -243,6 +245,22 @@ void coda_cursor_add_to_error_message(const coda_cursor *cursor)
     coda_cursor_print_path(cursor, add_error_message);
 }
 
+/* Save the current error value and error message, so they can be restored with coda_restore_error_state() after
+ * an operation whose failure should not be visible to the user (such as a prefetch hint).
+ * There is only one saved state per thread, so these calls can not be nested.
+ */
+void coda_save_error_state(void)
+{
+    coda_saved_errno = coda_errno;
+    strcpy(coda_saved_error_message_buffer, coda_error_message_buffer);
+}
+
+void coda_restore_error_state(void)
+{
+    coda_errno = coda_saved_errno;
+    strcpy(coda_error_message_buffer, coda_saved_error_message_buffer);
+}
+
 /** Set the error value and optionally set a custom error message.
  * If \a message is NULL then the default error message for the error number will be used.
  * \param err Value of #coda_errno.
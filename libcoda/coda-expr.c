@@ -31,6 +31,8 @@
 
 #include "coda-internal.h"
 #include "coda-expr.h"
+#include "coda-definition.h"
+#include "coda-statistics.h"
 
 #include <assert.h>
 #include <ctype.h>
@@ -236,6 +238,7 @@ static coda_expression *boolean_constant_new(char *string_value)
     expr->tag = expr_constant_boolean;
     expr->result_type = coda_expression_boolean;
     expr->is_constant = 1;
+    expr->profile = NULL;
     expr->value = (*string_value == 't' || *string_value == 'T');
     free(string_value);
 
@@ -264,6 +267,7 @@ static coda_expression *float_constant_new(char *string_value)
     expr->tag = expr_constant_float;
     expr->result_type = coda_expression_float;
     expr->is_constant = 1;
+    expr->profile = NULL;
     expr->value = value;
 
     return (coda_expression *)expr;
@@ -291,6 +295,7 @@ static coda_expression *integer_constant_new(char *string_value)
     expr->tag = expr_constant_integer;
     expr->result_type = coda_expression_integer;
     expr->is_constant = 1;
+    expr->profile = NULL;
     expr->value = value;
 
     return (coda_expression *)expr;
@@ -310,6 +315,7 @@ static coda_expression *rawstring_constant_new(char *string_value)
     expr->tag = expr_constant_rawstring;
     expr->result_type = coda_expression_string;
     expr->is_constant = 1;
+    expr->profile = NULL;
     expr->length = (long)strlen(string_value);
     expr->value = string_value;
 
@@ -338,6 +344,7 @@ static coda_expression *string_constant_new(char *string_value)
     expr->tag = expr_constant_string;
     expr->result_type = coda_expression_string;
     expr->is_constant = 1;
+    expr->profile = NULL;
     expr->length = length;
     expr->value = string_value;
 
@@ -408,6 +415,7 @@ coda_expression *coda_expression_new(coda_expression_node_type tag, char *string
         return NULL;
     }
     expr->tag = tag;
+    expr->profile = NULL;
     expr->identifier = string_value;
     expr->operand[0] = op1;
     expr->operand[1] = op2;
@@ -564,6 +572,128 @@ coda_expression *coda_expression_new(coda_expression_node_type tag, char *string
     return (coda_expression *)expr;
 }
 
+/* all expressions for which a source location was recorded (see coda_set_option_profile_expressions()) */
+static THREAD_LOCAL coda_expression_profile *profile_list = NULL;
+
+/* a profiled expression evaluation that is in progress; nested evaluations of profiled expressions (e.g. a size
+ * expression that is evaluated while evaluating an availability expression) form a stack
+ */
+typedef struct profile_frame_struct
+{
+    coda_expression_profile *profile;
+    double start_time;
+    double child_time;
+    struct profile_frame_struct *parent;
+} profile_frame;
+
+static THREAD_LOCAL profile_frame *current_profile_frame = NULL;
+
+static void profile_delete(coda_expression_profile *profile)
+{
+    if (profile->prev != NULL)
+    {
+        profile->prev->next = profile->next;
+    }
+    else
+    {
+        profile_list = profile->next;
+    }
+    if (profile->next != NULL)
+    {
+        profile->next->prev = profile->prev;
+    }
+    if (profile->entry != NULL)
+    {
+        free(profile->entry);
+    }
+    free(profile);
+}
+
+/* record where an expression from a product definition came from, so its evaluations can be profiled */
+int coda_expression_set_source(coda_expression *expr, const coda_product_class *product_class,
+                               const coda_product_definition *product_definition, const char *entry, long line,
+                               const char *element)
+{
+    coda_expression_profile *profile;
+
+    profile = malloc(sizeof(coda_expression_profile));
+    if (profile == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)sizeof(coda_expression_profile), __FILE__, __LINE__);
+        return -1;
+    }
+    profile->expr = expr;
+    profile->product_class = product_class;
+    profile->product_definition = product_definition;
+    profile->entry = NULL;
+    profile->line = line;
+    profile->element = element;
+    profile->num_evaluations = 0;
+    profile->total_time = 0;
+    profile->self_time = 0;
+    profile->prev = NULL;
+    profile->next = NULL;
+    if (entry != NULL)
+    {
+        profile->entry = strdup(entry);
+        if (profile->entry == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                           __LINE__);
+            free(profile);
+            return -1;
+        }
+    }
+
+    if (expr->profile != NULL)
+    {
+        profile_delete(expr->profile);
+    }
+    expr->profile = profile;
+    profile->next = profile_list;
+    if (profile_list != NULL)
+    {
+        profile_list->prev = profile;
+    }
+    profile_list = profile;
+
+    return 0;
+}
+
+static void begin_profile(profile_frame *frame, const coda_expression *expr)
+{
+    frame->profile = NULL;
+    if (expr->profile == NULL || !coda_option_profile_expressions)
+    {
+        return;
+    }
+    frame->profile = expr->profile;
+    frame->child_time = 0;
+    frame->parent = current_profile_frame;
+    current_profile_frame = frame;
+    frame->start_time = coda_statistics_get_time();
+}
+
+static void end_profile(profile_frame *frame)
+{
+    double duration;
+
+    if (frame->profile == NULL)
+    {
+        return;
+    }
+    duration = coda_statistics_get_time() - frame->start_time;
+    frame->profile->num_evaluations++;
+    frame->profile->total_time += duration;
+    frame->profile->self_time += duration - frame->child_time;
+    current_profile_frame = frame->parent;
+    if (frame->parent != NULL)
+    {
+        frame->parent->child_time += duration;
+    }
+}
+
 typedef struct eval_info_struct
 {
     const coda_cursor *orig_cursor;
@@ -4086,6 +4216,8 @@ static int eval_cursor(eval_info *info, const coda_expression *expr)
 int coda_expression_eval_void(const coda_expression *expr, const coda_cursor *cursor)
 {
     eval_info info;
+    profile_frame frame;
+    int result;
 
     if (expr->result_type != coda_expression_void)
     {
@@ -4099,7 +4231,12 @@ int coda_expression_eval_void(const coda_expression *expr, const coda_cursor *cu
     }
 
     init_eval_info(&info, cursor);
-    return eval_void(&info, expr);
+    coda_statistics_add_for_cursor(cursor, num_expression_evaluations[coda_expression_void], 1);
+    begin_profile(&frame, expr);
+    result = eval_void(&info, expr);
+    end_profile(&frame);
+
+    return result;
 }
 
 static void print_escaped_string(const char *str, int length, int (*print) (const char *, ...), int xml, int html)
@@ -4853,6 +4990,146 @@ int coda_expression_print_xml(const coda_expression *expr, int (*print) (const c
     return print_expression(expr, print, 1, 0, 15);
 }
 
+/* cursor position that is not within the data element for which dependencies are determined */
+#define OUTSIDE_NODE -1
+
+static int depends_on_node(const coda_expression *expr, int depth, int orig_depth);
+
+/* Determine where a node expression ends up when starting at 'depth' levels below the data element for which
+ * dependencies are determined (or at OUTSIDE_NODE). Returns 1 if this can not be determined statically (e.g. because
+ * an array index depends on the data element).
+ */
+static int get_node_depth(const coda_expression *expr, int depth, int orig_depth, int *node_depth)
+{
+    const coda_expression_operation *opexpr = (const coda_expression_operation *)expr;
+
+    if (expr == NULL)
+    {
+        *node_depth = depth;
+        return 0;
+    }
+    switch (expr->tag)
+    {
+        case expr_goto_here:
+            *node_depth = depth;
+            break;
+        case expr_goto_begin:
+            *node_depth = orig_depth;
+            break;
+        case expr_goto_root:
+        case expr_asciiline:
+            *node_depth = OUTSIDE_NODE;
+            break;
+        case expr_goto_parent:
+            if (get_node_depth(opexpr->operand[0], depth, orig_depth, node_depth) != 0)
+            {
+                return 1;
+            }
+            if (*node_depth > 0)
+            {
+                (*node_depth)--;
+            }
+            else
+            {
+                *node_depth = OUTSIDE_NODE;
+            }
+            break;
+        case expr_goto_field:
+        case expr_goto_attribute:
+        case expr_goto_array_element:
+            if (expr->tag == expr_goto_array_element && opexpr->operand[0] == NULL)
+            {
+                /* '[...]' without a preceding node starts at the root of the product */
+                *node_depth = OUTSIDE_NODE;
+            }
+            else if (get_node_depth(opexpr->operand[0], depth, orig_depth, node_depth) != 0)
+            {
+                return 1;
+            }
+            if (opexpr->operand[1] != NULL && depends_on_node(opexpr->operand[1], *node_depth, orig_depth))
+            {
+                return 1;
+            }
+            if (*node_depth != OUTSIDE_NODE)
+            {
+                (*node_depth)++;
+            }
+            break;
+        default:
+            return 1;
+    }
+
+    return 0;
+}
+
+static int depends_on_node(const coda_expression *expr, int depth, int orig_depth)
+{
+    const coda_expression_operation *opexpr = (const coda_expression_operation *)expr;
+    int node_depth;
+    int i;
+
+    switch (expr->tag)
+    {
+        case expr_constant_boolean:
+        case expr_constant_float:
+        case expr_constant_integer:
+        case expr_constant_rawstring:
+        case expr_constant_string:
+            return 0;
+        case expr_at:
+            if (get_node_depth(opexpr->operand[0], depth, orig_depth, &node_depth) != 0)
+            {
+                return 1;
+            }
+            return depends_on_node(opexpr->operand[1], node_depth, orig_depth);
+        case expr_array_add:
+        case expr_array_all:
+        case expr_array_count:
+        case expr_array_exists:
+        case expr_array_index:
+        case expr_array_max:
+        case expr_array_min:
+        case expr_unbound_array_index:
+            /* the second operand is evaluated for each element of the array */
+            if (get_node_depth(opexpr->operand[0], depth, orig_depth, &node_depth) != 0 ||
+                node_depth != OUTSIDE_NODE)
+            {
+                return 1;
+            }
+            return depends_on_node(opexpr->operand[1], OUTSIDE_NODE, orig_depth);
+        default:
+            break;
+    }
+    if (expr->result_type == coda_expression_node)
+    {
+        /* the data element that the node points to will be inspected */
+        if (get_node_depth(expr, depth, orig_depth, &node_depth) != 0)
+        {
+            return 1;
+        }
+        return node_depth != OUTSIDE_NODE;
+    }
+    for (i = 0; i < 4; i++)
+    {
+        if (opexpr->operand[i] != NULL && depends_on_node(opexpr->operand[i], depth, orig_depth))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Returns 1 if the result of the expression, when evaluated at a data element that is 'depth' levels below some data
+ * element X, could depend on the content, size, or position of X (or any of the data below X), and 0 if it can only
+ * depend on data outside X (e.g. '../../count', '/header/count', or product variables).
+ * This is a conservative check; anything that can not be determined statically counts as a dependency.
+ */
+int coda_expression_depends_on_node(const coda_expression *expr, int depth)
+{
+    return depends_on_node(expr, depth, depth);
+}
+
 /** \addtogroup coda_expression
  * @{
  */
@@ -4950,6 +5227,10 @@ LIBCODA_API void coda_expression_delete(coda_expression *expr)
             }
             break;
     }
+    if (expr->profile != NULL)
+    {
+        profile_delete(expr->profile);
+    }
     free(expr);
 }
 
@@ -5090,6 +5371,8 @@ LIBCODA_API int coda_expression_get_type(const coda_expression *expr, coda_expre
 LIBCODA_API int coda_expression_eval_bool(const coda_expression *expr, const coda_cursor *cursor, int *value)
 {
     eval_info info;
+    profile_frame frame;
+    int result;
 
     if (expr->result_type != coda_expression_boolean)
     {
@@ -5103,7 +5386,11 @@ LIBCODA_API int coda_expression_eval_bool(const coda_expression *expr, const cod
     }
 
     init_eval_info(&info, cursor);
-    if (eval_boolean(&info, expr, value) != 0)
+    coda_statistics_add_for_cursor(cursor, num_expression_evaluations[coda_expression_boolean], 1);
+    begin_profile(&frame, expr);
+    result = eval_boolean(&info, expr, value);
+    end_profile(&frame);
+    if (result != 0)
     {
         if (cursor != NULL && coda_cursor_compare(cursor, &info.cursor) != 0)
         {
@@ -5129,6 +5416,8 @@ LIBCODA_API int coda_expression_eval_bool(const coda_expression *expr, const cod
 LIBCODA_API int coda_expression_eval_integer(const coda_expression *expr, const coda_cursor *cursor, int64_t *value)
 {
     eval_info info;
+    profile_frame frame;
+    int result;
 
     if (expr->result_type != coda_expression_integer)
     {
@@ -5142,7 +5431,11 @@ LIBCODA_API int coda_expression_eval_integer(const coda_expression *expr, const
     }
 
     init_eval_info(&info, cursor);
-    if (eval_integer(&info, expr, value) != 0)
+    coda_statistics_add_for_cursor(cursor, num_expression_evaluations[coda_expression_integer], 1);
+    begin_profile(&frame, expr);
+    result = eval_integer(&info, expr, value);
+    end_profile(&frame);
+    if (result != 0)
     {
         if (cursor != NULL && coda_cursor_compare(cursor, &info.cursor) != 0)
         {
@@ -5168,6 +5461,8 @@ LIBCODA_API int coda_expression_eval_integer(const coda_expression *expr, const
 LIBCODA_API int coda_expression_eval_float(const coda_expression *expr, const coda_cursor *cursor, double *value)
 {
     eval_info info;
+    profile_frame frame;
+    int result;
 
     if (expr->result_type != coda_expression_float)
     {
@@ -5181,7 +5476,11 @@ LIBCODA_API int coda_expression_eval_float(const coda_expression *expr, const co
     }
 
     init_eval_info(&info, cursor);
-    if (eval_float(&info, expr, value) != 0)
+    coda_statistics_add_for_cursor(cursor, num_expression_evaluations[coda_expression_float], 1);
+    begin_profile(&frame, expr);
+    result = eval_float(&info, expr, value);
+    end_profile(&frame);
+    if (result != 0)
     {
         if (cursor != NULL && coda_cursor_compare(cursor, &info.cursor) != 0)
         {
@@ -5214,8 +5513,66 @@ LIBCODA_API int coda_expression_eval_float(const coda_expression *expr, const co
 LIBCODA_API int coda_expression_eval_string(const coda_expression *expr, const coda_cursor *cursor, char **value,
                                             long *length)
 {
+    char *buffer = NULL;
+    long buffer_size = 0;
+
+    if (coda_expression_eval_string_to_buffer(expr, cursor, &buffer, &buffer_size, length) != 0)
+    {
+        if (buffer != NULL)
+        {
+            free(buffer);
+        }
+        return -1;
+    }
+    if (*length == 0)
+    {
+        free(buffer);
+        buffer = NULL;
+    }
+    *value = buffer;
+
+    return 0;
+}
+
+static int ensure_string_buffer(char **buffer, long *buffer_size, long length)
+{
+    if (length + 1 > *buffer_size)
+    {
+        long new_buffer_size = *buffer_size > 0 ? *buffer_size : 64;
+        char *new_buffer;
+
+        while (length + 1 > new_buffer_size)
+        {
+            new_buffer_size *= 2;
+        }
+        new_buffer = realloc(*buffer, new_buffer_size);
+        if (new_buffer == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %ld bytes) (%s:%u)",
+                           new_buffer_size, __FILE__, __LINE__);
+            return -1;
+        }
+        *buffer = new_buffer;
+        *buffer_size = new_buffer_size;
+    }
+    return 0;
+}
+
+/* Same as coda_expression_eval_string(), but the result is stored in a buffer that is owned by the caller.
+ * '*buffer' (of '*buffer_size' bytes, may initially be NULL/0) is only reallocated if it is too small for the result, so
+ * repeated evaluations don't need a memory allocation per result. The result is zero terminated (also if the length is
+ * 0, in which case the buffer gets allocated if needed).
+ * Expressions of the form str(<node>[, <length>]) and constant strings are read directly into the buffer; for other
+ * string expressions the evaluated string is copied into the buffer (or, if the buffer is still NULL, the evaluated
+ * string becomes the buffer).
+ */
+LIBCODA_API int coda_expression_eval_string_to_buffer(const coda_expression *expr, const coda_cursor *cursor,
+                                                      char **buffer, long *buffer_size, long *length)
+{
+    const coda_expression_operation *opexpr = (const coda_expression_operation *)expr;
     eval_info info;
-    long offset;
+    profile_frame frame;
+    int result;
 
     if (expr->result_type != coda_expression_string)
     {
@@ -5229,42 +5586,86 @@ LIBCODA_API int coda_expression_eval_string(const coda_expression *expr, const c
     }
 
     init_eval_info(&info, cursor);
-    if (eval_string(&info, expr, &offset, length, value) != 0)
+    coda_statistics_add_for_cursor(cursor, num_expression_evaluations[coda_expression_string], 1);
+    begin_profile(&frame, expr);
+    if (expr->tag == expr_constant_string || expr->tag == expr_constant_rawstring)
     {
-        if (cursor != NULL && coda_cursor_compare(cursor, &info.cursor) != 0)
+        *length = ((coda_expression_string_constant *)expr)->length;
+        result = ensure_string_buffer(buffer, buffer_size, *length);
+        if (result == 0 && *length > 0)
         {
-            coda_cursor_add_to_error_message(&info.cursor);
+            memcpy(*buffer, ((coda_expression_string_constant *)expr)->value, *length);
         }
-        return -1;
     }
-
-    if (*length > 0)
+    else if (expr->tag == expr_string && opexpr->operand[0]->result_type == coda_expression_node)
     {
-        if (offset != 0)
+        result = eval_cursor(&info, opexpr->operand[0]);
+        if (result == 0)
+        {
+            result = coda_cursor_get_string_length(&info.cursor, length);
+        }
+        if (result == 0 && opexpr->operand[1] != NULL)
         {
-            char *truncated_value;
+            int64_t maxlength;
 
-            truncated_value = malloc(*length + 1);
-            if (truncated_value == NULL)
+            result = eval_integer(&info, opexpr->operand[1], &maxlength);
+            if (result == 0 && *length > maxlength)
             {
-                coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %ld bytes) (%s:%u)",
-                               *length, __FILE__, __LINE__);
-                return -1;
+                *length = (long)maxlength;
+            }
+        }
+        if (result == 0)
+        {
+            if (*length < 0)
+            {
+                *length = 0;
             }
-            memcpy(truncated_value, &(*value)[offset], *length);
-            free(*value);
-            *value = truncated_value;
+            result = ensure_string_buffer(buffer, buffer_size, *length);
+        }
+        if (result == 0 && *length > 0)
+        {
+            result = coda_cursor_read_string(&info.cursor, *buffer, *length + 1);
         }
-        (*value)[*length] = '\0';
     }
     else
     {
-        if (*value != NULL)
+        char *value = NULL;
+        long offset = 0;
+
+        result = eval_string(&info, expr, &offset, length, &value);
+        if (result == 0)
+        {
+            if (*buffer == NULL && offset == 0 && value != NULL)
+            {
+                /* the evaluated string can hold the terminating zero as well */
+                *buffer = value;
+                *buffer_size = *length + 1;
+                value = NULL;
+            }
+            else
+            {
+                result = ensure_string_buffer(buffer, buffer_size, *length);
+                if (result == 0 && *length > 0)
+                {
+                    memcpy(*buffer, &value[offset], *length);
+                }
+            }
+        }
+        if (value != NULL)
         {
-            free(*value);
+            free(value);
         }
-        *value = NULL;
     }
+    end_profile(&frame);
+    if (result != 0)
+    {
+        if (cursor != NULL && coda_cursor_compare(cursor, &info.cursor) != 0)
+        {
+            coda_cursor_add_to_error_message(&info.cursor);
+        }
+        return -1;
+    }
+    (*buffer)[*length] = '\0';
 
     return 0;
 }
@@ -5281,6 +5682,8 @@ LIBCODA_API int coda_expression_eval_string(const coda_expression *expr, const c
 LIBCODA_API int coda_expression_eval_node(const coda_expression *expr, coda_cursor *cursor)
 {
     eval_info info;
+    profile_frame frame;
+    int result;
 
     if (expr->result_type != coda_expression_node)
     {
@@ -5295,7 +5698,11 @@ LIBCODA_API int coda_expression_eval_node(const coda_expression *expr, coda_curs
     }
 
     init_eval_info(&info, cursor);
-    if (eval_cursor(&info, expr) != 0)
+    coda_statistics_add_for_cursor(cursor, num_expression_evaluations[coda_expression_node], 1);
+    begin_profile(&frame, expr);
+    result = eval_cursor(&info, expr);
+    end_profile(&frame);
+    if (result != 0)
     {
         if (cursor != NULL && coda_cursor_compare(cursor, &info.cursor) != 0)
         {
@@ -5309,4 +5716,132 @@ LIBCODA_API int coda_expression_eval_node(const coda_expression *expr, coda_curs
     return 0;
 }
 
+static int compare_profile_self_time(const void *a, const void *b)
+{
+    const coda_expression_profile *profile_a = *(const coda_expression_profile **)a;
+    const coda_expression_profile *profile_b = *(const coda_expression_profile **)b;
+
+    if (profile_a->self_time > profile_b->self_time)
+    {
+        return -1;
+    }
+    if (profile_a->self_time < profile_b->self_time)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+static void print_profile_source(const coda_expression_profile *profile, int (*print) (const char *, ...))
+{
+    if (profile->product_class != NULL)
+    {
+        print("%s", profile->product_class->name);
+    }
+    if (profile->product_definition != NULL)
+    {
+        if (profile->product_definition->product_type != NULL)
+        {
+            print("/%s", profile->product_definition->product_type->name);
+        }
+        print(" v%d", profile->product_definition->version);
+    }
+    if (profile->entry != NULL)
+    {
+        print(" %s:%ld", profile->entry, profile->line);
+    }
+    if (profile->element != NULL)
+    {
+        print(" (%s)", profile->element);
+    }
+}
+
+/** Print the evaluation profile of the expressions from the product definitions.
+ * Expression profiling needs to be enabled with coda_set_option_profile_expressions() for this function to produce
+ * any results.
+ * For each expression from a product definition that was evaluated, this function prints the time spent in the
+ * evaluation of the expression itself (self time), the time spent including the evaluation of other expressions from
+ * product definitions that were needed to evaluate the expression (total time), the number of evaluations, the
+ * product class, product type and version, and the location in the .codadef file of the expression (the entry, line
+ * number and xml element), followed by the expression itself.
+ * The expressions are sorted on self time, with the most expensive expression first.
+ * The profile only covers the evaluations that were performed by the current thread.
+ * The \a print function parameter should be a function that resembles printf().
+ * \param print Reference to a printf compatible function.
+ * \return
+ *   \arg \c  0, Succes.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_expression_print_profile(int (*print) (const char *, ...))
+{
+    coda_expression_profile **profile_array;
+    coda_expression_profile *profile;
+    long num_profiles = 0;
+    long i;
+
+    for (profile = profile_list; profile != NULL; profile = profile->next)
+    {
+        if (profile->num_evaluations > 0)
+        {
+            num_profiles++;
+        }
+    }
+    print("self time [s]  total time [s]  evaluations  source\n");
+    if (num_profiles == 0)
+    {
+        return 0;
+    }
+
+    profile_array = malloc(num_profiles * sizeof(coda_expression_profile *));
+    if (profile_array == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)(num_profiles * sizeof(coda_expression_profile *)), __FILE__, __LINE__);
+        return -1;
+    }
+    i = 0;
+    for (profile = profile_list; profile != NULL; profile = profile->next)
+    {
+        if (profile->num_evaluations > 0)
+        {
+            profile_array[i] = profile;
+            i++;
+        }
+    }
+    qsort(profile_array, num_profiles, sizeof(coda_expression_profile *), compare_profile_self_time);
+
+    for (i = 0; i < num_profiles; i++)
+    {
+        profile = profile_array[i];
+        print("%13.6f  %14.6f  %11ld  ", profile->self_time, profile->total_time, (long)profile->num_evaluations);
+        print_profile_source(profile, print);
+        print("\n    ");
+        if (print_expression(profile->expr, print, 0, 0, 15) != 0)
+        {
+            free(profile_array);
+            return -1;
+        }
+        print("\n");
+    }
+    free(profile_array);
+
+    return 0;
+}
+
+/** Reset the evaluation profile of the expressions from the product definitions.
+ * This sets the evaluation counts and times of all expressions to 0 (for the current thread).
+ * \see coda_expression_print_profile()
+ */
+LIBCODA_API void coda_expression_reset_profile(void)
+{
+    coda_expression_profile *profile;
+
+    for (profile = profile_list; profile != NULL; profile = profile->next)
+    {
+        profile->num_evaluations = 0;
+        profile->total_time = 0;
+        profile->self_time = 0;
+    }
+}
+
 /** @} */
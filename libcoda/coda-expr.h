@@ -126,11 +126,32 @@ enum coda_expression_node_type_enum
 };
 typedef enum coda_expression_node_type_enum coda_expression_node_type;
 
+/* source location and evaluation profile of an expression from a product definition
+ * (only available if expression profiling was enabled when the definition was read,
+ * see coda_set_option_profile_expressions())
+ */
+struct coda_expression_profile_struct
+{
+    const coda_expression *expr;
+    const struct coda_product_class_struct *product_class;
+    const coda_product_definition *product_definition;  /* NULL for expressions of named types */
+    char *entry;                /* entry within the .codadef file */
+    long line;                  /* line number within the entry */
+    const char *element;        /* name of the xml element that contains the expression */
+    int64_t num_evaluations;
+    double total_time;          /* includes time spent in evaluations of other profiled expressions */
+    double self_time;           /* excludes time spent in evaluations of other profiled expressions */
+    struct coda_expression_profile_struct *prev;
+    struct coda_expression_profile_struct *next;
+};
+typedef struct coda_expression_profile_struct coda_expression_profile;
+
 struct coda_expression_struct
 {
     coda_expression_node_type tag;
     coda_expression_type result_type;
     int is_constant;
+    struct coda_expression_profile_struct *profile;
 };
 
 struct coda_expression_bool_constant_struct
@@ -138,6 +159,7 @@ struct coda_expression_bool_constant_struct
     coda_expression_node_type tag;
     coda_expression_type result_type;
     int is_constant;
+    struct coda_expression_profile_struct *profile;
     int value;
 };
 typedef struct coda_expression_bool_constant_struct coda_expression_bool_constant;
@@ -147,6 +169,7 @@ struct coda_expression_float_constant_struct
     coda_expression_node_type tag;
     coda_expression_type result_type;
     int is_constant;
+    struct coda_expression_profile_struct *profile;
     double value;
 };
 typedef struct coda_expression_float_constant_struct coda_expression_float_constant;
@@ -156,6 +179,7 @@ struct coda_expression_integer_constant_struct
     coda_expression_node_type tag;
     coda_expression_type result_type;
     int is_constant;
+    struct coda_expression_profile_struct *profile;
     int64_t value;
 };
 typedef struct coda_expression_integer_constant_struct coda_expression_integer_constant;
@@ -165,6 +189,7 @@ struct coda_expression_string_constant_struct
     coda_expression_node_type tag;
     coda_expression_type result_type;
     int is_constant;
+    struct coda_expression_profile_struct *profile;
     long length;
     char *value;
 };
@@ -175,6 +200,7 @@ struct coda_expression_operation_struct
     coda_expression_node_type tag;
     coda_expression_type result_type;
     int is_constant;
+    struct coda_expression_profile_struct *profile;
     char *identifier;
     coda_expression *operand[4];
 };
@@ -184,4 +210,11 @@ typedef struct coda_expression_operation_struct coda_expression_operation;
 coda_expression *coda_expression_new(coda_expression_node_type tag, char *string_value, coda_expression *op1,
                                      coda_expression *op2, coda_expression *op3, coda_expression *op4);
 
+int coda_expression_depends_on_node(const coda_expression *expr, int depth);
+LIBCODA_API int coda_expression_eval_string_to_buffer(const coda_expression *expr, const coda_cursor *cursor,
+                                                      char **buffer, long *buffer_size, long *length);
+int coda_expression_set_source(coda_expression *expr, const struct coda_product_class_struct *product_class,
+                               const coda_product_definition *product_definition, const char *entry, long line,
+                               const char *element);
+
 #endif
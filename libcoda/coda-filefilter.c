@@ -30,6 +30,8 @@
  */
 
 #include "coda-filefilter.h"
+#include "coda-definition.h"
+#include "coda-expr.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -41,6 +43,11 @@
 #ifdef HAVE_DIRENT_H
 #include <dirent.h>
 #endif
+#if defined(HAVE_PTHREAD) && !defined(WIN32)
+#include <pthread.h>
+/* the parallel directory walk uses the POSIX directory functions */
+#define PARALLEL_MATCH
+#endif
 
 #define NAME_BLOCK_SIZE 1024
 
@@ -51,12 +58,190 @@ typedef struct NameBuffer_struct
     char *buffer;
 } NameBuffer;
 
+/* A file is matched against a filter in stages, where each stage makes more information about the file available.
+ * Each stage is only performed if the filter could not be decided by the previous stages.
+ */
+typedef enum match_stage_enum
+{
+    match_stage_name,   /* the path of the file */
+    match_stage_stat,   /* the size of the file from the directory entry */
+    match_stage_recognize,      /* the format and product class/type/version of the file (from product recognition) */
+    match_stage_open    /* the content of the product (requires a full open of the product) */
+} match_stage;
+
 THREAD_LOCAL ff_expr *coda_filefilter_tree;
 
 static int coda_match_filepath(int ignore_other_file_types, coda_expression *expr, NameBuffer *path_name,
                                int (*callback) (const char *, coda_filefilter_status, const char *, void *),
                                void *userdata);
 
+/* returns the first stage in which the (sub)expression can be evaluated */
+static match_stage get_match_stage(const coda_expression *expr)
+{
+    const coda_expression_operation *opexpr;
+    match_stage stage = match_stage_name;
+    match_stage operand_stage;
+    int i;
+
+    switch (expr->tag)
+    {
+        case expr_constant_boolean:
+        case expr_constant_float:
+        case expr_constant_integer:
+        case expr_constant_rawstring:
+        case expr_constant_string:
+        case expr_filename:
+            return match_stage_name;
+        case expr_file_size:
+            /* filesize() is the size of the uncompressed data for gzip compressed files */
+            return coda_get_option_decompress_gzip() ? match_stage_recognize : match_stage_stat;
+        case expr_product_class:
+        case expr_product_format:
+        case expr_product_type:
+        case expr_product_version:
+            return match_stage_recognize;
+        case expr_abs:
+        case expr_add:
+        case expr_and:
+        case expr_ceil:
+        case expr_divide:
+        case expr_equal:
+        case expr_float:
+        case expr_floor:
+        case expr_greater_equal:
+        case expr_greater:
+        case expr_if:
+        case expr_integer:
+        case expr_isinf:
+        case expr_ismininf:
+        case expr_isnan:
+        case expr_isplusinf:
+        case expr_length:
+        case expr_less_equal:
+        case expr_less:
+        case expr_logical_and:
+        case expr_logical_or:
+        case expr_ltrim:
+        case expr_max:
+        case expr_min:
+        case expr_modulo:
+        case expr_multiply:
+        case expr_neg:
+        case expr_not_equal:
+        case expr_not:
+        case expr_or:
+        case expr_power:
+        case expr_regex:
+        case expr_round:
+        case expr_rtrim:
+        case expr_string:
+        case expr_strtime:
+        case expr_substr:
+        case expr_subtract:
+        case expr_time:
+        case expr_trim:
+            /* these only depend on their operands (any operand that refers to the product content is a node
+             * expression, which requires the product to be opened)
+             */
+            break;
+        default:
+            return match_stage_open;
+    }
+
+    opexpr = (const coda_expression_operation *)expr;
+    for (i = 0; i < 4; i++)
+    {
+        if (opexpr->operand[i] != NULL)
+        {
+            operand_stage = get_match_stage(opexpr->operand[i]);
+            if (operand_stage > stage)
+            {
+                stage = operand_stage;
+            }
+        }
+    }
+
+    return stage;
+}
+
+/* returns whether the result of the recognition stage can decide (part of) the filter */
+static int recognition_can_decide(const coda_expression *expr)
+{
+    const coda_expression_operation *opexpr;
+    match_stage stage;
+
+    stage = get_match_stage(expr);
+    if (stage != match_stage_open)
+    {
+        return stage == match_stage_recognize;
+    }
+    opexpr = (const coda_expression_operation *)expr;
+    switch (expr->tag)
+    {
+        case expr_logical_and:
+        case expr_logical_or:
+            return recognition_can_decide(opexpr->operand[0]) || recognition_can_decide(opexpr->operand[1]);
+        case expr_not:
+            return recognition_can_decide(opexpr->operand[0]);
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+/* Evaluate the filter using only the information that is available up to the given stage.
+ * 'cursor' should point to a product that only has the information for that stage set.
+ * Sets 'result' to 0 (no match), 1 (match), or -1 (result can not be determined yet).
+ */
+static void eval_match_stage(const coda_expression *expr, match_stage stage, const coda_cursor *cursor, int *result)
+{
+    const coda_expression_operation *opexpr;
+    int result1;
+    int result2;
+
+    if (get_match_stage(expr) <= stage)
+    {
+        if (coda_expression_eval_bool(expr, cursor, result) != 0)
+        {
+            /* leave it to the evaluation on the opened product to report the error */
+            *result = -1;
+        }
+        return;
+    }
+
+    *result = -1;
+    opexpr = (const coda_expression_operation *)expr;
+    switch (expr->tag)
+    {
+        case expr_logical_and:
+            eval_match_stage(opexpr->operand[0], stage, cursor, &result1);
+            eval_match_stage(opexpr->operand[1], stage, cursor, &result2);
+            if (result1 == 0 || result2 == 0)
+            {
+                *result = 0;
+            }
+            break;
+        case expr_logical_or:
+            eval_match_stage(opexpr->operand[0], stage, cursor, &result1);
+            eval_match_stage(opexpr->operand[1], stage, cursor, &result2);
+            if (result1 == 1 || result2 == 1)
+            {
+                *result = 1;
+            }
+            break;
+        case expr_not:
+            eval_match_stage(opexpr->operand[0], stage, cursor, &result1);
+            if (result1 != -1)
+            {
+                *result = !result1;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
 static void name_buffer_init(NameBuffer *name)
 {
     assert(name != NULL);
@@ -107,14 +292,90 @@ static void append_string_to_name_buffer(NameBuffer *name, const char *str)
     name->length += length;
 }
 
-static int coda_match_file(coda_expression *expr, NameBuffer *path_name,
+static int report_open_error(NameBuffer *path_name,
+                             int (*callback) (const char *, coda_filefilter_status, const char *, void *),
+                             void *userdata)
+{
+    if (coda_errno == CODA_ERROR_UNSUPPORTED_PRODUCT)
+    {
+        return callback(path_name->buffer, coda_ffs_unsupported_file, NULL, userdata);
+    }
+    return callback(path_name->buffer, coda_ffs_could_not_open_file, coda_errno_to_string(coda_errno), userdata);
+}
+
+static int coda_match_file(coda_expression *expr, NameBuffer *path_name, int64_t file_size,
                            int (*callback) (const char *, coda_filefilter_status, const char *, void *), void *userdata)
 {
+    coda_product file_info;
     coda_product *product;
     coda_cursor cursor;
+    match_stage stage;
     int filter_result;
     int result;
 
+    /* first try to decide the filter using only the name and size of the file, then using the result of the product
+     * recognition, and only open the product if the filter really needs its content
+     */
+    stage = get_match_stage(expr);
+    memset(&file_info, 0, sizeof(coda_product));
+    file_info.filename = path_name->buffer;
+    file_info.file_size = file_size;
+    cursor.product = &file_info;
+    cursor.n = 0;
+    eval_match_stage(expr, match_stage_stat, &cursor, &filter_result);
+    if (filter_result == 0)
+    {
+        /* no need to find out whether the file is a supported product */
+        return callback(path_name->buffer, coda_ffs_no_match, NULL, userdata);
+    }
+
+    if (stage != match_stage_open || recognition_can_decide(expr))
+    {
+        coda_product_definition *definition = NULL;
+        const char *product_class;
+        const char *product_type;
+        int version;
+
+        /* this stage is also needed for a positive match, since only supported products can match */
+        result = coda_recognize_file(path_name->buffer, &file_info.file_size, &file_info.format, &product_class,
+                                     &product_type, &version);
+        if (result != 0 && coda_errno == CODA_ERROR_FILE_OPEN)
+        {
+            coda_set_option_use_mmap(0);
+            result = coda_recognize_file(path_name->buffer, &file_info.file_size, &file_info.format,
+                                         &product_class, &product_type, &version);
+            coda_set_option_use_mmap(1);
+        }
+        if (result != 0)
+        {
+            return report_open_error(path_name, callback, userdata);
+        }
+        if (product_class == NULL)
+        {
+            if (file_info.format == coda_format_ascii || file_info.format == coda_format_binary)
+            {
+                /* coda_open() does not support ascii/binary files without a definition */
+                return callback(path_name->buffer, coda_ffs_unsupported_file, NULL, userdata);
+            }
+        }
+        else
+        {
+            if (coda_data_dictionary_get_definition(product_class, product_type, version, &definition) != 0)
+            {
+                return callback(path_name->buffer, coda_ffs_error, coda_errno_to_string(coda_errno), userdata);
+            }
+            file_info.product_definition = definition;
+        }
+        if (filter_result == -1)
+        {
+            eval_match_stage(expr, match_stage_recognize, &cursor, &filter_result);
+        }
+        if (filter_result != -1)
+        {
+            return callback(path_name->buffer, filter_result ? coda_ffs_match : coda_ffs_no_match, NULL, userdata);
+        }
+    }
+
     result = coda_open(path_name->buffer, &product);
     if (result != 0 && coda_errno == CODA_ERROR_FILE_OPEN)
     {
@@ -127,15 +388,7 @@ static int coda_match_file(coda_expression *expr, NameBuffer *path_name,
     }
     if (result != 0)
     {
-        if (coda_errno == CODA_ERROR_UNSUPPORTED_PRODUCT)
-        {
-            return callback(path_name->buffer, coda_ffs_unsupported_file, NULL, userdata);
-        }
-        else
-        {
-            return callback(path_name->buffer, coda_ffs_could_not_open_file, coda_errno_to_string(coda_errno),
-                            userdata);
-        }
+        return report_open_error(path_name, callback, userdata);
     }
 
     if (coda_cursor_set_product(&cursor, product) != 0)
@@ -145,6 +398,7 @@ static int coda_match_file(coda_expression *expr, NameBuffer *path_name,
     }
     if (coda_expression_eval_bool(expr, &cursor, &filter_result) != 0)
     {
+        coda_close(product);
         return callback(path_name->buffer, coda_ffs_error, coda_errno_to_string(coda_errno), userdata);
     }
     coda_close(product);
@@ -209,7 +463,9 @@ static int coda_match_dir(coda_expression *expr, NameBuffer *path_name,
             }
             else
             {
-                result = coda_match_file(expr, path_name, callback, userdata);
+                result = coda_match_file(expr, path_name,
+                                         ((int64_t)FileData.nFileSizeHigh << 32) | FileData.nFileSizeLow, callback,
+                                         userdata);
                 if (result != 0)
                 {
                     FindClose(hSearch);
@@ -301,7 +557,7 @@ static int coda_match_filepath(int ignore_other_file_types, coda_expression *exp
     }
     else if (sb.st_mode & S_IFREG)
     {
-        return coda_match_file(expr, path_name, callback, userdata);
+        return coda_match_file(expr, path_name, (int64_t)sb.st_size, callback, userdata);
     }
     else if (!ignore_other_file_types)
     {
@@ -311,6 +567,577 @@ static int coda_match_filepath(int ignore_other_file_types, coda_expression *exp
     return 0;
 }
 
+static int get_filter_expression(const char *filefilter, coda_expression **expr)
+{
+    coda_expression_type result_type;
+
+    if (filefilter == NULL || filefilter[0] == '\0')
+    {
+        filefilter = "true";
+    }
+
+    if (coda_expression_from_string(filefilter, expr) != 0)
+    {
+        return -1;
+    }
+    if (coda_expression_get_type(*expr, &result_type) != 0)
+    {
+        coda_expression_delete(*expr);
+        return -1;
+    }
+    if (result_type != coda_expression_boolean)
+    {
+        coda_set_error(CODA_ERROR_EXPRESSION, "expression does not result in a boolean value");
+        coda_expression_delete(*expr);
+        return -1;
+    }
+
+    return 0;
+}
+
+#ifdef PARALLEL_MATCH
+
+/* file or directory that is processed by one of the worker threads of a parallel match */
+typedef struct match_node_struct
+{
+    char *path;
+    int ignore_other_file_types;
+    int done;
+    int has_status;     /* directories only get a status if they could not be read */
+    coda_filefilter_status status;
+    char *error;
+    int num_children;   /* entries of a directory, in the order in which a sequential walk would visit them */
+    struct match_node_struct **child;
+    struct match_node_struct *next;     /* next node in the list of pending or finished nodes */
+} match_node;
+
+typedef struct match_pool_struct
+{
+    coda_thread_settings settings;
+    const char *filefilter;
+    int ordered;
+    pthread_mutex_t mutex;
+    pthread_cond_t task_available;
+    pthread_cond_t task_done;
+    int terminate;
+    match_node *pending;        /* stack of nodes that still need to be processed */
+    match_node *finished;       /* (unordered only) queue of processed nodes that still need to be reported */
+    match_node *last_finished;
+    int num_busy_threads;
+} match_pool;
+
+static void match_node_delete(match_node *node)
+{
+    int i;
+
+    if (node->child != NULL)
+    {
+        for (i = 0; i < node->num_children; i++)
+        {
+            if (node->child[i] != NULL)
+            {
+                match_node_delete(node->child[i]);
+            }
+        }
+        free(node->child);
+    }
+    if (node->path != NULL)
+    {
+        free(node->path);
+    }
+    if (node->error != NULL)
+    {
+        free(node->error);
+    }
+    free(node);
+}
+
+static match_node *match_node_new(const char *path, const char *name, int ignore_other_file_types)
+{
+    match_node *node;
+
+    node = (match_node *)malloc(sizeof(match_node));
+    if (node == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)sizeof(match_node), __FILE__, __LINE__);
+        return NULL;
+    }
+    memset(node, 0, sizeof(match_node));
+    node->ignore_other_file_types = ignore_other_file_types;
+    if (path != NULL)
+    {
+        long length = (long)strlen(path);
+
+        if (name != NULL)
+        {
+            length += 1 + (long)strlen(name);
+        }
+        node->path = (char *)malloc(length + 1);
+        if (node->path == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           length + 1, __FILE__, __LINE__);
+            free(node);
+            return NULL;
+        }
+        strcpy(node->path, path);
+        if (name != NULL)
+        {
+            strcat(node->path, "/");
+            strcat(node->path, name);
+        }
+    }
+
+    return node;
+}
+
+static int match_node_add_child(match_node *node, match_node *child)
+{
+    if (node->num_children % 64 == 0)
+    {
+        match_node **new_child;
+
+        new_child = (match_node **)realloc(node->child, (node->num_children + 64) * sizeof(match_node *));
+        if (new_child == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (long)((node->num_children + 64) * sizeof(match_node *)), __FILE__, __LINE__);
+            return -1;
+        }
+        node->child = new_child;
+    }
+    node->child[node->num_children] = child;
+    node->num_children++;
+
+    return 0;
+}
+
+static int set_match_node_status(const char *filepath, coda_filefilter_status status, const char *error,
+                                 void *userdata)
+{
+    match_node *node = (match_node *)userdata;
+
+    (void)filepath;
+    node->has_status = 1;
+    node->status = status;
+    if (error != NULL)
+    {
+        node->error = strdup(error);
+    }
+
+    return 0;
+}
+
+static void read_match_dir(match_node *node)
+{
+    DIR *dirp;
+    struct dirent *dp;
+
+    dirp = opendir(node->path);
+    if (dirp == NULL)
+    {
+        set_match_node_status(node->path, coda_ffs_could_not_access_directory, "could not recurse into directory",
+                              node);
+        return;
+    }
+    while ((dp = readdir(dirp)) != NULL)
+    {
+        match_node *child;
+
+        if (strcmp(dp->d_name, ".") == 0 || strcmp(dp->d_name, "..") == 0)
+        {
+            continue;
+        }
+        child = match_node_new(node->path, dp->d_name, 1);
+        if (child == NULL)
+        {
+            set_match_node_status(node->path, coda_ffs_error, coda_errno_to_string(coda_errno), node);
+            break;
+        }
+        if (match_node_add_child(node, child) != 0)
+        {
+            match_node_delete(child);
+            set_match_node_status(node->path, coda_ffs_error, coda_errno_to_string(coda_errno), node);
+            break;
+        }
+    }
+    closedir(dirp);
+}
+
+/* same as coda_match_filepath(), but the entries of a directory are added as children of the node instead of being
+ * processed directly
+ */
+static void process_match_node(match_node *node, coda_expression *expr, const char *init_error,
+                               NameBuffer *path_name)
+{
+    struct stat sb;
+
+    if (expr == NULL)
+    {
+        /* CODA could not be initialized for this thread */
+        set_match_node_status(node->path, coda_ffs_error, init_error, node);
+        return;
+    }
+    if (stat(node->path, &sb) != 0)
+    {
+        if (errno == ENOENT || errno == ENOTDIR)
+        {
+            set_match_node_status(node->path, coda_ffs_error, "no such file or directory", node);
+        }
+        else
+        {
+            set_match_node_status(node->path, coda_ffs_error, strerror(errno), node);
+        }
+        return;
+    }
+
+    if (sb.st_mode & S_IFDIR)
+    {
+        read_match_dir(node);
+    }
+    else if (sb.st_mode & S_IFREG)
+    {
+        path_name->length = 0;
+        path_name->buffer[0] = '\0';
+        append_string_to_name_buffer(path_name, node->path);
+        coda_match_file(expr, path_name, (int64_t)sb.st_size, set_match_node_status, node);
+        coda_set_error(CODA_SUCCESS, NULL);
+    }
+    else if (!node->ignore_other_file_types)
+    {
+        set_match_node_status(node->path, coda_ffs_error, "not a directory or regular file", node);
+    }
+}
+
+static void *match_worker(void *userdata)
+{
+    match_pool *pool = (match_pool *)userdata;
+    coda_expression *expr = NULL;
+    char *init_error = NULL;
+    NameBuffer path_name;
+    int initialized = 0;
+    int i;
+
+    if (coda_thread_init(&pool->settings) == 0)
+    {
+        initialized = 1;
+        if (coda_expression_from_string(pool->filefilter, &expr) != 0)
+        {
+            expr = NULL;
+        }
+    }
+    if (expr == NULL)
+    {
+        init_error = strdup(coda_errno_to_string(coda_errno));
+        coda_set_error(CODA_SUCCESS, NULL);
+    }
+    name_buffer_init(&path_name);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (!pool->terminate)
+    {
+        match_node *node = pool->pending;
+
+        if (node == NULL)
+        {
+            if (pool->num_busy_threads == 0)
+            {
+                /* all nodes are processed and no new nodes can be added anymore */
+                break;
+            }
+            pthread_cond_wait(&pool->task_available, &pool->mutex);
+            continue;
+        }
+        pool->pending = node->next;
+        node->next = NULL;
+        pool->num_busy_threads++;
+        pthread_mutex_unlock(&pool->mutex);
+
+        process_match_node(node, expr, init_error, &path_name);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->num_busy_threads--;
+        /* push the entries in reverse order, such that the walk stays close to the order of a sequential walk */
+        for (i = node->num_children - 1; i >= 0; i--)
+        {
+            node->child[i]->next = pool->pending;
+            pool->pending = node->child[i];
+        }
+        if (!pool->ordered)
+        {
+            /* the nodes are only reachable via the list of pending nodes from now on */
+            if (node->child != NULL)
+            {
+                free(node->child);
+                node->child = NULL;
+                node->num_children = 0;
+            }
+            if (node->has_status)
+            {
+                if (pool->last_finished == NULL)
+                {
+                    pool->finished = node;
+                }
+                else
+                {
+                    pool->last_finished->next = node;
+                }
+                pool->last_finished = node;
+            }
+            else
+            {
+                match_node_delete(node);
+                node = NULL;
+            }
+        }
+        if (node != NULL)
+        {
+            node->done = 1;
+        }
+        pthread_cond_broadcast(&pool->task_available);
+        pthread_cond_broadcast(&pool->task_done);
+    }
+    /* make sure the other threads also notice that all nodes are processed */
+    pthread_cond_broadcast(&pool->task_available);
+    pthread_cond_broadcast(&pool->task_done);
+    pthread_mutex_unlock(&pool->mutex);
+
+    name_buffer_done(&path_name);
+    if (expr != NULL)
+    {
+        coda_expression_delete(expr);
+    }
+    if (init_error != NULL)
+    {
+        free(init_error);
+    }
+    if (initialized)
+    {
+        coda_done();
+    }
+
+    return NULL;
+}
+
+/* report the results of a node and its children in the order of a sequential walk */
+static int report_match_node_ordered(match_pool *pool, match_node *node,
+                                     int (*callback) (const char *, coda_filefilter_status, const char *, void *),
+                                     void *userdata)
+{
+    int result;
+    int i;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (!node->done)
+    {
+        pthread_cond_wait(&pool->task_done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (node->has_status)
+    {
+        result = callback(node->path, node->status, node->error, userdata);
+        if (result != 0)
+        {
+            return result;
+        }
+    }
+    for (i = 0; i < node->num_children; i++)
+    {
+        result = report_match_node_ordered(pool, node->child[i], callback, userdata);
+        if (result != 0)
+        {
+            return result;
+        }
+        /* the worker threads are done with this part of the tree, so we can already free it */
+        match_node_delete(node->child[i]);
+        node->child[i] = NULL;
+    }
+
+    return 0;
+}
+
+/* report the results of the nodes in the order in which they are finished */
+static int report_match_nodes_unordered(match_pool *pool,
+                                        int (*callback) (const char *, coda_filefilter_status, const char *,
+                                                         void *), void *userdata)
+{
+    int result = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;)
+    {
+        match_node *node;
+
+        while (pool->finished == NULL && (pool->pending != NULL || pool->num_busy_threads > 0))
+        {
+            pthread_cond_wait(&pool->task_done, &pool->mutex);
+        }
+        node = pool->finished;
+        if (node == NULL)
+        {
+            break;
+        }
+        pool->finished = node->next;
+        if (pool->finished == NULL)
+        {
+            pool->last_finished = NULL;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+        result = callback(node->path, node->status, node->error, userdata);
+        match_node_delete(node);
+        pthread_mutex_lock(&pool->mutex);
+        if (result != 0)
+        {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return result;
+}
+
+static void delete_match_node_list(match_node *node)
+{
+    while (node != NULL)
+    {
+        match_node *next = node->next;
+
+        match_node_delete(node);
+        node = next;
+    }
+}
+
+/* returns 1 if no worker threads could be started */
+static int match_parallel(const char *filefilter, int num_filepaths, const char **filepathlist, int num_threads,
+                          int ordered, int (*callback) (const char *, coda_filefilter_status, const char *, void *),
+                          void *userdata, int *result)
+{
+    match_pool pool;
+    match_node *root;
+    pthread_t *thread;
+    int num_running_threads = 0;
+    int i;
+
+    thread = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+    if (thread == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)(num_threads * sizeof(pthread_t)), __FILE__, __LINE__);
+        return -1;
+    }
+
+    /* the paths that are passed by the user become the children of a root node without a path */
+    root = match_node_new(NULL, NULL, 0);
+    if (root == NULL)
+    {
+        free(thread);
+        return -1;
+    }
+    root->done = 1;
+    for (i = 0; i < num_filepaths; i++)
+    {
+        match_node *node;
+
+        node = match_node_new(filepathlist[i], NULL, 0);
+        if (node == NULL)
+        {
+            match_node_delete(root);
+            free(thread);
+            return -1;
+        }
+        if (match_node_add_child(root, node) != 0)
+        {
+            match_node_delete(node);
+            match_node_delete(root);
+            free(thread);
+            return -1;
+        }
+    }
+
+    memset(&pool, 0, sizeof(match_pool));
+    if (coda_thread_settings_get(&pool.settings) != 0)
+    {
+        match_node_delete(root);
+        free(thread);
+        return -1;
+    }
+    pool.filefilter = filefilter;
+    pool.ordered = ordered;
+    pthread_mutex_init(&pool.mutex, NULL);
+    pthread_cond_init(&pool.task_available, NULL);
+    pthread_cond_init(&pool.task_done, NULL);
+    for (i = root->num_children - 1; i >= 0; i--)
+    {
+        root->child[i]->next = pool.pending;
+        pool.pending = root->child[i];
+    }
+    if (!ordered)
+    {
+        free(root->child);
+        root->child = NULL;
+        root->num_children = 0;
+    }
+
+    for (i = 0; i < num_threads; i++)
+    {
+        if (pthread_create(&thread[num_running_threads], NULL, match_worker, &pool) == 0)
+        {
+            num_running_threads++;
+        }
+    }
+
+    if (num_running_threads > 0)
+    {
+        if (ordered)
+        {
+            *result = report_match_node_ordered(&pool, root, callback, userdata);
+        }
+        else
+        {
+            *result = report_match_nodes_unordered(&pool, callback, userdata);
+        }
+
+        /* stop the threads (in case the callback function stopped the processing) */
+        pthread_mutex_lock(&pool.mutex);
+        pool.terminate = 1;
+        pthread_cond_broadcast(&pool.task_available);
+        pthread_mutex_unlock(&pool.mutex);
+        for (i = 0; i < num_running_threads; i++)
+        {
+            pthread_join(thread[i], NULL);
+        }
+    }
+
+    if (ordered)
+    {
+        /* any remaining (pending) nodes are still part of the tree */
+        match_node_delete(root);
+    }
+    else
+    {
+        delete_match_node_list(pool.pending);
+        delete_match_node_list(pool.finished);
+        match_node_delete(root);
+    }
+    pthread_cond_destroy(&pool.task_done);
+    pthread_cond_destroy(&pool.task_available);
+    pthread_mutex_destroy(&pool.mutex);
+    coda_thread_settings_done(&pool.settings);
+    free(thread);
+
+    if (num_running_threads == 0)
+    {
+        /* let the caller fall back to a sequential match */
+        return 1;
+    }
+
+    return 0;
+}
+
+#endif
+
 /** \addtogroup coda_general
  * @{
  */
@@ -321,6 +1148,12 @@ static int coda_match_filepath(int ignore_other_file_types, coda_expression *exp
  * also included with the CODA package. If you leave \a filefilter empty or pass a NULL pointer then each file that
  * can be opened by CODA will be matched positively (this has the same effect as if you had passed a filefilter "true").
  *
+ * Files are only opened if this is needed to evaluate the filter. Parts of the filter that only use filename() and
+ * filesize() are evaluated first, and files that are rejected by these parts are reported as #coda_ffs_no_match
+ * without checking whether they are supported. Next, parts that use productclass(), producttype(), productversion(),
+ * and productformat() are evaluated using the result of the product recognition (see coda_recognize_file()). Only if
+ * the filter still can not be decided, the product is opened and the full filter is evaluated.
+ *
  * The names of the files and directories need to be passed as an array of full/relative paths. If an entry is a
  * directory then all files and directories that are contained inside will be added to the filter matching. Directories
  * within directories are processed recursively.
@@ -376,7 +1209,6 @@ LIBCODA_API int coda_match_filefilter(const char *filefilter, int num_filepaths,
                                       void *userdata)
 {
     NameBuffer path_name;
-    coda_expression_type result_type;
     coda_expression *expr;
     int result;
     int i;
@@ -387,26 +1219,10 @@ LIBCODA_API int coda_match_filefilter(const char *filefilter, int num_filepaths,
         return -1;
     }
 
-    if (filefilter == NULL || filefilter[0] == '\0')
-    {
-        filefilter = "true";
-    }
-
-    if (coda_expression_from_string(filefilter, &expr) != 0)
+    if (get_filter_expression(filefilter, &expr) != 0)
     {
         return -1;
     }
-    if (coda_expression_get_type(expr, &result_type) != 0)
-    {
-        coda_expression_delete(expr);
-        return -1;
-    }
-    if (result_type != coda_expression_boolean)
-    {
-        coda_set_error(CODA_ERROR_EXPRESSION, "expression does not result in a boolean value");
-        coda_expression_delete(expr);
-        return -1;
-    }
 
     name_buffer_init(&path_name);
     for (i = 0; i < num_filepaths; i++)
@@ -432,3 +1248,58 @@ LIBCODA_API int coda_match_filefilter(const char *filefilter, int num_filepaths,
 /**
  * @}
  */
+
+/* Same as coda_match_filefilter(), but files are matched in parallel by a pool of num_threads worker threads.
+ * The worker threads also read the directories that need to be searched. Each worker thread initializes CODA itself,
+ * using the definition path and options of the calling thread. The callback function is always called from the
+ * calling thread. If ordered is set, the files are reported in the same order as coda_match_filefilter() would
+ * report them. Otherwise each file is reported as soon as it has been matched. If CODA is built without thread support
+ * or if num_threads <= 1 this function behaves as coda_match_filefilter().
+ */
+LIBCODA_API int coda_match_filefilter_parallel(const char *filefilter, int num_filepaths, const char **filepathlist,
+                                               int num_threads, int ordered,
+                                               int (*callbackfunc) (const char *, coda_filefilter_status,
+                                                                    const char *, void *), void *userdata)
+{
+#ifdef PARALLEL_MATCH
+    coda_expression *expr;
+    int result = 0;
+
+    if (num_threads <= 1)
+    {
+        return coda_match_filefilter(filefilter, num_filepaths, filepathlist, callbackfunc, userdata);
+    }
+    if (num_filepaths <= 0 || filepathlist == NULL || callbackfunc == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid argument (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    /* check the filter before starting any threads */
+    if (get_filter_expression(filefilter, &expr) != 0)
+    {
+        return -1;
+    }
+    coda_expression_delete(expr);
+    if (filefilter == NULL || filefilter[0] == '\0')
+    {
+        filefilter = "true";
+    }
+
+    switch (match_parallel(filefilter, num_filepaths, filepathlist, num_threads, ordered, callbackfunc, userdata,
+                           &result))
+    {
+        case 0:
+            return result;
+        case 1:
+            return coda_match_filefilter(filefilter, num_filepaths, filepathlist, callbackfunc, userdata);
+        default:
+            return -1;
+    }
+#else
+    (void)num_threads;
+    (void)ordered;
+
+    return coda_match_filefilter(filefilter, num_filepaths, filepathlist, callbackfunc, userdata);
+#endif
+}
@@ -136,6 +136,92 @@ int coda_grib_cursor_get_array_dim(const coda_cursor *cursor, int *num_dims, lon
     return coda_grib_cursor_get_num_elements(cursor, dim);
 }
 
+/* number of packed values that read_simple_packed_values() unpacks at once */
+#define PACKED_VALUES_BLOCK_SIZE 512
+
+/* translate the index of an array element into the index of its value in the packed data (taking the bitmask into
+ * account); the bitmask value for the element should be 1 */
+static long get_packed_value_index(const coda_grib_value_array *array, long index)
+{
+    long bm_index = index >> 3;
+    long value_index = 0;
+    uint8_t bm;
+    long i;
+
+    for (i = 0; i < bm_index >> 4; i++)
+    {
+        /* advance value_index based on cumsum of blocks of 128 bitmap bits (= 16 bytes) */
+        value_index += array->bitmask_cumsum128[16 * i + 15];
+    }
+    if (bm_index % 16 != 0)
+    {
+        value_index += array->bitmask_cumsum128[bm_index - 1];
+    }
+    bm = array->bitmask[bm_index];
+    for (i = 0; i < (index & 0x7); i++)
+    {
+        value_index += (bm >> (7 - i)) & 1;
+    }
+
+    return value_index;
+}
+
+/* read a range of elements of a simple packed array with a non-zero element bit size */
+static int read_simple_packed_values(const coda_grib_product *product, const coda_grib_value_array *array,
+                                     long offset, long length, float *dst)
+{
+    uint64_t buffer[PACKED_VALUES_BLOCK_SIZE];
+    long num_buffered = 0;
+    long buffer_index = 0;
+    long value_index = offset;
+    long num_values = length;   /* number of packed values that still need to be read */
+    long i;
+
+    if (array->bitmask != NULL)
+    {
+        num_values = 0;
+        for (i = offset; i < offset + length; i++)
+        {
+            if ((array->bitmask[i >> 3] >> (7 - (i & 0x7))) & 1)
+            {
+                if (num_values == 0)
+                {
+                    value_index = get_packed_value_index(array, i);
+                }
+                num_values++;
+            }
+        }
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        long index = offset + i;
+
+        if (array->bitmask != NULL && !((array->bitmask[index >> 3] >> (7 - (index & 0x7))) & 1))
+        {
+            /* bitmask value is 0 -> return NaN */
+            dst[i] = (float)coda_NaN();
+            continue;
+        }
+        if (buffer_index == num_buffered)
+        {
+            num_buffered = num_values < PACKED_VALUES_BLOCK_SIZE ? num_values : PACKED_VALUES_BLOCK_SIZE;
+            if (read_packed_bits(product->raw_product, array->bit_offset + value_index * array->element_bit_size,
+                                 array->element_bit_size, num_buffered, buffer) != 0)
+            {
+                return -1;
+            }
+            value_index += num_buffered;
+            num_values -= num_buffered;
+            buffer_index = 0;
+        }
+        dst[i] = (float)((int64_t)buffer[buffer_index] * array->scalefactor + array->offset);
+        buffer_index++;
+    }
+
+    return 0;
+}
+
 int coda_grib_cursor_read_float(const coda_cursor *cursor, float *dst)
 {
     coda_grib_value_array *array;
@@ -157,14 +243,7 @@ int coda_grib_cursor_read_float(const coda_cursor *cursor, float *dst)
         }
         if (array->bitmask != NULL)
         {
-            uint8_t bm;
-            long bm_index;
-            long value_index = 0;
-            long i;
-
-            bm_index = index >> 3;
-            bm = array->bitmask[bm_index];
-            if (!((bm >> (7 - (index & 0x7))) & 1))
+            if (!((array->bitmask[index >> 3] >> (7 - (index & 0x7))) & 1))
             {
                 /* bitmask value is 0 -> return NaN */
                 *((float *)dst) = (float)coda_NaN();
@@ -172,21 +251,7 @@ int coda_grib_cursor_read_float(const coda_cursor *cursor, float *dst)
             }
 
             /* bitmask value is 1 -> update index to be the index in the value array */
-            for (i = 0; i < bm_index >> 4; i++)
-            {
-                /* advance value_index based on cumsum of blocks of 128 bitmap bits (= 16 bytes) */
-                value_index += array->bitmask_cumsum128[16 * i + 15];
-            }
-            if (bm_index % 16 != 0)
-            {
-                value_index += array->bitmask_cumsum128[bm_index - 1];
-            }
-            bm = array->bitmask[bm_index];
-            for (i = 0; i < (index & 0x7); i++)
-            {
-                value_index += (bm >> (7 - i)) & 1;
-            }
-            index = value_index;
+            index = get_packed_value_index(array, index);
         }
         buffer = &((uint8_t *)&ivalue)[8 - bit_size_to_byte_size(array->element_bit_size)];
         if (read_bits(((coda_grib_product *)cursor->product)->raw_product,
@@ -218,6 +283,11 @@ int coda_grib_cursor_read_float_array(const coda_cursor *cursor, float *dst)
 {
     coda_grib_value_array *array = (coda_grib_value_array *)cursor->stack[cursor->n - 1].type;
 
+    if (array->simple_packing && array->element_bit_size > 0)
+    {
+        return read_simple_packed_values((coda_grib_product *)cursor->product, array, 0, array->num_elements, dst);
+    }
+
     if (array->num_elements > 0)
     {
         coda_cursor element_cursor = *cursor;
@@ -243,6 +313,11 @@ int coda_grib_cursor_read_float_partial_array(const coda_cursor *cursor, long of
 {
     coda_grib_value_array *array = (coda_grib_value_array *)cursor->stack[cursor->n - 1].type;
 
+    if (array->simple_packing && array->element_bit_size > 0)
+    {
+        return read_simple_packed_values((coda_grib_product *)cursor->product, array, offset, length, dst);
+    }
+
     if (array->num_elements > 0)
     {
         coda_cursor element_cursor = *cursor;
@@ -69,6 +69,9 @@ typedef struct coda_grib_product_struct
     int64_t **product_variable;
     int64_t mem_size;
     uint8_t *mem_ptr;
+#ifdef ENABLE_STATISTICS
+    coda_statistics statistics;
+#endif
 
     /* 'grib' product specific fields */
     coda_product *raw_product;
@@ -35,6 +35,7 @@
 #include "coda-mem-internal.h"
 #include "coda-read-bytes.h"
 #include "coda-read-bytes-in-bounds.h"
+#include "coda-statistics.h"
 #ifndef WORDS_BIGENDIAN
 #include "coda-swap4.h"
 #include "coda-swap8.h"
@@ -3029,6 +3030,7 @@ int coda_grib_reopen(coda_product **product)
     product_file->product_variable = NULL;
     product_file->mem_size = 0;
     product_file->mem_ptr = NULL;
+    coda_statistics_init(product_file);
 
     product_file->raw_product = *product;
 
@@ -844,6 +844,80 @@ static int read_partial_array(const coda_cursor *cursor, long offset, long lengt
     return 0;
 }
 
+/* Read the hyperslab start[]/count[]/stride[] of an SDS or GRImage (in the read type of the array elements) */
+int coda_hdf4_cursor_read_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                    const long stride[], void *dst)
+{
+    int32 hdf4_start[MAX_HDF4_VAR_DIMS];
+    int32 hdf4_stride[MAX_HDF4_VAR_DIMS];
+    int32 hdf4_edge[MAX_HDF4_VAR_DIMS];
+    long i;
+
+    switch (((coda_hdf4_type *)cursor->stack[cursor->n - 1].type)->tag)
+    {
+        case tag_hdf4_basic_type_array:
+            coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "hyperslab reading is not supported for HDF4 attributes");
+            return -1;
+        case tag_hdf4_GRImage:
+            {
+                coda_hdf4_GRImage *type;
+
+                type = (coda_hdf4_GRImage *)cursor->stack[cursor->n - 1].type;
+                if (type->ncomp != 1 && (start[2] != 0 || count[2] != type->ncomp || stride[2] != 1))
+                {
+                    coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "hyperslab reading for HDF4 GRImage requires all "
+                                   "components of a pixel to be read");
+                    return -1;
+                }
+                /* the dimensions of a GRImage are in reversed order in CODA */
+                hdf4_start[0] = (int32)start[1];
+                hdf4_start[1] = (int32)start[0];
+                hdf4_stride[0] = (int32)stride[1];
+                hdf4_stride[1] = (int32)stride[0];
+                hdf4_edge[0] = (int32)count[1];
+                hdf4_edge[1] = (int32)count[0];
+                if (GRreadimage(type->ri_id, hdf4_start, hdf4_stride, hdf4_edge, dst) != 0)
+                {
+                    coda_set_error(CODA_ERROR_HDF4, NULL);
+                    return -1;
+                }
+            }
+            break;
+        case tag_hdf4_SDS:
+            {
+                coda_hdf4_SDS *type;
+
+                type = (coda_hdf4_SDS *)cursor->stack[cursor->n - 1].type;
+                if (type->rank == 0)
+                {
+                    coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "hyperslab reading not allowed for zero dimensional "
+                                   "HDF4 SDS");
+                    return -1;
+                }
+                for (i = 0; i < type->rank; i++)
+                {
+                    hdf4_start[i] = (int32)start[i];
+                    hdf4_stride[i] = (int32)stride[i];
+                    hdf4_edge[i] = (int32)count[i];
+                }
+                if (SDreaddata(type->sds_id, hdf4_start, hdf4_stride, hdf4_edge, dst) != 0)
+                {
+                    coda_set_error(CODA_ERROR_HDF4, NULL);
+                    return -1;
+                }
+            }
+            break;
+        case tag_hdf4_Vdata_field:
+            coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "hyperslab reading is not supported for HDF4 Vdata");
+            return -1;
+        default:
+            assert(0);
+            exit(1);
+    }
+
+    return 0;
+}
+
 static int read_basic_type(const coda_cursor *cursor, void *dst)
 {
     int32 start[MAX_HDF4_VAR_DIMS];
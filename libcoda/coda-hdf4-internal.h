@@ -209,6 +209,9 @@ struct coda_hdf4_product_struct
     int64_t **product_variable;
     int64_t mem_size;
     uint8_t *mem_ptr;
+#ifdef ENABLE_STATISTICS
+    coda_statistics statistics;
+#endif
 
     /* 'hdf4' product specific fields */
     int32 is_hdf;       /* is it a real HDF4 file or are we accessing a (net)CDF file */
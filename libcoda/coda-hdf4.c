@@ -30,6 +30,7 @@
  */
 
 #include "coda-hdf4-internal.h"
+#include "coda-statistics.h"
 
 #include <assert.h>
 
@@ -468,6 +469,7 @@ int coda_hdf4_reopen(coda_product **product)
     product_file->product_variable = NULL;
     product_file->mem_size = 0;
     product_file->mem_ptr = NULL;
+    coda_statistics_init(product_file);
     product_file->is_hdf = 0;
     product_file->file_id = -1;
     product_file->gr_id = -1;
@@ -629,6 +629,117 @@ static int read_partial_array(const coda_cursor *cursor, long offset, long lengt
     return 0;
 }
 
+/* Read the hyperslab start[]/count[]/stride[] of a Dataset (in the read type of the array elements) */
+int coda_hdf5_cursor_read_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                    const long stride[], void *dst)
+{
+    coda_hdf5_basic_data_type *base_type;
+    coda_hdf5_dataset *dataset;
+    hsize_t hstart[CODA_MAX_NUM_DIMS];
+    hsize_t hcount[CODA_MAX_NUM_DIMS];
+    hsize_t hstride[CODA_MAX_NUM_DIMS];
+    hsize_t hlength = 1;
+    hid_t mem_type_id;
+    hid_t mem_space_id;
+    int element_to_size;
+    int num_dims;
+    long dim[CODA_MAX_NUM_DIMS];
+    int i;
+
+    dataset = (coda_hdf5_dataset *)cursor->stack[cursor->n - 1].type;
+    base_type = (coda_hdf5_basic_data_type *)dataset->base_type;
+    assert(base_type->tag == tag_hdf5_basic_datatype);
+
+    if (coda_hdf5_cursor_get_array_dim(cursor, &num_dims, dim) != 0)
+    {
+        return -1;
+    }
+    if (num_dims == 0)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "hyperslab reading not allowed for zero dimensional HDF5 Dataset");
+        return -1;
+    }
+    for (i = 0; i < num_dims; i++)
+    {
+        hstart[i] = (hsize_t)start[i];
+        hcount[i] = (hsize_t)count[i];
+        hstride[i] = (hsize_t)stride[i];
+        hlength *= hcount[i];
+    }
+
+    if (H5Tget_class(base_type->datatype_id) == H5T_ENUM)
+    {
+        /* we read the data as an enumeration and perform the conversion to a native type after reading */
+        element_to_size = (int)H5Tget_size(base_type->datatype_id);
+        /* we make a copy to ease the cleanup process */
+        mem_type_id = H5Tcopy(base_type->datatype_id);
+    }
+    else
+    {
+        get_hdf5_type_and_size(base_type->definition->read_type, &mem_type_id, &element_to_size);
+        /* we make a copy to ease the cleanup process */
+        mem_type_id = H5Tcopy(mem_type_id);
+    }
+
+    if (H5Sselect_hyperslab(dataset->dataspace_id, H5S_SELECT_SET, hstart, hstride, hcount, NULL) < 0)
+    {
+        coda_set_error(CODA_ERROR_HDF5, NULL);
+        H5Tclose(mem_type_id);
+        return -1;
+    }
+
+    mem_space_id = H5Screate_simple(1, &hlength, NULL);
+    if (mem_space_id < 0)
+    {
+        coda_set_error(CODA_ERROR_HDF5, NULL);
+        H5Tclose(mem_type_id);
+        H5Sselect_all(dataset->dataspace_id);
+        return -1;
+    }
+
+    if (H5Dread(dataset->dataset_id, mem_type_id, mem_space_id, dataset->dataspace_id, H5P_DEFAULT, dst) < 0)
+    {
+        coda_set_error(CODA_ERROR_HDF5, NULL);
+        H5Sclose(mem_space_id);
+        H5Tclose(mem_type_id);
+        H5Sselect_all(dataset->dataspace_id);
+        return -1;
+    }
+
+    H5Sclose(mem_space_id);
+    H5Tclose(mem_type_id);
+    if (H5Sselect_all(dataset->dataspace_id) < 0)
+    {
+        coda_set_error(CODA_ERROR_HDF5, NULL);
+        return -1;
+    }
+
+    if (H5Tget_class(base_type->datatype_id) == H5T_ENUM)
+    {
+        hid_t super;
+        int native_element_size;
+
+        /* convert the enumeration data to our native type */
+        super = H5Tget_super(base_type->datatype_id);
+        if (super < 0)
+        {
+            coda_set_error(CODA_ERROR_HDF5, NULL);
+            return -1;
+        }
+        get_hdf5_type_and_size(base_type->definition->read_type, &mem_type_id, &native_element_size);
+        assert(native_element_size == element_to_size);
+        if (H5Tconvert(super, mem_type_id, hlength, dst, NULL, H5P_DEFAULT) < 0)
+        {
+            coda_set_error(CODA_ERROR_HDF5, NULL);
+            H5Tclose(super);
+            return -1;
+        }
+        H5Tclose(super);
+    }
+
+    return 0;
+}
+
 static int read_basic_type(const coda_cursor *cursor, void *dst, long dst_size)
 {
     coda_hdf5_basic_data_type *base_type;
@@ -143,6 +143,9 @@ struct coda_hdf5_product_struct
     int64_t **product_variable;
     int64_t mem_size;
     uint8_t *mem_ptr;
+#ifdef ENABLE_STATISTICS
+    coda_statistics statistics;
+#endif
 
     /* 'hdf5' product specific fields */
     hid_t file_id;
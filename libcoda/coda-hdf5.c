@@ -30,6 +30,7 @@
  */
 
 #include "coda-hdf5-internal.h"
+#include "coda-statistics.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -64,6 +65,7 @@ int coda_hdf5_reopen(coda_product **product)
     product_file->product_variable = NULL;
     product_file->mem_size = 0;
     product_file->mem_ptr = NULL;
+    coda_statistics_init(product_file);
     product_file->file_id = -1;
     product_file->num_objects = 0;
     product_file->object = NULL;
@@ -88,5 +88,7 @@ int coda_hdf5_cursor_read_int64_partial_array(const coda_cursor *cursor, long of
 int coda_hdf5_cursor_read_uint64_partial_array(const coda_cursor *cursor, long offset, long length, uint64_t *dst);
 int coda_hdf5_cursor_read_float_partial_array(const coda_cursor *cursor, long offset, long length, float *dst);
 int coda_hdf5_cursor_read_double_partial_array(const coda_cursor *cursor, long offset, long length, double *dst);
+int coda_hdf5_cursor_read_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                    const long stride[], void *dst);
 
 #endif
@@ -0,0 +1,893 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "coda-inflate.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "zlib.h"
+
+/* size of the deflate history window (i.e. the maximum distance of a back reference) */
+#define WINDOW_SIZE 32768
+
+/* size of the buffers that are used for compressed input and for uncompressed data that is skipped */
+#define CHUNK_SIZE 65536
+
+/* maximum amount of data that is decompressed with a single inflate() call (avail_out is only an uInt) */
+#define MAX_INFLATE_LENGTH 1073741824
+
+#define INDEX_FILE_EXTENSION ".codaidx"
+#define INDEX_FILE_SIGNATURE "CODAIDX1"
+
+typedef struct access_point_struct
+{
+    int64_t out;        /* offset in the uncompressed data */
+    int64_t in;         /* offset in the compressed data of the first byte that is fully part of the next block */
+    int bits;   /* number of bits of the byte before 'in' that are part of the next block (0-7) */
+    uint8_t *window;    /* WINDOW_SIZE bytes of uncompressed data that precede the access point (NULL for the access
+                         * point at the start of the compressed data) */
+} access_point;
+
+struct coda_inflate_index_struct
+{
+    int fd;
+    int64_t offset;     /* file offset of the compressed data */
+    int64_t size;       /* byte size of the compressed data */
+    int gzip;   /* 1: gzip data (possibly consisting of multiple members), 0: raw deflate data */
+    int64_t uncompressed_size;
+    int64_t checkpoint_distance;        /* minimum distance between access points in the uncompressed data */
+    int complete;       /* are all access points known (otherwise they get added while data is being read) */
+    long num_points;
+    access_point *point;
+
+    /* decompression stream that is used for reading */
+    z_stream zs;
+    int zs_initialized;
+    int zs_active;      /* is the stream positioned at uncompressed offset 'zs_out' */
+    int zs_raw; /* is the stream in raw deflate mode (otherwise it expects a gzip header) */
+    int64_t zs_in;      /* offset in the compressed data of the next byte that will be loaded into the input buffer */
+    int64_t zs_out;     /* offset in the uncompressed data of the next byte that the stream will produce */
+    uint8_t *input;     /* CHUNK_SIZE bytes */
+    uint8_t *discard;   /* CHUNK_SIZE bytes */
+};
+
+static void set_inflate_error(z_stream *zs, int result)
+{
+    if (result == Z_MEM_ERROR)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not decompress data)");
+    }
+    else if (zs->msg != NULL)
+    {
+        coda_set_error(CODA_ERROR_FILE_READ, "could not decompress data (%s)", zs->msg);
+    }
+    else
+    {
+        coda_set_error(CODA_ERROR_FILE_READ, "could not decompress data (invalid or incomplete deflate data)");
+    }
+}
+
+/* read 'length' bytes at offset 'in_offset' of the compressed data */
+static int read_compressed(coda_inflate_index *index, int64_t in_offset, uint8_t *dst, long length)
+{
+    while (length > 0)
+    {
+        ssize_t result;
+
+#if HAVE_PREAD
+        result = pread(index->fd, dst, (size_t)length, (off_t)(index->offset + in_offset));
+#else
+        if (lseek(index->fd, (off_t)(index->offset + in_offset), SEEK_SET) < 0)
+        {
+            char byte_offset_str[21];
+
+            coda_str64(index->offset + in_offset, byte_offset_str);
+            coda_set_error(CODA_ERROR_FILE_READ, "could not move to byte position %s (%s)", byte_offset_str,
+                           strerror(errno));
+            return -1;
+        }
+        result = read(index->fd, dst, (size_t)length);
+#endif
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            coda_set_error(CODA_ERROR_FILE_READ, "could not read from file (%s)", strerror(errno));
+            return -1;
+        }
+        if (result == 0)
+        {
+            coda_set_error(CODA_ERROR_FILE_READ, "could not read from file (unexpected end of file)");
+            return -1;
+        }
+        dst += result;
+        in_offset += result;
+        length -= (long)result;
+    }
+
+    return 0;
+}
+
+/* refill the (empty) input buffer of the decompression stream */
+static int load_input(coda_inflate_index *index)
+{
+    long length = CHUNK_SIZE;
+
+    assert(index->zs.avail_in == 0);
+    if (index->zs_in >= index->size)
+    {
+        coda_set_error(CODA_ERROR_FILE_READ, "could not decompress data (unexpected end of compressed data)");
+        return -1;
+    }
+    if (index->zs_in + length > index->size)
+    {
+        length = (long)(index->size - index->zs_in);
+    }
+    if (read_compressed(index, index->zs_in, index->input, length) != 0)
+    {
+        return -1;
+    }
+    index->zs.next_in = index->input;
+    index->zs.avail_in = (uInt)length;
+    index->zs_in += length;
+
+    return 0;
+}
+
+/* returns 1 if the compressed data at the current stream position starts a new gzip member and 0 otherwise */
+static int at_gzip_member(coda_inflate_index *index)
+{
+    int64_t in_offset = index->zs_in - index->zs.avail_in;
+    uint8_t magic[2];
+
+    if (in_offset + 2 > index->size)
+    {
+        return 0;
+    }
+    if (read_compressed(index, in_offset, magic, 2) != 0)
+    {
+        return -1;
+    }
+
+    return coda_inflate_is_gzip(magic, 2);
+}
+
+/* prepare the stream for decompressing the next member of a gzip file (after the stream reported Z_STREAM_END) */
+static int next_gzip_member(coda_inflate_index *index)
+{
+    int result;
+
+    if (!index->gzip)
+    {
+        coda_set_error(CODA_ERROR_FILE_READ, "could not decompress data (unexpected end of compressed data)");
+        return -1;
+    }
+    if (index->zs_raw)
+    {
+        /* skip the gzip trailer (crc32 and uncompressed size) and switch to gzip mode for the header of the next member */
+        index->zs_in = index->zs_in - index->zs.avail_in + 8;
+        index->zs.avail_in = 0;
+        index->zs_raw = 0;
+        result = inflateReset2(&index->zs, 31);
+    }
+    else
+    {
+        result = inflateReset(&index->zs);
+    }
+    if (result != Z_OK)
+    {
+        set_inflate_error(&index->zs, result);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int add_access_point(coda_inflate_index *index, int64_t out, int64_t in, int bits, const uint8_t *window,
+                            long window_left)
+{
+    access_point *point;
+
+    if (index->num_points % 64 == 0)
+    {
+        access_point *new_point;
+
+        new_point = realloc(index->point, (index->num_points + 64) * sizeof(access_point));
+        if (new_point == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (index->num_points + 64) * sizeof(access_point), __FILE__, __LINE__);
+            return -1;
+        }
+        index->point = new_point;
+    }
+    point = &index->point[index->num_points];
+    point->out = out;
+    point->in = in;
+    point->bits = bits;
+    point->window = NULL;
+    if (window != NULL)
+    {
+        point->window = malloc(WINDOW_SIZE);
+        if (point->window == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (long)WINDOW_SIZE, __FILE__, __LINE__);
+            return -1;
+        }
+        /* the window buffer is used as a circular buffer; the last 'window_left' bytes are the oldest data */
+        if (window_left > 0)
+        {
+            memcpy(point->window, window + WINDOW_SIZE - window_left, window_left);
+        }
+        if (window_left < WINDOW_SIZE)
+        {
+            memcpy(point->window + window_left, window, WINDOW_SIZE - window_left);
+        }
+    }
+    index->num_points++;
+
+    return 0;
+}
+
+/* decompress all data once to determine the uncompressed size and to create an access point at the first block
+ * boundary after each 'checkpoint distance' bytes of uncompressed data
+ */
+static int build_index(coda_inflate_index *index)
+{
+    z_stream *zs = &index->zs;
+    uint8_t *window;
+    int64_t total_out = 0;
+    int64_t last_out = 0;
+    int result;
+
+    window = calloc(WINDOW_SIZE, 1);
+    if (window == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)WINDOW_SIZE, __FILE__, __LINE__);
+        return -1;
+    }
+
+    /* the start of the data is always an access point */
+    if (add_access_point(index, 0, 0, 0, NULL, 0) != 0)
+    {
+        free(window);
+        return -1;
+    }
+
+    index->zs_in = 0;
+    zs->avail_in = 0;
+    zs->avail_out = 0;
+    do
+    {
+        if (zs->avail_in == 0 && load_input(index) != 0)
+        {
+            free(window);
+            return -1;
+        }
+        if (zs->avail_out == 0)
+        {
+            zs->next_out = window;
+            zs->avail_out = WINDOW_SIZE;
+        }
+        total_out += zs->avail_out;
+        result = inflate(zs, Z_BLOCK);
+        total_out -= zs->avail_out;
+        if (result == Z_STREAM_END)
+        {
+            int is_member = 0;
+
+            if (index->gzip)
+            {
+                is_member = at_gzip_member(index);
+                if (is_member < 0)
+                {
+                    free(window);
+                    return -1;
+                }
+            }
+            if (is_member)
+            {
+                result = inflateReset(zs);
+                if (result != Z_OK)
+                {
+                    set_inflate_error(zs, result);
+                    free(window);
+                    return -1;
+                }
+            }
+            else
+            {
+                result = Z_STREAM_END;
+            }
+        }
+        else if (result != Z_OK && result != Z_BUF_ERROR)
+        {
+            set_inflate_error(zs, result == Z_NEED_DICT ? Z_DATA_ERROR : result);
+            free(window);
+            return -1;
+        }
+        else if ((zs->data_type & 128) && !(zs->data_type & 64) &&
+                 total_out - last_out > index->checkpoint_distance)
+        {
+            /* we are at a block boundary that is not at the end of the stream */
+            if (add_access_point(index, total_out, index->zs_in - zs->avail_in, zs->data_type & 7, window,
+                                 zs->avail_out) != 0)
+            {
+                free(window);
+                return -1;
+            }
+            last_out = total_out;
+        }
+    } while (result != Z_STREAM_END);
+
+    free(window);
+    index->uncompressed_size = total_out;
+
+    return 0;
+}
+
+/* add an access point at the current position of the decompression stream (which should be at a block boundary) */
+static int add_access_point_from_stream(coda_inflate_index *index, int64_t out)
+{
+    access_point *point;
+    uInt window_length;
+
+    if (add_access_point(index, out, index->zs_in - index->zs.avail_in, index->zs.data_type & 7, NULL, 0) != 0)
+    {
+        return -1;
+    }
+    point = &index->point[index->num_points - 1];
+    point->window = calloc(WINDOW_SIZE, 1);
+    if (point->window == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)WINDOW_SIZE, __FILE__, __LINE__);
+        index->num_points--;
+        return -1;
+    }
+    /* the history can be shorter than the window size if the access point is close to the start of the data */
+    inflateGetDictionary(&index->zs, NULL, &window_length);
+    inflateGetDictionary(&index->zs, point->window + WINDOW_SIZE - window_length, &window_length);
+
+    return 0;
+}
+
+static char *get_index_filename(const char *filename)
+{
+    char *index_filename;
+
+    index_filename = malloc(strlen(filename) + strlen(INDEX_FILE_EXTENSION) + 1);
+    if (index_filename == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)(strlen(filename) + strlen(INDEX_FILE_EXTENSION) + 1), __FILE__, __LINE__);
+        return NULL;
+    }
+    strcpy(index_filename, filename);
+    strcat(index_filename, INDEX_FILE_EXTENSION);
+
+    return index_filename;
+}
+
+/* An index file contains (in native byte order): the signature, the size and modification time of the compressed file,
+ * the uncompressed size, the number of access points, and for each access point (except the first, which is always at
+ * the start of the data) its 'out', 'in', and 'bits' values followed by its window.
+ */
+static int write_index_file(const coda_inflate_index *index, const char *filename, int64_t mtime)
+{
+    char *index_filename;
+    int64_t header[4];
+    FILE *f;
+    long i;
+
+    index_filename = get_index_filename(filename);
+    if (index_filename == NULL)
+    {
+        return -1;
+    }
+    f = fopen(index_filename, "wb");
+    if (f == NULL)
+    {
+        /* not being able to create an index file is not an error */
+        free(index_filename);
+        return 0;
+    }
+    header[0] = index->size;
+    header[1] = mtime;
+    header[2] = index->uncompressed_size;
+    header[3] = index->num_points;
+    if (fwrite(INDEX_FILE_SIGNATURE, 8, 1, f) != 1 || fwrite(header, sizeof(header), 1, f) != 1)
+    {
+        fclose(f);
+        remove(index_filename);
+        free(index_filename);
+        return 0;
+    }
+    for (i = 1; i < index->num_points; i++)
+    {
+        int64_t value[3];
+
+        value[0] = index->point[i].out;
+        value[1] = index->point[i].in;
+        value[2] = index->point[i].bits;
+        if (fwrite(value, sizeof(value), 1, f) != 1 || fwrite(index->point[i].window, WINDOW_SIZE, 1, f) != 1)
+        {
+            fclose(f);
+            remove(index_filename);
+            free(index_filename);
+            return 0;
+        }
+    }
+    if (fclose(f) != 0)
+    {
+        remove(index_filename);
+    }
+    free(index_filename);
+
+    return 0;
+}
+
+/* returns 1 if the index was read from the index file, 0 if there is no (valid) index file, and -1 on error */
+static int read_index_file(coda_inflate_index *index, const char *filename, int64_t mtime)
+{
+    char *index_filename;
+    char signature[8];
+    int64_t header[4];
+    FILE *f;
+    long i;
+
+    index_filename = get_index_filename(filename);
+    if (index_filename == NULL)
+    {
+        return -1;
+    }
+    f = fopen(index_filename, "rb");
+    free(index_filename);
+    if (f == NULL)
+    {
+        return 0;
+    }
+    if (fread(signature, 8, 1, f) != 1 || memcmp(signature, INDEX_FILE_SIGNATURE, 8) != 0 ||
+        fread(header, sizeof(header), 1, f) != 1 || header[0] != index->size || header[1] != mtime ||
+        header[2] < 0 || header[3] < 1)
+    {
+        fclose(f);
+        return 0;
+    }
+    if (add_access_point(index, 0, 0, 0, NULL, 0) != 0)
+    {
+        fclose(f);
+        return -1;
+    }
+    for (i = 1; i < header[3]; i++)
+    {
+        access_point *point;
+        int64_t value[3];
+
+        if (fread(value, sizeof(value), 1, f) != 1 || value[0] <= index->point[i - 1].out ||
+            value[0] > header[2] || value[1] <= 0 || value[1] > index->size || value[2] < 0 || value[2] > 7)
+        {
+            fclose(f);
+            return 0;
+        }
+        if (add_access_point(index, value[0], value[1], (int)value[2], NULL, 0) != 0)
+        {
+            fclose(f);
+            return -1;
+        }
+        point = &index->point[i];
+        point->window = malloc(WINDOW_SIZE);
+        if (point->window == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (long)WINDOW_SIZE, __FILE__, __LINE__);
+            fclose(f);
+            return -1;
+        }
+        if (fread(point->window, WINDOW_SIZE, 1, f) != 1)
+        {
+            fclose(f);
+            return 0;
+        }
+    }
+    fclose(f);
+    index->uncompressed_size = header[2];
+
+    return 1;
+}
+
+static void remove_access_points(coda_inflate_index *index)
+{
+    long i;
+
+    for (i = 0; i < index->num_points; i++)
+    {
+        if (index->point[i].window != NULL)
+        {
+            free(index->point[i].window);
+        }
+    }
+    index->num_points = 0;
+}
+
+/* position the decompression stream at an access point */
+static int start_at_access_point(coda_inflate_index *index, const access_point *point)
+{
+    z_stream *zs = &index->zs;
+    int result;
+
+    index->zs_active = 0;
+    zs->avail_in = 0;
+    index->zs_in = point->in;
+    if (point->window == NULL)
+    {
+        /* start of the data */
+        index->zs_raw = !index->gzip;
+        result = inflateReset2(zs, index->gzip ? 31 : -15);
+        if (result != Z_OK)
+        {
+            set_inflate_error(zs, result);
+            return -1;
+        }
+    }
+    else
+    {
+        index->zs_raw = 1;
+        result = inflateReset2(zs, -15);
+        if (result == Z_OK && point->bits > 0)
+        {
+            uint8_t byte;
+
+            if (read_compressed(index, point->in - 1, &byte, 1) != 0)
+            {
+                return -1;
+            }
+            result = inflatePrime(zs, point->bits, byte >> (8 - point->bits));
+        }
+        if (result == Z_OK)
+        {
+            result = inflateSetDictionary(zs, point->window, WINDOW_SIZE);
+        }
+        if (result != Z_OK)
+        {
+            set_inflate_error(zs, result);
+            return -1;
+        }
+    }
+    index->zs_out = point->out;
+    index->zs_active = 1;
+
+    return 0;
+}
+
+/* decompress 'length' bytes from the current stream position into 'dst' (the data is discarded if dst is NULL) */
+static int inflate_data(coda_inflate_index *index, uint8_t *dst, int64_t length)
+{
+    z_stream *zs = &index->zs;
+
+    while (length > 0)
+    {
+        int64_t chunk_length = length;
+
+        if (dst == NULL)
+        {
+            if (chunk_length > CHUNK_SIZE)
+            {
+                chunk_length = CHUNK_SIZE;
+            }
+            zs->next_out = index->discard;
+        }
+        else
+        {
+            if (chunk_length > MAX_INFLATE_LENGTH)
+            {
+                chunk_length = MAX_INFLATE_LENGTH;
+            }
+            zs->next_out = dst;
+        }
+        zs->avail_out = (uInt)chunk_length;
+        while (zs->avail_out > 0)
+        {
+            int result;
+
+            if (zs->avail_in == 0 && load_input(index) != 0)
+            {
+                index->zs_active = 0;
+                return -1;
+            }
+            /* if the index is not complete yet, stop at each block boundary to see if we need an access point there */
+            result = inflate(zs, index->complete ? Z_NO_FLUSH : Z_BLOCK);
+            if (result == Z_STREAM_END)
+            {
+                if (!index->gzip)
+                {
+                    /* we reached the end of the raw deflate data */
+                    index->complete = 1;
+                    if (zs->avail_out == 0)
+                    {
+                        break;
+                    }
+                }
+                if (next_gzip_member(index) != 0)
+                {
+                    index->zs_active = 0;
+                    return -1;
+                }
+            }
+            else if (result != Z_OK && result != Z_BUF_ERROR)
+            {
+                set_inflate_error(zs, result == Z_NEED_DICT ? Z_DATA_ERROR : result);
+                index->zs_active = 0;
+                return -1;
+            }
+            else if (!index->complete && (zs->data_type & 128) && !(zs->data_type & 64))
+            {
+                int64_t out = index->zs_out + chunk_length - zs->avail_out;
+
+                if (out - index->point[index->num_points - 1].out > index->checkpoint_distance &&
+                    add_access_point_from_stream(index, out) != 0)
+                {
+                    index->zs_active = 0;
+                    return -1;
+                }
+            }
+        }
+        index->zs_out += chunk_length;
+        length -= chunk_length;
+        if (dst != NULL)
+        {
+            dst += chunk_length;
+        }
+    }
+
+    return 0;
+}
+
+/* returns 1 if the buffer starts with the gzip magic bytes and 0 otherwise */
+int coda_inflate_is_gzip(const uint8_t *buffer, int64_t length)
+{
+    return length >= 2 && buffer[0] == 0x1f && buffer[1] == 0x8b;
+}
+
+void coda_inflate_index_delete(coda_inflate_index *index)
+{
+    if (index->point != NULL)
+    {
+        remove_access_points(index);
+        free(index->point);
+    }
+    if (index->zs_initialized)
+    {
+        inflateEnd(&index->zs);
+    }
+    if (index->input != NULL)
+    {
+        free(index->input);
+    }
+    if (index->discard != NULL)
+    {
+        free(index->discard);
+    }
+    free(index);
+}
+
+/* Create a random access index for the deflate compressed data at 'offset' in the file 'fd' (the file descriptor
+ * remains owned by the caller and should stay open for the lifetime of the index).
+ * If 'gzip' is set, the data is expected to be a gzip file (consisting of one or more members), otherwise it should be
+ * a raw deflate stream.
+ * If the size of the uncompressed data is known up front (such as for zip entries) 'uncompressed_size' should be set
+ * to this size. In that case nothing gets decompressed here and access points are added while data is being read.
+ * Otherwise (uncompressed_size < 0) all data is decompressed once to create the index. If 'filename' is not NULL and
+ * the gzip index file option is enabled, the index is then read from (or, if it does not exist yet, stored in) an
+ * index file with the name <filename>.codaidx.
+ */
+int coda_inflate_index_new(int fd, const char *filename, int64_t offset, int64_t size, int gzip,
+                           int64_t uncompressed_size, coda_inflate_index **index)
+{
+    coda_inflate_index *new_index;
+    int64_t mtime = 0;
+    int result;
+
+    new_index = malloc(sizeof(coda_inflate_index));
+    if (new_index == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(coda_inflate_index), __FILE__, __LINE__);
+        return -1;
+    }
+    new_index->fd = fd;
+    new_index->offset = offset;
+    new_index->size = size;
+    new_index->gzip = gzip;
+    new_index->uncompressed_size = 0;
+    new_index->checkpoint_distance = coda_option_gzip_checkpoint_distance;
+    new_index->complete = 1;
+    new_index->num_points = 0;
+    new_index->point = NULL;
+    new_index->zs_initialized = 0;
+    new_index->zs_active = 0;
+    new_index->zs_raw = !gzip;
+    new_index->zs_in = 0;
+    new_index->zs_out = 0;
+    new_index->input = NULL;
+    new_index->discard = NULL;
+
+    new_index->input = malloc(CHUNK_SIZE);
+    if (new_index->input == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)CHUNK_SIZE, __FILE__, __LINE__);
+        coda_inflate_index_delete(new_index);
+        return -1;
+    }
+    new_index->discard = malloc(CHUNK_SIZE);
+    if (new_index->discard == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)CHUNK_SIZE, __FILE__, __LINE__);
+        coda_inflate_index_delete(new_index);
+        return -1;
+    }
+
+    new_index->zs.next_in = Z_NULL;
+    new_index->zs.avail_in = 0;
+    new_index->zs.zalloc = Z_NULL;
+    new_index->zs.zfree = Z_NULL;
+    new_index->zs.opaque = Z_NULL;
+    new_index->zs.msg = NULL;
+    /* windowBits 31 means gzip decoding; the negative value means raw deflate data without zlib header */
+    result = inflateInit2(&new_index->zs, gzip ? 31 : -15);
+    if (result != Z_OK)
+    {
+        set_inflate_error(&new_index->zs, result);
+        coda_inflate_index_delete(new_index);
+        return -1;
+    }
+    new_index->zs_initialized = 1;
+
+    if (uncompressed_size >= 0)
+    {
+        new_index->uncompressed_size = uncompressed_size;
+        new_index->complete = 0;
+        if (add_access_point(new_index, 0, 0, 0, NULL, 0) != 0)
+        {
+            coda_inflate_index_delete(new_index);
+            return -1;
+        }
+        *index = new_index;
+        return 0;
+    }
+
+    if (filename != NULL && coda_option_gzip_index_file)
+    {
+        struct stat statbuf;
+
+        if (stat(filename, &statbuf) == 0)
+        {
+            mtime = (int64_t)statbuf.st_mtime;
+        }
+        result = read_index_file(new_index, filename, mtime);
+        if (result < 0)
+        {
+            coda_inflate_index_delete(new_index);
+            return -1;
+        }
+        if (result == 0)
+        {
+            /* discard any partially read index */
+            remove_access_points(new_index);
+        }
+    }
+    else
+    {
+        result = 0;
+    }
+
+    if (result == 0)
+    {
+        if (build_index(new_index) != 0)
+        {
+            coda_inflate_index_delete(new_index);
+            return -1;
+        }
+        if (filename != NULL && coda_option_gzip_index_file)
+        {
+            if (write_index_file(new_index, filename, mtime) != 0)
+            {
+                coda_inflate_index_delete(new_index);
+                return -1;
+            }
+        }
+    }
+
+    *index = new_index;
+
+    return 0;
+}
+
+/* returns the size of the uncompressed data */
+int64_t coda_inflate_index_get_size(const coda_inflate_index *index)
+{
+    return index->uncompressed_size;
+}
+
+/* Read 'length' bytes at offset 'byte_offset' of the uncompressed data.
+ * The caller should make sure that the requested range is within the bounds of the uncompressed data.
+ * If the requested data is located after the current position of the decompression stream (and there is no access
+ * point in between) decompression continues from the current position, so sequential reads never decompress data
+ * twice. Otherwise decompression restarts from the nearest preceding access point.
+ */
+int coda_inflate_index_read(coda_inflate_index *index, int64_t byte_offset, int64_t length, void *dst)
+{
+    long low = 0;
+    long high = index->num_points - 1;
+
+    /* find the last access point at or before byte_offset */
+    while (low < high)
+    {
+        long middle = (low + high + 1) / 2;
+
+        if (index->point[middle].out <= byte_offset)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    if (!index->zs_active || index->zs_out > byte_offset || index->point[low].out > index->zs_out)
+    {
+        if (start_at_access_point(index, &index->point[low]) != 0)
+        {
+            return -1;
+        }
+    }
+    if (inflate_data(index, NULL, byte_offset - index->zs_out) != 0)
+    {
+        return -1;
+    }
+
+    return inflate_data(index, (uint8_t *)dst, length);
+}
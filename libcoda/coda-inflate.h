@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CODA_INFLATE_H
+#define CODA_INFLATE_H
+
+#include "coda-internal.h"
+
+/* Random access to deflate compressed data.
+ * An index of access points (one every 'checkpoint distance' bytes of uncompressed data) is kept such that reading
+ * data at an arbitrary offset only requires decompressing from the nearest preceding access point onwards.
+ */
+typedef struct coda_inflate_index_struct coda_inflate_index;
+
+int coda_inflate_is_gzip(const uint8_t *buffer, int64_t length);
+int coda_inflate_index_new(int fd, const char *filename, int64_t offset, int64_t size, int gzip,
+                           int64_t uncompressed_size, coda_inflate_index **index);
+int64_t coda_inflate_index_get_size(const coda_inflate_index *index);
+int coda_inflate_index_read(coda_inflate_index *index, int64_t byte_offset, int64_t length, void *dst);
+void coda_inflate_index_delete(coda_inflate_index *index);
+
+#endif
@@ -104,19 +104,51 @@ struct coda_product_struct
     int64_t **product_variable;
     int64_t mem_size;
     uint8_t *mem_ptr;
+#ifdef ENABLE_STATISTICS
+    coda_statistics statistics;
+#endif
 };
 
 extern THREAD_LOCAL const char *libcoda_version;
 
 extern THREAD_LOCAL int coda_errno;
 
+extern THREAD_LOCAL long coda_option_auto_prefetch;
+extern THREAD_LOCAL long coda_option_bit_size_cache_max_entries;
+extern THREAD_LOCAL long coda_option_block_cache_block_size;
+extern THREAD_LOCAL long coda_option_block_cache_num_blocks;
 extern THREAD_LOCAL int coda_option_bypass_special_types;
+extern THREAD_LOCAL int coda_option_decompress_gzip;
+extern THREAD_LOCAL long coda_option_gzip_checkpoint_distance;
+extern THREAD_LOCAL int coda_option_gzip_index_file;
 extern THREAD_LOCAL int coda_option_perform_boundary_checks;
 extern THREAD_LOCAL int coda_option_perform_conversions;
+extern THREAD_LOCAL int coda_option_profile_expressions;
 extern THREAD_LOCAL int coda_option_read_all_definitions;
 extern THREAD_LOCAL int coda_option_use_fast_size_expressions;
 extern THREAD_LOCAL int coda_option_use_mmap;
 
+/* settings that a worker thread needs to initialize CODA in the same way as the thread that created it */
+struct coda_thread_settings_struct
+{
+    char *definition_path;
+    long option_auto_prefetch;
+    long option_bit_size_cache_max_entries;
+    long option_block_cache_block_size;
+    long option_block_cache_num_blocks;
+    int option_bypass_special_types;
+    int option_decompress_gzip;
+    long option_gzip_checkpoint_distance;
+    int option_gzip_index_file;
+    int option_perform_boundary_checks;
+    int option_perform_conversions;
+    int option_profile_expressions;
+    int option_read_all_definitions;
+    int option_use_fast_size_expressions;
+    int option_use_mmap;
+};
+typedef struct coda_thread_settings_struct coda_thread_settings;
+
 #define coda_get_type_for_dynamic_type(dynamic_type) (((coda_dynamic_type *)dynamic_type)->backend < first_dynamic_backend_id ? (coda_type *)dynamic_type : ((coda_dynamic_type *)dynamic_type)->definition)
 
 void coda_add_error_message(const char *message, ...);
@@ -124,6 +156,8 @@ void coda_set_error_message(const char *message, ...);
 void coda_add_error_message_vargs(const char *message, va_list ap);
 void coda_set_error_message_vargs(const char *message, va_list ap);
 void coda_cursor_add_to_error_message(const coda_cursor *cursor);
+void coda_save_error_state(void);
+void coda_restore_error_state(void);
 
 int coda_data_dictionary_init(void);
 void coda_data_dictionary_done(void);
@@ -144,6 +178,11 @@ int coda_expression_print_xml(const coda_expression *expr, int (*print) (const c
 
 int coda_product_variable_get_size(coda_product *product, const char *name, long *size);
 int coda_product_variable_get_pointer(coda_product *product, const char *name, long i, int64_t **ptr);
+int coda_product_is_in_memory(const coda_product *product);
+
+int coda_thread_settings_get(coda_thread_settings *settings);
+void coda_thread_settings_done(coda_thread_settings *settings);
+int coda_thread_init(const coda_thread_settings *settings);
 
 int coda_expression_eval_void(const coda_expression *expr, const coda_cursor *cursor);
 
@@ -214,17 +214,30 @@ static int read_array(const coda_cursor *cursor, void *dst)
     block_size = (long)(type->definition->num_elements * (type->base_type->definition->bit_size >> 3));
     if (type->base_type->record_var)
     {
+        coda_bin_read_request *request;
         long num_blocks = type->definition->dim[0];
 
         block_size /= num_blocks;
+        /* read all records at once */
+        request = malloc(num_blocks * sizeof(coda_bin_read_request));
+        if (request == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           num_blocks * sizeof(coda_bin_read_request), __FILE__, __LINE__);
+            return -1;
+        }
         for (i = 0; i < num_blocks; i++)
         {
-            if (read_bytes(product->raw_product, type->base_type->offset + i * product->record_size, block_size,
-                           &((uint8_t *)dst)[i * block_size]) != 0)
-            {
-                return -1;
-            }
+            request[i].byte_offset = type->base_type->offset + i * product->record_size;
+            request[i].length = block_size;
+            request[i].dst = &((uint8_t *)dst)[i * block_size];
         }
+        if (coda_bin_product_read_batch(product->raw_product, num_blocks, request) != 0)
+        {
+            free(request);
+            return -1;
+        }
+        free(request);
     }
     else
     {
@@ -280,14 +293,27 @@ static int read_partial_array(const coda_cursor *cursor, long offset, long lengt
     value_size = (long)(type->base_type->definition->bit_size >> 3);
     if (type->base_type->record_var)
     {
+        coda_bin_read_request *request;
         long num_blocks = type->definition->dim[0];
         long num_values_per_block;
+        long first_block;
+        long num_requests;
         int64_t target_offset;
 
         num_values_per_block = type->definition->num_elements / num_blocks;
         target_offset = 0;
 
-        for (i = 0; i < num_blocks; i++)
+        /* only visit the records that overlap with the requested range */
+        first_block = offset / num_values_per_block;
+        num_requests = (offset + length - 1) / num_values_per_block - first_block + 1;
+        request = malloc(num_requests * sizeof(coda_bin_read_request));
+        if (request == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           num_requests * sizeof(coda_bin_read_request), __FILE__, __LINE__);
+            return -1;
+        }
+        for (i = first_block; i < first_block + num_requests; i++)
         {
             int64_t local_offset = 0;   /* byte offset within record */
             int64_t local_size = num_values_per_block * value_size;     /* amount of bytes to read */
@@ -301,14 +327,17 @@ static int read_partial_array(const coda_cursor *cursor, long offset, long lengt
                 local_offset = (offset - i * num_values_per_block) * value_size;
                 local_size -= local_offset;
             }
-            if (read_bytes(product->raw_product, type->base_type->offset + i * product->record_size + local_offset,
-                           local_size, &((uint8_t *)dst)[target_offset]) != 0)
-            {
-                return -1;
-            }
+            request[i - first_block].byte_offset = type->base_type->offset + i * product->record_size + local_offset;
+            request[i - first_block].length = local_size;
+            request[i - first_block].dst = &((uint8_t *)dst)[target_offset];
             target_offset += local_size;
         }
-
+        if (coda_bin_product_read_batch(product->raw_product, num_requests, request) != 0)
+        {
+            free(request);
+            return -1;
+        }
+        free(request);
     }
     else
     {
@@ -326,19 +355,158 @@ static int read_partial_array(const coda_cursor *cursor, long offset, long lengt
             /* no endianness conversion needed */
             break;
         case 16:
-            for (i = 0; i < type->definition->num_elements; i++)
+            for (i = 0; i < length; i++)
             {
                 swap2(&((int16_t *)dst)[i]);
             }
             break;
         case 32:
-            for (i = 0; i < type->definition->num_elements; i++)
+            for (i = 0; i < length; i++)
             {
                 swap4(&((int32_t *)dst)[i]);
             }
             break;
         case 64:
-            for (i = 0; i < type->definition->num_elements; i++)
+            for (i = 0; i < length; i++)
+            {
+                swap8(&((int64_t *)dst)[i]);
+            }
+            break;
+        default:
+            assert(0);
+            exit(1);
+    }
+#endif
+
+    return 0;
+}
+
+/* Read the hyperslab start[]/count[]/stride[] of an array (in the read type of the array elements).
+ * Each contiguous run of array elements is read with a separate request and all requests are passed on at once, so
+ * that adjacent runs are merged and the reads can be performed asynchronously.
+ */
+int coda_netcdf_cursor_read_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                      const long stride[], void *dst)
+{
+    coda_netcdf_array *type;
+    coda_netcdf_product *product;
+    coda_bin_read_request *request;
+    long multiplier[CODA_MAX_NUM_DIMS];
+    long index[CODA_MAX_NUM_DIMS];
+    long run_length = 1;        /* number of consecutive array elements that are read with a single request */
+    long run_offset = 0;        /* offset of the run relative to the position that is determined by the outer dims */
+    long num_requests = 1;
+    long num_elements = 0;
+    long value_size;
+    int num_outer_dims = 0;
+    int num_dims;
+    long i;
+
+    type = (coda_netcdf_array *)cursor->stack[cursor->n - 1].type;
+    product = (coda_netcdf_product *)cursor->product;
+    value_size = (long)(type->base_type->definition->bit_size >> 3);
+    num_dims = type->definition->num_dims;
+
+    if (num_dims > 0)
+    {
+        multiplier[num_dims - 1] = 1;
+        for (i = num_dims - 1; i > 0; i--)
+        {
+            multiplier[i - 1] = multiplier[i] * type->definition->dim[i];
+        }
+
+        /* merge trailing dimensions that are read completely into a single run */
+        i = num_dims - 1;
+        while (i > 0 && start[i] == 0 && count[i] == type->definition->dim[i] && stride[i] == 1)
+        {
+            i--;
+        }
+        if (stride[i] == 1 && !(i == 0 && type->base_type->record_var))
+        {
+            run_length = count[i] * multiplier[i];
+            run_offset = start[i] * multiplier[i];
+            num_outer_dims = (int)i;
+        }
+        else
+        {
+            /* records of a record variable are not stored consecutively, so each record requires its own run */
+            run_length = multiplier[i];
+            num_outer_dims = (int)i + 1;
+        }
+        for (i = 0; i < num_outer_dims; i++)
+        {
+            num_requests *= count[i];
+            index[i] = 0;
+        }
+    }
+
+    request = malloc(num_requests * sizeof(coda_bin_read_request));
+    if (request == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_requests * sizeof(coda_bin_read_request), __FILE__, __LINE__);
+        return -1;
+    }
+    for (i = 0; i < num_requests; i++)
+    {
+        long offset = run_offset;
+        int k;
+
+        for (k = 0; k < num_outer_dims; k++)
+        {
+            offset += (start[k] + index[k] * stride[k]) * multiplier[k];
+        }
+        if (type->base_type->record_var)
+        {
+            request[i].byte_offset = type->base_type->offset + (offset / multiplier[0]) * product->record_size +
+                (offset % multiplier[0]) * value_size;
+        }
+        else
+        {
+            request[i].byte_offset = type->base_type->offset + offset * value_size;
+        }
+        request[i].length = run_length * value_size;
+        request[i].dst = &((uint8_t *)dst)[num_elements * value_size];
+        num_elements += run_length;
+
+        /* advance to the next run */
+        for (k = num_outer_dims - 1; k >= 0; k--)
+        {
+            index[k]++;
+            if (index[k] < count[k])
+            {
+                break;
+            }
+            index[k] = 0;
+        }
+    }
+    if (coda_bin_product_read_batch(product->raw_product, num_requests, request) != 0)
+    {
+        free(request);
+        return -1;
+    }
+    free(request);
+
+#ifndef WORDS_BIGENDIAN
+    switch (type->base_type->definition->bit_size)
+    {
+        case 8:
+            /* no endianness conversion needed */
+            break;
+        case 16:
+            for (i = 0; i < num_elements; i++)
+            {
+                swap2(&((int16_t *)dst)[i]);
+            }
+            break;
+        case 32:
+            for (i = 0; i < num_elements; i++)
+            {
+                swap4(&((int32_t *)dst)[i]);
+            }
+            break;
+        case 64:
+            for (i = 0; i < num_elements; i++)
             {
                 swap8(&((int64_t *)dst)[i]);
             }
@@ -468,6 +636,124 @@ int coda_netcdf_cursor_read_string(const coda_cursor *cursor, char *dst, long ds
     return 0;
 }
 
+int coda_netcdf_cursor_get_data_pointer(const coda_cursor *cursor, const uint8_t **data, int64_t *byte_size,
+                                        coda_endianness *endianness)
+{
+    coda_netcdf_product *product = (coda_netcdf_product *)cursor->product;
+    int64_t offset;
+
+    if (cursor->stack[cursor->n - 1].type->definition->type_class == coda_array_class)
+    {
+        coda_netcdf_array *type = (coda_netcdf_array *)cursor->stack[cursor->n - 1].type;
+
+        offset = type->base_type->offset;
+        *byte_size = type->definition->num_elements * (type->base_type->definition->bit_size >> 3);
+        if (type->base_type->record_var && type->definition->dim[0] > 1 &&
+            *byte_size / type->definition->dim[0] != product->record_size)
+        {
+            /* the data is interleaved with the data of other record variables */
+            coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "data is not stored contiguously");
+            return -1;
+        }
+    }
+    else
+    {
+        coda_netcdf_basic_type *type = (coda_netcdf_basic_type *)cursor->stack[cursor->n - 1].type;
+
+        offset = type->offset;
+        *byte_size = type->definition->bit_size >> 3;
+        if (cursor->n > 1 && cursor->stack[cursor->n - 2].type->backend == coda_backend_netcdf &&
+            cursor->stack[cursor->n - 2].type->definition->type_class == coda_array_class)
+        {
+            /* same offset calculation as in read_basic_type() */
+            if (type->record_var)
+            {
+                coda_netcdf_array *array = (coda_netcdf_array *)cursor->stack[cursor->n - 2].type;
+                long num_sub_elements;
+                long record_index;
+
+                num_sub_elements = array->definition->num_elements / array->definition->dim[0];
+                record_index = cursor->stack[cursor->n - 1].index / num_sub_elements;
+                offset += record_index * product->record_size;
+                offset += (cursor->stack[cursor->n - 1].index - record_index * num_sub_elements) * *byte_size;
+            }
+            else
+            {
+                offset += cursor->stack[cursor->n - 1].index * *byte_size;
+            }
+        }
+    }
+    /* netCDF data is always stored in big endian format */
+    *endianness = coda_big_endian;
+
+    return coda_bin_product_get_data_pointer(product->raw_product, offset, *byte_size, data);
+}
+
+/* Give the operating system a hint about the data of the current element and the (num_elements - 1) array elements
+ * that follow it.
+ */
+int coda_netcdf_cursor_prefetch(const coda_cursor *cursor, long num_elements)
+{
+    coda_netcdf_product *product = (coda_netcdf_product *)cursor->product;
+    int64_t offset;
+    int64_t byte_size;
+
+    if (cursor->stack[cursor->n - 1].type->definition->type_class == coda_array_class)
+    {
+        coda_netcdf_array *type = (coda_netcdf_array *)cursor->stack[cursor->n - 1].type;
+
+        offset = type->base_type->offset;
+        byte_size = type->definition->num_elements * (type->base_type->definition->bit_size >> 3);
+        if (type->base_type->record_var && type->definition->dim[0] > 1)
+        {
+            /* the span from the first to the end of the last record */
+            byte_size = (type->definition->dim[0] - 1) * product->record_size + byte_size / type->definition->dim[0];
+        }
+    }
+    else
+    {
+        coda_netcdf_basic_type *type = (coda_netcdf_basic_type *)cursor->stack[cursor->n - 1].type;
+
+        offset = type->offset;
+        byte_size = type->definition->bit_size >> 3;
+        if (cursor->n > 1 && cursor->stack[cursor->n - 2].type->backend == coda_backend_netcdf &&
+            cursor->stack[cursor->n - 2].type->definition->type_class == coda_array_class)
+        {
+            coda_netcdf_array *array = (coda_netcdf_array *)cursor->stack[cursor->n - 2].type;
+            long first_index = cursor->stack[cursor->n - 1].index;
+            long last_index = first_index + num_elements - 1;
+
+            if (last_index >= array->definition->num_elements)
+            {
+                last_index = array->definition->num_elements - 1;
+            }
+            if (type->record_var)
+            {
+                long num_sub_elements;
+                long first_record_index;
+                long last_record_index;
+
+                /* same offset calculation as in read_basic_type() */
+                num_sub_elements = array->definition->num_elements / array->definition->dim[0];
+                first_record_index = first_index / num_sub_elements;
+                last_record_index = last_index / num_sub_elements;
+                offset += first_record_index * product->record_size +
+                    (first_index - first_record_index * num_sub_elements) * byte_size;
+                byte_size += (last_record_index - first_record_index) * product->record_size +
+                    ((last_index - last_record_index * num_sub_elements) -
+                     (first_index - first_record_index * num_sub_elements)) * byte_size;
+            }
+            else
+            {
+                offset += first_index * byte_size;
+                byte_size *= last_index - first_index + 1;
+            }
+        }
+    }
+
+    return coda_bin_product_prefetch(product->raw_product, offset, byte_size);
+}
+
 int coda_netcdf_cursor_read_int8_array(const coda_cursor *cursor, int8_t *dst)
 {
     return read_array(cursor, dst);
@@ -33,6 +33,7 @@
 #include "coda-mem-internal.h"
 #include "coda-bin-internal.h"
 #include "coda-read-bytes.h"
+#include "coda-statistics.h"
 #ifndef WORDS_BIGENDIAN
 #include "coda-swap2.h"
 #include "coda-swap4.h"
@@ -811,6 +812,7 @@ int coda_netcdf_reopen(coda_product **product)
     product_file->product_variable = NULL;
     product_file->mem_size = 0;
     product_file->mem_ptr = NULL;
+    coda_statistics_init(product_file);
 
     product_file->raw_product = *product;
     product_file->netcdf_version = 1;
@@ -55,6 +55,9 @@ int coda_netcdf_cursor_read_float(const coda_cursor *cursor, float *dst);
 int coda_netcdf_cursor_read_double(const coda_cursor *cursor, double *dst);
 int coda_netcdf_cursor_read_char(const coda_cursor *cursor, char *dst);
 int coda_netcdf_cursor_read_string(const coda_cursor *cursor, char *dst, long dst_size);
+int coda_netcdf_cursor_get_data_pointer(const coda_cursor *cursor, const uint8_t **data, int64_t *byte_size,
+                                        coda_endianness *endianness);
+int coda_netcdf_cursor_prefetch(const coda_cursor *cursor, long num_elements);
 
 int coda_netcdf_cursor_read_int8_array(const coda_cursor *cursor, int8_t *dst);
 int coda_netcdf_cursor_read_int16_array(const coda_cursor *cursor, int16_t *dst);
@@ -69,5 +72,7 @@ int coda_netcdf_cursor_read_int32_partial_array(const coda_cursor *cursor, long
 int coda_netcdf_cursor_read_float_partial_array(const coda_cursor *cursor, long offset, long length, float *dst);
 int coda_netcdf_cursor_read_double_partial_array(const coda_cursor *cursor, long offset, long length, double *dst);
 int coda_netcdf_cursor_read_char_partial_array(const coda_cursor *cursor, long offset, long length, char *dst);
+int coda_netcdf_cursor_read_hyperslab(const coda_cursor *cursor, const long start[], const long count[],
+                                      const long stride[], void *dst);
 
 #endif
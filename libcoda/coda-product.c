@@ -50,11 +50,11 @@
 
 #include "coda-ascbin.h"
 #include "coda-ascii.h"
-#include "coda-bin.h"
-#include "coda-cdf.h"
-#include "coda-xml.h"
-#include "coda-netcdf.h"
-#include "coda-grib.h"
+#include "coda-bin-internal.h"
+#include "coda-cdf-internal.h"
+#include "coda-xml-internal.h"
+#include "coda-netcdf-internal.h"
+#include "coda-grib-internal.h"
 #ifdef HAVE_HDF4
 #include "coda-hdf4.h"
 #endif
@@ -64,6 +64,7 @@
 #include "coda-rinex.h"
 #include "coda-sp3.h"
 #include "coda-definition.h"
+#include "coda-statistics.h"
 
 /** \defgroup coda_product CODA Product
  * The CODA Product module contains functions and procedures to open, close and retrieve information about product
@@ -132,6 +133,18 @@
  * is a feature we encourage you to avoid on 32-bit systems because of the mmap() limitations - see
  * coda_set_option_use_mmap()). In that case CODA will just return a second product file handle which is completely
  * independent of the first product file handle you already had.
+ *
+ * A single product file handle can also be shared between multiple threads that only read from the product (i.e. that
+ * only use cursor functions, product information functions, and expressions). This avoids having to open (and detect)
+ * a large product once for every thread. Data that CODA determines on first use (such as product variables and the
+ * line offsets of ascii files) is initialized only once, and reads from memory mapped files require no locking at all.
+ * Reads that go through the block cache or through the decompression index of a compressed file are serialized per
+ * product, so for such products the speedup of using multiple threads will be limited.
+ * Each thread that accesses the product should call coda_init() itself (with the same CODA options set as in the
+ * thread that opened the product), and the product should only be closed (and CODA should only be finalized in the
+ * thread that opened the product) once all other threads are done with it.
+ * Note that this does not apply to HDF4 and HDF5 products, since the underlying HDF4 and HDF5 libraries are not
+ * thread safe.
  */
 
 /** \typedef coda_product
@@ -155,6 +168,40 @@
 
 #define DETECTION_BLOCK_SIZE 80
 
+/* get the raw 'bin' product that is used to access the data of a product (NULL if there is none) */
+static coda_product *get_raw_product(const coda_product *product)
+{
+    switch (product->format)
+    {
+        case coda_format_ascii:
+        case coda_format_binary:
+            return (coda_product *)product;
+        case coda_format_xml:
+            return ((coda_xml_product *)product)->raw_product;
+        case coda_format_cdf:
+            return ((coda_cdf_product *)product)->raw_product;
+        case coda_format_netcdf:
+            return ((coda_netcdf_product *)product)->raw_product;
+        case coda_format_grib:
+            return ((coda_grib_product *)product)->raw_product;
+        case coda_format_hdf4:
+        case coda_format_hdf5:
+        case coda_format_rinex:
+        case coda_format_sp3:
+            break;
+    }
+
+    return NULL;
+}
+
+/* returns 1 if the product was opened using coda_open_memory() and 0 otherwise */
+int coda_product_is_in_memory(const coda_product *product)
+{
+    coda_bin_product *raw_product = (coda_bin_product *)get_raw_product(product);
+
+    return raw_product != NULL && !raw_product->use_mmap && raw_product->fd < 0 && raw_product->mem_ptr != NULL;
+}
+
 static int get_file_size(const char *filename, int64_t *file_size)
 {
     struct stat statbuf;
@@ -191,6 +238,73 @@ static int get_file_size(const char *filename, int64_t *file_size)
     return 0;
 }
 
+/* Returns 1 if the file starts with a zip local file header or (for an empty archive) end of central directory
+ * signature, and 0 otherwise.
+ */
+static int has_zip_signature(const char *filename)
+{
+    unsigned char buffer[4];
+    int open_flags;
+    int result;
+    int fd;
+
+    open_flags = O_RDONLY;
+#ifdef WIN32
+    open_flags |= _O_BINARY;
+#endif
+    fd = open(filename, open_flags);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    result = (read(fd, buffer, 4) == 4 && buffer[0] == 'P' && buffer[1] == 'K' &&
+              ((buffer[2] == 3 && buffer[3] == 4) || (buffer[2] == 5 && buffer[3] == 6)));
+    close(fd);
+
+    return result;
+}
+
+/* If 'filename' refers to an entry inside a zip file (e.g. archive.zip/path/in/archive/product.nc), this function
+ * returns the length of the leading part of 'filename' that is the name of the zip file. Otherwise it returns 0.
+ */
+static long get_zip_filename_length(const char *filename)
+{
+    struct stat statbuf;
+    char *path;
+    long i;
+
+    path = strdup(filename);
+    if (path == NULL)
+    {
+        return 0;
+    }
+    for (i = 1; path[i] != '\0'; i++)
+    {
+        if (path[i] == '/')
+        {
+            path[i] = '\0';
+            if (stat(path, &statbuf) != 0)
+            {
+                break;
+            }
+            if ((statbuf.st_mode & S_IFMT) == S_IFREG)
+            {
+                /* only a zip file can have a path component after a regular file */
+                if (!has_zip_signature(path))
+                {
+                    break;
+                }
+                free(path);
+                return i;
+            }
+            path[i] = '/';
+        }
+    }
+    free(path);
+
+    return 0;
+}
+
 static int get_format(coda_product *raw_product, coda_format *format)
 {
     unsigned char buffer[DETECTION_BLOCK_SIZE];
@@ -349,6 +463,38 @@ static int get_format(coda_product *raw_product, coda_format *format)
     return 0;
 }
 
+/* get_format() that keeps track of the time spent on detection */
+static int detect_format(coda_product *raw_product, coda_format *format)
+{
+#ifdef ENABLE_STATISTICS
+    double start_time = coda_statistics_get_time();
+    int result;
+
+    result = get_format(raw_product, format);
+    coda_thread_statistics.detection_time += coda_statistics_get_time() - start_time;
+
+    return result;
+#else
+    return get_format(raw_product, format);
+#endif
+}
+
+/* coda_data_dictionary_find_definition_for_product() that keeps track of the time spent on detection */
+static int detect_definition(coda_product *product, coda_product_definition **definition)
+{
+#ifdef ENABLE_STATISTICS
+    double start_time = coda_statistics_get_time();
+    int result;
+
+    result = coda_data_dictionary_find_definition_for_product(product, definition);
+    coda_thread_statistics.detection_time += coda_statistics_get_time() - start_time;
+
+    return result;
+#else
+    return coda_data_dictionary_find_definition_for_product(product, definition);
+#endif
+}
+
 static int reopen_with_backend(coda_product **product_file, coda_format format)
 {
     /* the input product_file is a raw binary product
@@ -525,13 +671,25 @@ static int open_file(const char *filename, coda_product **product_file, int forc
 
     if (get_file_size(filename, &file_size) != 0)
     {
-        return -1;
-    }
+        long zip_filename_length;
 
-    /* we open the file as a 'raw file' which maps the whole file as a single binary raw data block */
-    if (coda_bin_open(filename, file_size, &product) != 0)
+        zip_filename_length = get_zip_filename_length(filename);
+        if (zip_filename_length == 0)
+        {
+            return -1;
+        }
+        if (coda_bin_open_zip_entry(filename, zip_filename_length, &product) != 0)
+        {
+            return -1;
+        }
+    }
+    else
     {
-        return -1;
+        /* we open the file as a 'raw file' which maps the whole file as a single binary raw data block */
+        if (coda_bin_open(filename, file_size, &product) != 0)
+        {
+            return -1;
+        }
     }
 
     if (force_binary)
@@ -540,8 +698,18 @@ static int open_file(const char *filename, coda_product **product_file, int forc
     }
     else
     {
-        if (get_format(product, &format) != 0)
+        if (detect_format(product, &format) != 0)
+        {
+            coda_close(product);
+            return -1;
+        }
+        if ((((coda_bin_product *)product)->inflate_index != NULL || ((coda_bin_product *)product)->file_offset != 0)
+            && (format == coda_format_hdf4 || format == coda_format_hdf5 || format == coda_format_rinex ||
+                format == coda_format_sp3))
         {
+            /* these backends access the file directly using its filename */
+            coda_set_error(CODA_ERROR_UNSUPPORTED_PRODUCT, "opening %s products that are compressed or that are "
+                           "stored inside a zip file is not supported", coda_type_get_format_name(format));
             coda_close(product);
             return -1;
         }
@@ -595,7 +763,7 @@ LIBCODA_API int coda_recognize_file(const char *filename, int64_t *file_size, co
     {
         return -1;
     }
-    if (coda_data_dictionary_find_definition_for_product(product, &definition) != 0)
+    if (detect_definition(product, &definition) != 0)
     {
         coda_close(product);
         return -1;
@@ -652,6 +820,12 @@ LIBCODA_API int coda_recognize_file(const char *filename, int64_t *file_size, co
 /** Open a product file for reading.
  * This function will try to open the specified file for reading. On success a newly allocated file handle will be
  * returned. The memory for this file handle will be released when coda_close() is called for this handle.
+ *
+ * Products can also be opened directly from within a zip file (without extracting them) by passing the path of the
+ * zip file followed by the path of the entry within the zip file (e.g. "S1A_product.zip/S1A_product.SAFE/x.nc").
+ * Entries that are stored without compression are accessed in place (using memory mapping if enabled), compressed
+ * entries are decompressed on demand. ZIP64 archives are supported. HDF4, HDF5, RINEX, and SP3 products can not be
+ * opened from within a zip file.
  * \param filename Relative or full path to the product file.
  * \param product Pointer to the variable where the pointer to the product file handle will be storeed.
  * \return
@@ -662,6 +836,9 @@ LIBCODA_API int coda_open(const char *filename, coda_product **product)
 {
     coda_product_definition *definition = NULL;
     coda_product *product_file;
+#ifdef ENABLE_STATISTICS
+    coda_statistics_open open_statistics;
+#endif
 
     if (filename == NULL)
     {
@@ -674,11 +851,14 @@ LIBCODA_API int coda_open(const char *filename, coda_product **product)
         return -1;
     }
 
+#ifdef ENABLE_STATISTICS
+    coda_statistics_begin_open(&open_statistics);
+#endif
     if (open_file(filename, &product_file, 0) != 0)
     {
         return -1;
     }
-    if (coda_data_dictionary_find_definition_for_product(product_file, &definition) != 0)
+    if (detect_definition(product_file, &definition) != 0)
     {
         coda_close(product_file);
         return -1;
@@ -688,6 +868,110 @@ LIBCODA_API int coda_open(const char *filename, coda_product **product)
         coda_close(product_file);
         return -1;
     }
+#ifdef ENABLE_STATISTICS
+    coda_statistics_end_open(&open_statistics, product_file, get_raw_product(product_file));
+#endif
+
+    *product = product_file;
+
+    return 0;
+}
+
+/** Open a product that is stored in memory.
+ * This function is similar to coda_open(), but instead of reading the product from a file, the product data is taken
+ * from the memory block \a buffer of \a size bytes. The product goes through the same format detection and automatic
+ * product recognition as a product file that is opened with coda_open(), where \a name is used as filename (e.g. for
+ * recognition rules that are based on the filename and for error messages).
+ *
+ * CODA does not copy the data, so the buffer should remain valid and unmodified until the product is closed.
+ * If \a free_buffer is not NULL, CODA takes ownership of the buffer as soon as this function is called and will call
+ * \a free_buffer with \a buffer as argument when the product is closed (or when this function fails). Pass NULL for
+ * \a free_buffer if you want to keep ownership of the buffer yourself.
+ *
+ * Products in HDF4, HDF5, RINEX, or SP3 format can not be opened from memory.
+ * \param buffer Pointer to the product data.
+ * \param size Size of the product data in bytes.
+ * \param name Name that will be used as filename of the product.
+ * \param free_buffer Function that will be used to release \a buffer (can be NULL).
+ * \param product Pointer to the variable where the pointer to the product file handle will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_open_memory(const void *buffer, int64_t size, const char *name, void (*free_buffer) (void *),
+                                 coda_product **product)
+{
+    coda_product_definition *definition = NULL;
+    coda_product *product_file;
+    coda_format format;
+#ifdef ENABLE_STATISTICS
+    coda_statistics_open open_statistics;
+#endif
+
+    if (buffer == NULL || size < 0 || name == NULL || product == NULL)
+    {
+        if (buffer == NULL)
+        {
+            coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "buffer argument is NULL (%s:%u)", __FILE__, __LINE__);
+        }
+        else if (size < 0)
+        {
+            coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "size argument is negative (%s:%u)", __FILE__, __LINE__);
+        }
+        else if (name == NULL)
+        {
+            coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "name argument is NULL (%s:%u)", __FILE__, __LINE__);
+        }
+        else
+        {
+            coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "product argument is NULL (%s:%u)", __FILE__, __LINE__);
+        }
+        if (buffer != NULL && free_buffer != NULL)
+        {
+            free_buffer((void *)buffer);
+        }
+        return -1;
+    }
+
+#ifdef ENABLE_STATISTICS
+    coda_statistics_begin_open(&open_statistics);
+#endif
+    /* the buffer is treated as a 'raw file' which maps the whole buffer as a single binary raw data block */
+    if (coda_bin_open_memory(name, (const uint8_t *)buffer, size, free_buffer, &product_file) != 0)
+    {
+        return -1;
+    }
+    if (detect_format(product_file, &format) != 0)
+    {
+        coda_close(product_file);
+        return -1;
+    }
+    if (format == coda_format_hdf4 || format == coda_format_hdf5 || format == coda_format_rinex ||
+        format == coda_format_sp3)
+    {
+        coda_set_error(CODA_ERROR_UNSUPPORTED_PRODUCT, "opening %s products from memory is not supported",
+                       coda_type_get_format_name(format));
+        coda_close(product_file);
+        return -1;
+    }
+    if (reopen_with_backend(&product_file, format) != 0)
+    {
+        /* no need to close 'product_file' as this should already have been done by the backend */
+        return -1;
+    }
+    if (detect_definition(product_file, &definition) != 0)
+    {
+        coda_close(product_file);
+        return -1;
+    }
+    if (set_definition(&product_file, definition) != 0)
+    {
+        coda_close(product_file);
+        return -1;
+    }
+#ifdef ENABLE_STATISTICS
+    coda_statistics_end_open(&open_statistics, product_file, get_raw_product(product_file));
+#endif
 
     *product = product_file;
 
@@ -713,6 +997,9 @@ LIBCODA_API int coda_open_as(const char *filename, const char *product_class, co
     coda_product_definition *definition = NULL;
     coda_product *product_file;
     int open_as_binary = 0;
+#ifdef ENABLE_STATISTICS
+    coda_statistics_open open_statistics;
+#endif
 
     if (filename == NULL)
     {
@@ -733,6 +1020,9 @@ LIBCODA_API int coda_open_as(const char *filename, const char *product_class, co
         }
     }
 
+#ifdef ENABLE_STATISTICS
+    coda_statistics_begin_open(&open_statistics);
+#endif
     if (product_class != NULL)
     {
         if (coda_data_dictionary_get_definition(product_class, product_type, version, &definition) != 0)
@@ -756,6 +1046,9 @@ LIBCODA_API int coda_open_as(const char *filename, const char *product_class, co
         coda_close(product_file);
         return -1;
     }
+#ifdef ENABLE_STATISTICS
+    coda_statistics_end_open(&open_statistics, product_file, get_raw_product(product_file));
+#endif
 
     *product = product_file;
 
@@ -1098,6 +1391,170 @@ LIBCODA_API int coda_get_product_definition_file(const coda_product *product, co
     return 0;
 }
 
+/** Get the statistics of the bit size cache of a product.
+ * The bit size cache is only used for ascii and binary products and only if it was enabled using
+ * coda_set_option_bit_size_cache() at the time the product was opened. For other products both \a num_hits and
+ * \a num_misses will be 0.
+ * Each calculation of the size of a variable sized data element that could be taken from the cache counts as a hit.
+ * Each time the size needed to be calculated counts as a miss.
+ * \param product Pointer to a product file handle.
+ * \param num_hits Pointer to the variable where the number of cache hits will be stored.
+ * \param num_misses Pointer to the variable where the number of cache misses will be stored.
+ * \return
+ *   \arg \c 0, Success
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_get_product_bit_size_cache_statistics(const coda_product *product, int64_t *num_hits,
+                                                          int64_t *num_misses)
+{
+    if (product == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "product file argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (num_hits == NULL || num_misses == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "statistics argument(s) are NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    *num_hits = 0;
+    *num_misses = 0;
+    if ((product->format == coda_format_ascii || product->format == coda_format_binary) &&
+        ((coda_bin_product *)product)->size_cache != NULL)
+    {
+        coda_size_cache_get_statistics(((coda_bin_product *)product)->size_cache, num_hits, num_misses);
+    }
+
+    return 0;
+}
+
+/** Get the statistics of the block cache of a product.
+ * The block cache is only used for products that are not memory mapped and only if it was enabled using
+ * coda_set_option_block_cache() at the time the product was opened. If the product has no block cache then both
+ * \a num_hits and \a num_misses will be 0.
+ * Each read of a data element that could be served from a block in the cache counts as a hit. Each time blocks
+ * needed to be read from the file counts as a miss.
+ * \param product Pointer to a product file handle.
+ * \param num_hits Pointer to the variable where the number of cache hits will be stored.
+ * \param num_misses Pointer to the variable where the number of cache misses will be stored.
+ * \return
+ *   \arg \c 0, Success
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_get_product_block_cache_statistics(const coda_product *product, int64_t *num_hits,
+                                                       int64_t *num_misses)
+{
+    coda_product *raw_product;
+
+    if (product == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "product file argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (num_hits == NULL || num_misses == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "statistics argument(s) are NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    raw_product = get_raw_product(product);
+    *num_hits = 0;
+    *num_misses = 0;
+    if (raw_product != NULL)
+    {
+        coda_bin_product_get_cache_statistics(raw_product, num_hits, num_misses);
+    }
+
+    return 0;
+}
+
+/** Get the statistics of a product.
+ * The statistics cover all work that CODA performed for the product since it was opened (including the work done
+ * while opening it, such as the detection of the product type) or since the last call to
+ * coda_reset_product_statistics(). If the product is accessed from multiple threads, the statistics include the work
+ * of all those threads. Use coda_get_thread_statistics() to get the statistics for the current thread only.
+ *
+ * The read statistics include all data that was read by CODA itself. Data that is read by the HDF4 and HDF5 libraries
+ * and the parsing of RINEX and SP3 products (which is done while opening the product) is not included.
+ *
+ * Statistics are only collected if CODA was built with statistics support (the \c --enable-statistics configure
+ * option or the \c CODA_ENABLE_STATISTICS CMake option). Otherwise this function returns an error.
+ * \param product Pointer to a product file handle.
+ * \param statistics Pointer to the variable where the statistics will be stored.
+ * \return
+ *   \arg \c 0, Success
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_get_product_statistics(const coda_product *product, coda_statistics *statistics)
+{
+#ifdef ENABLE_STATISTICS
+    coda_product *raw_product;
+#endif
+
+    if (product == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "product file argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (statistics == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "statistics argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+#ifdef ENABLE_STATISTICS
+    *statistics = product->statistics;
+    /* reads are counted for the raw product that the backend reads from */
+    raw_product = get_raw_product(product);
+    if (raw_product != NULL && raw_product != product)
+    {
+        coda_statistics_sum(statistics, &raw_product->statistics);
+    }
+
+    return 0;
+#else
+    coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "statistics are not available (this version of CODA was not built "
+                   "with statistics support)");
+    return -1;
+#endif
+}
+
+/** Reset all statistics of a product to zero.
+ * This does not change the statistics of the current thread.
+ * \param product Pointer to a product file handle.
+ * \return
+ *   \arg \c 0, Success
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_reset_product_statistics(coda_product *product)
+{
+#ifdef ENABLE_STATISTICS
+    coda_product *raw_product;
+#endif
+
+    if (product == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "product file argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+#ifdef ENABLE_STATISTICS
+    coda_statistics_init(product);
+    raw_product = get_raw_product(product);
+    if (raw_product != NULL && raw_product != product)
+    {
+        coda_statistics_init(raw_product);
+    }
+
+    return 0;
+#else
+    coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "statistics are not available (this version of CODA was not built "
+                   "with statistics support)");
+    return -1;
+#endif
+}
+
 /** Get the value for a product variable.
  * CODA supports a mechanism called product variables to store frequently needed information of a product (i.e.
  * information that is needed to calculate byte offsets or array sizes within a product). With this function you
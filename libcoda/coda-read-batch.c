@@ -0,0 +1,632 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef __linux__
+/* needed for syscall() and MAP_POPULATE (config.h may define _XOPEN_SOURCE, which hides them) */
+#define _GNU_SOURCE
+#endif
+
+#include "coda-bin-internal.h"
+#include "coda-statistics.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if defined(HAVE_PTHREAD) && defined(HAVE_PREAD)
+#include <pthread.h>
+#endif
+#if defined(HAVE_LINUX_IO_URING_H) && defined(HAVE_PREAD) && defined(__GNUC__)
+#define USE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+/* batches with less requests than this are just read one request at a time */
+#define MIN_ASYNC_REQUESTS 8
+
+/* batches with less data than this are not read using threads (starting the threads would cost more than it gains) */
+#define MIN_THREADED_BYTES (1 << 20)
+
+/* maximum number of reads that are in flight at the same time */
+#define MAX_QUEUE_DEPTH 256
+
+/* maximum number of threads that are used for reading when io_uring is not available */
+#define MAX_READ_THREADS 4
+
+/* a sequence of requests that are contiguous both in the file and in memory is read using a single read operation */
+typedef struct read_run_struct
+{
+    int64_t byte_offset;
+    int64_t length;
+    uint8_t *dst;
+#ifdef USE_IO_URING
+    struct iovec iov;
+#endif
+} read_run;
+
+/* the byte offsets of the runs are file offsets (i.e. they include the offset of the product data within the file) */
+static long create_runs(int64_t file_offset, long num_requests, const coda_bin_read_request *request, read_run *run)
+{
+    long num_runs = 0;
+    long i;
+
+    for (i = 0; i < num_requests; i++)
+    {
+        if (request[i].length == 0)
+        {
+            continue;
+        }
+        if (num_runs > 0 &&
+            run[num_runs - 1].byte_offset + run[num_runs - 1].length == file_offset + request[i].byte_offset &&
+            run[num_runs - 1].dst + run[num_runs - 1].length == (uint8_t *)request[i].dst)
+        {
+            run[num_runs - 1].length += request[i].length;
+        }
+        else
+        {
+            run[num_runs].byte_offset = file_offset + request[i].byte_offset;
+            run[num_runs].length = request[i].length;
+            run[num_runs].dst = (uint8_t *)request[i].dst;
+            num_runs++;
+        }
+    }
+
+    return num_runs;
+}
+
+#ifdef HAVE_PREAD
+/* read the full run (pread may return less data than requested); returns 0 or an errno value */
+static int read_run_from_file(int fd, const read_run *run, int64_t done)
+{
+    while (done < run->length)
+    {
+        ssize_t result;
+
+        result = pread(fd, run->dst + done, (size_t)(run->length - done), (off_t)(run->byte_offset + done));
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return errno;
+        }
+        if (result == 0)
+        {
+            /* unexpected end of file; leave the remainder as is (same behaviour as for a single read) */
+            break;
+        }
+        done += result;
+    }
+
+    return 0;
+}
+#endif
+
+#ifdef USE_IO_URING
+
+/* the io_uring instance of a product is created when it is first needed and is reused for all batches that follow */
+struct coda_bin_reader_struct
+{
+    int fd;
+    unsigned int num_entries;
+    void *sq_ptr;
+    size_t sq_size;
+    void *cq_ptr;
+    size_t cq_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned int *sq_head;
+    unsigned int *sq_tail;
+    unsigned int *sq_mask;
+    unsigned int *sq_array;
+    unsigned int *cq_head;
+    unsigned int *cq_tail;
+    unsigned int *cq_mask;
+    struct io_uring_cqe *cqes;
+    int failed;         /* set if the state of the ring is unknown (after a failed io_uring_enter) */
+};
+typedef struct coda_bin_reader_struct io_ring;
+
+/* set once io_uring turned out to be unavailable, so we don't try to set up a ring for every batch */
+static int io_uring_unavailable = 0;
+
+static void io_ring_done(io_ring *ring)
+{
+    if (ring->sqes != NULL)
+    {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ptr != NULL && ring->cq_ptr != ring->sq_ptr)
+    {
+        munmap(ring->cq_ptr, ring->cq_size);
+    }
+    if (ring->sq_ptr != NULL)
+    {
+        munmap(ring->sq_ptr, ring->sq_size);
+    }
+    if (ring->fd >= 0)
+    {
+        close(ring->fd);
+    }
+}
+
+/* returns 0 on success and -1 if io_uring is not available */
+static int io_ring_init(io_ring *ring, unsigned int num_entries)
+{
+    struct io_uring_params params;
+    void *ptr;
+
+    ring->sq_ptr = NULL;
+    ring->cq_ptr = NULL;
+    ring->sqes = NULL;
+    ring->failed = 0;
+
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, num_entries, &params);
+    if (ring->fd < 0)
+    {
+        return -1;
+    }
+    ring->num_entries = params.sq_entries;
+
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ring->cq_size > ring->sq_size)
+        {
+            ring->sq_size = ring->cq_size;
+        }
+        ring->cq_size = ring->sq_size;
+    }
+    ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ptr == MAP_FAILED)
+    {
+        io_ring_done(ring);
+        return -1;
+    }
+    ring->sq_ptr = ptr;
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        ring->cq_ptr = ring->sq_ptr;
+    }
+    else
+    {
+        ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                   IORING_OFF_CQ_RING);
+        if (ptr == MAP_FAILED)
+        {
+            io_ring_done(ring);
+            return -1;
+        }
+        ring->cq_ptr = ptr;
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ptr = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ptr == MAP_FAILED)
+    {
+        io_ring_done(ring);
+        return -1;
+    }
+    ring->sqes = (struct io_uring_sqe *)ptr;
+
+    ring->sq_head = (unsigned int *)((uint8_t *)ring->sq_ptr + params.sq_off.head);
+    ring->sq_tail = (unsigned int *)((uint8_t *)ring->sq_ptr + params.sq_off.tail);
+    ring->sq_mask = (unsigned int *)((uint8_t *)ring->sq_ptr + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned int *)((uint8_t *)ring->sq_ptr + params.sq_off.array);
+    ring->cq_head = (unsigned int *)((uint8_t *)ring->cq_ptr + params.cq_off.head);
+    ring->cq_tail = (unsigned int *)((uint8_t *)ring->cq_ptr + params.cq_off.tail);
+    ring->cq_mask = (unsigned int *)((uint8_t *)ring->cq_ptr + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)((uint8_t *)ring->cq_ptr + params.cq_off.cqes);
+
+    return 0;
+}
+
+/* take the io_uring instance of the product (creating it if needed); returns NULL if io_uring can not be used.
+ * A product can be read by several threads at once, so the ring is taken out of the product while it is in use;
+ * a thread that finds no ring in the product creates its own one.
+ */
+static io_ring *io_ring_acquire(coda_bin_product *product)
+{
+    io_ring *ring;
+
+    ring = __atomic_exchange_n(&product->reader, NULL, __ATOMIC_ACQUIRE);
+    if (ring != NULL || __atomic_load_n(&io_uring_unavailable, __ATOMIC_RELAXED))
+    {
+        return ring;
+    }
+    ring = malloc(sizeof(io_ring));
+    if (ring == NULL)
+    {
+        return NULL;
+    }
+    if (io_ring_init(ring, MAX_QUEUE_DEPTH) != 0)
+    {
+        __atomic_store_n(&io_uring_unavailable, 1, __ATOMIC_RELAXED);
+        free(ring);
+        return NULL;
+    }
+
+    return ring;
+}
+
+/* put the io_uring instance back in the product (it is deleted if the product already has one again) */
+static void io_ring_release(coda_bin_product *product, io_ring *ring)
+{
+    io_ring *expected = NULL;
+
+    if (ring->failed ||
+        !__atomic_compare_exchange_n(&product->reader, &expected, ring, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    {
+        io_ring_done(ring);
+        free(ring);
+    }
+}
+
+/* Submit all runs to the kernel (keeping at most 'num_entries' reads in flight) and wait until they are all complete.
+ * Runs complete out of order. Short reads are completed synchronously.
+ * Returns 0 on success, -1 on error, and -2 if io_uring could not be used (in which case nothing has been read).
+ */
+static int read_runs_io_uring(io_ring *ring, int fd, long num_runs, read_run *run)
+{
+    long next_run = 0;
+    long num_completed = 0;
+    long num_in_flight = 0;
+    int error = 0;
+
+    while (num_completed < num_runs)
+    {
+        unsigned int tail = *ring->sq_tail;
+        unsigned int head;
+        unsigned int num_submit = 0;
+        int result;
+
+        while (next_run < num_runs && error == 0 && num_in_flight < (long)ring->num_entries)
+        {
+            unsigned int index = tail & *ring->sq_mask;
+            struct io_uring_sqe *sqe = &ring->sqes[index];
+
+            run[next_run].iov.iov_base = run[next_run].dst;
+            run[next_run].iov.iov_len = (size_t)run[next_run].length;
+            memset(sqe, 0, sizeof(struct io_uring_sqe));
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = fd;
+            sqe->off = (uint64_t)run[next_run].byte_offset;
+            sqe->addr = (uint64_t)(uintptr_t)&run[next_run].iov;
+            sqe->len = 1;
+            sqe->user_data = (uint64_t)next_run;
+            ring->sq_array[index] = index;
+            tail++;
+            num_submit++;
+            num_in_flight++;
+            next_run++;
+        }
+        __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+        if (num_in_flight == 0)
+        {
+            /* an error occurred and everything that was in flight has completed */
+            break;
+        }
+        result = (int)syscall(__NR_io_uring_enter, ring->fd, num_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            /* the submission queue may still contain entries, so the ring can not be reused */
+            ring->failed = 1;
+            if (num_completed == 0 && num_submit == (unsigned int)num_in_flight)
+            {
+                /* nothing was submitted, so we can still fall back to another method */
+                return -2;
+            }
+            coda_set_error(CODA_ERROR_FILE_READ, "could not read from file (%s)", strerror(errno));
+            return -1;
+        }
+
+        head = *ring->cq_head;
+        while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+        {
+            struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+            long run_index = (long)cqe->user_data;
+
+            if (cqe->res < 0)
+            {
+                if (error == 0)
+                {
+                    error = -cqe->res;
+                }
+            }
+            else if (cqe->res < run[run_index].length && error == 0)
+            {
+                error = read_run_from_file(fd, &run[run_index], cqe->res);
+            }
+            head++;
+            num_completed++;
+            num_in_flight--;
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    if (error != 0)
+    {
+        coda_set_error(CODA_ERROR_FILE_READ, "could not read from file (%s)", strerror(error));
+        return -1;
+    }
+
+    return 0;
+}
+
+#endif
+
+#if defined(HAVE_PTHREAD) && defined(HAVE_PREAD)
+
+typedef struct read_pool_struct
+{
+    int fd;
+    long num_runs;
+    read_run *run;
+    long next_run;
+    int error;
+    pthread_mutex_t mutex;
+} read_pool;
+
+static void *read_pool_worker(void *arg)
+{
+    read_pool *pool = (read_pool *)arg;
+
+    for (;;)
+    {
+        long run_index;
+        int error;
+
+        pthread_mutex_lock(&pool->mutex);
+        run_index = pool->next_run;
+        if (pool->error != 0)
+        {
+            run_index = pool->num_runs;
+        }
+        if (run_index < pool->num_runs)
+        {
+            pool->next_run++;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+        if (run_index >= pool->num_runs)
+        {
+            break;
+        }
+
+        /* worker threads have their own (thread local) CODA error state, so just pass back the errno value */
+        error = read_run_from_file(pool->fd, &pool->run[run_index], 0);
+        if (error != 0)
+        {
+            pthread_mutex_lock(&pool->mutex);
+            if (pool->error == 0)
+            {
+                pool->error = error;
+            }
+            pthread_mutex_unlock(&pool->mutex);
+        }
+    }
+
+    return NULL;
+}
+
+/* read the runs using a small pool of threads that each perform blocking pread() calls */
+static int read_runs_threaded(int fd, long num_runs, read_run *run)
+{
+    pthread_t thread[MAX_READ_THREADS - 1];
+    read_pool pool;
+    int num_threads = 0;
+    int i;
+
+    pool.fd = fd;
+    pool.num_runs = num_runs;
+    pool.run = run;
+    pool.next_run = 0;
+    pool.error = 0;
+    pthread_mutex_init(&pool.mutex, NULL);
+
+    /* the calling thread acts as one of the readers */
+    while (num_threads < MAX_READ_THREADS - 1 && num_threads < num_runs - 1)
+    {
+        if (pthread_create(&thread[num_threads], NULL, read_pool_worker, &pool) != 0)
+        {
+            break;
+        }
+        num_threads++;
+    }
+    read_pool_worker(&pool);
+    for (i = 0; i < num_threads; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+    pthread_mutex_destroy(&pool.mutex);
+
+    if (pool.error != 0)
+    {
+        coda_set_error(CODA_ERROR_FILE_READ, "could not read from file (%s)", strerror(pool.error));
+        return -1;
+    }
+
+    return 0;
+}
+
+#endif
+
+#if defined(USE_IO_URING) || (defined(HAVE_PTHREAD) && defined(HAVE_PREAD))
+static void add_file_read_statistics(coda_product *product, long num_runs, const read_run *run)
+{
+#ifdef ENABLE_STATISTICS
+    long i;
+
+    for (i = 0; i < num_runs; i++)
+    {
+        coda_statistics_add(product, num_file_reads, 1);
+        coda_statistics_add(product, num_file_bytes_read, run[i].length);
+    }
+#else
+    (void)product;
+    (void)num_runs;
+    (void)run;
+#endif
+}
+#endif
+
+void coda_bin_reader_delete(coda_bin_reader *reader)
+{
+#ifdef USE_IO_URING
+    io_ring_done(reader);
+    free(reader);
+#else
+    /* readers are only created when io_uring is used */
+    assert(reader == NULL);
+#endif
+}
+
+/* Read a batch of (possibly scattered) blocks of data from a product.
+ * For products that are accessed using a file descriptor, requests that are adjacent both in the file and in memory
+ * are merged, and the resulting reads are all submitted at once using io_uring (on Linux, using an io_uring instance
+ * that is kept with the product) or, if that is not available and the batch is large enough, performed by a small pool
+ * of threads. The reads can complete in any order.
+ * Products that are memory mapped, gzip compressed, or that have a block cache are read one request at a time.
+ */
+int coda_bin_product_read_batch(coda_product *product, long num_requests, const coda_bin_read_request *request)
+{
+    coda_bin_product *product_file = (coda_bin_product *)product;
+    read_run *run;
+    int64_t num_bytes = 0;
+    long num_runs;
+    long i;
+
+    for (i = 0; i < num_requests; i++)
+    {
+        if (request[i].byte_offset < 0 || request[i].length < 0 ||
+            ((uint64_t)request[i].byte_offset + request[i].length) > ((uint64_t)product->file_size))
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_BOUNDS_READ, "trying to read beyond the end of the file");
+            return -1;
+        }
+        coda_statistics_add(product, num_reads, 1);
+        coda_statistics_add(product, num_bytes_read, request[i].length);
+        num_bytes += request[i].length;
+    }
+
+    if (product->mem_ptr != NULL)
+    {
+        for (i = 0; i < num_requests; i++)
+        {
+            memcpy(request[i].dst, product->mem_ptr + request[i].byte_offset, (size_t)request[i].length);
+            coda_statistics_add(product, num_memory_reads, 1);
+            coda_statistics_add(product, num_memory_bytes_read, request[i].length);
+        }
+        return 0;
+    }
+
+    if (num_requests < MIN_ASYNC_REQUESTS || product_file->cache != NULL || product_file->inflate_index != NULL)
+    {
+        for (i = 0; i < num_requests; i++)
+        {
+            if (coda_bin_product_read(product, request[i].byte_offset, request[i].length, request[i].dst) != 0)
+            {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    run = malloc(num_requests * sizeof(read_run));
+    if (run == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       num_requests * sizeof(read_run), __FILE__, __LINE__);
+        return -1;
+    }
+    num_runs = create_runs(product_file->file_offset, num_requests, request, run);
+
+    if (num_runs > 1)
+    {
+#ifdef USE_IO_URING
+        io_ring *ring;
+
+        ring = io_ring_acquire(product_file);
+        if (ring != NULL)
+        {
+            int result;
+
+            result = read_runs_io_uring(ring, product_file->fd, num_runs, run);
+            io_ring_release(product_file, ring);
+            if (result != -2)
+            {
+                add_file_read_statistics(product, num_runs, run);
+                free(run);
+                return result;
+            }
+            __atomic_store_n(&io_uring_unavailable, 1, __ATOMIC_RELAXED);
+        }
+#endif
+#if defined(HAVE_PTHREAD) && defined(HAVE_PREAD)
+        if (num_bytes >= MIN_THREADED_BYTES)
+        {
+            add_file_read_statistics(product, num_runs, run);
+            if (read_runs_threaded(product_file->fd, num_runs, run) != 0)
+            {
+                free(run);
+                return -1;
+            }
+            free(run);
+            return 0;
+        }
+#endif
+    }
+
+    for (i = 0; i < num_runs; i++)
+    {
+        if (coda_bin_product_read(product, run[i].byte_offset - product_file->file_offset, run[i].length,
+                                  run[i].dst) != 0)
+        {
+            free(run);
+            return -1;
+        }
+    }
+    free(run);
+
+    return 0;
+}
@@ -224,4 +224,68 @@ static int read_bits(coda_product *product, int64_t bit_offset, int64_t bit_leng
     return 0;
 }
 
+/* maximum number of bytes that read_packed_bits() reads from the product at once */
+#define PACKED_BITS_BLOCK_SIZE 4096
+
+/* Extract 'num_elements' consecutive unsigned big endian integers of 'bit_size' bits each (1 <= bit_size <= 64).
+ * The first value starts 'bit_pos' bits after the most significant bit of src[0].
+ * Each value is extracted by loading the 8 bytes that start at the byte containing its first bit as a single 64 bit
+ * big endian word (plus a 9th byte if the value does not fit in that word). The caller must make sure that at least
+ * 8 bytes can be read beyond the byte that contains the last bit.
+ */
+static void unpack_bits(const uint8_t *src, unsigned long bit_pos, int bit_size, long num_elements, uint64_t *dst)
+{
+    unsigned long value_shift = 64 - bit_size;
+    long i;
+
+    for (i = 0; i < num_elements; i++)
+    {
+        const uint8_t *p = &src[bit_pos >> 3];
+        unsigned long bit_shift = bit_pos & 0x7;
+        uint64_t value;
+
+        value = ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+            ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+        if (bit_shift != 0)
+        {
+            value = (value << bit_shift) | (p[8] >> (8 - bit_shift));
+        }
+        dst[i] = value >> value_shift;
+        bit_pos += bit_size;
+    }
+}
+
+/* Read 'num_elements' consecutive unsigned integers of 'bit_size' bits (1 <= bit_size <= 64) starting at 'bit_offset'.
+ * The bits of each value are interpreted as a big endian number (i.e. in the same way as read_bits() does) and each
+ * value is stored as an uint64_t in dst.
+ */
+static int read_packed_bits(coda_product *product, int64_t bit_offset, int bit_size, long num_elements, uint64_t *dst)
+{
+    uint8_t buffer[PACKED_BITS_BLOCK_SIZE + 9];
+    long max_block_elements;
+
+    assert(bit_size >= 1 && bit_size <= 64);
+
+    /* leave room for the padding bits in the first byte */
+    max_block_elements = (8 * PACKED_BITS_BLOCK_SIZE - 7) / bit_size;
+    while (num_elements > 0)
+    {
+        long block_elements = num_elements < max_block_elements ? num_elements : max_block_elements;
+        int64_t num_bytes = ((bit_offset & 0x7) + block_elements * bit_size + 7) >> 3;
+
+        if (read_bytes(product, bit_offset >> 3, num_bytes, buffer) != 0)
+        {
+            return -1;
+        }
+        /* unpack_bits() may read up to 8 bytes beyond the last byte */
+        memset(&buffer[num_bytes], 0, 9);
+        unpack_bits(buffer, (unsigned long)(bit_offset & 0x7), bit_size, block_elements, dst);
+        dst += block_elements;
+        bit_offset += block_elements * bit_size;
+        num_elements -= block_elements;
+    }
+
+    return 0;
+}
+
 #endif
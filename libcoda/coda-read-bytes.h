@@ -33,6 +33,7 @@
 #define CODA_READ_BYTES_H
 
 #include "coda-bin-internal.h"
+#include "coda-statistics.h"
 
 #include <assert.h>
 #include <errno.h>
@@ -53,6 +54,8 @@
 
 static int read_bytes(coda_product *product, int64_t byte_offset, int64_t length, void *dst)
 {
+    coda_statistics_add(product, num_reads, 1);
+    coda_statistics_add(product, num_bytes_read, length);
     if (product->mem_ptr != NULL)
     {
         if (((uint64_t)byte_offset + length) > ((uint64_t)product->mem_size))
@@ -77,6 +80,8 @@ static int read_bytes(coda_product *product, int64_t byte_offset, int64_t length
             }
         }
         memcpy(dst, product->mem_ptr + byte_offset, (size_t)length);
+        coda_statistics_add(product, num_memory_reads, 1);
+        coda_statistics_add(product, num_memory_bytes_read, length);
     }
     else
     {
@@ -86,28 +91,7 @@ static int read_bytes(coda_product *product, int64_t byte_offset, int64_t length
             coda_set_error(CODA_ERROR_OUT_OF_BOUNDS_READ, "trying to read beyond the end of the file");
             return -1;
         }
-#if HAVE_PREAD
-        if (pread(((coda_bin_product *)product)->fd, dst, (size_t)length, (off_t)byte_offset) < 0)
-        {
-            coda_set_error(CODA_ERROR_FILE_READ, "could not read from file (%s)", strerror(errno));
-            return -1;
-        }
-#else
-        if (lseek(((coda_bin_product *)product)->fd, (off_t)byte_offset, SEEK_SET) < 0)
-        {
-            char byte_offset_str[21];
-
-            coda_str64(byte_offset, byte_offset_str);
-            coda_set_error(CODA_ERROR_FILE_READ, "could not move to byte position %s (%s)", byte_offset_str,
-                           strerror(errno));
-            return -1;
-        }
-        if (read(((coda_bin_product *)product)->fd, dst, (size_t)length) < 0)
-        {
-            coda_set_error(CODA_ERROR_FILE_READ, "could not read from file (%s)", strerror(errno));
-            return -1;
-        }
-#endif
+        return coda_bin_product_read(product, byte_offset, length, dst);
     }
 
     return 0;
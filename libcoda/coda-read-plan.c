@@ -0,0 +1,886 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "coda-internal.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "coda-type.h"
+#include "coda-read-bytes.h"
+
+/* maximum number of bytes that is read at once for a group of values that can be copied directly */
+#define MAX_GROUP_BYTE_SIZE 256
+
+/* maximum number of unused bytes between two values that are read as part of the same group */
+#define MAX_GROUP_GAP 16
+
+/* a single move of the cursor from a record to one of its fields or from an array to one of its elements */
+typedef struct read_plan_step_struct
+{
+    int is_array_element;
+    long index;
+    coda_type *type;    /* type of the field/element that the step moves to */
+    int64_t rel_bit_offset;     /* static offset relative to the parent for ascii/binary data; -1 if not static */
+} read_plan_step;
+
+typedef struct read_plan_field_struct
+{
+    char *path;
+    coda_native_type read_type;
+    long offset;
+    int num_steps;
+    read_plan_step *step;
+    int num_shared_steps;       /* number of leading steps that are the same as for the preceding field in the plan */
+    int64_t static_bit_offset;  /* bit offset relative to the record if all steps have a static offset; -1 otherwise */
+    int copy_directly;  /* can the value be copied from the raw bytes of the product (see set_copy_directly()) */
+    int swap_bytes;     /* does the byte order need to be reversed when copying the value directly */
+} read_plan_field;
+
+struct coda_read_plan_struct
+{
+    coda_type *type;
+    long num_fields;
+    read_plan_field **field;    /* ordered by position in the product (instead of the order in which they were added) */
+};
+
+static long get_native_type_size(coda_native_type read_type)
+{
+    switch (read_type)
+    {
+        case coda_native_type_int8:
+        case coda_native_type_uint8:
+        case coda_native_type_char:
+            return 1;
+        case coda_native_type_int16:
+        case coda_native_type_uint16:
+            return 2;
+        case coda_native_type_int32:
+        case coda_native_type_uint32:
+        case coda_native_type_float:
+            return 4;
+        case coda_native_type_int64:
+        case coda_native_type_uint64:
+        case coda_native_type_double:
+            return 8;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+static void field_delete(read_plan_field *field)
+{
+    if (field->path != NULL)
+    {
+        free(field->path);
+    }
+    if (field->step != NULL)
+    {
+        free(field->step);
+    }
+    free(field);
+}
+
+static int add_step(read_plan_field *field, int is_array_element, long index, coda_type *type, int64_t rel_bit_offset)
+{
+    if (field->num_steps == CODA_CURSOR_MAXDEPTH - 1)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "path '%s' exceeds the maximum depth of a cursor (%d)", field->path,
+                       CODA_CURSOR_MAXDEPTH);
+        return -1;
+    }
+    if (field->num_steps % BLOCK_SIZE == 0)
+    {
+        read_plan_step *new_step;
+
+        new_step = realloc(field->step, (field->num_steps + BLOCK_SIZE) * sizeof(read_plan_step));
+        if (new_step == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (long)(field->num_steps + BLOCK_SIZE) * sizeof(read_plan_step), __FILE__, __LINE__);
+            return -1;
+        }
+        field->step = new_step;
+    }
+    field->step[field->num_steps].is_array_element = is_array_element;
+    field->step[field->num_steps].index = index;
+    field->step[field->num_steps].type = type;
+    field->step[field->num_steps].rel_bit_offset = rel_bit_offset;
+    field->num_steps++;
+
+    return 0;
+}
+
+/* translate the path into a list of steps, starting from 'type' */
+static int parse_path(read_plan_field *field, coda_type *type)
+{
+    const char *path = field->path;
+    int start = 0;
+    int end;
+
+    while (path[start] != '\0')
+    {
+        int64_t rel_bit_offset = -1;
+        coda_type *sub_type;
+        long index;
+
+        if (path[start] == '[')
+        {
+            coda_type_array *array;
+            int n;
+
+            start++;
+            end = start;
+            while (path[end] != '\0' && path[end] != ']')
+            {
+                end++;
+            }
+            if (path[end] == '\0')
+            {
+                coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid path '%s' (missing ']')", path);
+                return -1;
+            }
+            if (sscanf(&path[start], "%ld%n", &index, &n) != 1 || n != end - start || index < 0)
+            {
+                coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid array index '%.*s' in path", end - start,
+                               &path[start]);
+                return -1;
+            }
+            if (coda_type_get_array_base_type(type, &sub_type) != 0)
+            {
+                return -1;
+            }
+            array = (coda_type_array *)type;
+            if (array->num_elements >= 0 && index >= array->num_elements)
+            {
+                coda_set_error(CODA_ERROR_ARRAY_OUT_OF_BOUNDS, "array index (%ld) exceeds array range [0:%ld)", index,
+                               array->num_elements);
+                return -1;
+            }
+            if ((type->format == coda_format_ascii || type->format == coda_format_binary) &&
+                array->num_elements >= 0 && sub_type->bit_size >= 0)
+            {
+                rel_bit_offset = index * sub_type->bit_size;
+            }
+            if (add_step(field, 1, index, sub_type, rel_bit_offset) != 0)
+            {
+                return -1;
+            }
+            start = end + 1;
+        }
+        else
+        {
+            coda_type_record *record;
+
+            if (path[start] == '/')
+            {
+                if (start == 0)
+                {
+                    coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid path '%s' (path should be relative)", path);
+                    return -1;
+                }
+                start++;
+            }
+            else if (start > 0)
+            {
+                coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid path '%s' (missing '/'?)", path);
+                return -1;
+            }
+            end = start;
+            while (path[end] != '\0' && path[end] != '/' && path[end] != '[')
+            {
+                end++;
+            }
+            if (end == start || path[start] == '@' || path[start] == '.')
+            {
+                coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid path '%s' (only field names and array indices "
+                               "are allowed)", path);
+                return -1;
+            }
+            if (coda_type_get_record_field_index_from_name_n(type, &path[start], end - start, &index) != 0)
+            {
+                return -1;
+            }
+            if (coda_type_get_record_field_type(type, index, &sub_type) != 0)
+            {
+                return -1;
+            }
+            record = (coda_type_record *)type;
+            if ((type->format == coda_format_ascii || type->format == coda_format_binary) &&
+                record->union_field_expr == NULL && record->field[index]->available_expr == NULL &&
+                record->field[index]->bit_offset >= 0)
+            {
+                rel_bit_offset = record->field[index]->bit_offset;
+            }
+            if (add_step(field, 0, index, sub_type, rel_bit_offset) != 0)
+            {
+                return -1;
+            }
+            start = end;
+        }
+        type = sub_type;
+    }
+
+    if (type->type_class == coda_record_class || type->type_class == coda_array_class)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "path '%s' does not refer to a single value (type is %s)", path,
+                       coda_type_get_class_name(type->type_class));
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Determine whether the value can be copied directly from the raw bytes of an ascii/binary product.
+ * This is possible for values at a static byte aligned offset that are stored using exactly the requested read type
+ * (binary integers and floating point values without conversion, and single characters).
+ */
+static void set_copy_directly(read_plan_field *field)
+{
+    coda_type *type;
+    int i;
+
+    field->static_bit_offset = 0;
+    field->copy_directly = 0;
+    field->swap_bytes = 0;
+    for (i = 0; i < field->num_steps; i++)
+    {
+        if (field->step[i].rel_bit_offset < 0)
+        {
+            field->static_bit_offset = -1;
+            return;
+        }
+        field->static_bit_offset += field->step[i].rel_bit_offset;
+    }
+    if (field->num_steps == 0 || (field->static_bit_offset & 0x7) != 0)
+    {
+        return;
+    }
+    type = field->step[field->num_steps - 1].type;
+    if (type->read_type != field->read_type || type->bit_size != 8 * get_native_type_size(field->read_type))
+    {
+        return;
+    }
+    switch (type->type_class)
+    {
+        case coda_integer_class:
+        case coda_real_class:
+            if (type->format != coda_format_binary || ((coda_type_number *)type)->conversion != NULL)
+            {
+                return;
+            }
+#ifdef WORDS_BIGENDIAN
+            field->swap_bytes = (((coda_type_number *)type)->endianness == coda_little_endian && type->bit_size > 8);
+#else
+            field->swap_bytes = (((coda_type_number *)type)->endianness == coda_big_endian && type->bit_size > 8);
+#endif
+            break;
+        case coda_text_class:
+            break;
+        default:
+            return;
+    }
+    field->copy_directly = 1;
+}
+
+/* returns <0, 0, >0 if the position of field1 in a product is before, equal, or after that of field2 */
+static int compare_fields(const read_plan_field *field1, const read_plan_field *field2, int *num_shared_steps)
+{
+    int i;
+
+    for (i = 0; i < field1->num_steps && i < field2->num_steps; i++)
+    {
+        if (field1->step[i].index != field2->step[i].index)
+        {
+            *num_shared_steps = i;
+            return field1->step[i].index < field2->step[i].index ? -1 : 1;
+        }
+    }
+    *num_shared_steps = i;
+
+    return field1->num_steps - field2->num_steps;
+}
+
+static int read_value(const coda_cursor *cursor, coda_native_type read_type, void *dst)
+{
+    switch (read_type)
+    {
+        case coda_native_type_int8:
+            return coda_cursor_read_int8(cursor, (int8_t *)dst);
+        case coda_native_type_uint8:
+            return coda_cursor_read_uint8(cursor, (uint8_t *)dst);
+        case coda_native_type_int16:
+            return coda_cursor_read_int16(cursor, (int16_t *)dst);
+        case coda_native_type_uint16:
+            return coda_cursor_read_uint16(cursor, (uint16_t *)dst);
+        case coda_native_type_int32:
+            return coda_cursor_read_int32(cursor, (int32_t *)dst);
+        case coda_native_type_uint32:
+            return coda_cursor_read_uint32(cursor, (uint32_t *)dst);
+        case coda_native_type_int64:
+            return coda_cursor_read_int64(cursor, (int64_t *)dst);
+        case coda_native_type_uint64:
+            return coda_cursor_read_uint64(cursor, (uint64_t *)dst);
+        case coda_native_type_float:
+            return coda_cursor_read_float(cursor, (float *)dst);
+        case coda_native_type_double:
+            return coda_cursor_read_double(cursor, (double *)dst);
+        case coda_native_type_char:
+            return coda_cursor_read_char(cursor, (char *)dst);
+        default:
+            break;
+    }
+
+    assert(0);
+    exit(1);
+}
+
+/* For a struct-of-arrays (element_index >= 0) each value is stored at dst + offset + element_index * size */
+static uint8_t *get_value_dst(const read_plan_field *field, uint8_t *dst, long element_index)
+{
+    if (element_index < 0)
+    {
+        return &dst[field->offset];
+    }
+    return &dst[field->offset + element_index * get_native_type_size(field->read_type)];
+}
+
+/* Read the group of fields plan->field[first_index] up to and including plan->field[last_index] (which can all be
+ * copied directly) with a single read operation
+ */
+static int read_group(const coda_read_plan *plan, long first_index, long last_index, const coda_cursor *cursor,
+                      uint8_t *dst, long element_index)
+{
+    uint8_t buffer[MAX_GROUP_BYTE_SIZE];
+    int64_t group_offset = plan->field[first_index]->static_bit_offset >> 3;
+    int64_t group_size = 0;
+    long i;
+
+    for (i = first_index; i <= last_index; i++)
+    {
+        int64_t end = (plan->field[i]->static_bit_offset >> 3) - group_offset +
+            get_native_type_size(plan->field[i]->read_type);
+
+        if (end > group_size)
+        {
+            group_size = end;
+        }
+    }
+    if (read_bytes(cursor->product, (cursor->stack[cursor->n - 1].bit_offset >> 3) + group_offset, group_size,
+                   buffer) != 0)
+    {
+        return -1;
+    }
+    for (i = first_index; i <= last_index; i++)
+    {
+        read_plan_field *field = plan->field[i];
+        const uint8_t *src = &buffer[(field->static_bit_offset >> 3) - group_offset];
+        uint8_t *value_dst = get_value_dst(field, dst, element_index);
+        long size = get_native_type_size(field->read_type);
+
+        if (field->swap_bytes)
+        {
+            long k;
+
+            for (k = 0; k < size; k++)
+            {
+                value_dst[k] = src[size - 1 - k];
+            }
+        }
+        else
+        {
+            memcpy(value_dst, src, size);
+        }
+    }
+
+    return 0;
+}
+
+/* Returns the index of the last field of the group of fields, starting with plan->field[first_index], that can be
+ * read with a single read operation. Fields are in the group if they can be copied directly and are at most
+ * MAX_GROUP_GAP bytes apart, as long as the whole group fits in MAX_GROUP_BYTE_SIZE bytes.
+ */
+static long get_group_end(const coda_read_plan *plan, long first_index)
+{
+    int64_t group_offset = plan->field[first_index]->static_bit_offset >> 3;
+    int64_t group_end = group_offset + get_native_type_size(plan->field[first_index]->read_type);
+    long i = first_index;
+
+    while (i + 1 < plan->num_fields && plan->field[i + 1]->copy_directly)
+    {
+        int64_t offset = plan->field[i + 1]->static_bit_offset >> 3;
+        int64_t end = offset + get_native_type_size(plan->field[i + 1]->read_type);
+
+        if (offset < group_offset || offset > group_end + MAX_GROUP_GAP)
+        {
+            break;
+        }
+        if (end > group_end)
+        {
+            if (end - group_offset > MAX_GROUP_BYTE_SIZE)
+            {
+                break;
+            }
+            group_end = end;
+        }
+        i++;
+    }
+
+    return i;
+}
+
+/* Read all fields of the plan for the record at the top of 'cursor' (the cursor will be modified, but its depth is
+ * restored on success).
+ * For ascii/binary data, fields that can be copied directly are read in groups using a single read operation per
+ * group; all other fields are read by navigating the cursor to the field.
+ */
+static int execute(const coda_read_plan *plan, coda_cursor *cursor, uint8_t *dst, long element_index)
+{
+    int depth = cursor->n;
+    int use_static_offsets;
+    int use_direct_copy;
+    int num_valid_steps = 0;
+    long i;
+
+    if (coda_get_type_for_dynamic_type(cursor->stack[depth - 1].type) != plan->type)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "cursor does not refer to data of the type for which the read "
+                       "plan was created");
+        return -1;
+    }
+    /* static offsets can only be used if the cursor uses the definition types directly (i.e. for ascii/binary data) */
+    use_static_offsets = (cursor->stack[depth - 1].type == (coda_dynamic_type *)plan->type);
+    use_direct_copy = use_static_offsets && (cursor->stack[depth - 1].bit_offset & 0x7) == 0;
+
+    i = 0;
+    while (i < plan->num_fields)
+    {
+        read_plan_field *field = plan->field[i];
+        int j;
+
+        if (use_direct_copy && field->copy_directly)
+        {
+            long last_index = get_group_end(plan, i);
+
+            cursor->n = depth;
+            if (read_group(plan, i, last_index, cursor, dst, element_index) != 0)
+            {
+                return -1;
+            }
+            /* the cursor was not moved, so only the part of its path that the skipped fields share remains valid */
+            for (; i <= last_index; i++)
+            {
+                if (plan->field[i]->num_shared_steps < num_valid_steps)
+                {
+                    num_valid_steps = plan->field[i]->num_shared_steps;
+                }
+            }
+            continue;
+        }
+
+        if (depth + field->num_steps > CODA_CURSOR_MAXDEPTH)
+        {
+            coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "maximum depth in cursor (%d) reached (%s:%u)",
+                           CODA_CURSOR_MAXDEPTH, __FILE__, __LINE__);
+            return -1;
+        }
+
+        /* navigation that is shared with the previous field is not repeated */
+        if (field->num_shared_steps < num_valid_steps)
+        {
+            num_valid_steps = field->num_shared_steps;
+        }
+        cursor->n = depth + num_valid_steps;
+        for (j = num_valid_steps; j < field->num_steps; j++)
+        {
+            read_plan_step *step = &field->step[j];
+            coda_type *parent_type = (j == 0 ? plan->type : field->step[j - 1].type);
+
+            /* the parent check guards against the case where the parent turned out to be an unavailable field */
+            if (use_static_offsets && step->rel_bit_offset >= 0 &&
+                cursor->stack[cursor->n - 1].type == (coda_dynamic_type *)parent_type)
+            {
+                cursor->stack[cursor->n].type = (coda_dynamic_type *)step->type;
+                cursor->stack[cursor->n].index = step->index;
+                cursor->stack[cursor->n].bit_offset = cursor->stack[cursor->n - 1].bit_offset + step->rel_bit_offset;
+                cursor->n++;
+            }
+            else if (step->is_array_element)
+            {
+                if (coda_cursor_goto_array_element_by_index(cursor, step->index) != 0)
+                {
+                    return -1;
+                }
+            }
+            else
+            {
+                if (coda_cursor_goto_record_field_by_index(cursor, step->index) != 0)
+                {
+                    return -1;
+                }
+            }
+        }
+
+        if (read_value(cursor, field->read_type, get_value_dst(field, dst, element_index)) != 0)
+        {
+            return -1;
+        }
+        num_valid_steps = field->num_steps;
+        i++;
+    }
+    cursor->n = depth;
+
+    return 0;
+}
+
+/** \addtogroup coda_cursor
+ * @{
+ */
+
+/** Create a new read plan for data of the given type.
+ * A read plan allows retrieving a fixed set of values from a record (or from each record in an array of records)
+ * using a single function call. Fields are added to the plan using coda_read_plan_add_field() and the plan is then
+ * executed using coda_read_plan_execute() or coda_read_plan_execute_array().
+ * The navigation needed for each field is determined once when the field is added. When executing the plan, fields
+ * that share a part of their path reuse that part of the navigation, and for ascii and binary data all static
+ * offsets are used directly. Values at static byte aligned offsets that are stored using exactly the requested read
+ * type (binary integers and floating point values without conversion, and characters) are copied from the product
+ * without navigating to them, where values that are close together are read using a single read operation.
+ * The type should be retrieved using e.g. coda_cursor_get_type() and the plan should only be used while the product
+ * that the type was taken from is still open (the plan does not keep its own reference to the type).
+ * \param type CODA type of the records that the plan will be used for.
+ * \param plan Pointer to the variable where the new read plan will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_read_plan_new(coda_type *type, coda_read_plan **plan)
+{
+    coda_read_plan *new_plan;
+
+    if (type == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "type argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (plan == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "plan argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    new_plan = malloc(sizeof(coda_read_plan));
+    if (new_plan == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)sizeof(coda_read_plan), __FILE__, __LINE__);
+        return -1;
+    }
+    new_plan->type = type;
+    new_plan->num_fields = 0;
+    new_plan->field = NULL;
+
+    *plan = new_plan;
+
+    return 0;
+}
+
+/** Add a value to a read plan.
+ * The \a path should be a path relative to the record for which the plan was created and can consist of field names
+ * and array indices (e.g. "time", "mds/lat", or "geo[2]/lon"). Absolute paths, attributes, '.', and '..' are not
+ * allowed. The path should refer to a single value that can be read using the read function for \a read_type
+ * (e.g. coda_cursor_read_double() for #coda_native_type_double).
+ * When the plan is executed the value will be stored at byte offset \a offset in the destination buffer. For
+ * coda_read_plan_execute_array() this is the offset of the array of values for this field.
+ * \param plan Pointer to a CODA read plan.
+ * \param path Path to the value, relative to the record.
+ * \param read_type Native type in which to store the value (this can not be #coda_native_type_string or
+ * #coda_native_type_bytes).
+ * \param offset Byte offset at which to store the value in the destination buffer.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_read_plan_add_field(coda_read_plan *plan, const char *path, coda_native_type read_type,
+                                         long offset)
+{
+    read_plan_field **new_field_list;
+    read_plan_field *field;
+    long i;
+
+    if (plan == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "plan argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (path == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "path argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (get_native_type_size(read_type) == 0)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid read type (%s) for read plan",
+                       coda_type_get_native_type_name(read_type));
+        return -1;
+    }
+    if (offset < 0)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "offset argument (%ld) is negative (%s:%u)", offset, __FILE__,
+                       __LINE__);
+        return -1;
+    }
+
+    field = malloc(sizeof(read_plan_field));
+    if (field == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)sizeof(read_plan_field), __FILE__, __LINE__);
+        return -1;
+    }
+    field->path = NULL;
+    field->read_type = read_type;
+    field->offset = offset;
+    field->num_steps = 0;
+    field->step = NULL;
+    field->num_shared_steps = 0;
+    field->static_bit_offset = -1;
+    field->copy_directly = 0;
+    field->swap_bytes = 0;
+
+    field->path = strdup(path);
+    if (field->path == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                       __LINE__);
+        field_delete(field);
+        return -1;
+    }
+    if (parse_path(field, plan->type) != 0)
+    {
+        field_delete(field);
+        return -1;
+    }
+    set_copy_directly(field);
+
+    if (plan->num_fields % BLOCK_SIZE == 0)
+    {
+        new_field_list = realloc(plan->field, (plan->num_fields + BLOCK_SIZE) * sizeof(read_plan_field *));
+        if (new_field_list == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           (long)(plan->num_fields + BLOCK_SIZE) * sizeof(read_plan_field *), __FILE__, __LINE__);
+            field_delete(field);
+            return -1;
+        }
+        plan->field = new_field_list;
+    }
+
+    /* keep the fields ordered by their position in the product, so reading progresses forward through the product and
+     * each field can continue from the navigation of the previous field */
+    i = plan->num_fields;
+    while (i > 0 && compare_fields(plan->field[i - 1], field, &field->num_shared_steps) > 0)
+    {
+        plan->field[i] = plan->field[i - 1];
+        i--;
+    }
+    plan->field[i] = field;
+    plan->num_fields++;
+    if (i > 0)
+    {
+        compare_fields(plan->field[i - 1], field, &field->num_shared_steps);
+    }
+    else
+    {
+        field->num_shared_steps = 0;
+    }
+    if (i + 1 < plan->num_fields)
+    {
+        compare_fields(field, plan->field[i + 1], &plan->field[i + 1]->num_shared_steps);
+    }
+
+    return 0;
+}
+
+/** Read all values of a read plan for a single record.
+ * The cursor should point to a record of the type for which the plan was created. Each value is stored at its
+ * offset in \a dst (typically a caller defined struct, with offsets determined using offsetof()).
+ * \param plan Pointer to a CODA read plan.
+ * \param cursor Pointer to a CODA cursor that references a record.
+ * \param dst Pointer to the buffer where the values will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_read_plan_execute(const coda_read_plan *plan, const coda_cursor *cursor, void *dst)
+{
+    coda_cursor record_cursor;
+
+    if (plan == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "plan argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (cursor == NULL || cursor->n <= 0 || cursor->stack[cursor->n - 1].type == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid cursor argument (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (dst == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "dst argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    record_cursor = *cursor;
+
+    return execute(plan, &record_cursor, (uint8_t *)dst, -1);
+}
+
+/** Read all values of a read plan for a range of consecutive records in an array.
+ * The cursor should point to an array of records of the type for which the plan was created. The values are stored
+ * as a struct-of-arrays: the value of a field for the i-th record of the range is stored at byte offset
+ * offset_of_field + i * size_of_read_type in \a dst, where offset_of_field is the offset that was provided to
+ * coda_read_plan_add_field().
+ * \param plan Pointer to a CODA read plan.
+ * \param cursor Pointer to a CODA cursor that references an array of records.
+ * \param offset Index (as used in #coda_cursor_goto_array_element_by_index) of the first record to read.
+ * \param length Number of records to read.
+ * \param dst Pointer to the buffer where the values will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_read_plan_execute_array(const coda_read_plan *plan, const coda_cursor *cursor, long offset,
+                                             long length, void *dst)
+{
+    coda_cursor element_cursor;
+    coda_type *type;
+    long num_elements;
+    long i;
+
+    if (plan == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "plan argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (cursor == NULL || cursor->n <= 0 || cursor->stack[cursor->n - 1].type == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "invalid cursor argument (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+    if (dst == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "dst argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    type = coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
+    if (type->type_class != coda_array_class)
+    {
+        coda_set_error(CODA_ERROR_INVALID_TYPE, "cursor does not refer to an array (current type is %s)",
+                       coda_type_get_class_name(type->type_class));
+        return -1;
+    }
+    if (coda_cursor_get_num_elements(cursor, &num_elements) != 0)
+    {
+        return -1;
+    }
+    if (length <= 0)
+    {
+        return 0;
+    }
+    if (offset < 0 || offset >= num_elements)
+    {
+        coda_set_error(CODA_ERROR_ARRAY_OUT_OF_BOUNDS, "array offset (%ld) exceeds array range [0:%ld)", offset,
+                       num_elements);
+        return -1;
+    }
+    if (offset + length > num_elements)
+    {
+        coda_set_error(CODA_ERROR_ARRAY_OUT_OF_BOUNDS, "array offset (%ld) + length (%ld) exceeds array range "
+                       "[0:%ld)", offset, length, num_elements);
+        return -1;
+    }
+
+    /* give the operating system a hint about the data that we are going to read (failures are ignored) */
+    coda_cursor_prefetch_range(cursor, offset, length);
+
+    element_cursor = *cursor;
+    if (coda_cursor_goto_array_element_by_index(&element_cursor, offset) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < length; i++)
+    {
+        if (execute(plan, &element_cursor, (uint8_t *)dst, i) != 0)
+        {
+            return -1;
+        }
+        if (i < length - 1)
+        {
+            if (coda_cursor_goto_next_array_element(&element_cursor) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/** Delete a CODA read plan.
+ * \param plan Pointer to a CODA read plan.
+ */
+LIBCODA_API void coda_read_plan_delete(coda_read_plan *plan)
+{
+    long i;
+
+    if (plan == NULL)
+    {
+        return;
+    }
+    if (plan->field != NULL)
+    {
+        for (i = 0; i < plan->num_fields; i++)
+        {
+            field_delete(plan->field[i]);
+        }
+        free(plan->field);
+    }
+    free(plan);
+}
+
+/** @} */
@@ -0,0 +1,426 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "coda-size-cache.h"
+#include "coda-thread.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_TABLE_SIZE 64
+
+/* number of consecutive slots in which an entry can be stored */
+#define NUM_PROBES 4
+
+/* initial maximum length of the paths that a table can store */
+#define INITIAL_PATH_STRIDE 4
+
+/* Entries are only added by a thread that holds the lock of the cache, but they are looked up without taking the lock.
+ * Each slot is therefore guarded by a sequence number (a 'seqlock'): the writer makes the sequence number odd while it
+ * changes the slot and even again afterwards, and a reader only uses what it read from a slot if the sequence number
+ * was even and did not change in the meantime. When the table is replaced by a larger one (with more slots or room for
+ * longer paths), the old table is kept (unchanged) until the cache is deleted, since other threads may still be reading
+ * from it.
+ * Without atomic builtins, lookups take the lock as well.
+ */
+typedef struct size_cache_entry_struct
+{
+    long sequence;
+    const coda_type *type;      /* NULL if the slot is unused */
+    int64_t bit_offset;
+    int64_t bit_size;
+    uint64_t hash;      /* hash of type, bit offset and path */
+    int depth;  /* number of array/field indices in the path */
+} size_cache_entry;
+
+typedef struct size_cache_table_struct
+{
+    long num_slots;     /* a power of two */
+    int path_stride;    /* maximum number of indices in a path */
+    size_cache_entry *entry;
+    long *index;        /* the path of the entry in slot i starts at index[i * path_stride] */
+    struct size_cache_table_struct *previous;   /* table that was replaced by this one */
+} size_cache_table;
+
+struct coda_size_cache_struct
+{
+    long max_entries;
+    long num_entries;
+    size_cache_table *table;
+    int64_t num_hits;
+    int64_t num_misses;
+    coda_mutex *lock;
+};
+
+/* The key of a data element is its type, its absolute bit offset, and the array/field indices that lead from the root
+ * of the product to the element (cursor->stack[0] is the root and has no index).
+ */
+static uint64_t get_hash(const coda_type *type, const coda_cursor *cursor)
+{
+    uint64_t hash;
+    int i;
+
+    hash = ((uint64_t)(size_t)type >> 3) * 0x9E3779B97F4A7C15ULL;
+    hash ^= (uint64_t)cursor->stack[cursor->n - 1].bit_offset * 0xC2B2AE3D27D4EB4FULL;
+    for (i = 1; i < cursor->n; i++)
+    {
+        hash = (hash ^ (uint64_t)cursor->stack[i].index) * 0x100000001B3ULL;
+    }
+    hash ^= hash >> 29;
+
+    return hash;
+}
+
+static int path_equals(const long *index, const coda_cursor *cursor)
+{
+    int i;
+
+    for (i = 1; i < cursor->n; i++)
+    {
+        if (index[i - 1] != cursor->stack[i].index)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static size_cache_table *table_new(long num_slots, int path_stride)
+{
+    size_cache_table *table;
+
+    table = (size_cache_table *)malloc(sizeof(size_cache_table));
+    if (table == NULL)
+    {
+        return NULL;
+    }
+    table->num_slots = num_slots;
+    table->path_stride = path_stride;
+    table->previous = NULL;
+    /* all slots start out unused (type is NULL and the sequence number is 0) */
+    table->entry = (size_cache_entry *)calloc(num_slots, sizeof(size_cache_entry));
+    table->index = (long *)malloc(num_slots * path_stride * sizeof(long));
+    if (table->entry == NULL || table->index == NULL)
+    {
+        if (table->entry != NULL)
+        {
+            free(table->entry);
+        }
+        if (table->index != NULL)
+        {
+            free(table->index);
+        }
+        free(table);
+        return NULL;
+    }
+
+    return table;
+}
+
+/* Store an entry in a slot of a table; only called while holding the lock of the cache */
+static void table_set_slot(size_cache_table *table, long slot, const size_cache_entry *key, const long *index)
+{
+    size_cache_entry *entry = &table->entry[slot];
+    long sequence = entry->sequence;
+
+#ifdef CODA_HAVE_ATOMIC_BUILTINS
+    __atomic_store_n(&entry->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
+    entry->type = key->type;
+    entry->bit_offset = key->bit_offset;
+    entry->bit_size = key->bit_size;
+    entry->hash = key->hash;
+    entry->depth = key->depth;
+    memcpy(&table->index[slot * table->path_stride], index, key->depth * sizeof(long));
+#ifdef CODA_HAVE_ATOMIC_BUILTINS
+    __atomic_store_n(&entry->sequence, sequence + 2, __ATOMIC_RELEASE);
+#else
+    entry->sequence = sequence + 2;
+#endif
+}
+
+/* Returns the slot in which the entry should be stored, or -1 if all slots in which it can be stored are in use */
+static long table_find_free_slot(const size_cache_table *table, const size_cache_entry *key, const long *index)
+{
+    long slot = (long)(key->hash & (uint64_t)(table->num_slots - 1));
+    int i;
+
+    for (i = 0; i < NUM_PROBES; i++)
+    {
+        const size_cache_entry *entry = &table->entry[slot];
+
+        if (entry->type == NULL || (entry->hash == key->hash && entry->type == key->type &&
+                                    entry->bit_offset == key->bit_offset && entry->depth == key->depth &&
+                                    memcmp(&table->index[slot * table->path_stride], index,
+                                           key->depth * sizeof(long)) == 0))
+        {
+            return slot;
+        }
+        slot = (slot + 1) & (table->num_slots - 1);
+    }
+
+    return -1;
+}
+
+static int can_grow(const coda_size_cache *cache)
+{
+    return cache->num_entries < cache->max_entries && cache->table->num_slots < 2 * cache->max_entries;
+}
+
+/* Replace the table by a larger table; only called while holding the lock of the cache */
+static void resize_table(coda_size_cache *cache, long num_slots, int path_stride)
+{
+    size_cache_table *table = cache->table;
+    size_cache_table *new_table;
+    long i;
+
+    new_table = table_new(num_slots, path_stride);
+    if (new_table == NULL)
+    {
+        /* the cache just keeps using the current table */
+        return;
+    }
+    new_table->previous = table;
+    cache->num_entries = 0;
+    for (i = 0; i < table->num_slots; i++)
+    {
+        if (table->entry[i].type != NULL)
+        {
+            const long *index = &table->index[i * table->path_stride];
+            long slot = table_find_free_slot(new_table, &table->entry[i], index);
+
+            /* entries for which there is no room in the new table are dropped */
+            if (slot >= 0)
+            {
+                table_set_slot(new_table, slot, &table->entry[i], index);
+                cache->num_entries++;
+            }
+        }
+    }
+    coda_atomic_store_ptr(&cache->table, new_table);
+}
+
+int coda_size_cache_new(long max_entries, coda_size_cache **cache)
+{
+    coda_size_cache *new_cache;
+
+    assert(max_entries > 0);
+
+    new_cache = (coda_size_cache *)malloc(sizeof(coda_size_cache));
+    if (new_cache == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(coda_size_cache), __FILE__, __LINE__);
+        return -1;
+    }
+    new_cache->max_entries = max_entries;
+    new_cache->num_entries = 0;
+    new_cache->table = NULL;
+    new_cache->num_hits = 0;
+    new_cache->num_misses = 0;
+    new_cache->lock = NULL;
+
+    if (coda_mutex_new(&new_cache->lock) != 0)
+    {
+        coda_size_cache_delete(new_cache);
+        return -1;
+    }
+    new_cache->table = table_new(INITIAL_TABLE_SIZE, INITIAL_PATH_STRIDE);
+    if (new_cache->table == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       INITIAL_TABLE_SIZE * (sizeof(size_cache_entry) + INITIAL_PATH_STRIDE * sizeof(long)),
+                       __FILE__, __LINE__);
+        coda_size_cache_delete(new_cache);
+        return -1;
+    }
+
+    *cache = new_cache;
+
+    return 0;
+}
+
+/* Returns 1 and sets bit_size if the cache contains an entry for the data element that the cursor points to, and
+ * returns 0 otherwise.
+ */
+int coda_size_cache_find(coda_size_cache *cache, const coda_cursor *cursor, int64_t *bit_size)
+{
+    const coda_type *type = coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
+    int64_t bit_offset = cursor->stack[cursor->n - 1].bit_offset;
+    uint64_t hash = get_hash(type, cursor);
+    size_cache_table *table;
+    long slot;
+    int found = 0;
+    int i;
+
+#ifndef CODA_HAVE_ATOMIC_BUILTINS
+    coda_mutex_lock(cache->lock);
+#endif
+    table = coda_atomic_load_ptr(&cache->table);
+    slot = (long)(hash & (uint64_t)(table->num_slots - 1));
+    for (i = 0; i < NUM_PROBES && !found; i++)
+    {
+        size_cache_entry *entry = &table->entry[slot];
+#ifdef CODA_HAVE_ATOMIC_BUILTINS
+        long sequence = __atomic_load_n(&entry->sequence, __ATOMIC_ACQUIRE);
+#endif
+
+        if (entry->hash == hash && entry->type == type && entry->bit_offset == bit_offset &&
+            entry->depth == cursor->n - 1 && path_equals(&table->index[slot * table->path_stride], cursor))
+        {
+            *bit_size = entry->bit_size;
+            found = 1;
+#ifdef CODA_HAVE_ATOMIC_BUILTINS
+            /* only use the entry if it was not being changed while we were reading it */
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if ((sequence & 1) != 0 || __atomic_load_n(&entry->sequence, __ATOMIC_RELAXED) != sequence)
+            {
+                found = 0;
+            }
+#endif
+        }
+        slot = (slot + 1) & (table->num_slots - 1);
+    }
+#ifndef CODA_HAVE_ATOMIC_BUILTINS
+    coda_mutex_unlock(cache->lock);
+#endif
+    if (found)
+    {
+        coda_atomic_add_int64(&cache->num_hits, 1);
+    }
+    else
+    {
+        coda_atomic_add_int64(&cache->num_misses, 1);
+    }
+
+    return found;
+}
+
+/* Store the bit size of the data element that the cursor points to.
+ * Once the cache holds max_entries entries (or if there is no room for the entry in the table), the entry replaces an
+ * existing entry.
+ */
+void coda_size_cache_add(coda_size_cache *cache, const coda_cursor *cursor, int64_t bit_size)
+{
+    size_cache_entry key;
+    long index[CODA_CURSOR_MAXDEPTH];
+    long slot;
+    int i;
+
+    key.type = coda_get_type_for_dynamic_type(cursor->stack[cursor->n - 1].type);
+    key.bit_offset = cursor->stack[cursor->n - 1].bit_offset;
+    key.bit_size = bit_size;
+    key.hash = get_hash(key.type, cursor);
+    key.depth = cursor->n - 1;
+    for (i = 1; i < cursor->n; i++)
+    {
+        index[i - 1] = cursor->stack[i].index;
+    }
+
+    coda_mutex_lock(cache->lock);
+    if (key.depth > cache->table->path_stride)
+    {
+        resize_table(cache, cache->table->num_slots, key.depth);
+        if (key.depth > cache->table->path_stride)
+        {
+            coda_mutex_unlock(cache->lock);
+            return;
+        }
+    }
+    if (2 * (cache->num_entries + 1) > cache->table->num_slots && can_grow(cache))
+    {
+        resize_table(cache, 2 * cache->table->num_slots, cache->table->path_stride);
+    }
+    slot = table_find_free_slot(cache->table, &key, index);
+    if (slot < 0 && can_grow(cache))
+    {
+        resize_table(cache, 2 * cache->table->num_slots, cache->table->path_stride);
+        slot = table_find_free_slot(cache->table, &key, index);
+    }
+    if (slot >= 0 && cache->table->entry[slot].type == NULL)
+    {
+        if (cache->num_entries < cache->max_entries)
+        {
+            cache->num_entries++;
+        }
+        else
+        {
+            slot = -1;
+        }
+    }
+    if (slot < 0)
+    {
+        /* replace one of the entries in the slots that the entry could have been stored in */
+        for (i = 0; i < NUM_PROBES; i++)
+        {
+            slot = (long)((key.hash + (uint64_t)((key.bit_offset + i) % NUM_PROBES)) &
+                          (uint64_t)(cache->table->num_slots - 1));
+            if (cache->table->entry[slot].type != NULL)
+            {
+                break;
+            }
+        }
+        if (i == NUM_PROBES)
+        {
+            coda_mutex_unlock(cache->lock);
+            return;
+        }
+    }
+    table_set_slot(cache->table, slot, &key, index);
+    coda_mutex_unlock(cache->lock);
+}
+
+void coda_size_cache_get_statistics(coda_size_cache *cache, int64_t *num_hits, int64_t *num_misses)
+{
+    *num_hits = cache->num_hits;
+    *num_misses = cache->num_misses;
+}
+
+void coda_size_cache_delete(coda_size_cache *cache)
+{
+    while (cache->table != NULL)
+    {
+        size_cache_table *table = cache->table;
+
+        cache->table = table->previous;
+        free(table->entry);
+        free(table->index);
+        free(table);
+    }
+    if (cache->lock != NULL)
+    {
+        coda_mutex_delete(cache->lock);
+    }
+    free(cache);
+}
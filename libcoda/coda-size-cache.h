@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CODA_SIZE_CACHE_H
+#define CODA_SIZE_CACHE_H
+
+#include "coda-internal.h"
+
+/* Memo of bit sizes of variable sized data elements of a product.
+ * Entries are keyed by type, absolute bit offset, and the path (the array/field indices from the root of the product)
+ * to the data element. The type and offset alone are not enough, since e.g. an empty array element and the element
+ * after it (and the content of both) have the same types and offsets. A cache has room for 'max_entries' entries; once
+ * it is full, new entries replace older ones. All functions can be called concurrently from multiple threads; lookups
+ * never wait for other threads.
+ */
+typedef struct coda_size_cache_struct coda_size_cache;
+
+int coda_size_cache_new(long max_entries, coda_size_cache **cache);
+int coda_size_cache_find(coda_size_cache *cache, const coda_cursor *cursor, int64_t *bit_size);
+void coda_size_cache_add(coda_size_cache *cache, const coda_cursor *cursor, int64_t bit_size);
+void coda_size_cache_get_statistics(coda_size_cache *cache, int64_t *num_hits, int64_t *num_misses);
+void coda_size_cache_delete(coda_size_cache *cache);
+
+#endif
@@ -33,6 +33,7 @@
 #include "coda-ascbin.h"
 #include "coda-ascii.h"
 #include "coda-mem-internal.h"
+#include "coda-statistics.h"
 
 #include <assert.h>
 #include <errno.h>
@@ -1956,6 +1957,7 @@ int coda_sp3_reopen(coda_product **product)
     product_file->product_variable = NULL;
     product_file->mem_size = 0;
     product_file->mem_ptr = NULL;
+    coda_statistics_init(product_file);
 
     product_file->filename = strdup((*product)->filename);
     if (product_file->filename == NULL)
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "coda-statistics.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <time.h>
+#endif
+
+/* returns a time in seconds that can be used to measure durations */
+double coda_statistics_get_time(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+}
+
+#ifdef ENABLE_STATISTICS
+
+THREAD_LOCAL coda_statistics coda_thread_statistics;
+
+/* add all counters of 'other' to those of 'statistics' */
+void coda_statistics_sum(coda_statistics *statistics, const coda_statistics *other)
+{
+    int i;
+
+    statistics->num_reads += other->num_reads;
+    statistics->num_bytes_read += other->num_bytes_read;
+    statistics->num_memory_reads += other->num_memory_reads;
+    statistics->num_memory_bytes_read += other->num_memory_bytes_read;
+    statistics->num_file_reads += other->num_file_reads;
+    statistics->num_file_bytes_read += other->num_file_bytes_read;
+    statistics->num_prefetches += other->num_prefetches;
+    statistics->num_block_cache_hits += other->num_block_cache_hits;
+    statistics->num_block_cache_misses += other->num_block_cache_misses;
+    statistics->num_bit_size_cache_hits += other->num_bit_size_cache_hits;
+    statistics->num_bit_size_cache_misses += other->num_bit_size_cache_misses;
+    statistics->num_size_calculations += other->num_size_calculations;
+    statistics->num_offset_calculations += other->num_offset_calculations;
+    for (i = 0; i < 6; i++)
+    {
+        statistics->num_expression_evaluations[i] += other->num_expression_evaluations[i];
+    }
+    statistics->open_time += other->open_time;
+    statistics->detection_time += other->detection_time;
+}
+
+static void subtract(coda_statistics *statistics, const coda_statistics *other)
+{
+    int i;
+
+    statistics->num_reads -= other->num_reads;
+    statistics->num_bytes_read -= other->num_bytes_read;
+    statistics->num_memory_reads -= other->num_memory_reads;
+    statistics->num_memory_bytes_read -= other->num_memory_bytes_read;
+    statistics->num_file_reads -= other->num_file_reads;
+    statistics->num_file_bytes_read -= other->num_file_bytes_read;
+    statistics->num_prefetches -= other->num_prefetches;
+    statistics->num_block_cache_hits -= other->num_block_cache_hits;
+    statistics->num_block_cache_misses -= other->num_block_cache_misses;
+    statistics->num_bit_size_cache_hits -= other->num_bit_size_cache_hits;
+    statistics->num_bit_size_cache_misses -= other->num_bit_size_cache_misses;
+    statistics->num_size_calculations -= other->num_size_calculations;
+    statistics->num_offset_calculations -= other->num_offset_calculations;
+    for (i = 0; i < 6; i++)
+    {
+        statistics->num_expression_evaluations[i] -= other->num_expression_evaluations[i];
+    }
+    statistics->open_time -= other->open_time;
+    statistics->detection_time -= other->detection_time;
+}
+
+/* call this at the start of opening a product */
+void coda_statistics_begin_open(coda_statistics_open *open)
+{
+    open->thread_statistics = coda_thread_statistics;
+    open->start_time = coda_statistics_get_time();
+}
+
+/* call this once a product was successfully opened.
+ * Everything that the thread did since coda_statistics_begin_open() becomes the initial statistics of the product.
+ * 'raw_product' is the raw product that the product uses for reading (or NULL); its counters are cleared, since the
+ * reads that were performed on it are already included.
+ */
+void coda_statistics_end_open(coda_statistics_open *open, coda_product *product, coda_product *raw_product)
+{
+    coda_thread_statistics.open_time += coda_statistics_get_time() - open->start_time;
+    product->statistics = coda_thread_statistics;
+    subtract(&product->statistics, &open->thread_statistics);
+    if (raw_product != NULL && raw_product != product)
+    {
+        coda_statistics_init(raw_product);
+    }
+}
+
+#endif
+
+/** \addtogroup coda_general
+ * @{
+ */
+
+/** Retrieve the statistics of the current thread.
+ * The statistics cover all work that CODA performed within the calling thread since the thread was started or since
+ * the last call to coda_reset_thread_statistics(), for all products together (including products that are already
+ * closed). See coda_get_product_statistics() for the statistics of a single product.
+ *
+ * Statistics are only collected if CODA was built with statistics support (the \c --enable-statistics configure
+ * option or the \c CODA_ENABLE_STATISTICS CMake option). Otherwise this function returns an error.
+ * \param statistics Pointer to the variable where the statistics will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_get_thread_statistics(coda_statistics *statistics)
+{
+    if (statistics == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "statistics argument is NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+#ifdef ENABLE_STATISTICS
+    *statistics = coda_thread_statistics;
+
+    return 0;
+#else
+    coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "statistics are not available (this version of CODA was not built "
+                   "with statistics support)");
+    return -1;
+#endif
+}
+
+/** Reset all statistics of the current thread to zero.
+ * This does not change the statistics of any of the products.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_reset_thread_statistics(void)
+{
+#ifdef ENABLE_STATISTICS
+    memset(&coda_thread_statistics, 0, sizeof(coda_statistics));
+
+    return 0;
+#else
+    coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "statistics are not available (this version of CODA was not built "
+                   "with statistics support)");
+    return -1;
+#endif
+}
+
+/** @} */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CODA_STATISTICS_H
+#define CODA_STATISTICS_H
+
+#include "coda-thread.h"
+
+#include <string.h>
+
+/* Statistics on the work that CODA performs (see coda_get_product_statistics() and coda_get_thread_statistics()).
+ * Counters are kept both per product and per thread. A product can be read concurrently by multiple threads, so its
+ * counters are updated atomically. Statistics are only collected if CODA is built with ENABLE_STATISTICS; otherwise
+ * the macros below expand to nothing.
+ * While a product is being opened, its counters are taken from the thread statistics (see coda_statistics_end_open()),
+ * since the product handle may be replaced by the backends during the open.
+ */
+#ifdef ENABLE_STATISTICS
+
+/* state that is needed to attribute the work that is done while opening a product to that product */
+typedef struct coda_statistics_open_struct
+{
+    coda_statistics thread_statistics;
+    double start_time;
+} coda_statistics_open;
+
+extern THREAD_LOCAL coda_statistics coda_thread_statistics;
+
+#define coda_statistics_init(product) memset(&(product)->statistics, 0, sizeof(coda_statistics))
+#define coda_statistics_add(product, counter, value) \
+    do \
+    { \
+        coda_atomic_add_int64(&((coda_product *)(product))->statistics.counter, (int64_t)(value)); \
+        coda_thread_statistics.counter += (value); \
+    } while (0)
+#define coda_statistics_add_for_cursor(cursor, counter, value) \
+    do \
+    { \
+        if ((cursor) != NULL) \
+        { \
+            coda_statistics_add((cursor)->product, counter, value); \
+        } \
+        else \
+        { \
+            coda_thread_statistics.counter += (value); \
+        } \
+    } while (0)
+
+void coda_statistics_sum(coda_statistics *statistics, const coda_statistics *other);
+void coda_statistics_begin_open(coda_statistics_open *open);
+void coda_statistics_end_open(coda_statistics_open *open, coda_product *product, coda_product *raw_product);
+
+#else
+
+#define coda_statistics_init(product)
+#define coda_statistics_add(product, counter, value)
+#define coda_statistics_add_for_cursor(cursor, counter, value)
+
+#endif
+
+/* also used for expression profiling, so this is available regardless of ENABLE_STATISTICS */
+double coda_statistics_get_time(void);
+
+#endif
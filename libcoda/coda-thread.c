@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "coda-thread.h"
+
+#include <stdlib.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#elif defined(WIN32)
+#include <windows.h>
+#endif
+
+#if defined(HAVE_PTHREAD) || defined(WIN32)
+struct coda_mutex_struct
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t mutex;
+#else
+    CRITICAL_SECTION critical_section;
+#endif
+};
+#endif
+
+#ifdef HAVE_PTHREAD
+static pthread_once_t lazy_init_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t lazy_init_mutex;
+
+static void lazy_init_mutex_init(void)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&lazy_init_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif defined(WIN32)
+static INIT_ONCE lazy_init_once = INIT_ONCE_STATIC_INIT;
+static CRITICAL_SECTION lazy_init_critical_section;
+
+static BOOL CALLBACK lazy_init_critical_section_init(PINIT_ONCE once, PVOID parameter, PVOID *context)
+{
+    (void)once;
+    (void)parameter;
+    (void)context;
+    InitializeCriticalSection(&lazy_init_critical_section);
+    return TRUE;
+}
+#endif
+
+void coda_lazy_init_lock(void)
+{
+#ifdef HAVE_PTHREAD
+    pthread_once(&lazy_init_once, lazy_init_mutex_init);
+    pthread_mutex_lock(&lazy_init_mutex);
+#elif defined(WIN32)
+    InitOnceExecuteOnce(&lazy_init_once, lazy_init_critical_section_init, NULL, NULL);
+    EnterCriticalSection(&lazy_init_critical_section);
+#endif
+}
+
+void coda_lazy_init_unlock(void)
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&lazy_init_mutex);
+#elif defined(WIN32)
+    LeaveCriticalSection(&lazy_init_critical_section);
+#endif
+}
+
+int coda_mutex_new(coda_mutex **mutex)
+{
+#if defined(HAVE_PTHREAD) || defined(WIN32)
+    coda_mutex *new_mutex;
+
+    new_mutex = (coda_mutex *)malloc(sizeof(coda_mutex));
+    if (new_mutex == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(coda_mutex), __FILE__, __LINE__);
+        return -1;
+    }
+#ifdef HAVE_PTHREAD
+    if (pthread_mutex_init(&new_mutex->mutex, NULL) != 0)
+    {
+        free(new_mutex);
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "could not initialize mutex (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+#else
+    InitializeCriticalSection(&new_mutex->critical_section);
+#endif
+    *mutex = new_mutex;
+#else
+    *mutex = NULL;
+#endif
+
+    return 0;
+}
+
+void coda_mutex_lock(coda_mutex *mutex)
+{
+    if (mutex == NULL)
+    {
+        return;
+    }
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&mutex->mutex);
+#elif defined(WIN32)
+    EnterCriticalSection(&mutex->critical_section);
+#endif
+}
+
+void coda_mutex_unlock(coda_mutex *mutex)
+{
+    if (mutex == NULL)
+    {
+        return;
+    }
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&mutex->mutex);
+#elif defined(WIN32)
+    LeaveCriticalSection(&mutex->critical_section);
+#endif
+}
+
+void coda_mutex_delete(coda_mutex *mutex)
+{
+    if (mutex == NULL)
+    {
+        return;
+    }
+#ifdef HAVE_PTHREAD
+    pthread_mutex_destroy(&mutex->mutex);
+#elif defined(WIN32)
+    DeleteCriticalSection(&mutex->critical_section);
+#endif
+    free(mutex);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CODA_THREAD_H
+#define CODA_THREAD_H
+
+#include "coda-internal.h"
+
+/* Publication of lazily initialized product data that is shared between threads.
+ * Data should be fully initialized before a pointer to it is stored with coda_atomic_store_ptr(). Another thread that
+ * reads a non-NULL pointer with coda_atomic_load_ptr() is then guaranteed to also see the initialized data.
+ * Without compiler support for atomic builtins, naturally aligned pointer accesses are assumed to be atomic.
+ * coda_atomic_add_int64() is only used for counters; without atomic builtins concurrent updates can get lost.
+ */
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+#define CODA_HAVE_ATOMIC_BUILTINS
+#define coda_atomic_load_ptr(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define coda_atomic_store_ptr(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#define coda_atomic_add_int64(ptr, value) ((void)__atomic_fetch_add(ptr, value, __ATOMIC_RELAXED))
+#else
+#define coda_atomic_load_ptr(ptr) (*(ptr))
+#define coda_atomic_store_ptr(ptr, value) (*(ptr) = (value))
+#define coda_atomic_add_int64(ptr, value) ((void)(*(ptr) += (value)))
+#endif
+
+/* Global (recursive) lock that guards the one-time initialization of lazily initialized product data.
+ * It should only be taken after a coda_atomic_load_ptr() showed that the data is not yet available; the initialization
+ * state then needs to be checked again while holding the lock.
+ */
+void coda_lazy_init_lock(void);
+void coda_lazy_init_unlock(void);
+
+/* Non-recursive mutex. If CODA is built without thread support coda_mutex_new() returns a NULL mutex and the other
+ * functions do nothing.
+ */
+typedef struct coda_mutex_struct coda_mutex;
+
+int coda_mutex_new(coda_mutex **mutex);
+void coda_mutex_lock(coda_mutex *mutex);
+void coda_mutex_unlock(coda_mutex *mutex);
+void coda_mutex_delete(coda_mutex *mutex);
+
+#endif
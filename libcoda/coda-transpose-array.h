@@ -38,10 +38,9 @@
 #include <stdlib.h>
 #include <string.h>
 
-static int transpose_array(const coda_cursor *cursor, void *array, int element_size)
+/* transpose a C ordered array with the given dimensions into Fortran ordering (or vice versa) */
+static int transpose_array_with_dims(int num_dims, const long dim[], void *array, int element_size)
 {
-    long dim[CODA_MAX_NUM_DIMS];
-    int num_dims;
     long num_elements;
     long multiplier[CODA_MAX_NUM_DIMS + 1];
     long rsub[CODA_MAX_NUM_DIMS + 1];   /* reversed index in multi dim array */
@@ -51,11 +50,6 @@ static int transpose_array(const coda_cursor *cursor, void *array, int element_s
     uint8_t *src;
     uint8_t *dst;
 
-    if (coda_cursor_get_array_dim(cursor, &num_dims, dim) != 0)
-    {
-        return -1;
-    }
-
     if (num_dims <= 1)
     {
         /* nothing to do */
@@ -180,4 +174,17 @@ static int transpose_array(const coda_cursor *cursor, void *array, int element_s
     return 0;
 }
 
+static int transpose_array(const coda_cursor *cursor, void *array, int element_size)
+{
+    long dim[CODA_MAX_NUM_DIMS];
+    int num_dims;
+
+    if (coda_cursor_get_array_dim(cursor, &num_dims, dim) != 0)
+    {
+        return -1;
+    }
+
+    return transpose_array_with_dims(num_dims, dim, array, element_size);
+}
+
 #endif
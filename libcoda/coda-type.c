@@ -1600,6 +1600,7 @@ coda_type_array *coda_type_array_new(coda_format format)
     type->base_type = NULL;
     type->num_elements = 1;
     type->num_dims = 0;
+    type->has_uniform_element_size = 0;
 
     return type;
 }
@@ -1735,7 +1736,84 @@ int coda_type_array_add_variable_dimension(coda_type_array *type, coda_expressio
     return 0;
 }
 
-int coda_type_array_validate(const coda_type_array *type)
+/* Returns 1 if the bit size of a data element of the given type, located 'depth' levels below some data element X,
+ * could depend on the content or position of X (see coda_expression_depends_on_node()).
+ */
+static int bit_size_depends_on_node(const coda_type *type, int depth)
+{
+    long i;
+
+    if (type->bit_size >= 0)
+    {
+        return 0;
+    }
+    if (depth >= CODA_CURSOR_MAXDEPTH)
+    {
+        return 1;
+    }
+    switch (type->type_class)
+    {
+        case coda_record_class:
+            {
+                const coda_type_record *record = (const coda_type_record *)type;
+
+                if (record->size_expr != NULL)
+                {
+                    return coda_expression_depends_on_node(record->size_expr, depth);
+                }
+                if (record->union_field_expr != NULL &&
+                    coda_expression_depends_on_node(record->union_field_expr, depth))
+                {
+                    return 1;
+                }
+                for (i = 0; i < record->num_fields; i++)
+                {
+                    const coda_type_record_field *field = record->field[i];
+
+                    if (field->available_expr != NULL && coda_expression_depends_on_node(field->available_expr, depth))
+                    {
+                        return 1;
+                    }
+                    if (field->bit_offset_expr != NULL &&
+                        coda_expression_depends_on_node(field->bit_offset_expr, depth))
+                    {
+                        return 1;
+                    }
+                    if (bit_size_depends_on_node(field->type, depth + 1))
+                    {
+                        return 1;
+                    }
+                }
+            }
+            return 0;
+        case coda_array_class:
+            {
+                const coda_type_array *array = (const coda_type_array *)type;
+
+                for (i = 0; i < array->num_dims; i++)
+                {
+                    if (array->dim_expr[i] != NULL && coda_expression_depends_on_node(array->dim_expr[i], depth))
+                    {
+                        return 1;
+                    }
+                }
+                return bit_size_depends_on_node(array->base_type, depth + 1);
+            }
+        case coda_special_class:
+            return bit_size_depends_on_node(((const coda_type_special *)type)->base_type, depth);
+        default:
+            if (type->format == coda_format_binary && type->size_expr != NULL)
+            {
+                return coda_expression_depends_on_node(type->size_expr, depth);
+            }
+            /* the size of other data elements depends on their content (e.g. the position of an end-of-line) */
+            break;
+    }
+
+    return 1;
+}
+
+int coda_type_array_validate(coda_type_array *type)
 {
     if (type == NULL)
     {
@@ -1747,6 +1825,14 @@ int coda_type_array_validate(const coda_type_array *type)
         coda_set_error(CODA_ERROR_DATA_DEFINITION, "number of dimensions is 0 for array definition");
         return -1;
     }
+    if ((type->format == coda_format_ascii || type->format == coda_format_binary) && type->base_type != NULL &&
+        type->base_type->bit_size < 0)
+    {
+        /* if the size of an element only depends on data outside the element (e.g. on a count in a header) then the
+         * size of the array and the offset of an element can be calculated from the size of the first element
+         */
+        type->has_uniform_element_size = !bit_size_depends_on_node(type->base_type, 0);
+    }
     return 0;
 }
 
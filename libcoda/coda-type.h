@@ -155,6 +155,7 @@ typedef struct coda_type_array_struct
     int num_dims;
     long dim[CODA_MAX_NUM_DIMS];        /* -1 means it's variable and the value needs to be retrieved from dim_expr */
     coda_expression *dim_expr[CODA_MAX_NUM_DIMS];
+    int has_uniform_element_size;       /* elements have no fixed size, but all elements of an array have the same size */
 } coda_type_array;
 
 typedef struct coda_type_number_struct
@@ -272,7 +273,7 @@ coda_type_array *coda_type_array_new(coda_format format);
 int coda_type_array_set_base_type(coda_type_array *type, coda_type *base_type);
 int coda_type_array_add_fixed_dimension(coda_type_array *type, long dim);
 int coda_type_array_add_variable_dimension(coda_type_array *type, coda_expression *dim_expr);
-int coda_type_array_validate(const coda_type_array *type);
+int coda_type_array_validate(coda_type_array *type);
 
 coda_type_number *coda_type_number_new(coda_format format, coda_type_class type_class);
 int coda_type_number_set_unit(coda_type_number *type, const char *unit);
@@ -79,6 +79,9 @@ struct coda_xml_product_struct
     int64_t **product_variable;
     int64_t mem_size;
     uint8_t *mem_ptr;
+#ifdef ENABLE_STATISTICS
+    coda_statistics statistics;
+#endif
 
     /* 'xml' product specific fields */
     coda_product *raw_product;
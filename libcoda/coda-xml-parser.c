@@ -31,6 +31,7 @@
 
 #include "coda-xml-internal.h"
 #include "coda-mem-internal.h"
+#include "coda-statistics.h"
 
 #include "expat.h"
 
@@ -802,34 +803,26 @@ int coda_xml_parse(coda_xml_product *product)
         int length;
         int result;
 
-        if (((coda_bin_product *)product->raw_product)->use_mmap)
+        if (i < num_blocks - 1)
+        {
+            length = BUFFSIZE;
+        }
+        else
+        {
+            length = (int)(product->raw_product->file_size - (num_blocks - 1) * BUFFSIZE);
+        }
+        coda_statistics_add(product->raw_product, num_reads, 1);
+        coda_statistics_add(product->raw_product, num_bytes_read, length);
+        if (product->raw_product->mem_ptr != NULL)
         {
-            if (i < num_blocks - 1)
-            {
-                length = BUFFSIZE;
-            }
-            else
-            {
-                length = (int)(product->raw_product->file_size - (num_blocks - 1) * BUFFSIZE);
-            }
             buff_ptr = (const char *)&(product->raw_product->mem_ptr[i * BUFFSIZE]);
+            coda_statistics_add(product->raw_product, num_memory_reads, 1);
+            coda_statistics_add(product->raw_product, num_memory_bytes_read, length);
         }
         else
         {
-            if (lseek(((coda_bin_product *)product->raw_product)->fd, (off_t)i * BUFFSIZE, SEEK_SET) < 0)
-            {
-                char byte_offset_str[21];
-
-                coda_str64(i * BUFFSIZE, byte_offset_str);
-                coda_set_error(CODA_ERROR_FILE_READ, "could not move to byte position %s (%s)", byte_offset_str,
-                               strerror(errno));
-                parser_info_cleanup(&info);
-                return -1;
-            }
-            length = read(((coda_bin_product *)product->raw_product)->fd, buff, BUFFSIZE);
-            if (length < 0)
+            if (coda_bin_product_read(product->raw_product, (int64_t)i * BUFFSIZE, length, buff) != 0)
             {
-                coda_set_error(CODA_ERROR_FILE_READ, "could not read from file (%s)", strerror(errno));
                 parser_info_cleanup(&info);
                 return -1;
             }
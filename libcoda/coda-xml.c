@@ -41,6 +41,7 @@
 #endif
 
 #include "coda-definition.h"
+#include "coda-statistics.h"
 
 int coda_xml_reopen(coda_product **product)
 {
@@ -63,6 +64,7 @@ int coda_xml_reopen(coda_product **product)
     product_file->product_variable = NULL;
     product_file->mem_size = 0;
     product_file->mem_ptr = NULL;
+    coda_statistics_init(product_file);
     product_file->raw_product = *product;
 
     product_file->filename = strdup((*product)->filename);
@@ -95,13 +95,174 @@ LIBCODA_API const char *coda_get_libcoda_version(void)
 
 static THREAD_LOCAL int coda_init_counter = 0;
 
+THREAD_LOCAL long coda_option_auto_prefetch = 0;
+THREAD_LOCAL long coda_option_bit_size_cache_max_entries = 0;
+THREAD_LOCAL long coda_option_block_cache_block_size = 65536;
+THREAD_LOCAL long coda_option_block_cache_num_blocks = 0;
 THREAD_LOCAL int coda_option_bypass_special_types = 0;
+THREAD_LOCAL int coda_option_decompress_gzip = 1;
+THREAD_LOCAL long coda_option_gzip_checkpoint_distance = 4194304;
+THREAD_LOCAL int coda_option_gzip_index_file = 0;
 THREAD_LOCAL int coda_option_perform_boundary_checks = 1;
 THREAD_LOCAL int coda_option_perform_conversions = 1;
+THREAD_LOCAL int coda_option_profile_expressions = 0;
 THREAD_LOCAL int coda_option_read_all_definitions = 0;
 THREAD_LOCAL int coda_option_use_fast_size_expressions = 1;
 THREAD_LOCAL int coda_option_use_mmap = 1;
 
+/** Set the number of array elements that CODA should automatically prefetch during sequential iteration.
+ * If this option is set to a value N larger than 0, CODA will give the operating system a hint that data will be needed
+ * soon whenever a cursor is moved to an array element whose index is a multiple of N (this includes moving to the first
+ * element of an array). The hint covers the current and the next N array elements, so the operating system can read
+ * the data of the next block of elements from disk while the current block is being processed.
+ * This is the same as calling coda_cursor_prefetch_range() yourself for each block of elements.
+ *
+ * Prefetching only has an effect for data that is read directly from a file (i.e. it has no effect for in-memory data
+ * or for formats that are accessed via external libraries such as HDF4 and HDF5). It uses madvise() for files that are
+ * memory mapped and posix_fadvise() otherwise.
+ * By default automatic prefetching is disabled (value 0).
+ * \param num_elements
+ *   \arg 0: Disable automatic prefetching.
+ *   \arg >0: Prefetch data in blocks of \a num_elements array elements.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_set_option_auto_prefetch(long num_elements)
+{
+    if (num_elements < 0)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "num_elements argument (%ld) is not valid", num_elements);
+        return -1;
+    }
+
+    coda_option_auto_prefetch = num_elements;
+
+    return 0;
+}
+
+/** Retrieve the current setting for the automatic prefetching of array elements.
+ * \see coda_set_option_auto_prefetch()
+ * \return
+ *   \arg \c 0, Automatic prefetching is disabled.
+ *   \arg \c >0, The number of array elements that are prefetched per block.
+ */
+LIBCODA_API long coda_get_option_auto_prefetch(void)
+{
+    return coda_option_auto_prefetch;
+}
+
+/** Set the maximum number of entries of the bit size cache of a product.
+ * For ascii and binary products, CODA needs to calculate the size of records and arrays whose size is not fixed in the
+ * product definition whenever it needs to skip over such a data element (e.g. when moving to the next record field or
+ * to a certain array element). For data that has several levels of nested variable sized records and arrays, the same
+ * sizes would then be calculated many times. CODA therefore remembers, for each product, the bit sizes that it
+ * calculated, keyed by the type and the position of the data element. The cache is only used when fast size
+ * expressions are enabled (see coda_set_option_use_fast_size_expressions()).
+ *
+ * A cache uses about one kilobyte of memory per entry. When the cache of a product is full, newly calculated sizes
+ * replace older entries.
+ * You can use coda_get_product_bit_size_cache_statistics() to retrieve the number of cache hits and misses for a
+ * product.
+ *
+ * \note If you change this option, the new setting will only be applicable for files that will be opened after you
+ * changed the option.
+ *
+ * By default the bit size cache is disabled.
+ * \param max_entries
+ *   \arg 0: Disable the bit size cache.
+ *   \arg >0: Maximum number of entries in the bit size cache of a single product.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_set_option_bit_size_cache(long max_entries)
+{
+    if (max_entries < 0)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "max_entries argument (%ld) is not valid", max_entries);
+        return -1;
+    }
+
+    coda_option_bit_size_cache_max_entries = max_entries;
+
+    return 0;
+}
+
+/** Retrieve the current setting for the maximum number of entries of the bit size cache.
+ * \see coda_set_option_bit_size_cache()
+ * \return
+ *   \arg \c 0, The bit size cache is disabled.
+ *   \arg \c >0, The maximum number of entries in the bit size cache of a product.
+ */
+LIBCODA_API long coda_get_option_bit_size_cache(void)
+{
+    return coda_option_bit_size_cache_max_entries;
+}
+
+/** Set the block cache parameters for product files that are not memory mapped.
+ * If memory mapping of files is disabled (see coda_set_option_use_mmap()), each read of a data element results in a
+ * separate read() system call on the file, which can be expensive for products that consist of many small data
+ * elements (especially on network or FUSE based file systems). When the block cache is enabled, CODA reads the file in
+ * blocks of \a block_size bytes and keeps the \a num_blocks most recently used blocks in memory for each product.
+ * If CODA detects that blocks are accessed sequentially, it will read several consecutive blocks with a single read
+ * operation.
+ * Reads of at least \a block_size bytes (such as reading a large array in one go) bypass the cache.
+ *
+ * You can use coda_get_product_block_cache_statistics() to retrieve the number of cache hits and misses for a product.
+ *
+ * \note If you change the block cache parameters, the new setting will only be applicable for files that will be
+ * opened after you changed the option.
+ *
+ * By default the block cache is disabled (\a num_blocks = 0) and the block size is 65536 bytes.
+ * \param block_size Size in bytes of a cache block (needs to be > 0).
+ * \param num_blocks Maximum number of blocks in the cache of a single product (0 disables the cache).
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_set_option_block_cache(long block_size, long num_blocks)
+{
+    if (block_size <= 0)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "block_size argument (%ld) is not valid", block_size);
+        return -1;
+    }
+    if (num_blocks < 0)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "num_blocks argument (%ld) is not valid", num_blocks);
+        return -1;
+    }
+
+    coda_option_block_cache_block_size = block_size;
+    coda_option_block_cache_num_blocks = num_blocks;
+
+    return 0;
+}
+
+/** Retrieve the current block cache parameters.
+ * \see coda_set_option_block_cache()
+ * \param block_size Pointer to the variable where the size in bytes of a cache block will be stored.
+ * \param num_blocks Pointer to the variable where the maximum number of blocks in the cache will be stored (0 if the
+ * block cache is disabled).
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_get_option_block_cache(long *block_size, long *num_blocks)
+{
+    if (block_size == NULL || num_blocks == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "block cache argument(s) are NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    *block_size = coda_option_block_cache_block_size;
+    *num_blocks = coda_option_block_cache_num_blocks;
+
+    return 0;
+}
+
 /** Enable/Disable the use of special types.
  * The CODA type system contains a series of special types that were introduced to make it easier for the user to
  * read certain types of information. Examples of special types are the 'time', 'complex', and 'no data'
@@ -146,6 +307,120 @@ LIBCODA_API int coda_get_option_bypass_special_types(void)
     return coda_option_bypass_special_types;
 }
 
+/** Enable/Disable transparent decompression of gzip compressed files.
+ * If this option is enabled (the default), CODA will recognize files that are gzip compressed (such as product.nc.gz)
+ * and will give access to the uncompressed content as if the uncompressed file was opened. Format detection, product
+ * recognition, and all read functions then operate on the uncompressed data (and the file size reported by CODA is
+ * the uncompressed size).
+ *
+ * When such a file is opened, CODA decompresses it once to build an index of access points (see
+ * coda_set_option_gzip_index()). Reading data at an arbitrary position then only requires decompressing from the
+ * nearest preceding access point. Recently decompressed data is kept in the block cache of the product (see
+ * coda_set_option_block_cache(); if the block cache is disabled, a small cache is used for compressed files anyway).
+ *
+ * HDF4, HDF5, RINEX, and SP3 products can not be opened in compressed form.
+ * If this option is disabled, gzip compressed files are treated as ordinary (binary) files.
+ * \note If you change this option, the new setting will only be applicable for files that will be opened after you
+ * changed the option.
+ * \param enable
+ *   \arg 0: Disable decompression of gzip compressed files.
+ *   \arg 1: Enable decompression of gzip compressed files.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_set_option_decompress_gzip(int enable)
+{
+    if (enable != 0 && enable != 1)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "enable argument (%d) is not valid", enable);
+        return -1;
+    }
+
+    coda_option_decompress_gzip = enable;
+
+    return 0;
+}
+
+/** Retrieve the current setting for the decompression of gzip compressed files.
+ * \see coda_set_option_decompress_gzip()
+ * \return
+ *   \arg \c 0, Decompression of gzip compressed files is disabled.
+ *   \arg \c 1, Decompression of gzip compressed files is enabled.
+ */
+LIBCODA_API int coda_get_option_decompress_gzip(void)
+{
+    return coda_option_decompress_gzip;
+}
+
+/** Set the parameters of the access point index for gzip compressed files.
+ * When a gzip compressed file is opened (see coda_set_option_decompress_gzip()), CODA creates an access point at the
+ * first deflate block boundary after each \a checkpoint_distance bytes of uncompressed data. Each access point takes
+ * 32KiB of memory (the decompression history that is needed to restart decompression at that point), so a smaller
+ * distance makes random reads faster at the cost of memory.
+ *
+ * Building the index requires decompressing the whole file. If \a use_index_file is enabled, CODA stores the index in
+ * a file with the name of the compressed file extended with '.codaidx' and will reuse this index file (instead of
+ * decompressing the whole file again) the next time the product is opened, as long as the size and modification time
+ * of the compressed file did not change. Index files contain data in native byte order and are not meant to be
+ * shared between machines. If the index file can not be created (e.g. because the directory is read-only) the index is
+ * only kept in memory.
+ *
+ * \note If you change these parameters, the new setting will only be applicable for files that will be opened after
+ * you changed the option.
+ *
+ * By default the checkpoint distance is 4194304 bytes (4MiB) and index files are not used.
+ * \param checkpoint_distance Minimum number of bytes of uncompressed data between two access points (needs to be > 0).
+ * \param use_index_file
+ *   \arg 0: Only keep the index in memory.
+ *   \arg 1: Read and write the index from/to an index file next to the compressed file.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_set_option_gzip_index(long checkpoint_distance, int use_index_file)
+{
+    if (checkpoint_distance <= 0)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "checkpoint_distance argument (%ld) is not valid",
+                       checkpoint_distance);
+        return -1;
+    }
+    if (use_index_file != 0 && use_index_file != 1)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "use_index_file argument (%d) is not valid", use_index_file);
+        return -1;
+    }
+
+    coda_option_gzip_checkpoint_distance = checkpoint_distance;
+    coda_option_gzip_index_file = use_index_file;
+
+    return 0;
+}
+
+/** Retrieve the current parameters of the access point index for gzip compressed files.
+ * \see coda_set_option_gzip_index()
+ * \param checkpoint_distance Pointer to the variable where the minimum distance in bytes between two access points
+ * will be stored.
+ * \param use_index_file Pointer to the variable where the setting for the use of index files will be stored.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_get_option_gzip_index(long *checkpoint_distance, int *use_index_file)
+{
+    if (checkpoint_distance == NULL || use_index_file == NULL)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "gzip index argument(s) are NULL (%s:%u)", __FILE__, __LINE__);
+        return -1;
+    }
+
+    *checkpoint_distance = coda_option_gzip_checkpoint_distance;
+    *use_index_file = coda_option_gzip_index_file;
+
+    return 0;
+}
+
 /** Enable/Disable boundary checking.
  * By default all functions in libcoda perform boundary checks. However some boundary checks are quite compute
  * intensive. In order to increase performance you can turn off those compute intensive boundary checks with this
@@ -226,6 +501,51 @@ LIBCODA_API int coda_get_option_perform_conversions(void)
     return coda_option_perform_conversions;
 }
 
+/** Enable/Disable profiling of the expressions from product definitions.
+ * If this option is enabled, CODA records for each expression that it reads from a .codadef file where the expression
+ * came from (product class, product type and version, and the location within the .codadef file). Each evaluation of
+ * such an expression is then counted and timed. The result can be retrieved with coda_expression_print_profile().
+ * This makes it possible to find out which size, availability, offset, union field, or other expressions from a
+ * product definition take the most time.
+ *
+ * The source location is recorded while reading a product definition. The product definitions are read when a product
+ * of that type is opened for the first time, but detection rules are already read by coda_init(). To also include the
+ * expressions of the detection rules, this option should therefore be enabled before calling coda_init().
+ *
+ * Profiling is disabled by default. Enabling it adds a small overhead to each expression evaluation.
+ * Just as all other CODA state, the profile is kept per thread.
+ *
+ * \param enable
+ *   \arg 0: Disable expression profiling.
+ *   \arg 1: Enable expression profiling.
+ * \return
+ *   \arg \c 0, Success.
+ *   \arg \c -1, Error occurred (check #coda_errno).
+ */
+LIBCODA_API int coda_set_option_profile_expressions(int enable)
+{
+    if (!(enable == 0 || enable == 1))
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "enable argument (%d) is not valid", enable);
+        return -1;
+    }
+
+    coda_option_profile_expressions = enable;
+
+    return 0;
+}
+
+/** Retrieve the current setting for the expression profiling option.
+ * \see coda_set_option_profile_expressions()
+ * \return
+ *   \arg \c 0, Expression profiling is disabled.
+ *   \arg \c 1, Expression profiling is enabled.
+ */
+LIBCODA_API int coda_get_option_profile_expressions(void)
+{
+    return coda_option_profile_expressions;
+}
+
 /** Enable/Disable the use of fast size expressions.
  * Sometimes product files contain information that can be used to directly retrieve the size (or offset) of a data
  * element. If this information is redundant (i.e. the size and/or offset can also be determined in another way) then
@@ -593,3 +913,82 @@ void coda_free(void *ptr)
 }
 
 /** @} */
+
+/* Capture the settings of the current thread that are needed to initialize CODA in another thread.
+ * Since all CODA state is thread local, worker threads need to perform their own coda_init() with the same
+ * definition path and option values as the thread that created them.
+ */
+int coda_thread_settings_get(coda_thread_settings *settings)
+{
+    settings->definition_path = NULL;
+    if (coda_definition_path != NULL)
+    {
+        settings->definition_path = strdup(coda_definition_path);
+        if (settings->definition_path == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not duplicate string) (%s:%u)", __FILE__,
+                           __LINE__);
+            return -1;
+        }
+    }
+    settings->option_auto_prefetch = coda_option_auto_prefetch;
+    settings->option_bit_size_cache_max_entries = coda_option_bit_size_cache_max_entries;
+    settings->option_block_cache_block_size = coda_option_block_cache_block_size;
+    settings->option_block_cache_num_blocks = coda_option_block_cache_num_blocks;
+    settings->option_bypass_special_types = coda_option_bypass_special_types;
+    settings->option_decompress_gzip = coda_option_decompress_gzip;
+    settings->option_gzip_checkpoint_distance = coda_option_gzip_checkpoint_distance;
+    settings->option_gzip_index_file = coda_option_gzip_index_file;
+    settings->option_perform_boundary_checks = coda_option_perform_boundary_checks;
+    settings->option_perform_conversions = coda_option_perform_conversions;
+    settings->option_profile_expressions = coda_option_profile_expressions;
+    settings->option_read_all_definitions = coda_option_read_all_definitions;
+    settings->option_use_fast_size_expressions = coda_option_use_fast_size_expressions;
+    settings->option_use_mmap = coda_option_use_mmap;
+
+    return 0;
+}
+
+void coda_thread_settings_done(coda_thread_settings *settings)
+{
+    if (settings->definition_path != NULL)
+    {
+        free(settings->definition_path);
+        settings->definition_path = NULL;
+    }
+}
+
+/* Initialize CODA for the current thread using settings that were captured with coda_thread_settings_get().
+ * Each successful call needs to be matched by a call to coda_done() from the same thread.
+ */
+int coda_thread_init(const coda_thread_settings *settings)
+{
+    coda_option_profile_expressions = settings->option_profile_expressions;
+    coda_option_read_all_definitions = settings->option_read_all_definitions;
+    if (coda_init_counter == 0 && settings->definition_path != NULL)
+    {
+        if (coda_set_definition_path(settings->definition_path) != 0)
+        {
+            return -1;
+        }
+    }
+    if (coda_init() != 0)
+    {
+        return -1;
+    }
+    /* options need to be set after coda_init() since the first coda_init() resets some of them */
+    coda_option_auto_prefetch = settings->option_auto_prefetch;
+    coda_option_bit_size_cache_max_entries = settings->option_bit_size_cache_max_entries;
+    coda_option_block_cache_block_size = settings->option_block_cache_block_size;
+    coda_option_block_cache_num_blocks = settings->option_block_cache_num_blocks;
+    coda_option_bypass_special_types = settings->option_bypass_special_types;
+    coda_option_decompress_gzip = settings->option_decompress_gzip;
+    coda_option_gzip_checkpoint_distance = settings->option_gzip_checkpoint_distance;
+    coda_option_gzip_index_file = settings->option_gzip_index_file;
+    coda_option_perform_boundary_checks = settings->option_perform_boundary_checks;
+    coda_option_perform_conversions = settings->option_perform_conversions;
+    coda_option_use_fast_size_expressions = settings->option_use_fast_size_expressions;
+    coda_option_use_mmap = settings->option_use_mmap;
+
+    return 0;
+}
@@ -72,15 +72,15 @@ static void default_error_handler(const char *message, ...)
 
 struct za_entry_struct
 {
-    uint32_t localheader_offset;
+    int64_t localheader_offset;
     uint16_t compression;
     uint16_t modification_time;
     uint16_t modification_date;
     uint32_t attributes;
 
     uint32_t crc;
-    uint32_t compressed_size;
-    uint32_t uncompressed_size;
+    int64_t compressed_size;
+    int64_t uncompressed_size;
 
     uint16_t filename_length;
     uint16_t extrafield_length;
@@ -95,6 +95,7 @@ struct za_entry_struct
 struct za_file_struct
 {
     int fd;
+    int64_t file_size;
     int num_entries;
     char *filename;
     za_entry *entry;
@@ -102,6 +103,109 @@ struct za_file_struct
     void (*handle_error) (const char *, ...);
 };
 
+static uint16_t get_uint16(const uint8_t *data)
+{
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static uint32_t get_uint32(const uint8_t *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static uint64_t get_uint64(const uint8_t *data)
+{
+    return (uint64_t)get_uint32(data) | ((uint64_t)get_uint32(&data[4]) << 32);
+}
+
+static int read_at(za_file *zf, int64_t offset, void *buffer, long length)
+{
+    ssize_t result;
+
+    if (lseek(zf->fd, (off_t)offset, SEEK_SET) < 0)
+    {
+        zf->handle_error(strerror(errno));
+        return -1;
+    }
+    result = read(zf->fd, buffer, length);
+    if (result < 0)
+    {
+        zf->handle_error(strerror(errno));
+        return -1;
+    }
+    if (result < length)
+    {
+        zf->handle_error("unexpected end of zip file '%s'", zf->filename);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* replace the 32 bit sizes/offset of an entry that are set to 0xFFFFFFFF by the values from the ZIP64 extra field */
+static int read_zip64_extra_field(za_entry *entry, const uint8_t *data, long length)
+{
+    int need_uncompressed_size = entry->uncompressed_size == 0xFFFFFFFF;
+    int need_compressed_size = entry->compressed_size == 0xFFFFFFFF;
+    int need_localheader_offset = entry->localheader_offset == 0xFFFFFFFF;
+
+    while (length >= 4)
+    {
+        uint16_t id = get_uint16(data);
+        uint16_t size = get_uint16(&data[2]);
+
+        data += 4;
+        length -= 4;
+        if (size > length)
+        {
+            break;
+        }
+        if (id == 0x0001)
+        {
+            /* the extra field only contains the values that did not fit in the central directory file header */
+            if (size < 8 * (need_uncompressed_size + need_compressed_size + need_localheader_offset))
+            {
+                entry->zf->handle_error("invalid zip64 extra field for entry '%s' in zip file '%s'", entry->filename,
+                                        entry->zf->filename);
+                return -1;
+            }
+            if (need_uncompressed_size)
+            {
+                entry->uncompressed_size = get_uint64(data);
+                data += 8;
+                length -= 8;
+                size -= 8;
+            }
+            if (need_compressed_size)
+            {
+                entry->compressed_size = get_uint64(data);
+                data += 8;
+                length -= 8;
+                size -= 8;
+            }
+            if (need_localheader_offset)
+            {
+                entry->localheader_offset = get_uint64(data);
+                data += 8;
+                length -= 8;
+                size -= 8;
+            }
+            return 0;
+        }
+        data += size;
+        length -= size;
+    }
+
+    if (need_uncompressed_size || need_compressed_size || need_localheader_offset)
+    {
+        entry->zf->handle_error("missing zip64 extra field for entry '%s' in zip file '%s'", entry->filename,
+                                entry->zf->filename);
+        return -1;
+    }
+
+    return 0;
+}
+
 static int get_entries(za_file *zf)
 {
     union
@@ -110,70 +214,113 @@ static int get_entries(za_file *zf)
         uint16_t as_uint16[24];
         uint32_t as_uint32[12];
     } buffer;
+    uint8_t *tail;
+    uint8_t zip64[56];
     uint32_t signature;
-    uint32_t offset;
-    uint16_t num_entries;
-    int i;
+    int64_t file_size;
+    int64_t eocd_offset;
+    int64_t offset;
+    int64_t num_entries;
+    long tail_length;
+    long i;
 
-    /* read the 'end of central directory record' */
-    if (lseek(zf->fd, -22, SEEK_END) < 0)
+    file_size = lseek(zf->fd, 0, SEEK_END);
+    if (file_size < 0)
     {
         zf->handle_error(strerror(errno));
         return -1;
     }
+    zf->file_size = file_size;
 
-    if (read(zf->fd, buffer.as_int8, 22) < 0)
+    /* the 'end of central directory record' (22 bytes) is followed by a zip file comment of at most 65535 bytes */
+    tail_length = 22 + 65535;
+    if (tail_length > file_size)
     {
-        zf->handle_error(strerror(errno));
+        tail_length = (long)file_size;
+    }
+    tail = malloc(tail_length);
+    if (tail == NULL)
+    {
+        zf->handle_error("could not allocate %ld bytes", tail_length);
         return -1;
     }
-
-    signature = buffer.as_uint32[0];
-#ifdef WORDS_BIGENDIAN
-    swap_uint32(&signature);
-#endif
-    if (signature != 0x06054b50)
+    if (read_at(zf, file_size - tail_length, tail, tail_length) != 0)
     {
-        /* There is probably a zipfile comment at the end -> bail out */
-        /* In the future, if needed, we could implement an approach that just reads all local file headers */
-        zf->handle_error("could not locate package index in zip file '%s'. There is probably a 'zip file comment' at "
-                         "the end of the file (which is not supported)", zf->filename);
+        free(tail);
         return -1;
     }
+    for (i = tail_length - 22; i >= 0; i--)
+    {
+        if (get_uint32(&tail[i]) == 0x06054b50)
+        {
+            break;
+        }
+    }
+    if (i < 0)
+    {
+        free(tail);
+        zf->handle_error("could not locate package index in zip file '%s'", zf->filename);
+        return -1;
+    }
+    eocd_offset = file_size - tail_length + i;
+    num_entries = get_uint16(&tail[i + 10]);
+    offset = get_uint32(&tail[i + 16]);
+    free(tail);
 
-    num_entries = buffer.as_uint16[4];  /* offset 8 */
-#ifdef WORDS_BIGENDIAN
-    swap_uint16(&num_entries);
-#endif
-
-    offset = buffer.as_uint32[4];       /* offset 16 */
-#ifdef WORDS_BIGENDIAN
-    swap_uint32(&offset);
-#endif
+    if (num_entries == 0xFFFF || offset == 0xFFFFFFFF)
+    {
+        /* ZIP64 archive: the 'zip64 end of central directory locator' precedes the end of central directory record */
+        if (eocd_offset < 20 || read_at(zf, eocd_offset - 20, zip64, 20) != 0)
+        {
+            return -1;
+        }
+        if (get_uint32(zip64) != 0x07064b50)
+        {
+            zf->handle_error("could not locate zip64 package index in zip file '%s'", zf->filename);
+            return -1;
+        }
+        if (read_at(zf, (int64_t)get_uint64(&zip64[8]), zip64, 56) != 0)
+        {
+            return -1;
+        }
+        if (get_uint32(zip64) != 0x06064b50)
+        {
+            zf->handle_error("invalid zip64 package index in zip file '%s'", zf->filename);
+            return -1;
+        }
+        num_entries = (int64_t)get_uint64(&zip64[32]);
+        offset = (int64_t)get_uint64(&zip64[48]);
+        if (num_entries < 0 || num_entries > 0x7FFFFFF || offset < 0 || offset > file_size)
+        {
+            zf->handle_error("invalid zip64 package index in zip file '%s'", zf->filename);
+            return -1;
+        }
+    }
 
-    zf->num_entries = num_entries;
-    zf->entry = malloc(num_entries * sizeof(za_entry));
+    zf->num_entries = (int)num_entries;
+    zf->entry = malloc(zf->num_entries * sizeof(za_entry));
     if (zf->entry == NULL)
     {
-        zf->handle_error("could not allocate %ld bytes", num_entries * sizeof(za_entry));
+        zf->handle_error("could not allocate %ld bytes", zf->num_entries * sizeof(za_entry));
         return -1;
     }
-    for (i = 0; i < num_entries; i++)
+    for (i = 0; i < zf->num_entries; i++)
     {
         zf->entry[i].filename = NULL;
         zf->entry[i].zf = zf;
     }
 
-    if (lseek(zf->fd, offset, SEEK_SET) < 0)
+    if (lseek(zf->fd, (off_t)offset, SEEK_SET) < 0)
     {
         zf->handle_error(strerror(errno));
         return -1;
     }
 
-    for (i = 0; i < num_entries; i++)
+    for (i = 0; i < zf->num_entries; i++)
     {
         uint16_t comment_length;
         uint16_t internal_attributes;
+        uint32_t value;
         za_entry *entry;
 
         entry = &zf->entry[i];
@@ -225,15 +372,17 @@ static int get_entries(za_file *zf)
         swap_uint32(&entry->crc);
 #endif
 
-        entry->compressed_size = buffer.as_uint32[5];   /* offset 20 */
+        value = buffer.as_uint32[5];    /* offset 20 */
 #ifdef WORDS_BIGENDIAN
-        swap_uint32(&entry->compressed_size);
+        swap_uint32(&value);
 #endif
+        entry->compressed_size = value;
 
-        entry->uncompressed_size = buffer.as_uint32[6]; /* offset 24 */
+        value = buffer.as_uint32[6];    /* offset 24 */
 #ifdef WORDS_BIGENDIAN
-        swap_uint32(&entry->uncompressed_size);
+        swap_uint32(&value);
 #endif
+        entry->uncompressed_size = value;
 
         entry->filename_length = buffer.as_uint16[14];  /* offset 28 */
 #ifdef WORDS_BIGENDIAN
@@ -265,10 +414,11 @@ static int get_entries(za_file *zf)
         swap_uint32(&entry->attributes);
 #endif
 
-        memcpy(&entry->localheader_offset, &buffer.as_int8[42], 4);
+        memcpy(&value, &buffer.as_int8[42], 4);
 #ifdef WORDS_BIGENDIAN
-        swap_uint32(&entry->localheader_offset);
+        swap_uint32(&value);
 #endif
+        entry->localheader_offset = value;
 
         entry->filename = malloc(entry->filename_length + 1);
         if (entry->filename == NULL)
@@ -291,7 +441,43 @@ static int get_entries(za_file *zf)
             return -1;
         }
 
-        if (lseek(zf->fd, entry->extrafield_length + comment_length, SEEK_CUR) < 0)
+        if (entry->extrafield_length > 0)
+        {
+            uint8_t *extrafield;
+            ssize_t result;
+
+            extrafield = malloc(entry->extrafield_length);
+            if (extrafield == NULL)
+            {
+                zf->handle_error("could not allocate %d bytes", (int)entry->extrafield_length);
+                return -1;
+            }
+            result = read(zf->fd, extrafield, entry->extrafield_length);
+            if (result < 0)
+            {
+                zf->handle_error(strerror(errno));
+                free(extrafield);
+                return -1;
+            }
+            if (result < entry->extrafield_length)
+            {
+                zf->handle_error("unexpected end of zip file '%s'", zf->filename);
+                free(extrafield);
+                return -1;
+            }
+            if (read_zip64_extra_field(entry, extrafield, entry->extrafield_length) != 0)
+            {
+                free(extrafield);
+                return -1;
+            }
+            free(extrafield);
+        }
+        else if (read_zip64_extra_field(entry, NULL, 0) != 0)
+        {
+            return -1;
+        }
+
+        if (lseek(zf->fd, comment_length, SEEK_CUR) < 0)
         {
             zf->handle_error(strerror(errno));
             return -1;
@@ -350,6 +536,7 @@ za_file *za_open(const char *filename, void (*error_handler) (const char *, ...)
         }
         return NULL;
     }
+    zf->file_size = 0;
     zf->num_entries = 0;
     zf->entry = NULL;
     zf->hash_data = NULL;
@@ -408,6 +595,11 @@ const char *za_get_filename(za_file *zf)
     return zf->filename;
 }
 
+int64_t za_get_file_size(za_file *zf)
+{
+    return zf->file_size;
+}
+
 za_entry *za_get_entry_by_index(za_file *zf, long index)
 {
     if (index < 0 || index >= zf->num_entries)
@@ -431,16 +623,33 @@ za_entry *za_get_entry_by_name(za_file *zf, const char *name)
 }
 
 long za_get_entry_size(za_entry *entry)
+{
+    return (long)entry->uncompressed_size;
+}
+
+int64_t za_get_entry_uncompressed_size(za_entry *entry)
 {
     return entry->uncompressed_size;
 }
 
+int64_t za_get_entry_compressed_size(za_entry *entry)
+{
+    return entry->compressed_size;
+}
+
+/* returns 1 if the entry is deflate compressed and 0 if it is stored without compression */
+int za_is_entry_compressed(za_entry *entry)
+{
+    return entry->compression == 8;
+}
+
 const char *za_get_entry_name(za_entry *entry)
 {
     return entry->filename;
 }
 
-int za_read_entry(za_entry *entry, char *out_buffer)
+/* check the 'local file header' of an entry and determine the file offset of the entry data */
+static int read_local_header(za_entry *entry, int64_t *data_offset)
 {
     union
     {
@@ -449,6 +658,7 @@ int za_read_entry(za_entry *entry, char *out_buffer)
         uint32_t as_uint32[8];
     } buffer;
     uint32_t signature;
+    uint16_t bitflag;
     uint16_t compression;
     uint16_t modification_time;
     uint16_t modification_date;
@@ -458,7 +668,7 @@ int za_read_entry(za_entry *entry, char *out_buffer)
     uint16_t filename_length;
     uint16_t extrafield_length;
 
-    if (lseek(entry->zf->fd, entry->localheader_offset, SEEK_SET) < 0)
+    if (lseek(entry->zf->fd, (off_t)entry->localheader_offset, SEEK_SET) < 0)
     {
         entry->zf->handle_error(strerror(errno));
         return -1;
@@ -483,7 +693,17 @@ int za_read_entry(za_entry *entry, char *out_buffer)
     }
 
     /* uint16_t version2 = buffer.as_uint16[2];  */
-    /* uint16_t bitflag = buffer.as_uint16[3]; */
+
+    bitflag = buffer.as_uint16[3];      /* offset 6 */
+#ifdef WORDS_BIGENDIAN
+    swap_uint16(&bitflag);
+#endif
+    if (bitflag & 0x1)
+    {
+        entry->zf->handle_error("encrypted entry '%s' in zip file '%s' is not supported", entry->filename,
+                                entry->zf->filename);
+        return -1;
+    }
 
     compression = buffer.as_uint16[4];  /* offset 8 */
 #ifdef WORDS_BIGENDIAN
@@ -524,7 +744,7 @@ int za_read_entry(za_entry *entry, char *out_buffer)
 #ifdef WORDS_BIGENDIAN
     swap_uint32(&crc);
 #endif
-    if (crc != entry->crc)
+    if (!(bitflag & 0x8) && crc != entry->crc)
     {
         entry->zf->handle_error("inconsistency between local file header and central directory in zip file (crc)");
         return -1;
@@ -534,7 +754,9 @@ int za_read_entry(za_entry *entry, char *out_buffer)
 #ifdef WORDS_BIGENDIAN
     swap_uint32(&compressed_size);
 #endif
-    if (compressed_size != entry->compressed_size)
+    /* with bit 3 of the flags set, crc and sizes are stored in a data descriptor after the data instead;
+     * for ZIP64 entries the sizes are stored in the extra field */
+    if (!(bitflag & 0x8) && compressed_size != 0xFFFFFFFF && compressed_size != entry->compressed_size)
     {
         entry->zf->handle_error("inconsistency between local file header and central directory in zip file "
                                 "(compressed_size)");
@@ -545,7 +767,7 @@ int za_read_entry(za_entry *entry, char *out_buffer)
 #ifdef WORDS_BIGENDIAN
     swap_uint32(&uncompressed_size);
 #endif
-    if (uncompressed_size != entry->uncompressed_size)
+    if (!(bitflag & 0x8) && uncompressed_size != 0xFFFFFFFF && uncompressed_size != entry->uncompressed_size)
     {
         entry->zf->handle_error("inconsistency between local file header and central directory in zip file "
                                 "(uncompressed_size)");
@@ -569,7 +791,33 @@ int za_read_entry(za_entry *entry, char *out_buffer)
 #endif
     /* the extra field information is allowed to be different between the local file header and central directory! */
 
-    if (lseek(entry->zf->fd, filename_length + extrafield_length, SEEK_CUR) < 0)
+    *data_offset = entry->localheader_offset + 30 + filename_length + extrafield_length;
+
+    return 0;
+}
+
+/* returns the file offset of the (possibly compressed) data of an entry, or -1 on error */
+int64_t za_get_entry_data_offset(za_entry *entry)
+{
+    int64_t data_offset;
+
+    if (read_local_header(entry, &data_offset) != 0)
+    {
+        return -1;
+    }
+
+    return data_offset;
+}
+
+int za_read_entry(za_entry *entry, char *out_buffer)
+{
+    int64_t data_offset;
+
+    if (read_local_header(entry, &data_offset) != 0)
+    {
+        return -1;
+    }
+    if (lseek(entry->zf->fd, (off_t)data_offset, SEEK_SET) < 0)
     {
         entry->zf->handle_error(strerror(errno));
         return -1;
@@ -34,10 +34,15 @@
 
 #define za_open coda_za_open
 #define za_get_filename coda_za_get_filename
+#define za_get_file_size coda_za_get_file_size
 #define za_get_num_entries coda_za_get_num_entries
 #define za_get_entry_by_index coda_za_get_entry_by_index
 #define za_get_entry_by_name coda_za_get_entry_by_name
 #define za_get_entry_size coda_za_get_entry_size
+#define za_get_entry_uncompressed_size coda_za_get_entry_uncompressed_size
+#define za_get_entry_compressed_size coda_za_get_entry_compressed_size
+#define za_get_entry_data_offset coda_za_get_entry_data_offset
+#define za_is_entry_compressed coda_za_is_entry_compressed
 #define za_get_entry_name coda_za_get_entry_name
 #define za_read_entry coda_za_read_entry
 #define za_close coda_za_close
@@ -48,11 +53,16 @@ typedef struct za_file_struct za_file;
 za_file *za_open(const char *filename, void (*error_handler) (const char *, ...));
 
 const char *za_get_filename(za_file *zf);
+int64_t za_get_file_size(za_file *zf);
 long za_get_num_entries(za_file *zf);
 za_entry *za_get_entry_by_index(za_file *zf, long index);
 za_entry *za_get_entry_by_name(za_file *zf, const char *name);
 
 long za_get_entry_size(za_entry *entry);
+int64_t za_get_entry_uncompressed_size(za_entry *entry);
+int64_t za_get_entry_compressed_size(za_entry *entry);
+int64_t za_get_entry_data_offset(za_entry *entry);
+int za_is_entry_compressed(za_entry *entry);
 const char *za_get_entry_name(za_entry *entry);
 int za_read_entry(za_entry *entry, char *buffer);
 
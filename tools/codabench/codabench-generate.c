@@ -0,0 +1,1714 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Generators for synthetic products of each of the file formats that CODA can read.
+ *
+ * All products are generated from a fixed random seed, so generating a product twice with the same parameters gives
+ * byte-identical files. The 'size' parameter sets the number of records (binary, ascii, xml), rows (netCDF, CDF),
+ * epochs (RINEX, SP3) or hundreds of grid points (GRIB). The 'depth' parameter sets the number of nested levels of
+ * dynamically sized arrays (binary, ascii) or the nesting depth of elements (xml).
+ */
+
+#include "codabench.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* number of values in the innermost array when depth is 0 */
+#define NUM_INNER_VALUES 8
+
+/* number of columns for the two-dimensional netCDF and CDF variables */
+#define NUM_COLUMNS 64
+
+/* grid of each GRIB message (5 degree global grid) */
+#define GRIB_NI 72
+#define GRIB_NJ 37
+
+/* number of satellites in each RINEX/SP3 epoch */
+#define NUM_SATELLITES 8
+
+#define CODA_DEFINITION_NAMESPACE "http://www.stcorp.nl/coda/definition/2008/07"
+
+const char *bench_format_name[num_bench_formats] = {
+    "binary",
+    "ascii",
+    "xml",
+    "netcdf",
+    "cdf",
+    "cdf-gzip",
+    "grib1",
+    "grib2",
+    "rinex",
+    "sp3"
+};
+
+const int bench_format_uses_depth[num_bench_formats] = { 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+
+typedef struct text_buffer_struct
+{
+    char *data;
+    long length;
+    long size;
+} text_buffer;
+
+typedef struct bit_writer_struct
+{
+    uint8_t *data;
+    long length;
+    uint32_t bits;
+    int num_bits;
+} bit_writer;
+
+static uint32_t crc_table[256];
+static int crc_table_initialized = 0;
+
+uint32_t bench_random(uint32_t *state)
+{
+    /* xorshift32 */
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static int random_int(uint32_t *state, int min_value, int max_value)
+{
+    return min_value + (int)(bench_random(state) % (uint32_t)(max_value - min_value + 1));
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, long length)
+{
+    long i;
+
+    if (!crc_table_initialized)
+    {
+        uint32_t c;
+        int n, k;
+
+        for (n = 0; n < 256; n++)
+        {
+            c = (uint32_t)n;
+            for (k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            crc_table[n] = c;
+        }
+        crc_table_initialized = 1;
+    }
+
+    crc = crc ^ 0xFFFFFFFF;
+    for (i = 0; i < length; i++)
+    {
+        crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+static int text_buffer_append(text_buffer *buffer, const char *str)
+{
+    long length = (long)strlen(str);
+
+    if (buffer->length + length + 1 > buffer->size)
+    {
+        long new_size = 2 * buffer->size;
+        char *new_data;
+
+        if (new_size < buffer->length + length + 1)
+        {
+            new_size = buffer->length + length + 1;
+        }
+        if (new_size < 4096)
+        {
+            new_size = 4096;
+        }
+        new_data = realloc(buffer->data, new_size);
+        if (new_data == NULL)
+        {
+            fprintf(stderr, "ERROR: out of memory (could not allocate %lu bytes)\n", (long)new_size);
+            return -1;
+        }
+        buffer->data = new_data;
+        buffer->size = new_size;
+    }
+    memcpy(&buffer->data[buffer->length], str, length + 1);
+    buffer->length += length;
+
+    return 0;
+}
+
+static FILE *create_file(const char *filename)
+{
+    FILE *f;
+
+    f = fopen(filename, "wb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "ERROR: could not create file '%s' (%s)\n", filename, strerror(errno));
+    }
+    return f;
+}
+
+static int close_file(FILE *f, const char *filename)
+{
+    if (ferror(f))
+    {
+        fprintf(stderr, "ERROR: could not write to file '%s' (%s)\n", filename, strerror(errno));
+        fclose(f);
+        return -1;
+    }
+    if (fclose(f) != 0)
+    {
+        fprintf(stderr, "ERROR: could not write to file '%s' (%s)\n", filename, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+/* all binary values are written in big endian byte order unless the function name has a _le suffix */
+
+static void put_uint8(FILE *f, uint8_t value)
+{
+    fputc(value, f);
+}
+
+static void put_uint16(FILE *f, uint16_t value)
+{
+    fputc((value >> 8) & 0xFF, f);
+    fputc(value & 0xFF, f);
+}
+
+static void put_uint24(FILE *f, uint32_t value)
+{
+    fputc((value >> 16) & 0xFF, f);
+    fputc((value >> 8) & 0xFF, f);
+    fputc(value & 0xFF, f);
+}
+
+static void put_uint32(FILE *f, uint32_t value)
+{
+    put_uint16(f, (uint16_t)(value >> 16));
+    put_uint16(f, (uint16_t)(value & 0xFFFF));
+}
+
+static void put_uint64(FILE *f, uint64_t value)
+{
+    put_uint32(f, (uint32_t)(value >> 32));
+    put_uint32(f, (uint32_t)(value & 0xFFFFFFFF));
+}
+
+static void put_uint16_le(FILE *f, uint16_t value)
+{
+    fputc(value & 0xFF, f);
+    fputc((value >> 8) & 0xFF, f);
+}
+
+static void put_uint32_le(FILE *f, uint32_t value)
+{
+    put_uint16_le(f, (uint16_t)(value & 0xFFFF));
+    put_uint16_le(f, (uint16_t)(value >> 16));
+}
+
+static void put_float(FILE *f, float value)
+{
+    uint32_t bits;
+
+    memcpy(&bits, &value, 4);
+    put_uint32(f, bits);
+}
+
+static void put_double(FILE *f, double value)
+{
+    uint64_t bits;
+
+    memcpy(&bits, &value, 8);
+    put_uint64(f, bits);
+}
+
+static void put_padded_string(FILE *f, const char *str, int length)
+{
+    int i;
+
+    for (i = 0; i < length; i++)
+    {
+        fputc(*str != '\0' ? *str++ : '\0', f);
+    }
+}
+
+static void store_uint16(uint8_t *data, uint16_t value)
+{
+    data[0] = (value >> 8) & 0xFF;
+    data[1] = value & 0xFF;
+}
+
+static void store_float(uint8_t *data, float value)
+{
+    uint32_t bits;
+
+    memcpy(&bits, &value, 4);
+    data[0] = (bits >> 24) & 0xFF;
+    data[1] = (bits >> 16) & 0xFF;
+    data[2] = (bits >> 8) & 0xFF;
+    data[3] = bits & 0xFF;
+}
+
+static void store_double(uint8_t *data, double value)
+{
+    uint64_t bits;
+    int i;
+
+    memcpy(&bits, &value, 8);
+    for (i = 0; i < 8; i++)
+    {
+        data[i] = (uint8_t)((bits >> (56 - 8 * i)) & 0xFF);
+    }
+}
+
+/* synthetic value for a grid/column position that varies smoothly (so it compresses reasonably) */
+static double smooth_value(long row, long column)
+{
+    return 250.0 + 30.0 * sin(row * 0.01) * cos(column * 0.1);
+}
+
+/*
+ * .codadef generation
+ */
+
+static void append_indent(text_buffer *buffer, int indent)
+{
+    while (indent-- > 0)
+    {
+        text_buffer_append(buffer, "  ");
+    }
+}
+
+static void append_field(text_buffer *buffer, int indent, const char *name, const char *type)
+{
+    append_indent(buffer, indent);
+    text_buffer_append(buffer, "<cd:Field name=\"");
+    text_buffer_append(buffer, name);
+    text_buffer_append(buffer, "\">");
+    text_buffer_append(buffer, type);
+    text_buffer_append(buffer, "</cd:Field>\n");
+}
+
+/* level 'level' of the nested dynamically sized arrays; level 'depth' is an array of integers */
+static void append_level(text_buffer *buffer, int is_ascii, int level, int depth, int indent)
+{
+    const char *count_type;
+    const char *value_type;
+
+    if (is_ascii)
+    {
+        count_type = "<cd:Integer><cd:ByteSize>3</cd:ByteSize></cd:Integer>";
+        value_type = "<cd:Integer><cd:ByteSize>7</cd:ByteSize></cd:Integer>";
+    }
+    else
+    {
+        count_type = "<cd:Integer><cd:NativeType>uint8</cd:NativeType><cd:BitSize>8</cd:BitSize></cd:Integer>";
+        value_type = "<cd:Integer><cd:NativeType>int16</cd:NativeType><cd:BitSize>16</cd:BitSize></cd:Integer>";
+    }
+
+    append_indent(buffer, indent);
+    text_buffer_append(buffer, "<cd:Record>\n");
+    append_field(buffer, indent + 1, "count", count_type);
+    append_indent(buffer, indent + 1);
+    text_buffer_append(buffer, "<cd:Field name=\"item\">\n");
+    append_indent(buffer, indent + 2);
+    text_buffer_append(buffer, "<cd:Array>\n");
+    append_indent(buffer, indent + 3);
+    text_buffer_append(buffer, "<cd:Dimension>int(../count)</cd:Dimension>\n");
+    if (level < depth)
+    {
+        append_level(buffer, is_ascii, level + 1, depth, indent + 3);
+    }
+    else
+    {
+        append_indent(buffer, indent + 3);
+        text_buffer_append(buffer, value_type);
+        text_buffer_append(buffer, "\n");
+    }
+    append_indent(buffer, indent + 2);
+    text_buffer_append(buffer, "</cd:Array>\n");
+    append_indent(buffer, indent + 1);
+    text_buffer_append(buffer, "</cd:Field>\n");
+    append_indent(buffer, indent);
+    text_buffer_append(buffer, "</cd:Record>\n");
+}
+
+static void append_product_definition(text_buffer *buffer, int is_ascii, int depth)
+{
+    char str[200];
+
+    sprintf(str, "%s_d%d", is_ascii ? "asc" : "bin", depth);
+    text_buffer_append(buffer, "<?xml version=\"1.0\"?>\n");
+    text_buffer_append(buffer, "<cd:ProductDefinition id=\"");
+    text_buffer_append(buffer, str);
+    text_buffer_append(buffer, is_ascii ? "\" format=\"ascii\"" : "\" format=\"binary\"");
+    text_buffer_append(buffer, " xmlns:cd=\"" CODA_DEFINITION_NAMESPACE "\">\n");
+    text_buffer_append(buffer, "  <cd:Record>\n");
+    append_field(buffer, 2, "magic", "<cd:Text><cd:ByteSize>8</cd:ByteSize></cd:Text>");
+    if (is_ascii)
+    {
+        append_field(buffer, 2, "magic_eol", "<cd:AsciiLineSeparator/>");
+        append_field(buffer, 2, "num_records", "<cd:Integer><cd:ByteSize>8</cd:ByteSize></cd:Integer>");
+        append_field(buffer, 2, "num_records_eol", "<cd:AsciiLineSeparator/>");
+    }
+    else
+    {
+        append_field(buffer, 2, "num_records",
+                     "<cd:Integer><cd:NativeType>uint32</cd:NativeType><cd:BitSize>32</cd:BitSize></cd:Integer>");
+    }
+    text_buffer_append(buffer, "    <cd:Field name=\"records\">\n");
+    text_buffer_append(buffer, "      <cd:Array>\n");
+    text_buffer_append(buffer, "        <cd:Dimension>int(/num_records)</cd:Dimension>\n");
+    text_buffer_append(buffer, "        <cd:Record>\n");
+    if (is_ascii)
+    {
+        append_field(buffer, 5, "time", "<cd:Float><cd:ByteSize>16</cd:ByteSize></cd:Float>");
+        append_field(buffer, 5, "id", "<cd:Integer><cd:ByteSize>8</cd:ByteSize></cd:Integer>");
+        append_field(buffer, 5, "value", "<cd:Float><cd:ByteSize>14</cd:ByteSize></cd:Float>");
+    }
+    else
+    {
+        append_field(buffer, 5, "time",
+                     "<cd:Float><cd:NativeType>double</cd:NativeType><cd:BitSize>64</cd:BitSize></cd:Float>");
+        append_field(buffer, 5, "id",
+                     "<cd:Integer><cd:NativeType>int32</cd:NativeType><cd:BitSize>32</cd:BitSize></cd:Integer>");
+        append_field(buffer, 5, "value",
+                     "<cd:Float><cd:NativeType>float</cd:NativeType><cd:BitSize>32</cd:BitSize></cd:Float>");
+    }
+    if (depth == 0)
+    {
+        sprintf(str, "<cd:Array><cd:Dimension>%d</cd:Dimension>%s</cd:Array>", NUM_INNER_VALUES,
+                is_ascii ? "<cd:Integer><cd:ByteSize>7</cd:ByteSize></cd:Integer>" :
+                "<cd:Integer><cd:NativeType>int16</cd:NativeType><cd:BitSize>16</cd:BitSize></cd:Integer>");
+        append_field(buffer, 5, "values", str);
+    }
+    else
+    {
+        text_buffer_append(buffer, "          <cd:Field name=\"sub\">\n");
+        append_level(buffer, is_ascii, 1, depth, 6);
+        text_buffer_append(buffer, "          </cd:Field>\n");
+    }
+    if (is_ascii)
+    {
+        append_field(buffer, 5, "eol", "<cd:AsciiLineSeparator/>");
+    }
+    text_buffer_append(buffer, "        </cd:Record>\n");
+    text_buffer_append(buffer, "      </cd:Array>\n");
+    text_buffer_append(buffer, "    </cd:Field>\n");
+    text_buffer_append(buffer, "  </cd:Record>\n");
+    text_buffer_append(buffer, "</cd:ProductDefinition>\n");
+}
+
+static void append_product_type(text_buffer *buffer, int is_ascii, int num_depths, const int *depth)
+{
+    char str[200];
+    int i;
+
+    text_buffer_append(buffer, is_ascii ? "  <cd:ProductType name=\"BENCH_ASC\">\n" :
+                       "  <cd:ProductType name=\"BENCH_BIN\">\n");
+    for (i = 0; i < num_depths; i++)
+    {
+        sprintf(str, "    <cd:ProductDefinition id=\"%s_d%d\" format=\"%s\" version=\"%d\">\n",
+                is_ascii ? "asc" : "bin", depth[i], is_ascii ? "ascii" : "binary", depth[i]);
+        text_buffer_append(buffer, str);
+        sprintf(str, "      <cd:DetectionRule><cd:MatchData offset=\"0\">%s%d</cd:MatchData></cd:DetectionRule>\n",
+                is_ascii ? "CODAASC" : "CODABNC", depth[i]);
+        text_buffer_append(buffer, str);
+        text_buffer_append(buffer, "    </cd:ProductDefinition>\n");
+    }
+    text_buffer_append(buffer, "  </cd:ProductType>\n");
+}
+
+/* write a zip file with uncompressed entries (a .codadef file is a zip file) */
+static int write_zip(const char *filename, int num_entries, char **entry_name, text_buffer *entry_data)
+{
+    uint32_t *crc;
+    uint32_t *offset;
+    uint32_t directory_offset;
+    uint32_t directory_size;
+    FILE *f;
+    int i;
+
+    crc = malloc(num_entries * sizeof(uint32_t));
+    offset = malloc(num_entries * sizeof(uint32_t));
+    if (crc == NULL || offset == NULL)
+    {
+        fprintf(stderr, "ERROR: out of memory (could not allocate %lu bytes)\n",
+                (long)(num_entries * sizeof(uint32_t)));
+        return -1;
+    }
+
+    f = create_file(filename);
+    if (f == NULL)
+    {
+        free(crc);
+        free(offset);
+        return -1;
+    }
+
+    for (i = 0; i < num_entries; i++)
+    {
+        crc[i] = crc32_update(0, (uint8_t *)entry_data[i].data, entry_data[i].length);
+        offset[i] = (uint32_t)ftell(f);
+        put_uint32_le(f, 0x04034b50);   /* local file header signature */
+        put_uint16_le(f, 10);   /* version needed to extract */
+        put_uint16_le(f, 0);    /* flags */
+        put_uint16_le(f, 0);    /* compression method (stored) */
+        put_uint16_le(f, 0);    /* modification time */
+        put_uint16_le(f, 0x21); /* modification date (1980-01-01) */
+        put_uint32_le(f, crc[i]);
+        put_uint32_le(f, (uint32_t)entry_data[i].length);
+        put_uint32_le(f, (uint32_t)entry_data[i].length);
+        put_uint16_le(f, (uint16_t)strlen(entry_name[i]));
+        put_uint16_le(f, 0);    /* extra field length */
+        fwrite(entry_name[i], 1, strlen(entry_name[i]), f);
+        fwrite(entry_data[i].data, 1, entry_data[i].length, f);
+    }
+
+    directory_offset = (uint32_t)ftell(f);
+    for (i = 0; i < num_entries; i++)
+    {
+        put_uint32_le(f, 0x02014b50);   /* central directory file header signature */
+        put_uint16_le(f, 10);   /* version made by */
+        put_uint16_le(f, 10);   /* version needed to extract */
+        put_uint16_le(f, 0);    /* flags */
+        put_uint16_le(f, 0);    /* compression method (stored) */
+        put_uint16_le(f, 0);    /* modification time */
+        put_uint16_le(f, 0x21); /* modification date */
+        put_uint32_le(f, crc[i]);
+        put_uint32_le(f, (uint32_t)entry_data[i].length);
+        put_uint32_le(f, (uint32_t)entry_data[i].length);
+        put_uint16_le(f, (uint16_t)strlen(entry_name[i]));
+        put_uint16_le(f, 0);    /* extra field length */
+        put_uint16_le(f, 0);    /* comment length */
+        put_uint16_le(f, 0);    /* disk number start */
+        put_uint16_le(f, 1);    /* internal attributes (text) */
+        put_uint32_le(f, 0);    /* external attributes */
+        put_uint32_le(f, offset[i]);
+        fwrite(entry_name[i], 1, strlen(entry_name[i]), f);
+    }
+    directory_size = (uint32_t)ftell(f) - directory_offset;
+
+    put_uint32_le(f, 0x06054b50);       /* end of central directory signature */
+    put_uint16_le(f, 0);        /* number of this disk */
+    put_uint16_le(f, 0);        /* disk where central directory starts */
+    put_uint16_le(f, (uint16_t)num_entries);
+    put_uint16_le(f, (uint16_t)num_entries);
+    put_uint32_le(f, directory_size);
+    put_uint32_le(f, directory_offset);
+    put_uint16_le(f, 0);        /* comment length */
+
+    free(crc);
+    free(offset);
+
+    return close_file(f, filename);
+}
+
+/* generate a .codadef with a binary and an ascii product definition for each of the depths */
+int bench_generate_definitions(const char *filename, int num_depths, const int *depth)
+{
+    text_buffer *entry_data;
+    char **entry_name;
+    int num_entries;
+    int result;
+    int i;
+
+    num_entries = 2 + 2 * num_depths;
+    entry_name = malloc(num_entries * sizeof(char *));
+    entry_data = malloc(num_entries * sizeof(text_buffer));
+    if (entry_name == NULL || entry_data == NULL)
+    {
+        fprintf(stderr, "ERROR: out of memory (could not allocate %lu bytes)\n",
+                (long)(num_entries * sizeof(text_buffer)));
+        return -1;
+    }
+    for (i = 0; i < num_entries; i++)
+    {
+        entry_name[i] = malloc(100);
+        if (entry_name[i] == NULL)
+        {
+            fprintf(stderr, "ERROR: out of memory (could not allocate %lu bytes)\n", (long)100);
+            return -1;
+        }
+        entry_data[i].data = NULL;
+        entry_data[i].length = 0;
+        entry_data[i].size = 0;
+    }
+
+    strcpy(entry_name[0], "VERSION");
+    text_buffer_append(&entry_data[0], "1\n");
+
+    strcpy(entry_name[1], "index.xml");
+    text_buffer_append(&entry_data[1], "<?xml version=\"1.0\"?>\n");
+    text_buffer_append(&entry_data[1], "<cd:ProductClass name=\"" BENCH_PRODUCT_CLASS "\" xmlns:cd=\""
+                       CODA_DEFINITION_NAMESPACE "\">\n");
+    append_product_type(&entry_data[1], 0, num_depths, depth);
+    append_product_type(&entry_data[1], 1, num_depths, depth);
+    text_buffer_append(&entry_data[1], "</cd:ProductClass>\n");
+
+    for (i = 0; i < num_depths; i++)
+    {
+        sprintf(entry_name[2 + 2 * i], "products/bin_d%d.xml", depth[i]);
+        append_product_definition(&entry_data[2 + 2 * i], 0, depth[i]);
+        sprintf(entry_name[3 + 2 * i], "products/asc_d%d.xml", depth[i]);
+        append_product_definition(&entry_data[3 + 2 * i], 1, depth[i]);
+    }
+    for (i = 0; i < num_entries; i++)
+    {
+        if (entry_data[i].data == NULL)
+        {
+            /* text_buffer_append() already reported the error */
+            return -1;
+        }
+    }
+
+    result = write_zip(filename, num_entries, entry_name, entry_data);
+
+    for (i = 0; i < num_entries; i++)
+    {
+        free(entry_name[i]);
+        free(entry_data[i].data);
+    }
+    free(entry_name);
+    free(entry_data);
+
+    return result;
+}
+
+/*
+ * binary and ascii
+ */
+
+static void write_binary_level(FILE *f, uint32_t *state, int level, int depth)
+{
+    int count;
+    int i;
+
+    if (level < depth)
+    {
+        count = random_int(state, 1, 3);
+        put_uint8(f, (uint8_t)count);
+        for (i = 0; i < count; i++)
+        {
+            write_binary_level(f, state, level + 1, depth);
+        }
+    }
+    else
+    {
+        count = random_int(state, NUM_INNER_VALUES / 2, NUM_INNER_VALUES + NUM_INNER_VALUES / 2);
+        put_uint8(f, (uint8_t)count);
+        for (i = 0; i < count; i++)
+        {
+            put_uint16(f, (uint16_t)random_int(state, -1000, 1000));
+        }
+    }
+}
+
+static int generate_binary(const char *filename, long size, int depth)
+{
+    uint32_t state = 1;
+    char magic[9];
+    FILE *f;
+    long i;
+    int j;
+
+    f = create_file(filename);
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    sprintf(magic, "CODABNC%d", depth);
+    put_padded_string(f, magic, 8);
+    put_uint32(f, (uint32_t)size);
+    for (i = 0; i < size; i++)
+    {
+        put_double(f, 631152000.0 + i);
+        put_uint32(f, (uint32_t)i);
+        put_float(f, (float)(random_int(&state, 0, 100000) / 1000.0));
+        if (depth == 0)
+        {
+            for (j = 0; j < NUM_INNER_VALUES; j++)
+            {
+                put_uint16(f, (uint16_t)random_int(&state, -1000, 1000));
+            }
+        }
+        else
+        {
+            write_binary_level(f, &state, 1, depth);
+        }
+    }
+
+    return close_file(f, filename);
+}
+
+static void write_ascii_level(FILE *f, uint32_t *state, int level, int depth)
+{
+    int count;
+    int i;
+
+    if (level < depth)
+    {
+        count = random_int(state, 1, 3);
+        fprintf(f, "%3d", count);
+        for (i = 0; i < count; i++)
+        {
+            write_ascii_level(f, state, level + 1, depth);
+        }
+    }
+    else
+    {
+        count = random_int(state, NUM_INNER_VALUES / 2, NUM_INNER_VALUES + NUM_INNER_VALUES / 2);
+        fprintf(f, "%3d", count);
+        for (i = 0; i < count; i++)
+        {
+            fprintf(f, "%7d", random_int(state, -1000, 1000));
+        }
+    }
+}
+
+static int generate_ascii(const char *filename, long size, int depth)
+{
+    uint32_t state = 1;
+    FILE *f;
+    long i;
+    int j;
+
+    f = create_file(filename);
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    fprintf(f, "CODAASC%d\n", depth);
+    fprintf(f, "%8ld\n", size);
+    for (i = 0; i < size; i++)
+    {
+        fprintf(f, "%16.6f%8ld%14.6f", 631152000.0 + i, i, random_int(&state, 0, 100000) / 1000.0);
+        if (depth == 0)
+        {
+            for (j = 0; j < NUM_INNER_VALUES; j++)
+            {
+                fprintf(f, "%7d", random_int(&state, -1000, 1000));
+            }
+        }
+        else
+        {
+            write_ascii_level(f, &state, 1, depth);
+        }
+        fprintf(f, "\n");
+    }
+
+    return close_file(f, filename);
+}
+
+/*
+ * xml
+ */
+
+static void write_xml_level(FILE *f, uint32_t *state, int level, int depth, int indent)
+{
+    int count;
+    int i;
+
+    if (level <= depth)
+    {
+        count = random_int(state, 1, 3);
+        for (i = 0; i < count; i++)
+        {
+            fprintf(f, "%*s<group level=\"%d\">\n", 2 * indent, "", level);
+            write_xml_level(f, state, level + 1, depth, indent + 1);
+            fprintf(f, "%*s</group>\n", 2 * indent, "");
+        }
+    }
+    else
+    {
+        count = (depth == 0 ? NUM_INNER_VALUES :
+                 random_int(state, NUM_INNER_VALUES / 2, NUM_INNER_VALUES + NUM_INNER_VALUES / 2));
+        fprintf(f, "%*s", 2 * indent, "");
+        for (i = 0; i < count; i++)
+        {
+            fprintf(f, "<v>%d</v>", random_int(state, -1000, 1000));
+        }
+        fprintf(f, "\n");
+    }
+}
+
+static int generate_xml(const char *filename, long size, int depth)
+{
+    uint32_t state = 1;
+    FILE *f;
+    long i;
+
+    f = create_file(filename);
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    fprintf(f, "<bench depth=\"%d\">\n", depth);
+    for (i = 0; i < size; i++)
+    {
+        fprintf(f, "  <item id=\"%ld\">\n", i);
+        fprintf(f, "    <time>%.1f</time>\n", 631152000.0 + i);
+        fprintf(f, "    <value>%.3f</value>\n", random_int(&state, 0, 100000) / 1000.0);
+        write_xml_level(f, &state, 1, depth, 2);
+        fprintf(f, "  </item>\n");
+    }
+    fprintf(f, "</bench>\n");
+
+    return close_file(f, filename);
+}
+
+/*
+ * netCDF (classic format)
+ */
+
+static long netcdf_name_size(const char *name)
+{
+    return 4 + ((strlen(name) + 3) / 4) * 4;
+}
+
+static void put_netcdf_name(FILE *f, const char *name)
+{
+    long length = (long)strlen(name);
+
+    put_uint32(f, (uint32_t)length);
+    put_padded_string(f, name, (int)(((length + 3) / 4) * 4));
+}
+
+static int generate_netcdf(const char *filename, long size)
+{
+    const char *title = "CODA benchmark product";
+    long title_length;
+    long header_size;
+    long record_size;
+    long offset;
+    FILE *f;
+    long i;
+    int j;
+
+    f = create_file(filename);
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    title_length = (long)strlen(title);
+
+    /* dimensions 'time' (unlimited) and 'column', a global 'title' attribute, a non-record variable 'column'
+     * and record variables 'time', 'data', and 'flag' */
+    header_size = 4 + 4;
+    header_size += 8 + netcdf_name_size("time") + 4 + netcdf_name_size("column") + 4;
+    header_size += 8 + netcdf_name_size("title") + 8 + ((title_length + 3) / 4) * 4;
+    header_size += 8;
+    header_size += netcdf_name_size("column") + 4 + 4 + 8 + 12;
+    header_size += netcdf_name_size("time") + 4 + 4 + 8 + 12;
+    header_size += netcdf_name_size("data") + 4 + 8 + 8 + 12;
+    header_size += netcdf_name_size("flag") + 4 + 8 + 8 + 12;
+    record_size = 8 + NUM_COLUMNS * 4 + NUM_COLUMNS * 2;
+
+    put_padded_string(f, "CDF\001", 4);
+    put_uint32(f, (uint32_t)size);
+
+    put_uint32(f, 0x0A);        /* NC_DIMENSION */
+    put_uint32(f, 2);
+    put_netcdf_name(f, "time");
+    put_uint32(f, 0);
+    put_netcdf_name(f, "column");
+    put_uint32(f, NUM_COLUMNS);
+
+    put_uint32(f, 0x0C);        /* NC_ATTRIBUTE */
+    put_uint32(f, 1);
+    put_netcdf_name(f, "title");
+    put_uint32(f, 2);   /* NC_CHAR */
+    put_netcdf_name(f, title);
+
+    put_uint32(f, 0x0B);        /* NC_VARIABLE */
+    put_uint32(f, 4);
+    offset = header_size;
+
+    put_netcdf_name(f, "column");
+    put_uint32(f, 1);
+    put_uint32(f, 1);
+    put_uint64(f, 0);   /* no attributes */
+    put_uint32(f, 5);   /* NC_FLOAT */
+    put_uint32(f, NUM_COLUMNS * 4);
+    put_uint32(f, (uint32_t)offset);
+    offset += NUM_COLUMNS * 4;
+
+    put_netcdf_name(f, "time");
+    put_uint32(f, 1);
+    put_uint32(f, 0);
+    put_uint64(f, 0);
+    put_uint32(f, 6);   /* NC_DOUBLE */
+    put_uint32(f, 8);
+    put_uint32(f, (uint32_t)offset);
+
+    put_netcdf_name(f, "data");
+    put_uint32(f, 2);
+    put_uint32(f, 0);
+    put_uint32(f, 1);
+    put_uint64(f, 0);
+    put_uint32(f, 5);   /* NC_FLOAT */
+    put_uint32(f, NUM_COLUMNS * 4);
+    put_uint32(f, (uint32_t)(offset + 8));
+
+    put_netcdf_name(f, "flag");
+    put_uint32(f, 2);
+    put_uint32(f, 0);
+    put_uint32(f, 1);
+    put_uint64(f, 0);
+    put_uint32(f, 3);   /* NC_SHORT */
+    put_uint32(f, NUM_COLUMNS * 2);
+    put_uint32(f, (uint32_t)(offset + 8 + NUM_COLUMNS * 4));
+
+    for (j = 0; j < NUM_COLUMNS; j++)
+    {
+        put_float(f, (float)j);
+    }
+    for (i = 0; i < size; i++)
+    {
+        put_double(f, 631152000.0 + i);
+        for (j = 0; j < NUM_COLUMNS; j++)
+        {
+            put_float(f, (float)smooth_value(i, j));
+        }
+        for (j = 0; j < NUM_COLUMNS; j++)
+        {
+            put_uint16(f, (uint16_t)((i + j) % 4));
+        }
+    }
+    if (ftell(f) != header_size + NUM_COLUMNS * 4 + size * record_size)
+    {
+        fprintf(stderr, "ERROR: internal error while generating '%s' (inconsistent netCDF header)\n", filename);
+        fclose(f);
+        return -1;
+    }
+
+    return close_file(f, filename);
+}
+
+/*
+ * gzip (used for CDF variable compression)
+ */
+
+static void bit_writer_put(bit_writer *writer, uint32_t value, int num_bits)
+{
+    writer->bits |= value << writer->num_bits;
+    writer->num_bits += num_bits;
+    while (writer->num_bits >= 8)
+    {
+        writer->data[writer->length++] = (uint8_t)(writer->bits & 0xFF);
+        writer->bits >>= 8;
+        writer->num_bits -= 8;
+    }
+}
+
+/* Huffman codes are stored starting with the most significant bit */
+static void bit_writer_put_code(bit_writer *writer, uint32_t code, int num_bits)
+{
+    uint32_t reversed = 0;
+    int i;
+
+    for (i = 0; i < num_bits; i++)
+    {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    bit_writer_put(writer, reversed, num_bits);
+}
+
+/* literal/length symbol using the fixed Huffman code of deflate */
+static void put_deflate_symbol(bit_writer *writer, int symbol)
+{
+    if (symbol < 144)
+    {
+        bit_writer_put_code(writer, 0x30 + symbol, 8);
+    }
+    else if (symbol < 256)
+    {
+        bit_writer_put_code(writer, 0x190 + symbol - 144, 9);
+    }
+    else if (symbol < 280)
+    {
+        bit_writer_put_code(writer, symbol - 256, 7);
+    }
+    else
+    {
+        bit_writer_put_code(writer, 0xC0 + symbol - 280, 8);
+    }
+}
+
+static void put_deflate_match(bit_writer *writer, int length, int distance)
+{
+    static const int length_base[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195,
+        227, 258
+    };
+    static const int length_extra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    static const int distance_base[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+        4097, 6145, 8193, 12289, 16385, 24577
+    };
+    static const int distance_extra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+    int code;
+
+    code = 28;
+    while (length_base[code] > length)
+    {
+        code--;
+    }
+    put_deflate_symbol(writer, 257 + code);
+    bit_writer_put(writer, length - length_base[code], length_extra[code]);
+
+    code = 29;
+    while (distance_base[code] > distance)
+    {
+        code--;
+    }
+    bit_writer_put_code(writer, code, 5);
+    bit_writer_put(writer, distance - distance_base[code], distance_extra[code]);
+}
+
+/* compress data into a gzip stream using a single deflate block with fixed Huffman codes */
+static int gzip_compress(const uint8_t *data, long length, uint8_t **compressed_data, long *compressed_length)
+{
+    bit_writer writer;
+    int32_t *head;
+    uint32_t crc;
+    long position;
+    int i;
+
+    /* worst case is 9 bits per literal */
+    writer.data = malloc(10 + length + length / 8 + 16 + 8);
+    head = malloc(65536 * sizeof(int32_t));
+    if (writer.data == NULL || head == NULL)
+    {
+        fprintf(stderr, "ERROR: out of memory (could not allocate %lu bytes)\n", (long)(10 + length + length / 8 + 24));
+        return -1;
+    }
+    for (i = 0; i < 65536; i++)
+    {
+        head[i] = -1;
+    }
+
+    /* gzip header */
+    memcpy(writer.data, "\037\213\010\000\000\000\000\000\000\377", 10);
+    writer.length = 10;
+    writer.bits = 0;
+    writer.num_bits = 0;
+
+    /* final block with fixed Huffman codes */
+    bit_writer_put(&writer, 1, 1);
+    bit_writer_put(&writer, 1, 2);
+
+    position = 0;
+    while (position < length)
+    {
+        int match_length = 0;
+        long candidate = -1;
+
+        if (position + 2 < length)
+        {
+            uint32_t hash;
+
+            hash = ((data[position] << 8) ^ (data[position + 1] << 4) ^ data[position + 2]) & 0xFFFF;
+            candidate = head[hash];
+            head[hash] = (int32_t)position;
+            if (candidate >= 0 && position - candidate <= 32768)
+            {
+                while (match_length < 258 && position + match_length < length &&
+                       data[candidate + match_length] == data[position + match_length])
+                {
+                    match_length++;
+                }
+            }
+        }
+        if (match_length >= 3)
+        {
+            put_deflate_match(&writer, match_length, (int)(position - candidate));
+            position += match_length;
+        }
+        else
+        {
+            put_deflate_symbol(&writer, data[position]);
+            position++;
+        }
+    }
+    put_deflate_symbol(&writer, 256);
+    if (writer.num_bits > 0)
+    {
+        bit_writer_put(&writer, 0, 8 - writer.num_bits);
+    }
+
+    /* gzip trailer */
+    crc = crc32_update(0, data, length);
+    for (i = 0; i < 4; i++)
+    {
+        writer.data[writer.length++] = (uint8_t)((crc >> (8 * i)) & 0xFF);
+    }
+    for (i = 0; i < 4; i++)
+    {
+        writer.data[writer.length++] = (uint8_t)(((uint32_t)length >> (8 * i)) & 0xFF);
+    }
+
+    free(head);
+    *compressed_data = writer.data;
+    *compressed_length = writer.length;
+
+    return 0;
+}
+
+/*
+ * CDF
+ */
+
+#define CDF_NUM_VARIABLES 3
+#define CDF_CDR_SIZE 312
+#define CDF_GDR_SIZE 84
+#define CDF_CPR_SIZE 28
+#define CDF_VXR_SIZE 44
+
+static int generate_cdf(const char *filename, long size, int compress)
+{
+    static const char *name[CDF_NUM_VARIABLES] = { "Epoch", "data", "flag" };
+    static const int32_t data_type[CDF_NUM_VARIABLES] = { 31, 44, 2 };  /* CDF_EPOCH, CDF_REAL4, CDF_INT2 */
+    static const int num_dims[CDF_NUM_VARIABLES] = { 0, 1, 1 };
+    static const int value_size[CDF_NUM_VARIABLES] = { 8, 4, 2 };
+    uint8_t *data[CDF_NUM_VARIABLES];
+    long data_length[CDF_NUM_VARIABLES];
+    long vdr_offset[CDF_NUM_VARIABLES];
+    long vdr_size[CDF_NUM_VARIABLES];
+    long file_size;
+    FILE *f;
+    long i;
+    int j, k;
+
+    for (k = 0; k < CDF_NUM_VARIABLES; k++)
+    {
+        long num_values = size * (num_dims[k] == 0 ? 1 : NUM_COLUMNS);
+
+        data_length[k] = num_values * value_size[k];
+        data[k] = malloc(data_length[k]);
+        if (data[k] == NULL)
+        {
+            fprintf(stderr, "ERROR: out of memory (could not allocate %lu bytes)\n", (long)data_length[k]);
+            return -1;
+        }
+    }
+    for (i = 0; i < size; i++)
+    {
+        /* CDF_EPOCH is milliseconds since 0000-01-01; 63745056000000 is 2020-01-01 */
+        store_double(&data[0][i * 8], 63745056000000.0 + i * 1000.0);
+        for (j = 0; j < NUM_COLUMNS; j++)
+        {
+            /* round to 1/16 so the values compress */
+            store_float(&data[1][(i * NUM_COLUMNS + j) * 4], (float)(floor(smooth_value(i, j) * 16) / 16));
+            store_uint16(&data[2][(i * NUM_COLUMNS + j) * 2], (uint16_t)((i + j) % 4));
+        }
+    }
+    if (compress)
+    {
+        for (k = 0; k < CDF_NUM_VARIABLES; k++)
+        {
+            uint8_t *compressed_data;
+            long compressed_length;
+
+            if (gzip_compress(data[k], data_length[k], &compressed_data, &compressed_length) != 0)
+            {
+                return -1;
+            }
+            free(data[k]);
+            data[k] = compressed_data;
+            data_length[k] = compressed_length;
+        }
+    }
+
+    /* layout: magic, CDR, GDR, and for each variable a zVDR, (CPR), VXR, and VVR (or CVVR) */
+    file_size = 8 + CDF_CDR_SIZE + CDF_GDR_SIZE;
+    for (k = 0; k < CDF_NUM_VARIABLES; k++)
+    {
+        vdr_offset[k] = file_size;
+        vdr_size[k] = 344 + 8 * num_dims[k];
+        file_size += vdr_size[k] + (compress ? CDF_CPR_SIZE : 0) + CDF_VXR_SIZE + (compress ? 24 : 12) +
+            data_length[k];
+    }
+
+    f = create_file(filename);
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    put_uint32(f, 0xCDF30001);
+    put_uint32(f, 0x0000FFFF);
+
+    /* CDF Descriptor Record */
+    put_uint64(f, CDF_CDR_SIZE);
+    put_uint32(f, 1);
+    put_uint64(f, 8 + CDF_CDR_SIZE);    /* GDR offset */
+    put_uint32(f, 3);   /* version */
+    put_uint32(f, 7);   /* release */
+    put_uint32(f, 1);   /* encoding (network) */
+    put_uint32(f, 3);   /* flags (row major, single file) */
+    put_uint32(f, 0);
+    put_uint32(f, 0);
+    put_uint32(f, 0);   /* increment */
+    put_uint32(f, 3);   /* identifier */
+    put_uint32(f, 0xFFFFFFFF);
+    put_padded_string(f, "Common Data Format (CDF)", 256);
+
+    /* Global Descriptor Record */
+    put_uint64(f, CDF_GDR_SIZE);
+    put_uint32(f, 2);
+    put_uint64(f, 0);   /* rVDR head */
+    put_uint64(f, vdr_offset[0]);       /* zVDR head */
+    put_uint64(f, 0);   /* ADR head */
+    put_uint64(f, file_size);   /* eof */
+    put_uint32(f, 0);   /* NrVars */
+    put_uint32(f, 0);   /* NumAttr */
+    put_uint32(f, 0xFFFFFFFF);  /* rMaxRec */
+    put_uint32(f, 0);   /* rNumDims */
+    put_uint32(f, CDF_NUM_VARIABLES);   /* NzVars */
+    put_uint64(f, 0);   /* UIR head */
+    put_uint32(f, 0);
+    put_uint32(f, 0);   /* LeapSecondLastUpdated */
+    put_uint32(f, 0xFFFFFFFF);
+
+    for (k = 0; k < CDF_NUM_VARIABLES; k++)
+    {
+        long vxr_offset = vdr_offset[k] + vdr_size[k] + (compress ? CDF_CPR_SIZE : 0);
+
+        /* zVariable Descriptor Record */
+        put_uint64(f, vdr_size[k]);
+        put_uint32(f, 8);
+        put_uint64(f, k + 1 < CDF_NUM_VARIABLES ? vdr_offset[k + 1] : 0);
+        put_uint32(f, data_type[k]);
+        put_uint32(f, (uint32_t)(size - 1));    /* MaxRec */
+        put_uint64(f, vxr_offset);      /* VXR head */
+        put_uint64(f, vxr_offset);      /* VXR tail */
+        put_uint32(f, compress ? 5 : 1);        /* flags (record variance, compression) */
+        put_uint32(f, 0);       /* SRecords */
+        put_uint32(f, 0);
+        put_uint32(f, 0xFFFFFFFF);
+        put_uint32(f, 0xFFFFFFFF);
+        put_uint32(f, 1);       /* NumElems */
+        put_uint32(f, k);       /* Num */
+        put_uint64(f, compress ? (uint64_t)(vdr_offset[k] + vdr_size[k]) : (uint64_t)-1);     /* CPR offset */
+        put_uint32(f, (uint32_t)size);  /* BlockingFactor */
+        put_padded_string(f, name[k], 256);
+        put_uint32(f, num_dims[k]);
+        if (num_dims[k] > 0)
+        {
+            put_uint32(f, NUM_COLUMNS); /* zDimSizes */
+            put_uint32(f, 0xFFFFFFFF);  /* DimVarys */
+        }
+
+        if (compress)
+        {
+            /* Compressed Parameters Record */
+            put_uint64(f, CDF_CPR_SIZE);
+            put_uint32(f, 11);
+            put_uint32(f, 5);   /* GZIP */
+            put_uint32(f, 0);
+            put_uint32(f, 1);   /* pCount */
+            put_uint32(f, 6);   /* compression level */
+        }
+
+        /* Variable Index Record */
+        put_uint64(f, CDF_VXR_SIZE);
+        put_uint32(f, 6);
+        put_uint64(f, 0);       /* VXR next */
+        put_uint32(f, 1);       /* Nentries */
+        put_uint32(f, 1);       /* NusedEntries */
+        put_uint32(f, 0);       /* First */
+        put_uint32(f, (uint32_t)(size - 1));    /* Last */
+        put_uint64(f, vxr_offset + CDF_VXR_SIZE);       /* Offset */
+
+        if (compress)
+        {
+            /* Compressed Variable Values Record */
+            put_uint64(f, 24 + data_length[k]);
+            put_uint32(f, 13);
+            put_uint32(f, 0);
+            put_uint64(f, data_length[k]);
+        }
+        else
+        {
+            /* Variable Values Record */
+            put_uint64(f, 12 + data_length[k]);
+            put_uint32(f, 7);
+        }
+        fwrite(data[k], 1, data_length[k], f);
+        free(data[k]);
+    }
+
+    return close_file(f, filename);
+}
+
+/*
+ * GRIB
+ */
+
+/* convert to the IBM single precision floating point representation that GRIB1 uses */
+static uint32_t ibm_float(double value)
+{
+    uint32_t sign = 0;
+    uint32_t mantissa;
+    int exponent = 64;
+
+    if (value == 0)
+    {
+        return 0;
+    }
+    if (value < 0)
+    {
+        sign = 0x80000000;
+        value = -value;
+    }
+    while (value >= 1.0)
+    {
+        value /= 16.0;
+        exponent++;
+    }
+    while (value < 1.0 / 16.0)
+    {
+        value *= 16.0;
+        exponent--;
+    }
+    mantissa = (uint32_t)(value * 16777216.0);
+    return sign | ((uint32_t)exponent << 24) | mantissa;
+}
+
+/* values with simple packing: reference value 200, binary scale factor -9, 16 bits per value */
+static void put_grib_packed_values(FILE *f, int message)
+{
+    int i, j;
+
+    for (j = 0; j < GRIB_NJ; j++)
+    {
+        for (i = 0; i < GRIB_NI; i++)
+        {
+            put_uint16(f, (uint16_t)(512 * (smooth_value(message * GRIB_NJ + j, i) - 200.0)));
+        }
+    }
+}
+
+static void put_grib1_signed24(FILE *f, long value)
+{
+    put_uint24(f, value < 0 ? (uint32_t)(0x800000 | -value) : (uint32_t)value);
+}
+
+static void put_grib2_signed32(FILE *f, long value)
+{
+    put_uint32(f, value < 0 ? (uint32_t)(0x80000000 | -value) : (uint32_t)value);
+}
+
+static int generate_grib1(const char *filename, long size)
+{
+    long num_messages = (size + 99) / 100;
+    long bds_size = 11 + GRIB_NI * GRIB_NJ * 2;
+    long message_size;
+    FILE *f;
+    long m;
+
+    if (bds_size % 2 != 0)
+    {
+        bds_size++;
+    }
+    message_size = 8 + 28 + 32 + bds_size + 4;
+
+    f = create_file(filename);
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    for (m = 0; m < num_messages; m++)
+    {
+        /* Indicator Section */
+        put_padded_string(f, "GRIB", 4);
+        put_uint24(f, (uint32_t)message_size);
+        put_uint8(f, 1);
+
+        /* Product Definition Section */
+        put_uint24(f, 28);
+        put_uint8(f, 3);        /* table2Version */
+        put_uint8(f, 98);       /* centre */
+        put_uint8(f, 1);        /* generatingProcessIdentifier */
+        put_uint8(f, 255);      /* gridDefinition (grid is defined by the GDS) */
+        put_uint8(f, 0x80);     /* GDS included, no BMS */
+        put_uint8(f, 11);       /* indicatorOfParameter (temperature) */
+        put_uint8(f, 100);      /* indicatorOfTypeOfLevel (isobaric) */
+        put_uint16(f, (uint16_t)(100 + 10 * (m % 90)));  /* level */
+        put_uint8(f, 20);       /* yearOfCentury */
+        put_uint8(f, 1);        /* month */
+        put_uint8(f, (uint8_t)(1 + (m / 24) % 28));     /* day */
+        put_uint8(f, (uint8_t)(m % 24));        /* hour */
+        put_uint8(f, 0);        /* minute */
+        put_uint8(f, 1);        /* unitOfTimeRange */
+        put_uint8(f, 0);        /* P1 */
+        put_uint8(f, 0);        /* P2 */
+        put_uint8(f, 0);        /* timeRangeIndicator */
+        put_uint16(f, 0);       /* numberIncludedInAverage */
+        put_uint8(f, 0);        /* numberMissingFromAveragesOrAccumulations */
+        put_uint8(f, 21);       /* centuryOfReferenceTimeOfData */
+        put_uint8(f, 0);        /* subCentre */
+        put_uint16(f, 0);       /* decimalScaleFactor */
+
+        /* Grid Description Section (regular lat/lon grid) */
+        put_uint24(f, 32);
+        put_uint8(f, 0);        /* NV */
+        put_uint8(f, 255);      /* PVL */
+        put_uint8(f, 0);        /* dataRepresentationType */
+        put_uint16(f, GRIB_NI);
+        put_uint16(f, GRIB_NJ);
+        put_grib1_signed24(f, 90000);   /* latitudeOfFirstGridPoint */
+        put_grib1_signed24(f, 0);       /* longitudeOfFirstGridPoint */
+        put_uint8(f, 0x80);     /* resolutionAndComponentFlags */
+        put_grib1_signed24(f, -90000);  /* latitudeOfLastGridPoint */
+        put_grib1_signed24(f, 355000);  /* longitudeOfLastGridPoint */
+        put_uint16(f, 5000);    /* iDirectionIncrement */
+        put_uint16(f, 5000);    /* jDirectionIncrement */
+        put_uint8(f, 0);        /* scanningMode */
+        put_uint32(f, 0);
+
+        /* Binary Data Section */
+        put_uint24(f, (uint32_t)bds_size);
+        put_uint8(f, (uint8_t)(bds_size - 11 - GRIB_NI * GRIB_NJ * 2) * 8);     /* flags and unused bits */
+        put_uint16(f, 0x8000 | 9);      /* binaryScaleFactor (-9) */
+        put_uint32(f, ibm_float(200.0));        /* referenceValue */
+        put_uint8(f, 16);       /* bitsPerValue */
+        put_grib_packed_values(f, (int)m);
+        if (bds_size > 11 + GRIB_NI * GRIB_NJ * 2)
+        {
+            put_uint8(f, 0);
+        }
+
+        put_padded_string(f, "7777", 4);
+    }
+
+    return close_file(f, filename);
+}
+
+static int generate_grib2(const char *filename, long size)
+{
+    long num_messages = (size + 99) / 100;
+    long data_size = GRIB_NI * GRIB_NJ * 2;
+    long message_size;
+    FILE *f;
+    long m;
+
+    message_size = 16 + 21 + 72 + 34 + 21 + 6 + 5 + data_size + 4;
+
+    f = create_file(filename);
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    for (m = 0; m < num_messages; m++)
+    {
+        /* Section 0: Indicator Section */
+        put_padded_string(f, "GRIB", 4);
+        put_uint16(f, 0);
+        put_uint8(f, 0);        /* discipline (meteorological products) */
+        put_uint8(f, 2);        /* editionNumber */
+        put_uint64(f, message_size);
+
+        /* Section 1: Identification Section */
+        put_uint32(f, 21);
+        put_uint8(f, 1);
+        put_uint16(f, 98);      /* centre */
+        put_uint16(f, 0);       /* subCentre */
+        put_uint8(f, 4);        /* masterTablesVersion */
+        put_uint8(f, 0);        /* localTablesVersion */
+        put_uint8(f, 1);        /* significanceOfReferenceTime */
+        put_uint16(f, 2020);    /* year */
+        put_uint8(f, 1);        /* month */
+        put_uint8(f, (uint8_t)(1 + (m / 24) % 28));     /* day */
+        put_uint8(f, (uint8_t)(m % 24));        /* hour */
+        put_uint8(f, 0);        /* minute */
+        put_uint8(f, 0);        /* second */
+        put_uint8(f, 0);        /* productionStatusOfProcessedData */
+        put_uint8(f, 1);        /* typeOfProcessedData */
+
+        /* Section 3: Grid Definition Section (template 3.0, regular lat/lon grid) */
+        put_uint32(f, 72);
+        put_uint8(f, 3);
+        put_uint8(f, 0);        /* sourceOfGridDefinition */
+        put_uint32(f, GRIB_NI * GRIB_NJ);       /* numberOfDataPoints */
+        put_uint8(f, 0);        /* numberOfOctectsForNumberOfPoints */
+        put_uint8(f, 0);        /* interpretationOfNumberOfPoints */
+        put_uint16(f, 0);       /* gridDefinitionTemplateNumber */
+        put_uint8(f, 6);        /* shapeOfTheEarth */
+        put_uint8(f, 0);
+        put_uint32(f, 0);
+        put_uint8(f, 0);
+        put_uint32(f, 0);
+        put_uint8(f, 0);
+        put_uint32(f, 0);
+        put_uint32(f, GRIB_NI);
+        put_uint32(f, GRIB_NJ);
+        put_uint32(f, 0);       /* basicAngleOfTheInitialProductionDomain */
+        put_uint32(f, 0xFFFFFFFF);      /* subdivisionsOfBasicAngle */
+        put_grib2_signed32(f, 90000000);        /* latitudeOfFirstGridPoint */
+        put_grib2_signed32(f, 0);       /* longitudeOfFirstGridPoint */
+        put_uint8(f, 0x30);     /* resolutionAndComponentFlags */
+        put_grib2_signed32(f, -90000000);       /* latitudeOfLastGridPoint */
+        put_grib2_signed32(f, 355000000);       /* longitudeOfLastGridPoint */
+        put_uint32(f, 5000000); /* iDirectionIncrement */
+        put_uint32(f, 5000000); /* jDirectionIncrement */
+        put_uint8(f, 0);        /* scanningMode */
+
+        /* Section 4: Product Definition Section (template 4.0) */
+        put_uint32(f, 34);
+        put_uint8(f, 4);
+        put_uint16(f, 0);       /* NV */
+        put_uint16(f, 0);       /* productDefinitionTemplateNumber */
+        put_uint8(f, 0);        /* parameterCategory */
+        put_uint8(f, 0);        /* parameterNumber */
+        put_uint8(f, 2);        /* typeOfGeneratingProcess */
+        put_uint8(f, 0);        /* backgroundProcess */
+        put_uint8(f, 1);        /* generatingProcessIdentifier */
+        put_uint16(f, 0);       /* hoursAfterDataCutoff */
+        put_uint8(f, 0);        /* minutesAfterDataCutoff */
+        put_uint8(f, 1);        /* indicatorOfUnitOfTimeRange */
+        put_uint32(f, 0);       /* forecastTime */
+        put_uint8(f, 100);      /* typeOfFirstFixedSurface */
+        put_uint8(f, 0);
+        put_uint32(f, (uint32_t)(10000 + 1000 * (m % 90)));     /* firstFixedSurface */
+        put_uint8(f, 255);      /* typeOfSecondFixedSurface */
+        put_uint8(f, 0);
+        put_uint32(f, 0);
+
+        /* Section 5: Data Representation Section (template 5.0, simple packing) */
+        put_uint32(f, 21);
+        put_uint8(f, 5);
+        put_uint32(f, GRIB_NI * GRIB_NJ);
+        put_uint16(f, 0);       /* dataRepresentationTemplateNumber */
+        put_float(f, 200.0);    /* referenceValue */
+        put_uint16(f, 0x8000 | 9);      /* binaryScaleFactor (-9) */
+        put_uint16(f, 0);       /* decimalScaleFactor */
+        put_uint8(f, 16);       /* bitsPerValue */
+        put_uint8(f, 0);        /* typeOfOriginalFieldValues */
+
+        /* Section 6: Bit-Map Section (no bitmap) */
+        put_uint32(f, 6);
+        put_uint8(f, 6);
+        put_uint8(f, 255);
+
+        /* Section 7: Data Section */
+        put_uint32(f, (uint32_t)(5 + data_size));
+        put_uint8(f, 7);
+        put_grib_packed_values(f, (int)m);
+
+        /* Section 8: End Section */
+        put_padded_string(f, "7777", 4);
+    }
+
+    return close_file(f, filename);
+}
+
+/*
+ * RINEX (3.00 observation data) and SP3 (SP3-c)
+ */
+
+static int generate_rinex(const char *filename, long size)
+{
+    static const char *observable[4] = { "C1C", "L1C", "D1C", "S1C" };
+    uint32_t state = 1;
+    FILE *f;
+    long i;
+    int j, k;
+
+    f = create_file(filename);
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    fprintf(f, "%9.2f%11s%-20s%-20s%-20s\n", 3.0, "", "OBSERVATION DATA", "G (GPS)", "RINEX VERSION / TYPE");
+    fprintf(f, "%-20s%-20s%-20s%-20s\n", "codabench", "CODA", "20200101 000000 UTC", "PGM / RUN BY / DATE");
+    fprintf(f, "%-60s%-20s\n", "BENCH", "MARKER NAME");
+    fprintf(f, "%-20s%-40s%-20s\n", "CODA", "CODA", "OBSERVER / AGENCY");
+    fprintf(f, "%-20s%-20s%-20s%-20s\n", "1", "BENCH", "1.0", "REC # / TYPE / VERS");
+    fprintf(f, "%-20s%-20s%-20s%-20s\n", "1", "BENCH", "", "ANT # / TYPE");
+    fprintf(f, "%14.4f%14.4f%14.4f%-18s%-20s\n", 3875000.0, 332000.0, 5029000.0, "", "APPROX POSITION XYZ");
+    fprintf(f, "%14.4f%14.4f%14.4f%-18s%-20s\n", 0.0, 0.0, 0.0, "", "ANTENNA: DELTA H/E/N");
+    fprintf(f, "G  %3d", 4);
+    for (k = 0; k < 4; k++)
+    {
+        fprintf(f, " %s", observable[k]);
+    }
+    fprintf(f, "%-38s%-20s\n", "", "SYS / # / OBS TYPES");
+    fprintf(f, "%10.3f%-50s%-20s\n", 30.0, "", "INTERVAL");
+    fprintf(f, "%6d%6d%6d%6d%6d%13.7f%5s%3s%-9s%-20s\n", 2020, 1, 1, 0, 0, 0.0, "", "GPS", "",
+            "TIME OF FIRST OBS");
+    fprintf(f, "%-60s%-20s\n", "", "END OF HEADER");
+
+    for (i = 0; i < size; i++)
+    {
+        int year, month, day, hour, minute, second, musec;
+
+        coda_time_double_to_parts(631152000.0 + i * 30.0, &year, &month, &day, &hour, &minute, &second, &musec);
+        fprintf(f, "> %4d %02d %02d %02d %02d%11.7f  0%3d\n", year, month, day, hour, minute, (double)second,
+                NUM_SATELLITES);
+        for (j = 0; j < NUM_SATELLITES; j++)
+        {
+            double range = 20000000.0 + random_int(&state, 0, 5000000);
+
+            fprintf(f, "G%02d", j + 1);
+            fprintf(f, "%14.3f %1d", range, 8);
+            fprintf(f, "%14.3f %1d", range / 0.19029367, 8);
+            fprintf(f, "%14.3f %1d", (double)random_int(&state, -5000, 5000), 8);
+            fprintf(f, "%14.3f %1d\n", (double)random_int(&state, 30, 55), 8);
+        }
+    }
+
+    return close_file(f, filename);
+}
+
+static int generate_sp3(const char *filename, long size)
+{
+    uint32_t state = 1;
+    FILE *f;
+    long i;
+    int j, k;
+
+    f = create_file(filename);
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    fprintf(f, "#cP%4d %2d %2d %2d %2d %11.8f %7ld %-5s %-5s %-3s %4s\n", 2020, 1, 1, 0, 0, 0.0, size, "ORBIT",
+            "IGS14", "FIT", "CODA");
+    fprintf(f, "## %4d %15.8f %14.8f %5d %15.13f\n", 2086, 259200.0, 900.0, 58849, 0.0);
+    for (k = 0; k < 5; k++)
+    {
+        if (k == 0)
+        {
+            fprintf(f, "+   %2d   ", NUM_SATELLITES);
+        }
+        else
+        {
+            fprintf(f, "+        ");
+        }
+        for (j = 0; j < 17; j++)
+        {
+            if (k * 17 + j < NUM_SATELLITES)
+            {
+                fprintf(f, "G%02d", k * 17 + j + 1);
+            }
+            else
+            {
+                fprintf(f, "  0");
+            }
+        }
+        fprintf(f, "\n");
+    }
+    for (k = 0; k < 5; k++)
+    {
+        fprintf(f, "++       ");
+        for (j = 0; j < 17; j++)
+        {
+            fprintf(f, "%3d", k * 17 + j < NUM_SATELLITES ? 7 : 0);
+        }
+        fprintf(f, "\n");
+    }
+    fprintf(f, "%%c G  cc GPS ccc cccc cccc cccc cccc ccccc ccccc ccccc ccccc\n");
+    fprintf(f, "%%c cc cc ccc ccc cccc cccc cccc cccc ccccc ccccc ccccc ccccc\n");
+    fprintf(f, "%%f  1.2500000  1.025000000  0.00000000000  0.000000000000000\n");
+    fprintf(f, "%%f  0.0000000  0.000000000  0.00000000000  0.000000000000000\n");
+    fprintf(f, "%%i    0    0    0    0      0      0      0      0         0\n");
+    fprintf(f, "%%i    0    0    0    0      0      0      0      0         0\n");
+    for (k = 0; k < 4; k++)
+    {
+        fprintf(f, "/* %-57s\n", k == 0 ? "SYNTHETIC PRODUCT GENERATED BY CODABENCH" : "");
+    }
+
+    for (i = 0; i < size; i++)
+    {
+        int year, month, day, hour, minute, second, musec;
+
+        coda_time_double_to_parts(631152000.0 + i * 900.0, &year, &month, &day, &hour, &minute, &second, &musec);
+        fprintf(f, "*  %4d %2d %2d %2d %2d %11.8f\n", year, month, day, hour, minute, (double)second);
+        for (j = 0; j < NUM_SATELLITES; j++)
+        {
+            fprintf(f, "PG%02d%14.6f%14.6f%14.6f%14.6f\n", j + 1, random_int(&state, -26000000, 26000000) / 1000.0,
+                    random_int(&state, -26000000, 26000000) / 1000.0,
+                    random_int(&state, -26000000, 26000000) / 1000.0, random_int(&state, -500000, 500000) / 1000.0);
+        }
+    }
+    fprintf(f, "EOF\n");
+
+    return close_file(f, filename);
+}
+
+int bench_generate_product(bench_format format, const char *filename, long size, int depth)
+{
+    switch (format)
+    {
+        case bench_format_binary:
+            return generate_binary(filename, size, depth);
+        case bench_format_ascii:
+            return generate_ascii(filename, size, depth);
+        case bench_format_xml:
+            return generate_xml(filename, size, depth);
+        case bench_format_netcdf:
+            return generate_netcdf(filename, size);
+        case bench_format_cdf:
+            return generate_cdf(filename, size, 0);
+        case bench_format_cdf_gzip:
+            return generate_cdf(filename, size, 1);
+        case bench_format_grib1:
+            return generate_grib1(filename, size);
+        case bench_format_grib2:
+            return generate_grib2(filename, size);
+        case bench_format_rinex:
+            return generate_rinex(filename, size);
+        case bench_format_sp3:
+            return generate_sp3(filename, size);
+    }
+
+    return -1;
+}
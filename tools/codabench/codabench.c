@@ -0,0 +1,1110 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "codabench.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+/* number of leaf elements that are read in the 'random' scenario */
+#define NUM_RANDOM_ACCESSES 10000
+
+#define MAX_LIST_LENGTH 32
+
+typedef enum bench_scenario_enum
+{
+    bench_scenario_open,
+    bench_scenario_detect,
+    bench_scenario_traverse,
+    bench_scenario_random,
+    bench_scenario_bulk,
+    bench_scenario_expr,
+    bench_scenario_dump
+} bench_scenario;
+
+#define num_bench_scenarios ((int)bench_scenario_dump + 1)
+
+static const char *bench_scenario_name[num_bench_scenarios] = {
+    "open",
+    "detect",
+    "traverse",
+    "random",
+    "bulk",
+    "expr",
+    "dump"
+};
+
+/* expression that is evaluated at the root of the product in the 'expr' scenario */
+static const char *bench_expression[num_bench_formats] = {
+    "add(/records, float(./value))",
+    "add(/records, float(./value))",
+    "add(/bench/item, float(str(./value)))",
+    "add(/data, float(.))",
+    "add(/data, float(.))",
+    "add(/data, float(.))",
+    "add(/, add(./grib1/data/values, float(.)))",
+    "add(/, add(./grib2/data[0]/values, float(.)))",
+    "add(/record, add(./gps, float(./C1C/observation)))",
+    "add(/record, add(./pos_clk, float(./x_coordinate)))"
+};
+
+static const char *bench_file_extension[num_bench_formats] = {
+    "dat",
+    "txt",
+    "xml",
+    "nc",
+    "cdf",
+    "cdf",
+    "grib",
+    "grib2",
+    "obs",
+    "sp3"
+};
+
+typedef struct bench_product_struct
+{
+    bench_format format;
+    long size;
+    int depth;
+    char *filename;
+    int64_t file_size;
+} bench_product;
+
+const char *program_path;
+const char *option_directory;
+const char *option_codadump;
+const char *option_output;
+int option_generate;
+int option_run;
+int option_json;
+int option_repeat;
+int option_format[num_bench_formats];
+int option_scenario[num_bench_scenarios];
+long option_size[MAX_LIST_LENGTH];
+int option_num_sizes;
+int option_depth[MAX_LIST_LENGTH];
+int option_num_depths;
+
+static bench_product *product = NULL;
+static int num_products = 0;
+
+static FILE *output;
+static int num_results = 0;
+
+static void print_version()
+{
+    printf("codabench %s\n", libcoda_version);
+    printf("Copyright (C) 2007-2019 S[&]T, The Netherlands\n");
+    printf("\n");
+}
+
+static void print_help()
+{
+    printf("Usage:\n");
+    printf("    codabench [<options>] <directory>\n");
+    printf("        Generate synthetic products for each of the formats supported by CODA\n");
+    printf("        in the given directory and measure how long it takes CODA to perform\n");
+    printf("        a range of operations on them\n");
+    printf("\n");
+    printf("        Options:\n");
+    printf("            -g, --generate-only\n");
+    printf("                    only generate the products; do not run the benchmarks\n");
+    printf("            -b, --benchmark-only\n");
+    printf("                    do not generate the products; use the products that were\n");
+    printf("                    generated by an earlier run with the same parameters\n");
+    printf("            -n, --size <n>[,<n>...]\n");
+    printf("                    generate products with n records (or rows/epochs)\n");
+    printf("                    for GRIB products n/100 messages are generated\n");
+    printf("                    (default: 1000,10000)\n");
+    printf("            -d, --depth <d>[,<d>...]\n");
+    printf("                    number of nested levels of dynamically sized arrays for\n");
+    printf("                    binary and ascii products and nesting depth of elements\n");
+    printf("                    for xml products (default: 0,2)\n");
+    printf("            -f, --format <format>[,<format>...]\n");
+    printf("                    only include the given formats; available formats are:\n");
+    printf("                    binary, ascii, xml, netcdf, cdf, cdf-gzip, grib1, grib2,\n");
+    printf("                    rinex, sp3\n");
+    printf("            -s, --scenario <scenario>[,<scenario>...]\n");
+    printf("                    only run the given scenarios; available scenarios are:\n");
+    printf("                        open     : open and close the product\n");
+    printf("                        detect   : only determine the product type\n");
+    printf("                        traverse : read every element of the product one by one\n");
+    printf("                        random   : read %d randomly selected elements\n", NUM_RANDOM_ACCESSES);
+    printf("                        bulk     : read every element of the product, using\n");
+    printf("                                   array reads for arrays of numbers\n");
+    printf("                        expr     : evaluate an expression over all records\n");
+    printf("                        dump     : export the product with 'codadump ascii'\n");
+    printf("            -r, --repeat <N>\n");
+    printf("                    run each scenario N times and report the best and median\n");
+    printf("                    time (default: 5)\n");
+    printf("            -c, --codadump <path>\n");
+    printf("                    codadump executable to use for the dump scenario (the dump\n");
+    printf("                    scenario is skipped if no codadump executable is given)\n");
+    printf("            -j, --json\n");
+    printf("                    write the results as JSON instead of as a table\n");
+    printf("            -o, --output <file>\n");
+    printf("                    write the results to the given file instead of stdout\n");
+    printf("\n");
+    printf("        A .codadef file with the definitions for the binary and ascii products\n");
+    printf("        is written to the same directory. Generated products are deterministic,\n");
+    printf("        so results of different CODA versions can be compared directly.\n");
+    printf("\n");
+    printf("    codabench -h, --help\n");
+    printf("        Show help (this text)\n");
+    printf("\n");
+    printf("    codabench -v, --version\n");
+    printf("        Print the version number of CODA and exit\n");
+    printf("\n");
+}
+
+static double get_time(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+
+    return (da < db) ? -1 : (da > db) ? 1 : 0;
+}
+
+static int parse_list(const char *arg, const char **name, int num_names, int *enabled)
+{
+    const char *p = arg;
+    int i;
+
+    for (i = 0; i < num_names; i++)
+    {
+        enabled[i] = 0;
+    }
+    while (*p != '\0')
+    {
+        int length = 0;
+
+        while (p[length] != '\0' && p[length] != ',')
+        {
+            length++;
+        }
+        for (i = 0; i < num_names; i++)
+        {
+            if ((int)strlen(name[i]) == length && strncmp(p, name[i], length) == 0)
+            {
+                enabled[i] = 1;
+                break;
+            }
+        }
+        if (i == num_names)
+        {
+            fprintf(stderr, "ERROR: invalid value '%.*s'\n", length, p);
+            return -1;
+        }
+        p += length;
+        if (*p == ',')
+        {
+            p++;
+        }
+    }
+
+    return 0;
+}
+
+static int parse_number_list(const char *arg, long *value, int *num_values, long min_value)
+{
+    const char *p = arg;
+
+    *num_values = 0;
+    while (*p != '\0')
+    {
+        char *end;
+
+        if (*num_values == MAX_LIST_LENGTH)
+        {
+            fprintf(stderr, "ERROR: too many values in '%s'\n", arg);
+            return -1;
+        }
+        value[*num_values] = strtol(p, &end, 10);
+        if (end == p || (*end != '\0' && *end != ',') || value[*num_values] < min_value)
+        {
+            fprintf(stderr, "ERROR: invalid value in '%s'\n", arg);
+            return -1;
+        }
+        (*num_values)++;
+        p = end;
+        if (*p == ',')
+        {
+            p++;
+        }
+    }
+    if (*num_values == 0)
+    {
+        fprintf(stderr, "ERROR: invalid value '%s'\n", arg);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void add_product(bench_format format, long size, int depth)
+{
+    bench_product *new_product;
+    char *filename;
+
+    new_product = realloc(product, (num_products + 1) * sizeof(bench_product));
+    filename = malloc(strlen(option_directory) + 100);
+    if (new_product == NULL || filename == NULL)
+    {
+        fprintf(stderr, "ERROR: out of memory\n");
+        exit(1);
+    }
+    product = new_product;
+    if (bench_format_uses_depth[format])
+    {
+        sprintf(filename, "%s/%s_n%ld_d%d.%s", option_directory, bench_format_name[format], size, depth,
+                bench_file_extension[format]);
+    }
+    else
+    {
+        sprintf(filename, "%s/%s_n%ld.%s", option_directory, bench_format_name[format], size,
+                bench_file_extension[format]);
+    }
+    product[num_products].format = format;
+    product[num_products].size = size;
+    product[num_products].depth = depth;
+    product[num_products].filename = filename;
+    product[num_products].file_size = 0;
+    num_products++;
+}
+
+static void create_product_list(void)
+{
+    int i, j, k;
+
+    for (i = 0; i < num_bench_formats; i++)
+    {
+        if (!option_format[i])
+        {
+            continue;
+        }
+        for (j = 0; j < option_num_sizes; j++)
+        {
+            if (bench_format_uses_depth[i])
+            {
+                for (k = 0; k < option_num_depths; k++)
+                {
+                    add_product((bench_format)i, option_size[j], option_depth[k]);
+                }
+            }
+            else
+            {
+                add_product((bench_format)i, option_size[j], 0);
+            }
+        }
+    }
+}
+
+static int generate_products(void)
+{
+    char *filename;
+    int i;
+
+#ifdef WIN32
+    if (_mkdir(option_directory) != 0 && errno != EEXIST)
+#else
+    if (mkdir(option_directory, 0777) != 0 && errno != EEXIST)
+#endif
+    {
+        fprintf(stderr, "ERROR: could not create directory '%s' (%s)\n", option_directory, strerror(errno));
+        return -1;
+    }
+
+    filename = malloc(strlen(option_directory) + strlen(BENCH_PRODUCT_CLASS) + 10);
+    if (filename == NULL)
+    {
+        fprintf(stderr, "ERROR: out of memory\n");
+        return -1;
+    }
+    sprintf(filename, "%s/%s.codadef", option_directory, BENCH_PRODUCT_CLASS);
+    if (bench_generate_definitions(filename, option_num_depths, option_depth) != 0)
+    {
+        free(filename);
+        return -1;
+    }
+    free(filename);
+
+    for (i = 0; i < num_products; i++)
+    {
+        if (bench_generate_product(product[i].format, product[i].filename, product[i].size, product[i].depth) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int read_leaf(coda_cursor *cursor, coda_type_class type_class)
+{
+    switch (type_class)
+    {
+        case coda_integer_class:
+        case coda_real_class:
+            {
+                double value;
+
+                return coda_cursor_read_double(cursor, &value);
+            }
+        case coda_text_class:
+            {
+                char buffer[256];
+                char *str = buffer;
+                long length;
+
+                if (coda_cursor_get_string_length(cursor, &length) != 0)
+                {
+                    return -1;
+                }
+                if (length + 1 > (long)sizeof(buffer))
+                {
+                    str = malloc(length + 1);
+                    if (str == NULL)
+                    {
+                        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) "
+                                       "(%s:%u)", (long)length + 1, __FILE__, __LINE__);
+                        return -1;
+                    }
+                }
+                if (coda_cursor_read_string(cursor, str, length + 1) != 0)
+                {
+                    if (str != buffer)
+                    {
+                        free(str);
+                    }
+                    return -1;
+                }
+                if (str != buffer)
+                {
+                    free(str);
+                }
+            }
+            break;
+        case coda_raw_class:
+            {
+                uint8_t buffer[256];
+                uint8_t *data = buffer;
+                int64_t byte_size;
+
+                if (coda_cursor_get_byte_size(cursor, &byte_size) != 0)
+                {
+                    return -1;
+                }
+                if (byte_size > (int64_t)sizeof(buffer))
+                {
+                    data = malloc((size_t)byte_size);
+                    if (data == NULL)
+                    {
+                        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) "
+                                       "(%s:%u)", (long)byte_size, __FILE__, __LINE__);
+                        return -1;
+                    }
+                }
+                if (coda_cursor_read_bytes(cursor, data, 0, byte_size) != 0)
+                {
+                    if (data != buffer)
+                    {
+                        free(data);
+                    }
+                    return -1;
+                }
+                if (data != buffer)
+                {
+                    free(data);
+                }
+            }
+            break;
+        default:
+            assert(0);
+            exit(1);
+    }
+
+    return 0;
+}
+
+/* read all elements below the cursor; with 'bulk' set, arrays of numbers are read with a single array read */
+static int traverse(coda_cursor *cursor, int bulk, long *num_values)
+{
+    coda_type_class type_class;
+    long num_elements;
+    long i;
+
+    if (coda_cursor_get_type_class(cursor, &type_class) != 0)
+    {
+        return -1;
+    }
+    switch (type_class)
+    {
+        case coda_record_class:
+        case coda_array_class:
+            if (coda_cursor_get_num_elements(cursor, &num_elements) != 0)
+            {
+                return -1;
+            }
+            if (num_elements == 0)
+            {
+                break;
+            }
+            if (bulk && type_class == coda_array_class)
+            {
+                coda_type *type;
+                coda_type_class base_type_class;
+
+                if (coda_cursor_get_type(cursor, &type) != 0)
+                {
+                    return -1;
+                }
+                if (coda_type_get_array_base_type(type, &type) != 0)
+                {
+                    return -1;
+                }
+                if (coda_type_get_class(type, &base_type_class) != 0)
+                {
+                    return -1;
+                }
+                if (base_type_class == coda_integer_class || base_type_class == coda_real_class)
+                {
+                    double *data;
+
+                    data = malloc(num_elements * sizeof(double));
+                    if (data == NULL)
+                    {
+                        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) "
+                                       "(%s:%u)", num_elements * sizeof(double), __FILE__, __LINE__);
+                        return -1;
+                    }
+                    if (coda_cursor_read_double_array(cursor, data, coda_array_ordering_c) != 0)
+                    {
+                        free(data);
+                        return -1;
+                    }
+                    free(data);
+                    *num_values += num_elements;
+                    break;
+                }
+            }
+            if (type_class == coda_record_class)
+            {
+                if (coda_cursor_goto_first_record_field(cursor) != 0)
+                {
+                    return -1;
+                }
+            }
+            else
+            {
+                if (coda_cursor_goto_first_array_element(cursor) != 0)
+                {
+                    return -1;
+                }
+            }
+            for (i = 0; i < num_elements; i++)
+            {
+                if (traverse(cursor, bulk, num_values) != 0)
+                {
+                    return -1;
+                }
+                if (i < num_elements - 1)
+                {
+                    if (type_class == coda_record_class)
+                    {
+                        if (coda_cursor_goto_next_record_field(cursor) != 0)
+                        {
+                            return -1;
+                        }
+                    }
+                    else
+                    {
+                        if (coda_cursor_goto_next_array_element(cursor) != 0)
+                        {
+                            return -1;
+                        }
+                    }
+                }
+            }
+            coda_cursor_goto_parent(cursor);
+            break;
+        case coda_special_class:
+            {
+                coda_special_type special_type;
+
+                if (coda_cursor_get_special_type(cursor, &special_type) != 0)
+                {
+                    return -1;
+                }
+                if (special_type == coda_special_no_data)
+                {
+                    break;
+                }
+                if (coda_cursor_use_base_type_of_special_type(cursor) != 0)
+                {
+                    return -1;
+                }
+                if (traverse(cursor, bulk, num_values) != 0)
+                {
+                    return -1;
+                }
+            }
+            break;
+        default:
+            if (read_leaf(cursor, type_class) != 0)
+            {
+                return -1;
+            }
+            (*num_values)++;
+            break;
+    }
+
+    return 0;
+}
+
+/* walk from the root to a randomly selected leaf element and read it */
+static int random_access(coda_cursor *root, uint32_t *state, long *num_values)
+{
+    coda_cursor cursor;
+
+    cursor = *root;
+    for (;;)
+    {
+        coda_type_class type_class;
+        long num_elements;
+        long index;
+
+        if (coda_cursor_get_type_class(&cursor, &type_class) != 0)
+        {
+            return -1;
+        }
+        if (type_class == coda_record_class || type_class == coda_array_class)
+        {
+            if (coda_cursor_get_num_elements(&cursor, &num_elements) != 0)
+            {
+                return -1;
+            }
+            if (num_elements == 0)
+            {
+                return 0;
+            }
+            index = (long)(bench_random(state) % (uint32_t)num_elements);
+            if (type_class == coda_record_class)
+            {
+                if (coda_cursor_goto_record_field_by_index(&cursor, index) != 0)
+                {
+                    return -1;
+                }
+            }
+            else
+            {
+                if (coda_cursor_goto_array_element_by_index(&cursor, index) != 0)
+                {
+                    return -1;
+                }
+            }
+        }
+        else if (type_class == coda_special_class)
+        {
+            coda_special_type special_type;
+
+            if (coda_cursor_get_special_type(&cursor, &special_type) != 0)
+            {
+                return -1;
+            }
+            if (special_type == coda_special_no_data)
+            {
+                return 0;
+            }
+            if (coda_cursor_use_base_type_of_special_type(&cursor) != 0)
+            {
+                return -1;
+            }
+        }
+        else
+        {
+            if (read_leaf(&cursor, type_class) != 0)
+            {
+                return -1;
+            }
+            (*num_values)++;
+            return 0;
+        }
+    }
+}
+
+/* run a single scenario and store the time it took in 'elapsed' */
+static int run_scenario(bench_product *p, bench_scenario scenario, coda_expression *expr, long *num_values,
+                        double *elapsed)
+{
+    coda_product *pf;
+    coda_cursor cursor;
+    double start;
+    double value;
+    uint32_t state = 1;
+    long i;
+
+    *num_values = 0;
+    start = get_time();
+
+    switch (scenario)
+    {
+        case bench_scenario_open:
+            if (coda_open(p->filename, &pf) != 0)
+            {
+                return -1;
+            }
+            if (coda_close(pf) != 0)
+            {
+                return -1;
+            }
+            *elapsed = get_time() - start;
+            return 0;
+        case bench_scenario_detect:
+            {
+                const char *product_class;
+                const char *product_type;
+                int version;
+                coda_format format;
+                int64_t file_size;
+
+                if (coda_recognize_file(p->filename, &file_size, &format, &product_class, &product_type,
+                                        &version) != 0)
+                {
+                    return -1;
+                }
+                *elapsed = get_time() - start;
+                return 0;
+            }
+        case bench_scenario_dump:
+            {
+                char *command;
+                int result;
+
+                command = malloc(strlen(option_codadump) + strlen(option_directory) + strlen(p->filename) + 100);
+                if (command == NULL)
+                {
+                    coda_set_error(CODA_ERROR_OUT_OF_MEMORY, NULL);
+                    return -1;
+                }
+#ifdef WIN32
+                sprintf(command, "\"\"%s\" -D \"%s\" ascii \"%s\" > NUL\"", option_codadump, option_directory,
+                        p->filename);
+#else
+                sprintf(command, "\"%s\" -D \"%s\" ascii \"%s\" > /dev/null", option_codadump, option_directory,
+                        p->filename);
+#endif
+                result = system(command);
+                free(command);
+                if (result != 0)
+                {
+                    coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "codadump failed (exit status %d)", result);
+                    return -1;
+                }
+                *elapsed = get_time() - start;
+                return 0;
+            }
+        default:
+            break;
+    }
+
+    /* all remaining scenarios exclude the time to open the product */
+    if (coda_open(p->filename, &pf) != 0)
+    {
+        return -1;
+    }
+    if (coda_cursor_set_product(&cursor, pf) != 0)
+    {
+        coda_close(pf);
+        return -1;
+    }
+
+    start = get_time();
+    switch (scenario)
+    {
+        case bench_scenario_traverse:
+            if (traverse(&cursor, 0, num_values) != 0)
+            {
+                coda_close(pf);
+                return -1;
+            }
+            break;
+        case bench_scenario_bulk:
+            if (traverse(&cursor, 1, num_values) != 0)
+            {
+                coda_close(pf);
+                return -1;
+            }
+            break;
+        case bench_scenario_random:
+            for (i = 0; i < NUM_RANDOM_ACCESSES; i++)
+            {
+                if (random_access(&cursor, &state, num_values) != 0)
+                {
+                    coda_close(pf);
+                    return -1;
+                }
+            }
+            break;
+        case bench_scenario_expr:
+            if (coda_expression_eval_float(expr, &cursor, &value) != 0)
+            {
+                coda_close(pf);
+                return -1;
+            }
+            *num_values = 1;
+            break;
+        default:
+            assert(0);
+            exit(1);
+    }
+    *elapsed = get_time() - start;
+
+    return coda_close(pf);
+}
+
+static void print_result(bench_product *p, bench_scenario scenario, double best, double median, long num_values)
+{
+    const char *filename;
+
+    filename = strrchr(p->filename, '/');
+    filename = (filename == NULL ? p->filename : filename + 1);
+
+    if (option_json)
+    {
+        if (num_results > 0)
+        {
+            fprintf(output, ",\n");
+        }
+        fprintf(output, "    {\"format\": \"%s\", \"file\": \"%s\", \"size\": %ld, \"depth\": %d, "
+                "\"file_size\": %ld, \"scenario\": \"%s\", \"best\": %.6f, \"median\": %.6f, \"values\": %ld}",
+                bench_format_name[p->format], filename, p->size, p->depth, (long)p->file_size,
+                bench_scenario_name[scenario], best, median, num_values);
+    }
+    else
+    {
+        if (num_results == 0)
+        {
+            fprintf(output, "%-9s %8s %5s %11s %-9s %12s %12s %10s\n", "format", "size", "depth", "file_size",
+                    "scenario", "best(s)", "median(s)", "values");
+        }
+        fprintf(output, "%-9s %8ld %5d %11ld %-9s %12.6f %12.6f %10ld\n", bench_format_name[p->format], p->size,
+                p->depth, (long)p->file_size, bench_scenario_name[scenario], best, median, num_values);
+    }
+    fflush(output);
+    num_results++;
+}
+
+static int run_benchmarks(void)
+{
+    double *timing;
+    int i, j, k;
+
+    timing = malloc(option_repeat * sizeof(double));
+    if (timing == NULL)
+    {
+        fprintf(stderr, "ERROR: out of memory\n");
+        return -1;
+    }
+
+    if (option_json)
+    {
+        fprintf(output, "{\n");
+        fprintf(output, "  \"coda_version\": \"%s\",\n", libcoda_version);
+        fprintf(output, "  \"repeat\": %d,\n", option_repeat);
+        fprintf(output, "  \"results\": [\n");
+    }
+
+    for (i = 0; i < num_products; i++)
+    {
+        bench_product *p = &product[i];
+        coda_expression *expr = NULL;
+
+        if (coda_recognize_file(p->filename, &p->file_size, NULL, NULL, NULL, NULL) != 0)
+        {
+            fprintf(stderr, "ERROR: %s (%s)\n", coda_errno_to_string(coda_errno), p->filename);
+            free(timing);
+            return -1;
+        }
+        if (coda_expression_from_string(bench_expression[p->format], &expr) != 0)
+        {
+            fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+            free(timing);
+            return -1;
+        }
+
+        for (j = 0; j < num_bench_scenarios; j++)
+        {
+            long num_values = 0;
+
+            if (!option_scenario[j] || (j == bench_scenario_dump && option_codadump == NULL))
+            {
+                continue;
+            }
+            for (k = 0; k < option_repeat; k++)
+            {
+                if (run_scenario(p, (bench_scenario)j, expr, &num_values, &timing[k]) != 0)
+                {
+                    fprintf(stderr, "ERROR: %s (%s scenario for %s)\n", coda_errno_to_string(coda_errno),
+                            bench_scenario_name[j], p->filename);
+                    coda_expression_delete(expr);
+                    free(timing);
+                    return -1;
+                }
+            }
+            qsort(timing, option_repeat, sizeof(double), compare_double);
+            print_result(p, (bench_scenario)j, timing[0], timing[option_repeat / 2], num_values);
+        }
+
+        coda_expression_delete(expr);
+    }
+
+    if (option_json)
+    {
+        fprintf(output, "\n  ]\n");
+        fprintf(output, "}\n");
+    }
+
+    free(timing);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+
+    program_path = argv[0];
+    option_directory = NULL;
+    option_codadump = NULL;
+    option_output = NULL;
+    option_generate = 1;
+    option_run = 1;
+    option_json = 0;
+    option_repeat = 5;
+    for (i = 0; i < num_bench_formats; i++)
+    {
+        option_format[i] = 1;
+    }
+    for (i = 0; i < num_bench_scenarios; i++)
+    {
+        option_scenario[i] = 1;
+    }
+    option_size[0] = 1000;
+    option_size[1] = 10000;
+    option_num_sizes = 2;
+    option_depth[0] = 0;
+    option_depth[1] = 2;
+    option_num_depths = 2;
+
+    if (argc == 1 || strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)
+    {
+        print_help();
+        exit(0);
+    }
+
+    if (strcmp(argv[1], "-v") == 0 || strcmp(argv[1], "--version") == 0)
+    {
+        print_version();
+        exit(0);
+    }
+
+    for (i = 1; i < argc - 1; i++)
+    {
+        if (strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "--generate-only") == 0)
+        {
+            option_run = 0;
+        }
+        else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--benchmark-only") == 0)
+        {
+            option_generate = 0;
+        }
+        else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--size") == 0) && i + 1 < argc - 1)
+        {
+            if (parse_number_list(argv[i + 1], option_size, &option_num_sizes, 1) != 0)
+            {
+                exit(1);
+            }
+            i++;
+        }
+        else if ((strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--depth") == 0) && i + 1 < argc - 1)
+        {
+            long depth[MAX_LIST_LENGTH];
+            int j;
+
+            if (parse_number_list(argv[i + 1], depth, &option_num_depths, 0) != 0)
+            {
+                exit(1);
+            }
+            for (j = 0; j < option_num_depths; j++)
+            {
+                if (depth[j] > 9)
+                {
+                    fprintf(stderr, "ERROR: depth can not be larger than 9\n");
+                    exit(1);
+                }
+                option_depth[j] = (int)depth[j];
+            }
+            i++;
+        }
+        else if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--format") == 0) && i + 1 < argc - 1)
+        {
+            if (parse_list(argv[i + 1], bench_format_name, num_bench_formats, option_format) != 0)
+            {
+                exit(1);
+            }
+            i++;
+        }
+        else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--scenario") == 0) && i + 1 < argc - 1)
+        {
+            if (parse_list(argv[i + 1], bench_scenario_name, num_bench_scenarios, option_scenario) != 0)
+            {
+                exit(1);
+            }
+            i++;
+        }
+        else if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--repeat") == 0) && i + 1 < argc - 1)
+        {
+            option_repeat = atoi(argv[i + 1]);
+            if (option_repeat < 1)
+            {
+                fprintf(stderr, "ERROR: invalid repeat count '%s'\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
+        else if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--codadump") == 0) && i + 1 < argc - 1)
+        {
+            option_codadump = argv[i + 1];
+            i++;
+        }
+        else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--json") == 0)
+        {
+            option_json = 1;
+        }
+        else if ((strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) && i + 1 < argc - 1)
+        {
+            option_output = argv[i + 1];
+            i++;
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: invalid arguments\n");
+            print_help();
+            exit(1);
+        }
+    }
+    if (i != argc - 1 || argv[i][0] == '-')
+    {
+        fprintf(stderr, "ERROR: invalid arguments\n");
+        print_help();
+        exit(1);
+    }
+    option_directory = argv[i];
+
+    create_product_list();
+
+    if (option_generate)
+    {
+        if (generate_products() != 0)
+        {
+            exit(1);
+        }
+    }
+
+    if (option_run)
+    {
+        output = stdout;
+        if (option_output != NULL)
+        {
+            output = fopen(option_output, "w");
+            if (output == NULL)
+            {
+                fprintf(stderr, "ERROR: could not create file '%s' (%s)\n", option_output, strerror(errno));
+                exit(1);
+            }
+        }
+
+        coda_set_definition_path(option_directory);
+        if (coda_init() != 0)
+        {
+            fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+            exit(1);
+        }
+        if (run_benchmarks() != 0)
+        {
+            exit(1);
+        }
+        coda_done();
+
+        if (output != stdout)
+        {
+            fclose(output);
+        }
+    }
+
+    for (i = 0; i < num_products; i++)
+    {
+        free(product[i].filename);
+    }
+    if (product != NULL)
+    {
+        free(product);
+    }
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CODABENCH_H
+#define CODABENCH_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include "coda.h"
+
+/* name of the product class (and .codadef file) that describes the generated binary and ascii products */
+#define BENCH_PRODUCT_CLASS "BENCH"
+
+typedef enum bench_format_enum
+{
+    bench_format_binary,
+    bench_format_ascii,
+    bench_format_xml,
+    bench_format_netcdf,
+    bench_format_cdf,
+    bench_format_cdf_gzip,
+    bench_format_grib1,
+    bench_format_grib2,
+    bench_format_rinex,
+    bench_format_sp3
+} bench_format;
+
+#define num_bench_formats ((int)bench_format_sp3 + 1)
+
+/* name of the format as used on the command line and in the results */
+extern const char *bench_format_name[num_bench_formats];
+
+/* whether the product layout depends on the depth parameter (otherwise only the size is used) */
+extern const int bench_format_uses_depth[num_bench_formats];
+
+uint32_t bench_random(uint32_t *state);
+
+int bench_generate_definitions(const char *filename, int num_depths, const int *depth);
+int bench_generate_product(bench_format format, const char *filename, long size, int depth);
+
+#endif
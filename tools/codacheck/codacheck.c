@@ -36,21 +36,47 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
 #include <time.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 #include "coda.h"
 
+#ifndef THREAD_LOCAL
+#define THREAD_LOCAL
+#endif
+
 /* internal CODA functions */
 int coda_cursor_print_path(const coda_cursor *cursor, int (*print) (const char *, ...));
-int coda_product_check(coda_product *product, int full_read_check,
-                       void (*callbackfunc) (coda_cursor *, const char *, void *), void *userdata);
+int coda_product_check_parallel(coda_product *product, int full_read_check, int num_threads,
+                                void (*callbackfunc) (coda_cursor *, const char *, void *), void *userdata);
 
+const char *program_path;
+const char *option_definition_path;
 int option_verbose;
 int option_quick;
 int option_require_definition;
+int option_use_mmap;
+int option_num_threads;
+int option_profile;
 int found_errors;
 
+/* output of a single file check (when checking files in parallel the output is buffered per file) */
+typedef struct output_buffer_struct
+{
+    char *data;
+    long length;
+    long size;
+    int found_errors;
+    int done;
+} output_buffer;
+
+/* buffer that all output of the current thread is written to (if NULL, output is written directly to stdout) */
+static THREAD_LOCAL output_buffer *thread_output = NULL;
+
 static void print_version()
 {
     printf("codacheck version %s\n", libcoda_version);
@@ -75,6 +101,16 @@ static void print_help()
     printf("                    show more information while performing the check\n");
     printf("            --no-mmap\n");
     printf("                    disable the use of mmap when opening files\n");
+    printf("            -j, --jobs <N>\n");
+    printf("                    use N threads; multiple files are checked concurrently\n");
+    printf("                    (output is still reported in the order of the files),\n");
+    printf("                    a single file is checked by splitting its top-level\n");
+    printf("                    arrays over the threads\n");
+    printf("            --profile\n");
+    printf("                    after checking all files, print how often each expression\n");
+    printf("                    from the product definitions was evaluated and how much\n");
+    printf("                    time this took (sorted on time, most expensive first);\n");
+    printf("                    files are then always checked using a single thread\n");
     printf("\n");
     printf("        If you pass a '-' for the <files> section then the list of files will\n");
     printf("        be read from stdin.\n");
@@ -95,21 +131,69 @@ static void print_help()
     printf("\n");
 }
 
-static void print_error(coda_cursor *cursor, const char *error, void *userdata)
+static int print_output(const char *format, ...)
 {
-    (void)userdata;     /* prevent unused warning */
+    va_list ap;
+    int length;
+
+    if (thread_output == NULL)
+    {
+        va_start(ap, format);
+        length = vprintf(format, ap);
+        va_end(ap);
+        return length;
+    }
 
-    printf("  ERROR: %s", error);
+    va_start(ap, format);
+    length = vsnprintf(NULL, 0, format, ap);
+    va_end(ap);
+    if (length < 0)
+    {
+        return length;
+    }
+    if (thread_output->length + length + 1 > thread_output->size)
+    {
+        long new_size = 2 * thread_output->size;
+        char *new_data;
+
+        if (new_size < thread_output->length + length + 1)
+        {
+            new_size = thread_output->length + length + 1;
+        }
+        if (new_size < 1024)
+        {
+            new_size = 1024;
+        }
+        new_data = realloc(thread_output->data, new_size);
+        if (new_data == NULL)
+        {
+            return -1;
+        }
+        thread_output->data = new_data;
+        thread_output->size = new_size;
+    }
+    va_start(ap, format);
+    vsnprintf(&thread_output->data[thread_output->length], length + 1, format, ap);
+    va_end(ap);
+    thread_output->length += length;
+
+    return length;
+}
+
+static void print_error(coda_cursor *cursor, const char *error, void *userdata)
+{
+    print_output("  ERROR: %s", error);
     if (cursor != NULL)
     {
-        printf(" at ");
-        coda_cursor_print_path(cursor, printf);
+        print_output(" at ");
+        coda_cursor_print_path(cursor, print_output);
     }
-    printf("\n");
-    found_errors = 1;
+    print_output("\n");
+    *(int *)userdata = 1;
 }
 
-static void check_file(char *filename)
+/* returns 1 if errors were found and 0 otherwise */
+static int check_file(const char *filename, int num_threads)
 {
     coda_product *product;
     coda_format format;
@@ -118,32 +202,31 @@ static void check_file(char *filename)
     const char *product_type;
     int version;
     int result;
+    int found_file_errors = 0;
 
-    printf("%s\n", filename);
+    print_output("%s\n", filename);
 
     if (coda_recognize_file(filename, &file_size, &format, &product_class, &product_type, &version) != 0)
     {
-        printf("  ERROR: %s\n\n", coda_errno_to_string(coda_errno));
+        print_output("  ERROR: %s\n\n", coda_errno_to_string(coda_errno));
         coda_set_error(CODA_SUCCESS, NULL);
-        found_errors = 1;
-        return;
+        return 1;
     }
 
     if (option_require_definition && (product_class == NULL || product_type == NULL))
     {
-        printf("  ERROR: could not determine product type\n\n");
-        found_errors = 1;
-        return;
+        print_output("  ERROR: could not determine product type\n\n");
+        return 1;
     }
 
     if (option_verbose)
     {
-        printf("  product format: %s", coda_type_get_format_name(format));
+        print_output("  product format: %s", coda_type_get_format_name(format));
         if (product_class != NULL && product_type != NULL)
         {
-            printf(" %s/%s v%d", product_class, product_type, version);
+            print_output(" %s/%s v%d", product_class, product_type, version);
         }
-        printf("\n");
+        print_output("\n");
     }
 
     result = coda_open(filename, &product);
@@ -154,44 +237,216 @@ static void check_file(char *filename)
          */
         coda_set_option_use_mmap(0);
         result = coda_open(filename, &product);
-        coda_set_option_use_mmap(1);
+        coda_set_option_use_mmap(option_use_mmap);
     }
     if (result != 0)
     {
-        printf("  ERROR: %s\n\n", coda_errno_to_string(coda_errno));
-        found_errors = 1;
-        return;
+        print_output("  ERROR: %s\n\n", coda_errno_to_string(coda_errno));
+        return 1;
     }
 
-    if (coda_product_check(product, !option_quick, print_error, NULL) != 0)
+    if (coda_product_check_parallel(product, !option_quick, num_threads, print_error, &found_file_errors) != 0)
     {
-        printf("  ERROR: %s\n\n", coda_errno_to_string(coda_errno));
-        found_errors = 1;
+        print_output("  ERROR: %s\n\n", coda_errno_to_string(coda_errno));
         coda_close(product);
-        return;
+        return 1;
     }
 
     if (coda_close(product) != 0)
     {
-        printf("  ERROR: %s\n", coda_errno_to_string(coda_errno));
-        found_errors = 1;
-        return;
+        print_output("  ERROR: %s\n", coda_errno_to_string(coda_errno));
+        return 1;
     }
 
-    printf("\n");
+    print_output("\n");
+
+    return found_file_errors;
+}
+
+/* initialize CODA for the current thread (all CODA settings are thread local) */
+static int init_coda(void)
+{
+    if (option_definition_path != NULL)
+    {
+        if (coda_set_definition_path(option_definition_path) != 0)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        const char *definition_path = "../share/" PACKAGE "/definitions";
+
+        if (coda_set_definition_path_conditional(program_path, NULL, definition_path) != 0)
+        {
+            return -1;
+        }
+    }
+
+    if (option_profile)
+    {
+        /* this needs to be set before coda_init(), since that already reads the detection rules */
+        coda_set_option_profile_expressions(1);
+    }
+
+    if (coda_init() != 0)
+    {
+        return -1;
+    }
+
+    /* The codacheck program should never navigate beyond the array bounds.
+     * We therefore disable to boundary check option to increase performance.
+     * Mind that this option does not influence the out-of-bounds check that CODA performs to ensure
+     * that a read is performed using a byte offset/size that is within the limits of the total file size.
+     */
+    coda_set_option_perform_boundary_checks(0);
+
+    /* We disable conversions since this speeds up the check of reading all numerical data */
+    coda_set_option_perform_conversions(0);
+
+    /* Set mmap based on the chosen option */
+    coda_set_option_use_mmap(option_use_mmap);
+
+    return 0;
+}
+
+#ifdef HAVE_PTHREAD
+typedef struct file_queue_struct
+{
+    int num_files;
+    char **filename;
+    output_buffer *output;
+    int next_file;
+    pthread_mutex_t mutex;
+    pthread_cond_t file_done;
+} file_queue;
+
+static void *check_worker(void *userdata)
+{
+    file_queue *queue = (file_queue *)userdata;
+    int initialized;
+
+    initialized = (init_coda() == 0);
+
+    pthread_mutex_lock(&queue->mutex);
+    while (queue->next_file < queue->num_files)
+    {
+        output_buffer *output = &queue->output[queue->next_file];
+        const char *filename = queue->filename[queue->next_file];
+
+        queue->next_file++;
+        pthread_mutex_unlock(&queue->mutex);
+
+        thread_output = output;
+        if (initialized)
+        {
+            output->found_errors = check_file(filename, 1);
+        }
+        else
+        {
+            print_output("%s\n  ERROR: %s\n\n", filename, coda_errno_to_string(coda_errno));
+            output->found_errors = 1;
+        }
+        thread_output = NULL;
+
+        pthread_mutex_lock(&queue->mutex);
+        output->done = 1;
+        pthread_cond_broadcast(&queue->file_done);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+
+    if (initialized)
+    {
+        coda_done();
+    }
+
+    return NULL;
+}
+
+/* check files concurrently using option_num_threads threads and print the results in the order of the files */
+static void check_files_parallel(int num_files, char **filename)
+{
+    file_queue queue;
+    pthread_t *thread;
+    int num_running_threads = 0;
+    int i;
+
+    queue.num_files = num_files;
+    queue.filename = filename;
+    queue.next_file = 0;
+    queue.output = calloc(num_files, sizeof(output_buffer));
+    thread = malloc(option_num_threads * sizeof(pthread_t));
+    if (queue.output == NULL || thread == NULL)
+    {
+        fprintf(stderr, "ERROR: out of memory\n");
+        exit(1);
+    }
+    pthread_mutex_init(&queue.mutex, NULL);
+    pthread_cond_init(&queue.file_done, NULL);
+
+    for (i = 0; i < option_num_threads && i < num_files; i++)
+    {
+        if (pthread_create(&thread[num_running_threads], NULL, check_worker, &queue) == 0)
+        {
+            num_running_threads++;
+        }
+    }
+    if (num_running_threads == 0)
+    {
+        fprintf(stderr, "ERROR: could not create threads\n");
+        exit(1);
+    }
+
+    for (i = 0; i < num_files; i++)
+    {
+        pthread_mutex_lock(&queue.mutex);
+        while (!queue.output[i].done)
+        {
+            pthread_cond_wait(&queue.file_done, &queue.mutex);
+        }
+        pthread_mutex_unlock(&queue.mutex);
+        if (queue.output[i].length > 0)
+        {
+            fwrite(queue.output[i].data, 1, queue.output[i].length, stdout);
+        }
+        fflush(NULL);
+        if (queue.output[i].found_errors)
+        {
+            found_errors = 1;
+        }
+        if (queue.output[i].data != NULL)
+        {
+            free(queue.output[i].data);
+        }
+    }
+
+    for (i = 0; i < num_running_threads; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+    pthread_cond_destroy(&queue.file_done);
+    pthread_mutex_destroy(&queue.mutex);
+    free(thread);
+    free(queue.output);
 }
+#endif
 
 int main(int argc, char *argv[])
 {
+    char **filename_list = NULL;
+    int num_filenames = 0;
     int option_stdin;
-    int option_use_mmap;
     int i;
 
+    program_path = argv[0];
+    option_definition_path = NULL;
     option_stdin = 0;
     option_verbose = 0;
     option_quick = 0;
     option_use_mmap = 1;
     option_require_definition = 0;
+    option_num_threads = 1;
+    option_profile = 0;
 
     if (argc == 1 || strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)
     {
@@ -208,19 +463,9 @@ int main(int argc, char *argv[])
     i = 1;
     if (i + 1 < argc && strcmp(argv[i], "-D") == 0)
     {
-        coda_set_definition_path(argv[i + 1]);
+        option_definition_path = argv[i + 1];
         i += 2;
     }
-    else
-    {
-        const char *definition_path = "../share/" PACKAGE "/definitions";
-
-        if (coda_set_definition_path_conditional(argv[0], NULL, definition_path) != 0)
-        {
-            fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
-            exit(1);
-        }
-    }
 
     while (i < argc)
     {
@@ -240,6 +485,21 @@ int main(int argc, char *argv[])
         {
             option_use_mmap = 0;
         }
+        else if (strcmp(argv[i], "--profile") == 0)
+        {
+            option_profile = 1;
+        }
+        else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc &&
+                 argv[i + 1][0] != '-')
+        {
+            option_num_threads = atoi(argv[i + 1]);
+            if (option_num_threads < 1)
+            {
+                fprintf(stderr, "ERROR: invalid number of jobs '%s'\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
         else if (strcmp(argv[i], "-") == 0 && i == argc - 1)
         {
             option_stdin = 1;
@@ -259,25 +519,18 @@ int main(int argc, char *argv[])
         i++;
     }
 
-    if (coda_init() != 0)
+    if (option_profile)
+    {
+        /* the expression profile is kept per thread */
+        option_num_threads = 1;
+    }
+
+    if (init_coda() != 0)
     {
         fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
         exit(1);
     }
 
-    /* The codacheck program should never navigate beyond the array bounds.
-     * We therefore disable to boundary check option to increase performance.
-     * Mind that this option does not influence the out-of-bounds check that CODA performs to ensure
-     * that a read is performed using a byte offset/size that is within the limits of the total file size.
-     */
-    coda_set_option_perform_boundary_checks(0);
-
-    /* We disable conversions since this speeds up the check of reading all numerical data */
-    coda_set_option_perform_conversions(0);
-
-    /* Set mmap based on the chosen option */
-    coda_set_option_use_mmap(option_use_mmap);
-
     if (option_stdin)
     {
         char filename[1000];
@@ -314,21 +567,89 @@ int main(int argc, char *argv[])
             }
             if (k > 0)
             {
-                check_file(filename);
-                fflush(NULL);
+                if (option_num_threads > 1)
+                {
+                    /* collect all filenames first, so they can be divided over the threads */
+                    if (num_filenames % 1024 == 0)
+                    {
+                        char **new_filename_list;
+
+                        new_filename_list = realloc(filename_list, (num_filenames + 1024) * sizeof(char *));
+                        if (new_filename_list == NULL)
+                        {
+                            fprintf(stderr, "ERROR: out of memory\n");
+                            exit(1);
+                        }
+                        filename_list = new_filename_list;
+                    }
+                    filename_list[num_filenames] = strdup(filename);
+                    if (filename_list[num_filenames] == NULL)
+                    {
+                        fprintf(stderr, "ERROR: out of memory\n");
+                        exit(1);
+                    }
+                    num_filenames++;
+                }
+                else
+                {
+                    found_errors |= check_file(filename, 1);
+                    fflush(NULL);
+                }
             }
         } while (c != EOF);
     }
+    else if (option_num_threads > 1)
+    {
+        filename_list = &argv[i];
+        num_filenames = argc - i;
+    }
     else
     {
         while (i < argc)
         {
-            check_file(argv[i]);
+            found_errors |= check_file(argv[i], 1);
             fflush(NULL);
             i++;
         }
     }
 
+    if (num_filenames == 1)
+    {
+        /* use the threads to check the product itself in parallel */
+        found_errors |= check_file(filename_list[0], option_num_threads);
+        fflush(NULL);
+    }
+    else if (num_filenames > 1)
+    {
+#ifdef HAVE_PTHREAD
+        check_files_parallel(num_filenames, filename_list);
+#else
+        for (i = 0; i < num_filenames; i++)
+        {
+            found_errors |= check_file(filename_list[i], 1);
+            fflush(NULL);
+        }
+#endif
+    }
+    if (option_stdin && filename_list != NULL)
+    {
+        for (i = 0; i < num_filenames; i++)
+        {
+            free(filename_list[i]);
+        }
+        free(filename_list);
+    }
+
+    if (option_profile)
+    {
+        printf("\n");
+        if (coda_expression_print_profile(printf) != 0)
+        {
+            fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+            found_errors = 1;
+        }
+    }
+
     coda_done();
 
     if (found_errors)
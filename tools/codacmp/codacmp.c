@@ -40,13 +40,19 @@
 
 #include "coda.h"
 #include "coda-tree.h"
-#include "hashtable.h"
 
 #define BLOCK_SIZE 16
 
+/* number of array elements that are read at once when comparing numeric arrays in bulk */
+#define BULK_COMPARE_CHUNK_SIZE 4096
+/* number of bytes that are read at once when comparing the raw data of numeric arrays */
+#define BULK_COMPARE_RAW_CHUNK_SIZE 65536
+
 /* internal CODA functions */
 void coda_cursor_add_to_error_message(const coda_cursor *cursor);
 int coda_cursor_print_path(const coda_cursor *cursor, int (*print) (const char *, ...));
+int coda_expression_eval_string_to_buffer(const coda_expression *expr, const coda_cursor *cursor, char **buffer,
+                                          long *buffer_size, long *length);
 
 const char *pre[] = { "< ", "> " };
 
@@ -80,13 +86,13 @@ static void print_help()
     printf("                    location in the product where the comparison should begin.\n");
     printf("                    This path should be available in both products. If this\n");
     printf("                    parameter is not provided the full products are compared.\n");
-    printf("            -k, --key <path_to_array> <key_string_expr>\n");
-    printf("                    for the given array in the product use the string\n");
-    printf("                    expression as a unique key to line up the array elements in\n");
-    printf("                    the two products. The array elements will then be compared\n");
-    printf("                    as if it were record fields where the 'key' is used as the\n");
-    printf("                    field name. This option can be provided multiple times (for\n");
-    printf("                    different paths).\n");
+    printf("            -k, --key <path_to_array> <key_expr>\n");
+    printf("                    for the given array in the product use the string, integer\n");
+    printf("                    or float expression as a unique key to line up the array\n");
+    printf("                    elements in the two products. The array elements will then\n");
+    printf("                    be compared as if it were record fields where the 'key' is\n");
+    printf("                    used as the field name. This option can be provided multiple\n");
+    printf("                    times (for different paths).\n");
     printf("            -V, --verbose\n");
     printf("                    show more information while performing the comparison\n");
     printf("\n");
@@ -248,13 +254,434 @@ static int array_key_info_set_product(coda_product *product)
     return 0;
 }
 
+/* Table of array keys that is used to line up the elements of two arrays.
+ * Keys are either integers, floating point values (stored by their bit pattern), or strings. String keys are stored
+ * in a single string pool and are referenced by their offset into this pool together with their length (string keys
+ * can contain '\0' characters).
+ * The hash index uses open addressing with linear probing.
+ */
+typedef struct array_key_table_struct
+{
+    coda_expression_type key_type;
+    long num_keys;
+    long max_keys;
+    int64_t *key;       /* integer value, bit pattern of float value, or offset in string pool */
+    long *key_length;   /* length of each string key (NULL if keys are not strings) */
+    long *array_index;  /* index of the array element to which the key belongs */
+    long *match_index;  /* index of the array element in the other array with the same key (or -1) */
+    long hash_size;     /* always a power of two */
+    long *hash_index;   /* index into 'key' (or -1 for an empty slot) */
+    char *pool;
+    long pool_size;
+    long pool_capacity;
+} array_key_table;
+
+static void array_key_table_delete(array_key_table *table)
+{
+    if (table->key != NULL)
+    {
+        free(table->key);
+    }
+    if (table->key_length != NULL)
+    {
+        free(table->key_length);
+    }
+    if (table->array_index != NULL)
+    {
+        free(table->array_index);
+    }
+    if (table->match_index != NULL)
+    {
+        free(table->match_index);
+    }
+    if (table->hash_index != NULL)
+    {
+        free(table->hash_index);
+    }
+    if (table->pool != NULL)
+    {
+        free(table->pool);
+    }
+    free(table);
+}
+
+static array_key_table *array_key_table_new(coda_expression_type key_type, long expected_num_keys)
+{
+    array_key_table *table;
+    long i;
+
+    table = malloc(sizeof(array_key_table));
+    if (table == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       sizeof(array_key_table), __FILE__, __LINE__);
+        return NULL;
+    }
+    table->key_type = key_type;
+    table->num_keys = 0;
+    table->max_keys = (expected_num_keys > BLOCK_SIZE ? expected_num_keys : BLOCK_SIZE);
+    table->key = NULL;
+    table->key_length = NULL;
+    table->array_index = NULL;
+    table->match_index = NULL;
+    table->hash_size = 2 * BLOCK_SIZE;
+    while (table->hash_size < 2 * table->max_keys)
+    {
+        table->hash_size *= 2;
+    }
+    table->hash_index = NULL;
+    table->pool = NULL;
+    table->pool_size = 0;
+    table->pool_capacity = 0;
+
+    table->key = malloc(table->max_keys * sizeof(int64_t));
+    table->array_index = malloc(table->max_keys * sizeof(long));
+    table->match_index = malloc(table->max_keys * sizeof(long));
+    table->hash_index = malloc(table->hash_size * sizeof(long));
+    if (table->key == NULL || table->array_index == NULL || table->match_index == NULL || table->hash_index == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       table->max_keys * (sizeof(int64_t) + 2 * sizeof(long)) + table->hash_size * sizeof(long),
+                       __FILE__, __LINE__);
+        array_key_table_delete(table);
+        return NULL;
+    }
+    for (i = 0; i < table->hash_size; i++)
+    {
+        table->hash_index[i] = -1;
+    }
+    if (key_type == coda_expression_string)
+    {
+        table->key_length = malloc(table->max_keys * sizeof(long));
+        if (table->key_length == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           table->max_keys * sizeof(long), __FILE__, __LINE__);
+            array_key_table_delete(table);
+            return NULL;
+        }
+        /* start with a pool that can hold 16 characters per key; it will grow when needed */
+        table->pool_capacity = 16 * table->max_keys;
+        table->pool = malloc(table->pool_capacity);
+        if (table->pool == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           table->pool_capacity, __FILE__, __LINE__);
+            array_key_table_delete(table);
+            return NULL;
+        }
+    }
+
+    return table;
+}
+
+static uint64_t array_key_hash(coda_expression_type key_type, int64_t value, const char *str, long length)
+{
+    uint64_t hash;
+
+    if (key_type == coda_expression_string)
+    {
+        long i;
+
+        /* FNV-1a */
+        hash = 14695981039346656037ULL;
+        for (i = 0; i < length; i++)
+        {
+            hash ^= (uint8_t)str[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    /* finalizer of splitmix64 */
+    hash = (uint64_t)value;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+/* returns the slot in the hash index for the given key; the slot is either empty or holds the matching key */
+static long array_key_table_get_slot(const array_key_table *table, int64_t value, const char *str, long length)
+{
+    long slot;
+
+    slot = (long)(array_key_hash(table->key_type, value, str, length) & (uint64_t)(table->hash_size - 1));
+    while (table->hash_index[slot] >= 0)
+    {
+        long index = table->hash_index[slot];
+
+        if (table->key_type == coda_expression_string)
+        {
+            if (length == table->key_length[index] && memcmp(&table->pool[table->key[index]], str, length) == 0)
+            {
+                return slot;
+            }
+        }
+        else if (table->key[index] == value)
+        {
+            return slot;
+        }
+        slot = (slot + 1) & (table->hash_size - 1);
+    }
+
+    return slot;
+}
+
+static long array_key_table_find(const array_key_table *table, int64_t value, const char *str, long length)
+{
+    return table->hash_index[array_key_table_get_slot(table, value, str, length)];
+}
+
+static int array_key_table_rehash(array_key_table *table)
+{
+    long *new_hash_index;
+    long new_hash_size = 2 * table->hash_size;
+    long i;
+
+    new_hash_index = malloc(new_hash_size * sizeof(long));
+    if (new_hash_index == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       new_hash_size * sizeof(long), __FILE__, __LINE__);
+        return -1;
+    }
+    free(table->hash_index);
+    table->hash_index = new_hash_index;
+    table->hash_size = new_hash_size;
+    for (i = 0; i < new_hash_size; i++)
+    {
+        table->hash_index[i] = -1;
+    }
+    for (i = 0; i < table->num_keys; i++)
+    {
+        const char *str = NULL;
+        long length = 0;
+
+        if (table->key_type == coda_expression_string)
+        {
+            str = &table->pool[table->key[i]];
+            length = table->key_length[i];
+        }
+        table->hash_index[array_key_table_get_slot(table, table->key[i], str, length)] = i;
+    }
+
+    return 0;
+}
+
+/* adds the key to the table; returns the index of the key, -2 if the key was already present, and -1 on error */
+static long array_key_table_add(array_key_table *table, long array_index, int64_t value, const char *str, long length)
+{
+    long slot;
+
+    slot = array_key_table_get_slot(table, value, str, length);
+    if (table->hash_index[slot] >= 0)
+    {
+        return -2;
+    }
+    if (table->num_keys == table->max_keys)
+    {
+        int64_t *new_key;
+        long *new_array_index;
+        long *new_match_index;
+
+        new_key = realloc(table->key, 2 * table->max_keys * sizeof(int64_t));
+        if (new_key == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           2 * table->max_keys * sizeof(int64_t), __FILE__, __LINE__);
+            return -1;
+        }
+        table->key = new_key;
+        new_array_index = realloc(table->array_index, 2 * table->max_keys * sizeof(long));
+        if (new_array_index == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           2 * table->max_keys * sizeof(long), __FILE__, __LINE__);
+            return -1;
+        }
+        table->array_index = new_array_index;
+        new_match_index = realloc(table->match_index, 2 * table->max_keys * sizeof(long));
+        if (new_match_index == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           2 * table->max_keys * sizeof(long), __FILE__, __LINE__);
+            return -1;
+        }
+        table->match_index = new_match_index;
+        if (table->key_type == coda_expression_string)
+        {
+            long *new_key_length;
+
+            new_key_length = realloc(table->key_length, 2 * table->max_keys * sizeof(long));
+            if (new_key_length == NULL)
+            {
+                coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                               2 * table->max_keys * sizeof(long), __FILE__, __LINE__);
+                return -1;
+            }
+            table->key_length = new_key_length;
+        }
+        table->max_keys *= 2;
+    }
+    if (table->key_type == coda_expression_string)
+    {
+        if (table->pool_size + length + 1 > table->pool_capacity)
+        {
+            long new_pool_capacity = 2 * table->pool_capacity;
+            char *new_pool;
+
+            while (table->pool_size + length + 1 > new_pool_capacity)
+            {
+                new_pool_capacity *= 2;
+            }
+            new_pool = realloc(table->pool, new_pool_capacity);
+            if (new_pool == NULL)
+            {
+                coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                               new_pool_capacity, __FILE__, __LINE__);
+                return -1;
+            }
+            table->pool = new_pool;
+            table->pool_capacity = new_pool_capacity;
+        }
+        memcpy(&table->pool[table->pool_size], str, length);
+        table->pool[table->pool_size + length] = '\0';
+        table->key_length[table->num_keys] = length;
+        value = table->pool_size;
+        table->pool_size += length + 1;
+    }
+    table->key[table->num_keys] = value;
+    table->array_index[table->num_keys] = array_index;
+    table->match_index[table->num_keys] = -1;
+    table->hash_index[slot] = table->num_keys;
+    table->num_keys++;
+
+    if (2 * table->num_keys > table->hash_size)
+    {
+        if (array_key_table_rehash(table) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return table->num_keys - 1;
+}
+
+static void print_array_key(coda_expression_type key_type, int64_t value, const char *str)
+{
+    switch (key_type)
+    {
+        case coda_expression_integer:
+            {
+                char s[21];
+
+                coda_str64(value, s);
+                printf("%s", s);
+            }
+            break;
+        case coda_expression_float:
+            {
+                double d;
+
+                memcpy(&d, &value, sizeof(double));
+                printf("%.15g", d);
+            }
+            break;
+        default:
+            printf("%s", str);
+            break;
+    }
+}
+
+static void print_array_key_from_table(const array_key_table *table, long index)
+{
+    print_array_key(table->key_type, table->key[index],
+                    table->key_type == coda_expression_string ? &table->pool[table->key[index]] : NULL);
+}
+
+/* Evaluate the key for the array element that the cursor points to.
+ * String keys are stored in the scratch buffer 'key_buffer' (which is grown when needed) and 'str' will point to it,
+ * so the key remains valid until the next evaluation.
+ */
+static int eval_array_key(coda_expression *expr, coda_expression_type key_type, coda_cursor *cursor, int64_t *value,
+                          char **key_buffer, long *key_buffer_size, const char **str, long *length)
+{
+    *value = 0;
+    *str = NULL;
+    *length = 0;
+    switch (key_type)
+    {
+        case coda_expression_integer:
+            return coda_expression_eval_integer(expr, cursor, value);
+        case coda_expression_float:
+            {
+                double d;
+
+                if (coda_expression_eval_float(expr, cursor, &d) != 0)
+                {
+                    return -1;
+                }
+                if (d == 0)
+                {
+                    /* make sure that -0.0 and +0.0 match */
+                    d = 0;
+                }
+                memcpy(value, &d, sizeof(double));
+            }
+            return 0;
+        default:
+            break;
+    }
+
+    if (coda_expression_eval_string_to_buffer(expr, cursor, key_buffer, key_buffer_size, length) != 0)
+    {
+        return -1;
+    }
+    *str = *key_buffer;
+
+    return 0;
+}
+
+static void print_duplicate_array_key_error(int file_id, coda_expression_type key_type, int64_t value,
+                                            const char *str)
+{
+    char s[32];
+
+    switch (key_type)
+    {
+        case coda_expression_integer:
+            coda_str64(value, s);
+            str = s;
+            break;
+        case coda_expression_float:
+            {
+                double d;
+
+                memcpy(&d, &value, sizeof(double));
+                sprintf(s, "%.15g", d);
+                str = s;
+            }
+            break;
+        default:
+            break;
+    }
+    coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "multiple occurrence of array key '%s'", str);
+    fprintf(stderr, "%sERROR: %s\n", pre[file_id - 1], coda_errno_to_string(coda_errno));
+}
+
 static int compare_data(coda_cursor *cursor1, coda_cursor *cursor2);
 
+/* Line up the array elements using a hash join.
+ * The keys of the first array are stored in 'table1'. The second array is streamed: each key is looked up in
+ * 'table1' and only keys that do not occur in the first array are stored (in 'table2').
+ */
 static int compare_arrays_as_records_sub(coda_cursor *cursor1, coda_cursor *cursor2, coda_expression *expr,
-                                         long num_elements1, long num_elements2, char **keys1, char **keys2,
-                                         hashtable *table1, hashtable *table2)
+                                         coda_expression_type key_type, long num_elements1, long num_elements2,
+                                         array_key_table *table1, array_key_table *table2, char **key_buffer,
+                                         long *key_buffer_size)
 {
     int first_definition_mismatch;
+    long last_index2;
     long index1;
     long index2;
 
@@ -267,17 +694,27 @@ static int compare_arrays_as_records_sub(coda_cursor *cursor1, coda_cursor *curs
         }
         for (index1 = 0; index1 < num_elements1; index1++)
         {
+            int64_t value;
+            const char *str;
             long length;
+            long result;
 
-            if (coda_expression_eval_string(expr, cursor1, &keys1[index1], &length) != 0)
+            if (eval_array_key(expr, key_type, cursor1, &value, key_buffer, key_buffer_size, &str, &length) != 0)
             {
                 fprintf(stderr, "%sERROR: %s\n", pre[0], coda_errno_to_string(coda_errno));
                 return -1;
             }
-            if (hashtable_add_name(table1, keys1[index1]) != 0)
+            result = array_key_table_add(table1, index1, value, str, length);
+            if (result < 0)
             {
-                coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "multiple occurrence of array key '%s'", keys1[index1]);
-                fprintf(stderr, "%sERROR: %s\n", pre[0], coda_errno_to_string(coda_errno));
+                if (result == -2)
+                {
+                    print_duplicate_array_key_error(1, key_type, value, str);
+                }
+                else
+                {
+                    fprintf(stderr, "%sERROR: %s\n", pre[0], coda_errno_to_string(coda_errno));
+                }
                 return -1;
             }
             if (index1 < num_elements1 - 1)
@@ -300,17 +737,42 @@ static int compare_arrays_as_records_sub(coda_cursor *cursor1, coda_cursor *curs
         }
         for (index2 = 0; index2 < num_elements2; index2++)
         {
+            int64_t value;
+            const char *str;
             long length;
+            long result;
 
-            if (coda_expression_eval_string(expr, cursor2, &keys2[index2], &length) != 0)
+            if (eval_array_key(expr, key_type, cursor2, &value, key_buffer, key_buffer_size, &str, &length) != 0)
             {
                 fprintf(stderr, "%sERROR: %s\n", pre[1], coda_errno_to_string(coda_errno));
                 return -1;
             }
-            if (hashtable_add_name(table2, keys2[index2]) != 0)
+            result = array_key_table_find(table1, value, str, length);
+            if (result >= 0)
             {
-                coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "multiple occurrence of array key '%s'", keys2[index2]);
-                fprintf(stderr, "%sERROR: %s\n", pre[1], coda_errno_to_string(coda_errno));
+                if (table1->match_index[result] >= 0)
+                {
+                    result = -2;
+                }
+                else
+                {
+                    table1->match_index[result] = index2;
+                }
+            }
+            else
+            {
+                result = array_key_table_add(table2, index2, value, str, length);
+            }
+            if (result < 0)
+            {
+                if (result == -2)
+                {
+                    print_duplicate_array_key_error(2, key_type, value, str);
+                }
+                else
+                {
+                    fprintf(stderr, "%sERROR: %s\n", pre[1], coda_errno_to_string(coda_errno));
+                }
                 return -1;
             }
             if (index2 < num_elements2 - 1)
@@ -340,49 +802,44 @@ static int compare_arrays_as_records_sub(coda_cursor *cursor1, coda_cursor *curs
     /* first perform structural comparison */
     first_definition_mismatch = 1;
 
-    /* enumerate all elements of array #1 and try to find matching elements from array #2 */
-    if (num_elements1 > 0)
+    /* enumerate all elements of array #1 for which no matching element in array #2 was found */
+    for (index1 = 0; index1 < table1->num_keys; index1++)
     {
-        for (index1 = 0; index1 < num_elements1; index1++)
+        if (table1->match_index[index1] < 0)
         {
-            if (hashtable_get_index_from_name(table2, keys1[index1]) < 0)
+            /* this field is not defined in record #2 */
+            if (first_definition_mismatch)
             {
-                /* this field is not defined in record #2 */
-                if (first_definition_mismatch)
-                {
-                    printf("array elements differ at ");
-                    coda_cursor_print_path(cursor1, printf);
-                    printf("\n");
-                    first_definition_mismatch = 0;
-                }
-                if (option_verbose)
-                {
-                    printf("%scontains array element with key '%s'\n", pre[0], keys1[index1]);
-                }
+                printf("array elements differ at ");
+                coda_cursor_print_path(cursor1, printf);
+                printf("\n");
+                first_definition_mismatch = 0;
+            }
+            if (option_verbose)
+            {
+                printf("%scontains array element with key '", pre[0]);
+                print_array_key_from_table(table1, index1);
+                printf("'\n");
             }
         }
     }
 
-    /* now enumerate all elements of record #2 and see which fields were not present in record #1 */
-    if (num_elements2 > 0)
+    /* now enumerate all elements of record #2 that were not present in record #1 */
+    for (index2 = 0; index2 < table2->num_keys; index2++)
     {
-        for (index2 = 0; index2 < num_elements2; index2++)
+        /* this field is not defined in record #1 */
+        if (first_definition_mismatch)
         {
-            if (hashtable_get_index_from_name(table1, keys2[index2]) < 0)
-            {
-                /* this field is not defined in record #1 */
-                if (first_definition_mismatch)
-                {
-                    printf("array elements differ at ");
-                    coda_cursor_print_path(cursor1, printf);
-                    printf("\n");
-                    first_definition_mismatch = 0;
-                }
-                if (option_verbose)
-                {
-                    printf("%scontains array element with key '%s'\n", pre[1], keys2[index2]);
-                }
-            }
+            printf("array elements differ at ");
+            coda_cursor_print_path(cursor1, printf);
+            printf("\n");
+            first_definition_mismatch = 0;
+        }
+        if (option_verbose)
+        {
+            printf("%scontains array element with key '", pre[1]);
+            print_array_key_from_table(table2, index2);
+            printf("'\n");
         }
     }
 
@@ -394,21 +851,42 @@ static int compare_arrays_as_records_sub(coda_cursor *cursor1, coda_cursor *curs
             print_error_with_cursor(cursor1, 1);
             return -1;
         }
+        /* cursor2 is kept at the last matched element so elements that are in the same order in both arrays can be
+         * reached by moving to the next element (which, for variable sized elements, is much cheaper than moving to
+         * an element by index)
+         */
+        last_index2 = -1;
         for (index1 = 0; index1 < num_elements1; index1++)
         {
-            index2 = hashtable_get_index_from_name(table2, keys1[index1]);
+            /* keys were added to table1 in array order, so the key index equals the array index */
+            index2 = table1->match_index[index1];
             if (index2 >= 0)
             {
-                if (coda_cursor_goto_array_element_by_index(cursor2, index2) != 0)
+                if (last_index2 >= 0 && index2 == last_index2 + 1)
                 {
-                    print_error_with_cursor(cursor2, 2);
-                    return -1;
+                    if (coda_cursor_goto_next_array_element(cursor2) != 0)
+                    {
+                        print_error_with_cursor(cursor2, 2);
+                        return -1;
+                    }
                 }
+                else
+                {
+                    if (last_index2 >= 0)
+                    {
+                        coda_cursor_goto_parent(cursor2);
+                    }
+                    if (coda_cursor_goto_array_element_by_index(cursor2, index2) != 0)
+                    {
+                        print_error_with_cursor(cursor2, 2);
+                        return -1;
+                    }
+                }
+                last_index2 = index2;
                 if (compare_data(cursor1, cursor2) != 0)
                 {
                     return -1;
                 }
-                coda_cursor_goto_parent(cursor2);
             }
             if (index1 < num_elements1 - 1)
             {
@@ -420,6 +898,10 @@ static int compare_arrays_as_records_sub(coda_cursor *cursor1, coda_cursor *curs
             }
         }
         coda_cursor_goto_parent(cursor1);
+        if (last_index2 >= 0)
+        {
+            coda_cursor_goto_parent(cursor2);
+        }
     }
 
     return 0;
@@ -428,13 +910,13 @@ static int compare_arrays_as_records_sub(coda_cursor *cursor1, coda_cursor *curs
 static int compare_arrays_as_records(coda_cursor *cursor1, coda_cursor *cursor2, const char *key_expr)
 {
     coda_expression *expr = NULL;
-    hashtable *table1 = NULL;
-    hashtable *table2 = NULL;
-    char **keys1 = NULL;
-    char **keys2 = NULL;
+    coda_expression_type key_type;
+    array_key_table *table1 = NULL;
+    array_key_table *table2 = NULL;
+    char *key_buffer = NULL;
+    long key_buffer_size = 0;
     long num_elements1;
     long num_elements2;
-    long i;
     int result;
 
     if (coda_cursor_get_num_elements(cursor1, &num_elements1) != 0)
@@ -453,83 +935,356 @@ static int compare_arrays_as_records(coda_cursor *cursor1, coda_cursor *cursor2,
         fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
         return -1;
     }
+    if (coda_expression_get_type(expr, &key_type) != 0)
+    {
+        fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+        coda_expression_delete(expr);
+        return -1;
+    }
+    if (key_type != coda_expression_integer && key_type != coda_expression_float &&
+        key_type != coda_expression_string)
+    {
+        coda_set_error(CODA_ERROR_INVALID_ARGUMENT, "array key expression should be a string, integer, or float "
+                       "expression (current type is %s)", coda_expression_get_type_name(key_type));
+        fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+        coda_expression_delete(expr);
+        return -1;
+    }
 
-    keys1 = malloc(num_elements1 * sizeof(const char *));
-    if (keys1 == NULL)
+    table1 = array_key_table_new(key_type, num_elements1);
+    if (table1 == NULL)
     {
-        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       num_elements1 * sizeof(const char *), __FILE__, __LINE__);
         print_error_with_cursor(cursor1, 1);
         coda_expression_delete(expr);
         return -1;
     }
-    for (i = 0; i < num_elements1; i++)
+    /* the second table only holds the keys that are not in the first array */
+    table2 = array_key_table_new(key_type, 0);
+    if (table2 == NULL)
     {
-        keys1[i] = NULL;
+        print_error_with_cursor(cursor2, 2);
+        coda_expression_delete(expr);
+        array_key_table_delete(table1);
+        return -1;
     }
-    keys2 = malloc(num_elements2 * sizeof(const char *));
-    if (keys2 == NULL)
+
+    result = compare_arrays_as_records_sub(cursor1, cursor2, expr, key_type, num_elements1, num_elements2, table1,
+                                           table2, &key_buffer, &key_buffer_size);
+
+    coda_expression_delete(expr);
+    array_key_table_delete(table1);
+    array_key_table_delete(table2);
+    if (key_buffer != NULL)
     {
+        coda_free(key_buffer);
+    }
 
-        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
-                       num_elements2 * sizeof(const char *), __FILE__, __LINE__);
+    return result;
+}
+
+static int compare_array_elements(coda_cursor *cursor1, coda_cursor *cursor2, long offset, long length)
+{
+    long i;
+
+    if (coda_cursor_goto_array_element_by_index(cursor1, offset) != 0)
+    {
+        print_error_with_cursor(cursor1, 1);
+        return -1;
+    }
+    if (coda_cursor_goto_array_element_by_index(cursor2, offset) != 0)
+    {
         print_error_with_cursor(cursor2, 2);
-        coda_expression_delete(expr);
-        free(keys1);
         return -1;
     }
-    for (i = 0; i < num_elements2; i++)
+    for (i = 0; i < length; i++)
     {
-        keys2[i] = NULL;
+        if (compare_data(cursor1, cursor2) != 0)
+        {
+            return -1;
+        }
+        if (i < length - 1)
+        {
+            if (coda_cursor_goto_next_array_element(cursor1) != 0)
+            {
+                print_error_with_cursor(cursor1, 1);
+                return -1;
+            }
+            if (coda_cursor_goto_next_array_element(cursor2) != 0)
+            {
+                print_error_with_cursor(cursor2, 2);
+                return -1;
+            }
+        }
     }
-    table1 = hashtable_new(1);
-    if (table1 == NULL)
+    coda_cursor_goto_parent(cursor1);
+    coda_cursor_goto_parent(cursor2);
+
+    return 0;
+}
+
+/* Determine whether the arrays can be compared in bulk.
+ * This is the case if both arrays contain numbers without attributes that have the same read type.
+ * If this is the case, 'base_type' will be set to the base type of the first array and 'same_definition' will be set
+ * to 1 if both arrays share the same base type definition (i.e. same encoding and conversion).
+ * Returns 1 if bulk comparison is possible, 0 if not, and -1 on error.
+ */
+static int can_compare_arrays_in_bulk(coda_cursor *cursor1, coda_cursor *cursor2, coda_native_type *read_type,
+                                      coda_type **base_type, int *same_definition)
+{
+    coda_type *array_type1;
+    coda_type *array_type2;
+    coda_type *base_type1;
+    coda_type *base_type2;
+    coda_type_class type_class1;
+    coda_type_class type_class2;
+    coda_native_type read_type1;
+    coda_native_type read_type2;
+    int has_attributes;
+
+    if (coda_cursor_get_type(cursor1, &array_type1) != 0 || coda_type_get_array_base_type(array_type1, &base_type1) != 0)
     {
-        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not create hashtable) (%s:%u)", __FILE__,
-                       __LINE__);
         print_error_with_cursor(cursor1, 1);
-        coda_expression_delete(expr);
-        free(keys1);
-        free(keys2);
         return -1;
     }
-    table2 = hashtable_new(1);
-    if (table2 == NULL)
+    if (coda_cursor_get_type(cursor2, &array_type2) != 0 || coda_type_get_array_base_type(array_type2, &base_type2) != 0)
     {
-        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not create hashtable) (%s:%u)", __FILE__,
-                       __LINE__);
         print_error_with_cursor(cursor2, 2);
-        coda_expression_delete(expr);
-        hashtable_delete(table1);
-        free(keys1);
-        free(keys2);
         return -1;
     }
+    if (coda_type_get_class(base_type1, &type_class1) != 0 || coda_type_get_class(base_type2, &type_class2) != 0)
+    {
+        fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+        return -1;
+    }
+    if ((type_class1 != coda_integer_class && type_class1 != coda_real_class) || type_class1 != type_class2)
+    {
+        return 0;
+    }
+    if (coda_type_get_read_type(base_type1, &read_type1) != 0 || coda_type_get_read_type(base_type2, &read_type2) != 0)
+    {
+        fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+        return -1;
+    }
+    if (read_type1 != read_type2)
+    {
+        return 0;
+    }
+    /* attributes of array elements can only be compared element by element */
+    if (coda_type_has_attributes(base_type1, &has_attributes) != 0)
+    {
+        fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+        return -1;
+    }
+    if (has_attributes)
+    {
+        return 0;
+    }
+    if (coda_type_has_attributes(base_type2, &has_attributes) != 0)
+    {
+        fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+        return -1;
+    }
+    if (has_attributes)
+    {
+        return 0;
+    }
 
-    result = compare_arrays_as_records_sub(cursor1, cursor2, expr, num_elements1, num_elements2, keys1, keys2, table1,
-                                           table2);
+    *read_type = read_type1;
+    *base_type = base_type1;
+    *same_definition = (base_type1 == base_type2);
 
-    coda_expression_delete(expr);
-    hashtable_delete(table1);
-    hashtable_delete(table2);
-    for (i = 0; i < num_elements1; i++)
+    return 1;
+}
+
+/* Compare the raw data of both arrays.
+ * Sets 'first_index' to num_elements if the arrays are bit-identical. Otherwise 'first_index' is set to the index of
+ * the first element of the first chunk that differs (or to 0 if the raw data could not be compared).
+ */
+static int compare_raw_arrays(coda_cursor *cursor1, coda_cursor *cursor2, int64_t element_bit_size, long num_elements,
+                              long *first_index)
+{
+    uint8_t *value1;
+    uint8_t *value2;
+    int64_t total_byte_size;
+    int64_t byte_offset;
+
+    *first_index = 0;
+
+    value1 = (uint8_t *)malloc(2 * BULK_COMPARE_RAW_CHUNK_SIZE);
+    if (value1 == NULL)
     {
-        if (keys1[i] != NULL)
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)(2 * BULK_COMPARE_RAW_CHUNK_SIZE), __FILE__, __LINE__);
+        print_error_with_cursor(cursor1, 1);
+        return -1;
+    }
+    value2 = &value1[BULK_COMPARE_RAW_CHUNK_SIZE];
+
+    total_byte_size = (element_bit_size * num_elements) >> 3;
+    for (byte_offset = 0; byte_offset < total_byte_size; byte_offset += BULK_COMPARE_RAW_CHUNK_SIZE)
+    {
+        int64_t byte_size = total_byte_size - byte_offset;
+
+        if (byte_size > BULK_COMPARE_RAW_CHUNK_SIZE)
+        {
+            byte_size = BULK_COMPARE_RAW_CHUNK_SIZE;
+        }
+        if (coda_cursor_read_bits(cursor1, value1, byte_offset << 3, byte_size << 3) != 0 ||
+            coda_cursor_read_bits(cursor2, value2, byte_offset << 3, byte_size << 3) != 0)
+        {
+            /* leave it to the element based comparison to report any errors */
+            coda_set_error(CODA_SUCCESS, NULL);
+            free(value1);
+            return 0;
+        }
+        if (memcmp(value1, value2, (size_t)byte_size) != 0)
         {
-            coda_free(keys1[i]);
+            *first_index = (long)((byte_offset << 3) / element_bit_size);
+            free(value1);
+            return 0;
         }
     }
-    free(keys1);
-    for (i = 0; i < num_elements2; i++)
+    free(value1);
+
+    *first_index = num_elements;
+
+    return 0;
+}
+
+/* Compare two numeric arrays in chunks using bulk reads.
+ * Only chunks that contain differences (or that could not be read in bulk) are compared element by element, which
+ * takes care of reporting the differences.
+ */
+static int compare_number_arrays(coda_cursor *cursor1, coda_cursor *cursor2, long num_elements,
+                                 coda_native_type read_type, coda_type *base_type, int same_definition)
+{
+    long offset = 0;
+    int element_size;
+    uint8_t *buffer;
+    void *value1;
+    void *value2;
+
+    if (same_definition)
     {
-        if (keys2[i] != NULL)
+        coda_format format;
+        int64_t bit_size;
+
+        /* if both arrays use the same definition then bit-identical data means identical values */
+        if (coda_type_get_format(base_type, &format) != 0 || coda_type_get_bit_size(base_type, &bit_size) != 0)
+        {
+            fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+            return -1;
+        }
+        if ((format == coda_format_ascii || format == coda_format_binary) && bit_size > 0 && (bit_size & 0x7) == 0)
         {
-            coda_free(keys2[i]);
+            if (compare_raw_arrays(cursor1, cursor2, bit_size, num_elements, &offset) != 0)
+            {
+                return -1;
+            }
+            if (offset == num_elements)
+            {
+                return 0;
+            }
         }
     }
-    free(keys2);
 
-    return result;
+    element_size = (read_type == coda_native_type_float || read_type == coda_native_type_double ? sizeof(double) :
+                    sizeof(int64_t));
+    buffer = (uint8_t *)malloc(2 * BULK_COMPARE_CHUNK_SIZE * element_size);
+    if (buffer == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (long)(2 * BULK_COMPARE_CHUNK_SIZE * element_size), __FILE__, __LINE__);
+        print_error_with_cursor(cursor1, 1);
+        return -1;
+    }
+    value1 = buffer;
+    value2 = &buffer[BULK_COMPARE_CHUNK_SIZE * element_size];
+
+    while (offset < num_elements)
+    {
+        long length = num_elements - offset;
+        int equal = 1;
+        long i;
+
+        if (length > BULK_COMPARE_CHUNK_SIZE)
+        {
+            length = BULK_COMPARE_CHUNK_SIZE;
+        }
+        switch (read_type)
+        {
+            case coda_native_type_int8:
+            case coda_native_type_int16:
+            case coda_native_type_int32:
+            case coda_native_type_int64:
+                if (coda_cursor_read_int64_partial_array(cursor1, offset, length, (int64_t *)value1) != 0 ||
+                    coda_cursor_read_int64_partial_array(cursor2, offset, length, (int64_t *)value2) != 0)
+                {
+                    equal = 0;
+                }
+                else
+                {
+                    for (i = 0; i < length && equal; i++)
+                    {
+                        equal = (((int64_t *)value1)[i] == ((int64_t *)value2)[i]);
+                    }
+                }
+                break;
+            case coda_native_type_uint8:
+            case coda_native_type_uint16:
+            case coda_native_type_uint32:
+            case coda_native_type_uint64:
+                if (coda_cursor_read_uint64_partial_array(cursor1, offset, length, (uint64_t *)value1) != 0 ||
+                    coda_cursor_read_uint64_partial_array(cursor2, offset, length, (uint64_t *)value2) != 0)
+                {
+                    equal = 0;
+                }
+                else
+                {
+                    for (i = 0; i < length && equal; i++)
+                    {
+                        equal = (((uint64_t *)value1)[i] == ((uint64_t *)value2)[i]);
+                    }
+                }
+                break;
+            case coda_native_type_float:
+            case coda_native_type_double:
+                if (coda_cursor_read_double_partial_array(cursor1, offset, length, (double *)value1) != 0 ||
+                    coda_cursor_read_double_partial_array(cursor2, offset, length, (double *)value2) != 0)
+                {
+                    equal = 0;
+                }
+                else
+                {
+                    for (i = 0; i < length && equal; i++)
+                    {
+                        double d1 = ((double *)value1)[i];
+                        double d2 = ((double *)value2)[i];
+
+                        equal = (d1 == d2 || (coda_isNaN(d1) && coda_isNaN(d2)));
+                    }
+                }
+                break;
+            default:
+                assert(0);
+                exit(1);
+        }
+        if (!equal)
+        {
+            /* (re)compare this chunk element by element to report the differences and/or read errors */
+            coda_set_error(CODA_SUCCESS, NULL);
+            if (compare_array_elements(cursor1, cursor2, offset, length) != 0)
+            {
+                free(buffer);
+                return -1;
+            }
+        }
+        offset += length;
+    }
+
+    free(buffer);
+
+    return 0;
 }
 
 static int compare_arrays(coda_cursor *cursor1, coda_cursor *cursor2)
@@ -537,7 +1292,6 @@ static int compare_arrays(coda_cursor *cursor1, coda_cursor *cursor2)
     const char *key_expr;
     long num_elements1;
     long num_elements2;
-    long i;
 
     if (coda_tree_node_get_item_for_cursor(array_key_info.tree, cursor1, (void **)&key_expr) != 0)
     {
@@ -573,38 +1327,24 @@ static int compare_arrays(coda_cursor *cursor1, coda_cursor *cursor2)
     }
     if (num_elements1 > 0)
     {
-        if (coda_cursor_goto_first_array_element(cursor1) != 0)
+        coda_native_type read_type;
+        coda_type *base_type;
+        int same_definition;
+        int result;
+
+        result = can_compare_arrays_in_bulk(cursor1, cursor2, &read_type, &base_type, &same_definition);
+        if (result < 0)
         {
-            print_error_with_cursor(cursor1, 1);
             return -1;
         }
-        if (coda_cursor_goto_first_array_element(cursor2) != 0)
+        if (result > 0)
         {
-            print_error_with_cursor(cursor2, 1);
-            return -1;
+            return compare_number_arrays(cursor1, cursor2, num_elements1, read_type, base_type, same_definition);
         }
-        for (i = 0; i < num_elements1; i++)
+        if (compare_array_elements(cursor1, cursor2, 0, num_elements1) != 0)
         {
-            if (compare_data(cursor1, cursor2) != 0)
-            {
-                return -1;
-            }
-            if (i < num_elements1 - 1)
-            {
-                if (coda_cursor_goto_next_array_element(cursor1) != 0)
-                {
-                    print_error_with_cursor(cursor1, 1);
-                    return -1;
-                }
-                if (coda_cursor_goto_next_array_element(cursor2) != 0)
-                {
-                    print_error_with_cursor(cursor2, 2);
-                    return -1;
-                }
-            }
+            return -1;
         }
-        coda_cursor_goto_parent(cursor1);
-        coda_cursor_goto_parent(cursor2);
     }
 
     return 0;
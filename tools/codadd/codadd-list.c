@@ -56,6 +56,7 @@ extern int show_hidden;
 extern int show_expressions;
 extern int show_parent_types;
 extern int show_attributes;
+extern int show_size_method;
 extern int use_special_types;
 
 
@@ -129,6 +130,39 @@ static void print_path(int depth)
     }
 }
 
+static const char *get_size_method(const coda_type *type)
+{
+    if (type->bit_size >= 0)
+    {
+        return "fixed";
+    }
+    if (type->size_expr != NULL)
+    {
+        return "expression";
+    }
+    switch (type->type_class)
+    {
+        case coda_record_class:
+            return "walk";
+        case coda_array_class:
+            if (((coda_type_array *)type)->base_type->bit_size >= 0)
+            {
+                return "calculated";
+            }
+            if (((coda_type_array *)type)->has_uniform_element_size)
+            {
+                return "uniform";
+            }
+            return "walk";
+        case coda_special_class:
+            return get_size_method(((coda_type_special *)type)->base_type);
+        default:
+            break;
+    }
+
+    return "content";
+}
+
 static void print_type(coda_type *type, int depth)
 {
     coda_type_class type_class;
@@ -194,6 +228,17 @@ static void print_type(coda_type *type, int depth)
                 }
             }
         }
+        if (show_size_method)
+        {
+            coda_format format;
+
+            printf("%s", ascii_col_sep);
+            coda_type_get_format(type, &format);
+            if (format == coda_format_ascii || format == coda_format_binary)
+            {
+                printf("%s", get_size_method(type));
+            }
+        }
         if (show_description)
         {
             const char *description;
@@ -49,6 +49,7 @@ int show_hidden;
 int show_expressions;
 int show_parent_types;
 int show_attributes;
+int show_size_method;
 int use_special_types;
 
 void generate_html(const char *prefixdir);
@@ -98,6 +99,13 @@ static void print_help()
     printf("                    show additional lines for records and arrays\n");
     printf("            --attributes\n");
     printf("                    show additional lines for attributes\n");
+    printf("            --size-method\n");
+    printf("                    show how CODA determines the size of ascii/binary data:\n");
+    printf("                    fixed, expression (size expression from the definition),\n");
+    printf("                    calculated (array of fixed size elements), uniform (array\n");
+    printf("                    whose elements all have the size of the first element),\n");
+    printf("                    walk (sum of the sizes of all fields/elements), or content\n");
+    printf("                    (determined by parsing the data)\n");
     printf("            --no_special_types\n");
     printf("                    bypass special data types from the CODA format definition -\n");
     printf("                    data with a special type is treated using its non-special\n");
@@ -155,6 +163,7 @@ int main(int argc, char *argv[])
     show_expressions = 0;
     show_parent_types = 0;
     show_attributes = 0;
+    show_size_method = 0;
     use_special_types = 1;
 
     if (argc > 1)
@@ -255,6 +264,10 @@ int main(int argc, char *argv[])
             {
                 show_attributes = 1;
             }
+            else if (strcmp(argv[i], "--size-method") == 0)
+            {
+                show_size_method = 1;
+            }
             else if (strcmp(argv[i], "--no_special_types") == 0)
             {
                 use_special_types = 0;
@@ -0,0 +1,1455 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "codadump.h"
+
+/* Export of product data to an Apache Arrow IPC file (https://arrow.apache.org/docs/format/Columnar.html).
+ *
+ * Each data element that codadump would export as a separate data set (i.e. each path to a basic type after all arrays
+ * of records have been flattened, just as for the HDF4 export) becomes a column of a single record batch that has
+ * length 1. The dimensions of the data element are represented by nested FixedSizeList types (using the maximum size
+ * for variable sized dimensions) and the values are stored in one contiguous buffer in C array ordering. Elements that
+ * do not exist in the product (because of variable sized dimensions or dynamically available record fields) are
+ * marked as null.
+ *
+ * The metadata of an Arrow file is encoded using FlatBuffers. Since the structure of the metadata is fixed and small
+ * we use a minimal builder below that writes the tables front to back (so all offsets point forward).
+ * Column data is first written to a temporary file, since the record batch metadata (which precedes the data in the
+ * file) is only known after all data has been read.
+ */
+
+#define ARROW_ALIGNMENT 64
+
+#define ARROW_METADATA_VERSION_V5 4
+
+#define ARROW_MESSAGE_HEADER_SCHEMA 1
+#define ARROW_MESSAGE_HEADER_RECORD_BATCH 3
+
+#define ARROW_TYPE_INT 2
+#define ARROW_TYPE_FLOATING_POINT 3
+#define ARROW_TYPE_BINARY 4
+#define ARROW_TYPE_UTF8 5
+#define ARROW_TYPE_FIXED_SIZE_LIST 16
+
+#define ARROW_PRECISION_SINGLE 1
+#define ARROW_PRECISION_DOUBLE 2
+
+typedef enum arrow_value_kind_enum
+{
+    arrow_value_int8,
+    arrow_value_uint8,
+    arrow_value_int16,
+    arrow_value_uint16,
+    arrow_value_int32,
+    arrow_value_uint32,
+    arrow_value_int64,
+    arrow_value_uint64,
+    arrow_value_float,
+    arrow_value_double,
+    arrow_value_complex,        /* pair of doubles */
+    arrow_value_char,
+    arrow_value_string,
+    arrow_value_bytes
+} arrow_value_kind;
+
+typedef struct arrow_column_struct
+{
+    char *name;
+    char *unit;
+    char *description;
+    arrow_value_kind kind;
+    int nullable;
+    int num_dims;
+    int64_t dim[MAX_NUM_DIMS];
+    int64_t num_elements;
+} arrow_column;
+
+typedef struct arrow_block_struct
+{
+    int64_t offset;
+    int64_t length;
+} arrow_block;
+
+typedef struct arrow_info_struct
+{
+    FILE *body;
+    int64_t body_size;
+
+    int num_columns;
+    arrow_column *column;
+
+    /* nodes (length, null count) and buffers (offset, length) of the record batch */
+    int num_nodes;
+    arrow_block *node;
+    int num_buffers;
+    arrow_block *buffer;
+
+    /* properties of the column that is currently being written */
+    arrow_column *current;
+    int element_size;   /* size in bytes of a single element for fixed size element types */
+    int64_t stride[MAX_NUM_DIMS];       /* number of elements for a step of one in each dimension */
+    int64_t next_position;      /* position of the next element in the body that we write */
+    uint8_t *validity;  /* validity bitmap (only used if the column is nullable) */
+    int64_t num_valid;  /* number of values that were written */
+    int32_t *offsets;   /* element offsets for string and bytes data */
+    int64_t data_length;        /* size of the string/bytes data that was written */
+} arrow_info_t;
+
+static arrow_info_t arrow_info;
+
+static void *checked_realloc(void *ptr, size_t size)
+{
+    ptr = realloc(ptr, size);
+    if (ptr == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)", (long)size,
+                       __FILE__, __LINE__);
+        handle_coda_error();
+    }
+    return ptr;
+}
+
+static char *checked_strdup(const char *str)
+{
+    char *result;
+
+    result = checked_realloc(NULL, strlen(str) + 1);
+    strcpy(result, str);
+
+    return result;
+}
+
+static void handle_write_error(void)
+{
+    fprintf(stderr, "ERROR: could not write to output file \"%s\"\n", output_file_name);
+    exit(1);
+}
+
+/* --- FlatBuffers builder --- */
+
+typedef struct fb_builder_struct
+{
+    uint8_t *data;
+    long size;
+    long capacity;
+} fb_builder;
+
+typedef struct fb_field_struct
+{
+    int size;   /* size of a scalar field in bytes (1, 2, 4, 8) or 0 if the field is absent */
+    int is_offset;      /* the field is an offset to a string, vector or table (set later with fb_set_offset) */
+    int64_t value;      /* value for scalar fields */
+    long position;      /* position of the field in the buffer (set by fb_add_table) */
+} fb_field;
+
+static void fb_reserve(fb_builder *fb, long size)
+{
+    if (fb->size + size > fb->capacity)
+    {
+        while (fb->size + size > fb->capacity)
+        {
+            fb->capacity = fb->capacity == 0 ? 1024 : 2 * fb->capacity;
+        }
+        fb->data = checked_realloc(fb->data, fb->capacity);
+    }
+}
+
+/* add zero bytes until (size + extra) is a multiple of alignment */
+static void fb_pad(fb_builder *fb, int alignment, int extra)
+{
+    while ((fb->size + extra) % alignment != 0)
+    {
+        fb_reserve(fb, 1);
+        fb->data[fb->size++] = 0;
+    }
+}
+
+static void fb_set_scalar(fb_builder *fb, long position, int size, int64_t value)
+{
+    int i;
+
+    /* FlatBuffers are always little endian */
+    for (i = 0; i < size; i++)
+    {
+        fb->data[position + i] = (uint8_t)((uint64_t)value >> (8 * i));
+    }
+}
+
+static long fb_add_scalar(fb_builder *fb, int size, int64_t value)
+{
+    long position = fb->size;
+
+    fb_reserve(fb, size);
+    fb_set_scalar(fb, position, size, value);
+    fb->size += size;
+
+    return position;
+}
+
+static void fb_set_offset(fb_builder *fb, long position, long target)
+{
+    assert(target > position);
+    fb_set_scalar(fb, position, 4, target - position);
+}
+
+static long fb_add_string(fb_builder *fb, const char *str)
+{
+    long length = (long)strlen(str);
+    long position;
+
+    fb_pad(fb, 4, 0);
+    position = fb_add_scalar(fb, 4, length);
+    fb_reserve(fb, length + 1);
+    memcpy(&fb->data[fb->size], str, length + 1);
+    fb->size += length + 1;
+
+    return position;
+}
+
+/* adds a vector of offsets; the offset of element i is at position + 4 + 4 * i and should be set with fb_set_offset */
+static long fb_add_offset_vector(fb_builder *fb, long num_elements)
+{
+    long position;
+    long i;
+
+    fb_pad(fb, 4, 0);
+    position = fb_add_scalar(fb, 4, num_elements);
+    for (i = 0; i < num_elements; i++)
+    {
+        fb_add_scalar(fb, 4, 0);
+    }
+
+    return position;
+}
+
+/* adds a vector of structs that consist of 'num_words' 64-bit values each */
+static long fb_add_struct_vector(fb_builder *fb, long num_elements, int num_words, const int64_t *word)
+{
+    long position;
+    long i;
+
+    fb_pad(fb, 8, 4);
+    position = fb_add_scalar(fb, 4, num_elements);
+    for (i = 0; i < num_elements * num_words; i++)
+    {
+        fb_add_scalar(fb, 8, word[i]);
+    }
+
+    return position;
+}
+
+/* adds a table (preceded by its vtable) and returns the position of the table */
+static long fb_add_table(fb_builder *fb, int num_fields, fb_field *field)
+{
+    int field_offset[16];
+    long vtable_position;
+    long position;
+    int table_size = 4;
+    int size;
+    int i;
+
+    assert(num_fields <= 16);
+
+    /* place the fields in order of decreasing size, such that all fields are properly aligned */
+    for (size = 8; size > 0; size /= 2)
+    {
+        for (i = 0; i < num_fields; i++)
+        {
+            if (field[i].size == size)
+            {
+                field_offset[i] = table_size;
+                table_size += size;
+            }
+        }
+    }
+
+    fb_pad(fb, 2, 0);
+    vtable_position = fb_add_scalar(fb, 2, 4 + 2 * num_fields);
+    fb_add_scalar(fb, 2, table_size);
+    for (i = 0; i < num_fields; i++)
+    {
+        fb_add_scalar(fb, 2, field[i].size > 0 ? field_offset[i] : 0);
+    }
+
+    /* the table starts with a 32-bit offset to the vtable, which is followed by any 64-bit fields */
+    fb_pad(fb, 8, 4);
+    position = fb_add_scalar(fb, 4, fb->size - vtable_position);
+    fb_reserve(fb, table_size - 4);
+    memset(&fb->data[fb->size], 0, table_size - 4);
+    fb->size += table_size - 4;
+    for (i = 0; i < num_fields; i++)
+    {
+        if (field[i].size > 0)
+        {
+            field[i].position = position + field_offset[i];
+            if (!field[i].is_offset)
+            {
+                fb_set_scalar(fb, field[i].position, field[i].size, field[i].value);
+            }
+        }
+    }
+
+    return position;
+}
+
+static void fb_set_scalar_field(fb_field *field, int size, int64_t value)
+{
+    field->size = size;
+    field->is_offset = 0;
+    field->value = value;
+}
+
+static void fb_set_offset_field(fb_field *field)
+{
+    field->size = 4;
+    field->is_offset = 1;
+    field->value = 0;
+}
+
+/* --- Arrow metadata --- */
+
+static long add_type(fb_builder *fb, int type_id, int64_t parameter)
+{
+    fb_field field[2];
+
+    memset(field, 0, sizeof(field));
+    switch (type_id)
+    {
+        case ARROW_TYPE_INT:
+            /* parameter is the bit width; a negative value denotes a signed integer */
+            fb_set_scalar_field(&field[0], 4, parameter < 0 ? -parameter : parameter);
+            fb_set_scalar_field(&field[1], 1, parameter < 0);
+            return fb_add_table(fb, 2, field);
+        case ARROW_TYPE_FLOATING_POINT:
+            fb_set_scalar_field(&field[0], 2, parameter);
+            return fb_add_table(fb, 1, field);
+        case ARROW_TYPE_FIXED_SIZE_LIST:
+            fb_set_scalar_field(&field[0], 4, parameter);
+            return fb_add_table(fb, 1, field);
+        default:
+            return fb_add_table(fb, 0, field);
+    }
+}
+
+static long add_key_value(fb_builder *fb, const char *key, const char *value)
+{
+    fb_field field[2];
+    long position;
+
+    memset(field, 0, sizeof(field));
+    fb_set_offset_field(&field[0]);
+    fb_set_offset_field(&field[1]);
+    position = fb_add_table(fb, 2, field);
+    fb_set_offset(fb, field[0].position, fb_add_string(fb, key));
+    fb_set_offset(fb, field[1].position, fb_add_string(fb, value));
+
+    return position;
+}
+
+/* adds the Field table for dimension 'dim_id' of a column (or for the values if dim_id == column->num_dims)
+ * 'is_root' should be set for the top level field of the column (which carries the name and the metadata)
+ */
+static long add_field(fb_builder *fb, const arrow_column *column, int dim_id, int is_root)
+{
+    fb_field field[7];
+    long position;
+    long vector;
+    int64_t parameter = 0;
+    int type_id;
+    int is_leaf;
+
+    is_leaf = (dim_id == column->num_dims);
+    if (!is_leaf)
+    {
+        type_id = ARROW_TYPE_FIXED_SIZE_LIST;
+        parameter = column->dim[dim_id];
+    }
+    else
+    {
+        switch (column->kind)
+        {
+            case arrow_value_int8:
+                type_id = ARROW_TYPE_INT;
+                parameter = -8;
+                break;
+            case arrow_value_uint8:
+                type_id = ARROW_TYPE_INT;
+                parameter = 8;
+                break;
+            case arrow_value_int16:
+                type_id = ARROW_TYPE_INT;
+                parameter = -16;
+                break;
+            case arrow_value_uint16:
+                type_id = ARROW_TYPE_INT;
+                parameter = 16;
+                break;
+            case arrow_value_int32:
+                type_id = ARROW_TYPE_INT;
+                parameter = -32;
+                break;
+            case arrow_value_uint32:
+                type_id = ARROW_TYPE_INT;
+                parameter = 32;
+                break;
+            case arrow_value_int64:
+                type_id = ARROW_TYPE_INT;
+                parameter = -64;
+                break;
+            case arrow_value_uint64:
+                type_id = ARROW_TYPE_INT;
+                parameter = 64;
+                break;
+            case arrow_value_float:
+                type_id = ARROW_TYPE_FLOATING_POINT;
+                parameter = ARROW_PRECISION_SINGLE;
+                break;
+            case arrow_value_double:
+                type_id = ARROW_TYPE_FLOATING_POINT;
+                parameter = ARROW_PRECISION_DOUBLE;
+                break;
+            case arrow_value_complex:
+                /* a complex value is a fixed size list of two doubles (real, imaginary) */
+                type_id = ARROW_TYPE_FIXED_SIZE_LIST;
+                parameter = 2;
+                break;
+            case arrow_value_char:
+            case arrow_value_string:
+                type_id = ARROW_TYPE_UTF8;
+                break;
+            case arrow_value_bytes:
+            default:
+                type_id = ARROW_TYPE_BINARY;
+                break;
+        }
+    }
+
+    memset(field, 0, sizeof(field));
+    fb_set_offset_field(&field[0]);     /* name */
+    fb_set_scalar_field(&field[1], 1, is_leaf && column->nullable);     /* nullable */
+    fb_set_scalar_field(&field[2], 1, type_id); /* type_type */
+    fb_set_offset_field(&field[3]);     /* type */
+    fb_set_offset_field(&field[5]);     /* children */
+    if (is_root && (column->unit != NULL || column->description != NULL))
+    {
+        fb_set_offset_field(&field[6]); /* custom_metadata */
+    }
+    position = fb_add_table(fb, 7, field);
+
+    fb_set_offset(fb, field[0].position, fb_add_string(fb, is_root ? column->name : "item"));
+    fb_set_offset(fb, field[3].position, add_type(fb, type_id, parameter));
+    if (!is_leaf || column->kind == arrow_value_complex)
+    {
+        vector = fb_add_offset_vector(fb, 1);
+        fb_set_offset(fb, field[5].position, vector);
+        if (is_leaf)
+        {
+            arrow_column values = *column;
+
+            /* the two parts of a complex value are stored as a (nullable) double values array */
+            values.kind = arrow_value_double;
+            fb_set_offset(fb, vector + 4, add_field(fb, &values, dim_id, 0));
+        }
+        else
+        {
+            fb_set_offset(fb, vector + 4, add_field(fb, column, dim_id + 1, 0));
+        }
+    }
+    else
+    {
+        fb_set_offset(fb, field[5].position, fb_add_offset_vector(fb, 0));
+    }
+    if (field[6].size > 0)
+    {
+        int num_items = (column->unit != NULL) + (column->description != NULL);
+        int i = 0;
+
+        vector = fb_add_offset_vector(fb, num_items);
+        fb_set_offset(fb, field[6].position, vector);
+        if (column->unit != NULL)
+        {
+            fb_set_offset(fb, vector + 4 + 4 * i, add_key_value(fb, "unit", column->unit));
+            i++;
+        }
+        if (column->description != NULL)
+        {
+            fb_set_offset(fb, vector + 4 + 4 * i, add_key_value(fb, "description", column->description));
+        }
+    }
+
+    return position;
+}
+
+static long add_schema(fb_builder *fb)
+{
+    fb_field field[2];
+    long position;
+    long vector;
+    int i;
+
+    memset(field, 0, sizeof(field));
+#ifdef WORDS_BIGENDIAN
+    fb_set_scalar_field(&field[0], 2, 1);       /* endianness = Big */
+#else
+    fb_set_scalar_field(&field[0], 2, 0);       /* endianness = Little */
+#endif
+    fb_set_offset_field(&field[1]);     /* fields */
+    position = fb_add_table(fb, 2, field);
+
+    vector = fb_add_offset_vector(fb, arrow_info.num_columns);
+    fb_set_offset(fb, field[1].position, vector);
+    for (i = 0; i < arrow_info.num_columns; i++)
+    {
+        fb_set_offset(fb, vector + 4 + 4 * i, add_field(fb, &arrow_info.column[i], 0, 1));
+    }
+
+    return position;
+}
+
+static long add_record_batch(fb_builder *fb)
+{
+    fb_field field[3];
+    long position;
+
+    memset(field, 0, sizeof(field));
+    fb_set_scalar_field(&field[0], 8, 1);       /* length */
+    fb_set_offset_field(&field[1]);     /* nodes */
+    fb_set_offset_field(&field[2]);     /* buffers */
+    position = fb_add_table(fb, 3, field);
+
+    fb_set_offset(fb, field[1].position,
+                  fb_add_struct_vector(fb, arrow_info.num_nodes, 2, (int64_t *)arrow_info.node));
+    fb_set_offset(fb, field[2].position,
+                  fb_add_struct_vector(fb, arrow_info.num_buffers, 2, (int64_t *)arrow_info.buffer));
+
+    return position;
+}
+
+/* builds a Message flatbuffer with a Schema or RecordBatch header */
+static void build_message(fb_builder *fb, int header_type, int64_t body_length)
+{
+    fb_field field[4];
+    long root;
+
+    fb->size = 0;
+    root = fb_add_scalar(fb, 4, 0);
+    memset(field, 0, sizeof(field));
+    fb_set_scalar_field(&field[0], 2, ARROW_METADATA_VERSION_V5);       /* version */
+    fb_set_scalar_field(&field[1], 1, header_type);     /* header_type */
+    fb_set_offset_field(&field[2]);     /* header */
+    fb_set_scalar_field(&field[3], 8, body_length);     /* bodyLength */
+    fb_set_offset(fb, root, fb_add_table(fb, 4, field));
+    if (header_type == ARROW_MESSAGE_HEADER_SCHEMA)
+    {
+        fb_set_offset(fb, field[2].position, add_schema(fb));
+    }
+    else
+    {
+        fb_set_offset(fb, field[2].position, add_record_batch(fb));
+    }
+}
+
+static void build_footer(fb_builder *fb, int64_t record_batch_offset, int64_t metadata_length, int64_t body_length)
+{
+    fb_field field[4];
+    int64_t block[3];
+    long root;
+
+    fb->size = 0;
+    root = fb_add_scalar(fb, 4, 0);
+    memset(field, 0, sizeof(field));
+    fb_set_scalar_field(&field[0], 2, ARROW_METADATA_VERSION_V5);       /* version */
+    fb_set_offset_field(&field[1]);     /* schema */
+    fb_set_offset_field(&field[2]);     /* dictionaries */
+    fb_set_offset_field(&field[3]);     /* recordBatches */
+    fb_set_offset(fb, root, fb_add_table(fb, 4, field));
+    fb_set_offset(fb, field[1].position, add_schema(fb));
+    fb_set_offset(fb, field[2].position, fb_add_struct_vector(fb, 0, 3, NULL));
+    /* Block struct: offset (int64), metaDataLength (int32 + padding), bodyLength (int64) */
+    block[0] = record_batch_offset;
+    block[1] = metadata_length;
+    block[2] = body_length;
+    fb_set_offset(fb, field[3].position, fb_add_struct_vector(fb, 1, 3, block));
+}
+
+/* --- Output file --- */
+
+static void write_bytes(FILE *f, const void *data, size_t size)
+{
+    if (size > 0 && fwrite(data, 1, size, f) != size)
+    {
+        handle_write_error();
+    }
+}
+
+static void write_int32(FILE *f, int32_t value)
+{
+    uint8_t buffer[4];
+
+    buffer[0] = (uint8_t)(value & 0xFF);
+    buffer[1] = (uint8_t)((value >> 8) & 0xFF);
+    buffer[2] = (uint8_t)((value >> 16) & 0xFF);
+    buffer[3] = (uint8_t)((value >> 24) & 0xFF);
+    write_bytes(f, buffer, 4);
+}
+
+static void write_zeros(FILE *f, int64_t size)
+{
+    static const uint8_t zeros[4096] = { 0 };
+
+    while (size > 0)
+    {
+        size_t length = size > (int64_t)sizeof(zeros) ? sizeof(zeros) : (size_t)size;
+
+        write_bytes(f, zeros, length);
+        size -= length;
+    }
+}
+
+/* write an encapsulated message (continuation marker, metadata length, metadata, padding) and return its size */
+static int64_t write_message(FILE *f, fb_builder *fb)
+{
+    int32_t length;
+
+    length = (int32_t)((fb->size + 7) & ~7);
+    write_int32(f, -1);
+    write_int32(f, length);
+    write_bytes(f, fb->data, fb->size);
+    write_zeros(f, length - fb->size);
+
+    return 8 + length;
+}
+
+void arrow_info_init()
+{
+    memset(&arrow_info, 0, sizeof(arrow_info));
+    arrow_info.body = tmpfile();
+    if (arrow_info.body == NULL)
+    {
+        fprintf(stderr, "ERROR: could not create temporary file\n");
+        exit(1);
+    }
+}
+
+void arrow_info_done()
+{
+    static const char magic[8] = { 'A', 'R', 'R', 'O', 'W', '1', 0, 0 };
+    fb_builder fb = { NULL, 0, 0 };
+    int64_t record_batch_offset;
+    int64_t metadata_length;
+    FILE *f;
+    int i;
+
+    f = fopen(output_file_name, "wb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "ERROR: could not create output file \"%s\"\n", output_file_name);
+        exit(1);
+    }
+
+    write_bytes(f, magic, 8);
+    build_message(&fb, ARROW_MESSAGE_HEADER_SCHEMA, 0);
+    record_batch_offset = 8 + write_message(f, &fb);
+    build_message(&fb, ARROW_MESSAGE_HEADER_RECORD_BATCH, arrow_info.body_size);
+    metadata_length = write_message(f, &fb);
+
+    /* copy the record batch body from the temporary file */
+    rewind(arrow_info.body);
+    for (;;)
+    {
+        char buffer[65536];
+        size_t length;
+
+        length = fread(buffer, 1, sizeof(buffer), arrow_info.body);
+        if (length == 0)
+        {
+            break;
+        }
+        write_bytes(f, buffer, length);
+    }
+    if (ferror(arrow_info.body))
+    {
+        fprintf(stderr, "ERROR: could not read from temporary file\n");
+        exit(1);
+    }
+    fclose(arrow_info.body);
+
+    /* end-of-stream marker */
+    write_int32(f, -1);
+    write_int32(f, 0);
+
+    build_footer(&fb, record_batch_offset, metadata_length, arrow_info.body_size);
+    write_bytes(f, fb.data, fb.size);
+    write_int32(f, (int32_t)fb.size);
+    write_bytes(f, magic, 6);
+    if (fclose(f) != 0)
+    {
+        handle_write_error();
+    }
+
+    free(fb.data);
+    for (i = 0; i < arrow_info.num_columns; i++)
+    {
+        free(arrow_info.column[i].name);
+        if (arrow_info.column[i].unit != NULL)
+        {
+            free(arrow_info.column[i].unit);
+        }
+        if (arrow_info.column[i].description != NULL)
+        {
+            free(arrow_info.column[i].description);
+        }
+    }
+    if (arrow_info.column != NULL)
+    {
+        free(arrow_info.column);
+    }
+    if (arrow_info.node != NULL)
+    {
+        free(arrow_info.node);
+    }
+    if (arrow_info.buffer != NULL)
+    {
+        free(arrow_info.buffer);
+    }
+}
+
+/* --- Column data --- */
+
+static void add_node(int64_t length, int64_t null_count)
+{
+    if (arrow_info.num_nodes % 64 == 0)
+    {
+        arrow_info.node = checked_realloc(arrow_info.node, (arrow_info.num_nodes + 64) * sizeof(arrow_block));
+    }
+    arrow_info.node[arrow_info.num_nodes].offset = length;
+    arrow_info.node[arrow_info.num_nodes].length = null_count;
+    arrow_info.num_nodes++;
+}
+
+static void add_buffer(int64_t offset, int64_t length)
+{
+    if (arrow_info.num_buffers % 64 == 0)
+    {
+        arrow_info.buffer = checked_realloc(arrow_info.buffer, (arrow_info.num_buffers + 64) * sizeof(arrow_block));
+    }
+    arrow_info.buffer[arrow_info.num_buffers].offset = offset;
+    arrow_info.buffer[arrow_info.num_buffers].length = length;
+    arrow_info.num_buffers++;
+}
+
+static void write_body(const void *data, int64_t size)
+{
+    write_bytes(arrow_info.body, data, (size_t)size);
+    arrow_info.body_size += size;
+}
+
+static void pad_body(void)
+{
+    int64_t size = (ARROW_ALIGNMENT - arrow_info.body_size % ARROW_ALIGNMENT) % ARROW_ALIGNMENT;
+
+    write_zeros(arrow_info.body, size);
+    arrow_info.body_size += size;
+}
+
+/* reserve an aligned region in the body that will be written with write_body_at() and return its offset */
+static int64_t reserve_body(int64_t size)
+{
+    int64_t offset = arrow_info.body_size;
+
+    write_zeros(arrow_info.body, size);
+    arrow_info.body_size += size;
+    pad_body();
+
+    return offset;
+}
+
+static void write_body_at(int64_t offset, const void *data, int64_t size)
+{
+    if (fseek(arrow_info.body, (long)offset, SEEK_SET) != 0)
+    {
+        handle_write_error();
+    }
+    write_bytes(arrow_info.body, data, (size_t)size);
+    if (fseek(arrow_info.body, 0, SEEK_END) != 0)
+    {
+        handle_write_error();
+    }
+}
+
+static void set_valid(int64_t position, int64_t count)
+{
+    int num_values = (arrow_info.current->kind == arrow_value_complex ? 2 : 1);
+    int64_t i;
+
+    if (arrow_info.validity != NULL)
+    {
+        for (i = position * num_values; i < (position + count) * num_values; i++)
+        {
+            arrow_info.validity[i >> 3] |= (uint8_t)(1 << (i & 7));
+        }
+    }
+    arrow_info.num_valid += count * num_values;
+}
+
+/* write 'count' fixed size elements that start at element 'position' (in C ordering of the column dimensions) */
+static void write_elements(int64_t position, const void *data, int64_t count)
+{
+    assert(position >= arrow_info.next_position);
+    if (position > arrow_info.next_position)
+    {
+        /* the skipped elements are null */
+        write_zeros(arrow_info.body, (position - arrow_info.next_position) * arrow_info.element_size);
+        arrow_info.body_size += (position - arrow_info.next_position) * arrow_info.element_size;
+    }
+    write_body(data, count * arrow_info.element_size);
+    set_valid(position, count);
+    arrow_info.next_position = position + count;
+}
+
+static void write_variable_element(int64_t position, const void *data, int64_t length)
+{
+    int64_t i;
+
+    assert(position >= arrow_info.next_position);
+    if (arrow_info.data_length + length > 0x7FFFFFFF)
+    {
+        fprintf(stderr, "ERROR: string data of field \"%s\" is too large for an Arrow column\n",
+                arrow_info.current->name);
+        exit(1);
+    }
+    for (i = arrow_info.next_position; i <= position; i++)
+    {
+        arrow_info.offsets[i] = (int32_t)arrow_info.data_length;
+    }
+    write_body(data, length);
+    arrow_info.data_length += length;
+    arrow_info.offsets[position + 1] = (int32_t)arrow_info.data_length;
+    set_valid(position, 1);
+    arrow_info.next_position = position + 1;
+}
+
+static void write_basic_data(int64_t position)
+{
+    arrow_value_kind kind = arrow_info.current->kind;
+    uint8_t data[16];   /* buffer for the maximum element size (complex) */
+    int result = 0;
+
+    switch (kind)
+    {
+        case arrow_value_int8:
+            result = coda_cursor_read_int8(&traverse_info.cursor, (int8_t *)data);
+            break;
+        case arrow_value_uint8:
+            result = coda_cursor_read_uint8(&traverse_info.cursor, (uint8_t *)data);
+            break;
+        case arrow_value_int16:
+            result = coda_cursor_read_int16(&traverse_info.cursor, (int16_t *)data);
+            break;
+        case arrow_value_uint16:
+            result = coda_cursor_read_uint16(&traverse_info.cursor, (uint16_t *)data);
+            break;
+        case arrow_value_int32:
+            result = coda_cursor_read_int32(&traverse_info.cursor, (int32_t *)data);
+            break;
+        case arrow_value_uint32:
+            result = coda_cursor_read_uint32(&traverse_info.cursor, (uint32_t *)data);
+            break;
+        case arrow_value_int64:
+            result = coda_cursor_read_int64(&traverse_info.cursor, (int64_t *)data);
+            break;
+        case arrow_value_uint64:
+            result = coda_cursor_read_uint64(&traverse_info.cursor, (uint64_t *)data);
+            break;
+        case arrow_value_float:
+            result = coda_cursor_read_float(&traverse_info.cursor, (float *)data);
+            break;
+        case arrow_value_double:
+            result = coda_cursor_read_double(&traverse_info.cursor, (double *)data);
+            break;
+        case arrow_value_complex:
+            result = coda_cursor_read_complex_double_pair(&traverse_info.cursor, (double *)data);
+            break;
+        case arrow_value_char:
+            if (coda_cursor_read_char(&traverse_info.cursor, (char *)data) != 0)
+            {
+                handle_coda_error();
+            }
+            write_variable_element(position, data, 1);
+            return;
+        case arrow_value_string:
+            {
+                long length;
+                char *str;
+
+                if (coda_cursor_get_string_length(&traverse_info.cursor, &length) != 0)
+                {
+                    handle_coda_error();
+                }
+                str = checked_realloc(NULL, length + 1);
+                if (coda_cursor_read_string(&traverse_info.cursor, str, length + 1) != 0)
+                {
+                    handle_coda_error();
+                }
+                /* the string ends at the first terminating zero (e.g. for padded netCDF char arrays) */
+                write_variable_element(position, str, (int64_t)strlen(str));
+                free(str);
+            }
+            return;
+        case arrow_value_bytes:
+            {
+                int64_t bit_size;
+                int64_t byte_size;
+                uint8_t *bytes;
+
+                if (coda_cursor_get_bit_size(&traverse_info.cursor, &bit_size) != 0)
+                {
+                    handle_coda_error();
+                }
+                byte_size = (bit_size >> 3) + (bit_size & 0x7 ? 1 : 0);
+                bytes = checked_realloc(NULL, (size_t)(byte_size > 0 ? byte_size : 1));
+                if (coda_cursor_read_bits(&traverse_info.cursor, bytes, 0, bit_size) != 0)
+                {
+                    handle_coda_error();
+                }
+                write_variable_element(position, bytes, byte_size);
+                free(bytes);
+            }
+            return;
+    }
+    if (result != 0)
+    {
+        handle_coda_error();
+    }
+    write_elements(position, data, 1);
+}
+
+/* read all elements of the array at the cursor with a single read and write them as a contiguous block */
+static int write_array_block(int64_t position, int64_t num_elements)
+{
+    arrow_value_kind kind = arrow_info.current->kind;
+    void *data;
+    int result = 0;
+
+    if (kind == arrow_value_char || kind == arrow_value_string || kind == arrow_value_bytes)
+    {
+        return 0;
+    }
+
+    data = checked_realloc(NULL, (size_t)(num_elements * arrow_info.element_size));
+    switch (kind)
+    {
+        case arrow_value_int8:
+            result = coda_cursor_read_int8_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        case arrow_value_uint8:
+            result = coda_cursor_read_uint8_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        case arrow_value_int16:
+            result = coda_cursor_read_int16_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        case arrow_value_uint16:
+            result = coda_cursor_read_uint16_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        case arrow_value_int32:
+            result = coda_cursor_read_int32_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        case arrow_value_uint32:
+            result = coda_cursor_read_uint32_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        case arrow_value_int64:
+            result = coda_cursor_read_int64_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        case arrow_value_uint64:
+            result = coda_cursor_read_uint64_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        case arrow_value_float:
+            result = coda_cursor_read_float_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        case arrow_value_double:
+            result = coda_cursor_read_double_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        case arrow_value_complex:
+            result = coda_cursor_read_complex_double_pairs_array(&traverse_info.cursor, data, coda_array_ordering_c);
+            break;
+        default:
+            assert(0);
+            exit(1);
+    }
+    if (result != 0)
+    {
+        handle_coda_error();
+    }
+    write_elements(position, data, num_elements);
+    free(data);
+
+    return 1;
+}
+
+static void write_data(int depth, int array_depth, int record_depth, int64_t position)
+{
+    coda_type_class type_class;
+
+    if (coda_type_get_class(traverse_info.type[depth], &type_class) != 0)
+    {
+        handle_coda_error();
+    }
+    switch (type_class)
+    {
+        case coda_record_class:
+            {
+                int available;
+
+                if (coda_cursor_get_record_field_available_status(&traverse_info.cursor,
+                                                                  traverse_info.parent_index[record_depth],
+                                                                  &available) != 0)
+                {
+                    handle_coda_error();
+                }
+                /* if the field is not available, the elements will be null */
+                if (available)
+                {
+                    if (coda_cursor_goto_record_field_by_index(&traverse_info.cursor,
+                                                               traverse_info.parent_index[record_depth]) != 0)
+                    {
+                        handle_coda_error();
+                    }
+                    write_data(depth + 1, array_depth, record_depth + 1, position);
+                    coda_cursor_goto_parent(&traverse_info.cursor);
+                }
+            }
+            break;
+        case coda_array_class:
+            {
+                array_info_t *array_info;
+                int64_t number_of_elements;
+                int has_var_dim_sub_array;
+                int is_contiguous = 1;
+                int local_dim[MAX_NUM_DIMS];
+                int index[MAX_NUM_DIMS];
+                int dim_id;
+                int i;
+
+                array_info = &traverse_info.array_info[array_depth];
+                dim_id = array_info->dim_id;
+
+                if (array_depth == 0)
+                {
+                    array_info->global_index = 0;
+                }
+
+                has_var_dim_sub_array = (dim_info.last_var_size_dim >= dim_id + array_info->num_dims);
+                if (has_var_dim_sub_array && array_depth < traverse_info.num_arrays - 1)
+                {
+                    /* Set the index for the var_dim list(s) for the next array */
+                    traverse_info.array_info[array_depth + 1].global_index =
+                        array_info->global_index * array_info->num_elements;
+                }
+
+                /* calculate local dimensions and number of array elements */
+                number_of_elements = 1;
+                for (i = 0; i < array_info->num_dims; i++)
+                {
+                    if (dim_info.is_var_size_dim[dim_id + i])
+                    {
+                        local_dim[i] = dim_info.var_dim[dim_id + i][array_info->global_index];
+                    }
+                    else
+                    {
+                        local_dim[i] = dim_info.dim[dim_id + i];
+                    }
+                    if (i > 0 && local_dim[i] != dim_info.dim[dim_id + i])
+                    {
+                        is_contiguous = 0;
+                    }
+                    number_of_elements *= local_dim[i];
+                    index[i] = 0;
+                }
+                if (number_of_elements == 0)
+                {
+                    /* array is empty */
+                    return;
+                }
+
+                if (depth + 1 == traverse_info.current_depth && is_contiguous &&
+                    write_array_block(position, number_of_elements))
+                {
+                    return;
+                }
+
+                /* traverse array */
+                if (coda_cursor_goto_first_array_element(&traverse_info.cursor) != 0)
+                {
+                    handle_coda_error();
+                }
+                for (i = 0; i < number_of_elements; i++)
+                {
+                    int64_t element_position = position;
+                    int k;
+
+                    for (k = 0; k < array_info->num_dims; k++)
+                    {
+                        element_position += index[k] * arrow_info.stride[dim_id + k];
+                    }
+
+                    /* write data for current array element */
+                    write_data(depth + 1, array_depth + 1, record_depth, element_position);
+
+                    if (i < number_of_elements - 1)
+                    {
+                        /* jump to next array element */
+                        if (coda_cursor_goto_next_array_element(&traverse_info.cursor) != 0)
+                        {
+                            handle_coda_error();
+                        }
+                        if (has_var_dim_sub_array && array_depth < traverse_info.num_arrays - 1)
+                        {
+                            traverse_info.array_info[array_depth + 1].global_index++;
+                        }
+                        k = array_info->num_dims - 1;
+                        index[k]++;
+                        while (k > 0 && index[k] == local_dim[k])
+                        {
+                            index[k] = 0;
+                            k--;
+                            index[k]++;
+                        }
+                    }
+                }
+                coda_cursor_goto_parent(&traverse_info.cursor);
+            }
+            break;
+        default:
+            write_basic_data(position);
+            break;
+    }
+}
+
+static int get_value_kind(coda_type *type, arrow_value_kind *kind)
+{
+    coda_type_class type_class;
+
+    if (coda_type_get_class(type, &type_class) != 0)
+    {
+        handle_coda_error();
+    }
+    if (type_class == coda_special_class)
+    {
+        coda_special_type special_type;
+
+        if (coda_type_get_special_type(type, &special_type) != 0)
+        {
+            handle_coda_error();
+        }
+        switch (special_type)
+        {
+            case coda_special_vsf_integer:
+            case coda_special_time:
+                *kind = arrow_value_double;
+                return 0;
+            case coda_special_complex:
+                *kind = arrow_value_complex;
+                return 0;
+            case coda_special_no_data:
+                break;
+        }
+    }
+    else
+    {
+        coda_native_type read_type;
+
+        if (coda_type_get_read_type(type, &read_type) != 0)
+        {
+            handle_coda_error();
+        }
+        switch (read_type)
+        {
+            case coda_native_type_int8:
+                *kind = arrow_value_int8;
+                return 0;
+            case coda_native_type_uint8:
+                *kind = arrow_value_uint8;
+                return 0;
+            case coda_native_type_int16:
+                *kind = arrow_value_int16;
+                return 0;
+            case coda_native_type_uint16:
+                *kind = arrow_value_uint16;
+                return 0;
+            case coda_native_type_int32:
+                *kind = arrow_value_int32;
+                return 0;
+            case coda_native_type_uint32:
+                *kind = arrow_value_uint32;
+                return 0;
+            case coda_native_type_int64:
+                *kind = arrow_value_int64;
+                return 0;
+            case coda_native_type_uint64:
+                *kind = arrow_value_uint64;
+                return 0;
+            case coda_native_type_float:
+                *kind = arrow_value_float;
+                return 0;
+            case coda_native_type_double:
+                *kind = arrow_value_double;
+                return 0;
+            case coda_native_type_char:
+                *kind = arrow_value_char;
+                return 0;
+            case coda_native_type_string:
+                *kind = arrow_value_string;
+                return 0;
+            case coda_native_type_bytes:
+                *kind = arrow_value_bytes;
+                return 0;
+            case coda_native_type_not_available:
+                break;
+        }
+    }
+
+    return -1;
+}
+
+static int get_element_size(arrow_value_kind kind)
+{
+    switch (kind)
+    {
+        case arrow_value_int8:
+        case arrow_value_uint8:
+            return 1;
+        case arrow_value_int16:
+        case arrow_value_uint16:
+            return 2;
+        case arrow_value_int32:
+        case arrow_value_uint32:
+        case arrow_value_float:
+            return 4;
+        case arrow_value_int64:
+        case arrow_value_uint64:
+        case arrow_value_double:
+            return 8;
+        case arrow_value_complex:
+            return 16;
+        case arrow_value_char:
+        case arrow_value_string:
+        case arrow_value_bytes:
+            break;
+    }
+
+    return 0;
+}
+
+static char *get_column_name(void)
+{
+    char *name;
+    size_t length = 1;
+    int i;
+
+    for (i = 0; i < traverse_info.num_records; i++)
+    {
+        length += 1 + strlen(traverse_info.field_name[i]);
+    }
+    name = checked_realloc(NULL, length + 1);
+    name[0] = '\0';
+    for (i = 0; i < traverse_info.num_records; i++)
+    {
+        strcat(name, "/");
+        strcat(name, traverse_info.field_name[i]);
+    }
+    if (name[0] == '\0')
+    {
+        strcpy(name, "/");
+    }
+
+    return name;
+}
+
+void export_data_element_to_arrow()
+{
+    coda_type *type = traverse_info.type[traverse_info.current_depth];
+    arrow_column *column;
+    arrow_value_kind kind;
+    int64_t validity_offset = 0;
+    int64_t validity_size = 0;
+    int64_t offsets_offset = 0;
+    int64_t data_offset;
+    int64_t num_values;
+    const char *str;
+    int i;
+
+    if (get_value_kind(type, &kind) != 0)
+    {
+        /* can not be exported */
+        return;
+    }
+
+    if (arrow_info.num_columns % 64 == 0)
+    {
+        arrow_info.column = checked_realloc(arrow_info.column, (arrow_info.num_columns + 64) * sizeof(arrow_column));
+    }
+    column = &arrow_info.column[arrow_info.num_columns];
+    arrow_info.num_columns++;
+
+    column->name = get_column_name();
+    column->kind = kind;
+    if (coda_type_get_unit(type, &str) != 0)
+    {
+        handle_coda_error();
+    }
+    column->unit = (str != NULL && str[0] != '\0') ? checked_strdup(str) : NULL;
+    if (coda_type_get_description(type, &str) != 0)
+    {
+        handle_coda_error();
+    }
+    column->description = (str != NULL && str[0] != '\0') ? checked_strdup(str) : NULL;
+
+    /* the last dimension of string, raw, and complex data (length/size) is part of the element itself */
+    column->num_dims = dim_info.num_dims;
+    if (kind == arrow_value_string || kind == arrow_value_bytes || kind == arrow_value_complex)
+    {
+        column->num_dims--;
+    }
+    column->num_elements = 1;
+    column->nullable = 0;
+    for (i = 0; i < column->num_dims; i++)
+    {
+        column->dim[i] = dim_info.dim[i];
+        column->num_elements *= column->dim[i];
+        if (dim_info.is_var_size_dim[i])
+        {
+            column->nullable = 1;
+        }
+    }
+    for (i = 0; i < traverse_info.current_depth; i++)
+    {
+        coda_type_class type_class;
+
+        if (coda_type_get_class(traverse_info.type[i], &type_class) != 0)
+        {
+            handle_coda_error();
+        }
+        if (type_class == coda_record_class && traverse_info.field_available_status[i] == -1)
+        {
+            column->nullable = 1;
+            break;
+        }
+    }
+    num_values = column->num_elements * (kind == arrow_value_complex ? 2 : 1);
+
+    if (verbosity > 0)
+    {
+        print_full_field_name(stdout, 2, 1);
+        printf(" -> \"%s\"\n", column->name);
+    }
+
+    /* initialize the column writer */
+    arrow_info.current = column;
+    arrow_info.element_size = get_element_size(kind);
+    for (i = column->num_dims - 1; i >= 0; i--)
+    {
+        arrow_info.stride[i] = (i == column->num_dims - 1 ? 1 : arrow_info.stride[i + 1] * column->dim[i + 1]);
+    }
+    arrow_info.next_position = 0;
+    arrow_info.num_valid = 0;
+    arrow_info.data_length = 0;
+    arrow_info.validity = NULL;
+    arrow_info.offsets = NULL;
+
+    if (column->nullable)
+    {
+        validity_size = (num_values + 7) >> 3;
+        arrow_info.validity = checked_realloc(NULL, (size_t)(validity_size > 0 ? validity_size : 1));
+        memset(arrow_info.validity, 0, (size_t)validity_size);
+        validity_offset = reserve_body(validity_size);
+    }
+    if (arrow_info.element_size == 0)
+    {
+        arrow_info.offsets = checked_realloc(NULL, (size_t)(column->num_elements + 1) * sizeof(int32_t));
+        offsets_offset = reserve_body((column->num_elements + 1) * sizeof(int32_t));
+    }
+    data_offset = arrow_info.body_size;
+
+    /* write the data */
+    if (dim_info.num_dims == 0 || dim_info.filled_num_elements[dim_info.num_dims - 1] > 0)
+    {
+        write_data(0, 0, 0, 0);
+    }
+
+    /* finalize the column */
+    if (arrow_info.element_size > 0)
+    {
+        int64_t size = (column->num_elements - arrow_info.next_position) * arrow_info.element_size;
+
+        write_zeros(arrow_info.body, size);
+        arrow_info.body_size += size;
+    }
+    else
+    {
+        int64_t k;
+
+        for (k = arrow_info.next_position; k <= column->num_elements; k++)
+        {
+            arrow_info.offsets[k] = (int32_t)arrow_info.data_length;
+        }
+        write_body_at(offsets_offset, arrow_info.offsets, (column->num_elements + 1) * sizeof(int32_t));
+        free(arrow_info.offsets);
+    }
+    if (arrow_info.validity != NULL)
+    {
+        write_body_at(validity_offset, arrow_info.validity, validity_size);
+        free(arrow_info.validity);
+    }
+
+    /* add the nodes and buffers for this column */
+    for (i = 0; i < column->num_dims; i++)
+    {
+        add_node(i == 0 ? 1 : arrow_info.stride[i - 1] == 0 ? 0 : column->num_elements / arrow_info.stride[i - 1], 0);
+        add_buffer(0, 0);
+    }
+    if (kind == arrow_value_complex)
+    {
+        add_node(column->num_elements, 0);
+        add_buffer(0, 0);
+    }
+    add_node(column->num_dims > 0 || kind == arrow_value_complex ? num_values : 1, num_values - arrow_info.num_valid);
+    add_buffer(validity_offset, validity_size);
+    if (arrow_info.element_size == 0)
+    {
+        add_buffer(offsets_offset, (column->num_elements + 1) * sizeof(int32_t));
+        add_buffer(data_offset, arrow_info.data_length);
+    }
+    else
+    {
+        add_buffer(data_offset, column->num_elements * arrow_info.element_size);
+    }
+    pad_body();
+}
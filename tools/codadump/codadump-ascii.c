@@ -32,10 +32,26 @@
 #include "codadump.h"
 
 static int first_write_of_data = 1;
+static int separator_pending = 0;
+static int separator_record_depth;
 
-static void write_data(FILE *f, int depth, int array_depth, int record_depth);
+static void print_separator(void)
+{
+    separator_pending = 0;
+    if (first_write_of_data)
+    {
+        first_write_of_data = 0;
+    }
+    else
+    {
+        /* print data separator */
+        output_char('\n');
+    }
+}
+
+static void write_data(int depth, int array_depth, int record_depth);
 
-static void write_index(FILE *f)
+static void write_index(void)
 {
     int array_id;
     int i;
@@ -55,20 +71,21 @@ static void write_index(FILE *f)
 
             for (j = 0; j < traverse_info.array_info[array_id].num_dims; j++)
             {
-                fprintf(f, "%ld%s", (long)traverse_info.array_info[array_id].index[j], ascii_col_sep);
+                output_int64(traverse_info.array_info[array_id].index[j]);
+                output_string(ascii_col_sep);
             }
             array_id++;
         }
     }
 }
 
-static void write_basic_data(FILE *f, int depth)
+static void write_basic_data(int depth)
 {
     coda_type_class type_class;
 
     if (show_index)
     {
-        write_index(f);
+        write_index();
     }
 
     if (coda_type_get_class(traverse_info.type[depth], &type_class) != 0)
@@ -101,11 +118,13 @@ static void write_basic_data(FILE *f, int depth)
 
                             if (show_quotes)
                             {
-                                fprintf(f, "'%c'", data);
+                                output_char('\'');
+                                output_char(data);
+                                output_char('\'');
                             }
                             else
                             {
-                                fprintf(f, "%c", data);
+                                output_char(data);
                             }
                         }
                         break;
@@ -133,11 +152,13 @@ static void write_basic_data(FILE *f, int depth)
 
                             if (show_quotes)
                             {
-                                fprintf(f, "\"%s\"", data);
+                                output_char('"');
+                                output_string(data);
+                                output_char('"');
                             }
                             else
                             {
-                                fprintf(f, "%s", data);
+                                output_string(data);
                             }
 
                             free(data);
@@ -176,37 +197,37 @@ static void write_basic_data(FILE *f, int depth)
                                 switch (c)
                                 {
                                     case '\a':
-                                        fprintf(f, "\\a");
+                                        output_string("\\a");
                                         break;
                                     case '\b':
-                                        fprintf(f, "\\b");
+                                        output_string("\\b");
                                         break;
                                     case '\t':
-                                        fprintf(f, "\\t");
+                                        output_string("\\t");
                                         break;
                                     case '\n':
-                                        fprintf(f, "\\n");
+                                        output_string("\\n");
                                         break;
                                     case '\v':
-                                        fprintf(f, "\\v");
+                                        output_string("\\v");
                                         break;
                                     case '\f':
-                                        fprintf(f, "\\f");
+                                        output_string("\\f");
                                         break;
                                     case '\r':
-                                        fprintf(f, "\\r");
+                                        output_string("\\r");
                                         break;
                                     case '\\':
-                                        fprintf(f, "\\\\");
+                                        output_string("\\\\");
                                         break;
                                     default:
                                         if (c >= 32 && c <= 126)
                                         {
-                                            fprintf(f, "%c", c);
+                                            output_char(c);
                                         }
                                         else
                                         {
-                                            fprintf(f, "\\%03o", (int)(unsigned char)c);
+                                            output_printf("\\%03o", (int)(unsigned char)c);
                                         }
                                 }
                             }
@@ -225,7 +246,7 @@ static void write_basic_data(FILE *f, int depth)
                                 handle_coda_error();
                             }
 
-                            fprintf(f, "%ld", (long)data);
+                            output_int64(data);
                         }
                         break;
                     case coda_native_type_uint8:
@@ -239,38 +260,45 @@ static void write_basic_data(FILE *f, int depth)
                                 handle_coda_error();
                             }
 
-                            fprintf(f, "%lu", (unsigned long)data);
+                            output_uint64(data);
                         }
                         break;
                     case coda_native_type_int64:
                         {
                             int64_t data;
-                            char s[21];
 
                             if (coda_cursor_read_int64(&traverse_info.cursor, &data) != 0)
                             {
                                 handle_coda_error();
                             }
 
-                            coda_str64(data, s);
-                            fprintf(f, "%s", s);
+                            output_int64(data);
                         }
                         break;
                     case coda_native_type_uint64:
                         {
                             uint64_t data;
-                            char s[21];
 
                             if (coda_cursor_read_uint64(&traverse_info.cursor, &data) != 0)
                             {
                                 handle_coda_error();
                             }
 
-                            coda_str64u(data, s);
-                            fprintf(f, "%s", s);
+                            output_uint64(data);
                         }
                         break;
                     case coda_native_type_float:
+                        {
+                            float data;
+
+                            if (coda_cursor_read_float(&traverse_info.cursor, &data) != 0)
+                            {
+                                handle_coda_error();
+                            }
+
+                            output_float(data);
+                        }
+                        break;
                     case coda_native_type_double:
                         {
                             double data;
@@ -280,14 +308,7 @@ static void write_basic_data(FILE *f, int depth)
                                 handle_coda_error();
                             }
 
-                            if (read_type == coda_native_type_float)
-                            {
-                                fprintf(f, "%.7g", data);
-                            }
-                            else
-                            {
-                                fprintf(f, "%.16g", data);
-                            }
+                            output_double(data);
                         }
                         break;
                     case coda_native_type_not_available:
@@ -335,16 +356,18 @@ static void write_basic_data(FILE *f, int depth)
                                 }
                                 if (show_quotes)
                                 {
-                                    fprintf(f, "\"%s\"", str);
+                                    output_char('"');
+                                    output_string(str);
+                                    output_char('"');
                                 }
                                 else
                                 {
-                                    fprintf(f, "%s", str);
+                                    output_string(str);
                                 }
                             }
                             else
                             {
-                                fprintf(f, "%.16g", data);
+                                output_double(data);
                             }
                         }
                         break;
@@ -357,7 +380,7 @@ static void write_basic_data(FILE *f, int depth)
                                 handle_coda_error();
                             }
 
-                            fprintf(f, "%g%s%g", data[0], ascii_col_sep, data[1]);
+                            output_printf("%g%s%g", data[0], ascii_col_sep, data[1]);
                         }
                         break;
                 }
@@ -368,10 +391,10 @@ static void write_basic_data(FILE *f, int depth)
             assert(0);
             exit(1);
     }
-    fprintf(f, "\n");
+    output_char('\n');
 }
 
-static void write_data(FILE *f, int depth, int array_depth, int record_depth)
+static void write_data(int depth, int array_depth, int record_depth)
 {
     coda_type_class type_class;
 
@@ -393,33 +416,56 @@ static void write_data(FILE *f, int depth, int array_depth, int record_depth)
                 array_info = &traverse_info.array_info[array_depth];
                 dim_id = array_info->dim_id;
 
-                if (array_depth == 0)
+                if (!calc_dim)
                 {
-                    array_info->global_index = 0;
-                }
+                    long dim[MAX_NUM_DIMS];
+                    int num_dims;
 
-                has_var_dim_sub_array = (dim_info.last_var_size_dim >= dim_id + array_info->num_dims);
-                if (has_var_dim_sub_array && array_depth < traverse_info.num_arrays - 1)
-                {
-                    /* Set the index for the var_dim list(s) for the next array */
-                    traverse_info.array_info[array_depth + 1].global_index =
-                        array_info->global_index * array_info->num_elements;
+                    /* take the array size directly from the product */
+                    has_var_dim_sub_array = 0;
+                    if (coda_cursor_get_array_dim(&traverse_info.cursor, &num_dims, dim) != 0)
+                    {
+                        handle_coda_error();
+                    }
+                    assert(num_dims == array_info->num_dims);
+                    number_of_elements = 1;
+                    for (i = 0; i < array_info->num_dims; i++)
+                    {
+                        local_dim[i] = (int)dim[i];
+                        number_of_elements *= local_dim[i];
+                        array_info->index[i] = 0;
+                    }
                 }
-
-                /* calculate local dimensions and number of array elements */
-                number_of_elements = 1;
-                for (i = 0; i < array_info->num_dims; i++)
+                else
                 {
-                    if (dim_info.is_var_size_dim[dim_id + i])
+                    if (array_depth == 0)
                     {
-                        local_dim[i] = dim_info.var_dim[dim_id + i][array_info->global_index];
+                        array_info->global_index = 0;
                     }
-                    else
+
+                    has_var_dim_sub_array = (dim_info.last_var_size_dim >= dim_id + array_info->num_dims);
+                    if (has_var_dim_sub_array && array_depth < traverse_info.num_arrays - 1)
                     {
-                        local_dim[i] = dim_info.dim[dim_id + i];
+                        /* Set the index for the var_dim list(s) for the next array */
+                        traverse_info.array_info[array_depth + 1].global_index =
+                            array_info->global_index * array_info->num_elements;
+                    }
+
+                    /* calculate local dimensions and number of array elements */
+                    number_of_elements = 1;
+                    for (i = 0; i < array_info->num_dims; i++)
+                    {
+                        if (dim_info.is_var_size_dim[dim_id + i])
+                        {
+                            local_dim[i] = dim_info.var_dim[dim_id + i][array_info->global_index];
+                        }
+                        else
+                        {
+                            local_dim[i] = dim_info.dim[dim_id + i];
+                        }
+                        number_of_elements *= local_dim[i];
+                        array_info->index[i] = 0;
                     }
-                    number_of_elements *= local_dim[i];
-                    array_info->index[i] = 0;
                 }
                 if (number_of_elements == 0)
                 {
@@ -427,6 +473,18 @@ static void write_data(FILE *f, int depth, int array_depth, int record_depth)
                     return;
                 }
 
+                if (!show_index && depth + 1 == traverse_info.current_depth)
+                {
+                    /* the array elements are the data element that is exported, so if these are plain numbers we
+                     * can read and write all elements at once
+                     */
+                    if (output_numeric_array(&traverse_info.cursor, number_of_elements, 0, "", "\n"))
+                    {
+                        output_char('\n');
+                        return;
+                    }
+                }
+
                 /* traverse array */
                 if (coda_cursor_goto_first_array_element(&traverse_info.cursor) != 0)
                 {
@@ -435,7 +493,7 @@ static void write_data(FILE *f, int depth, int array_depth, int record_depth)
                 for (i = 0; i < number_of_elements; i++)
                 {
                     /* write data for current array element */
-                    write_data(f, depth + 1, array_depth + 1, record_depth);
+                    write_data(depth + 1, array_depth + 1, record_depth);
 
                     if (i < number_of_elements - 1)
                     {
@@ -483,45 +541,79 @@ static void write_data(FILE *f, int depth, int array_depth, int record_depth)
                 /* if the field is not available just don't print it */
                 if (available)
                 {
+                    if (separator_pending && record_depth == separator_record_depth)
+                    {
+                        /* the data element is available at least once, so it is part of the output */
+                        print_separator();
+                    }
                     if (coda_cursor_goto_record_field_by_index(&traverse_info.cursor,
                                                                traverse_info.parent_index[record_depth]) != 0)
                     {
                         handle_coda_error();
                     }
-                    write_data(f, depth + 1, array_depth, record_depth + 1);
+                    write_data(depth + 1, array_depth, record_depth + 1);
                     coda_cursor_goto_parent(&traverse_info.cursor);
                 }
             }
             break;
         default:
-            write_basic_data(f, depth);
+            write_basic_data(depth);
             break;
     }
 }
 
 void export_data_element_to_ascii()
 {
-    if (first_write_of_data)
-    {
-        first_write_of_data = 0;
-    }
-    else
+    if (show_label)
     {
-        /* print data separator */
+        print_separator();
+        output_flush();
+        print_full_field_name(ascii_output, 2, 0);
         fprintf(ascii_output, "\n");
     }
+    else if (!calc_dim)
+    {
+        int record_depth = 0;
+        int i;
+
+        /* Without the dimension pass, data elements below a dynamically available record field are not skipped up
+         * front if the field is not available anywhere in the product. We then only print the separator once we find
+         * an occurrence of the deepest of these fields (which gives the same output as with the dimension pass).
+         */
+        for (i = 0; i < traverse_info.current_depth; i++)
+        {
+            coda_type_class type_class;
 
-    if (show_label)
+            if (coda_type_get_class(traverse_info.type[i], &type_class) != 0)
+            {
+                handle_coda_error();
+            }
+            if (type_class == coda_record_class)
+            {
+                if (traverse_info.field_available_status[i] == -1)
+                {
+                    separator_pending = 1;
+                    separator_record_depth = record_depth;
+                }
+                record_depth++;
+            }
+        }
+        if (!separator_pending)
+        {
+            print_separator();
+        }
+    }
+    else
     {
-        print_full_field_name(ascii_output, 2, 0);
-        fprintf(ascii_output, "\n");
+        print_separator();
     }
 
-    if (dim_info.num_dims > 0 && dim_info.filled_num_elements[dim_info.num_dims - 1] == 0)
+    if (calc_dim && dim_info.num_dims > 0 && dim_info.filled_num_elements[dim_info.num_dims - 1] == 0)
     {
         /* no data */
         return;
     }
 
-    write_data(ascii_output, 0, 0, 0);
+    write_data(0, 0, 0);
+    separator_pending = 0;
 }
@@ -31,8 +31,6 @@
 
 #include "codadump.h"
 
-#include <stdarg.h>
-
 static int INDENT = 0;
 
 static int print_offsets = 1;
@@ -44,36 +42,10 @@ static void indent(void)
     assert(INDENT >= 0);
     for (i = INDENT; i > 0; i--)
     {
-        fprintf(ascii_output, "  ");
+        output_string("  ");
     }
 }
 
-static int ff_printf(const char *templ, ...)
-{
-    int result;
-    va_list ap;
-
-    va_start(ap, templ);
-    result = vfprintf(ascii_output, templ, ap);
-    va_end(ap);
-
-    return result;
-}
-
-static int fi_printf(const char *templ, ...)
-{
-    int result;
-    va_list ap;
-
-    indent();
-
-    va_start(ap, templ);
-    result = vfprintf(ascii_output, templ, ap);
-    va_end(ap);
-
-    return result;
-}
-
 static void print_escaped(const char *data, long length)
 {
     long i;
@@ -86,37 +58,37 @@ static void print_escaped(const char *data, long length)
         switch (c)
         {
             case '\a':
-                ff_printf("\\a");
+                output_string("\\a");
                 break;
             case '\b':
-                ff_printf("\\b");
+                output_string("\\b");
                 break;
             case '\t':
-                ff_printf("\\t");
+                output_string("\\t");
                 break;
             case '\n':
-                ff_printf("\\n");
+                output_string("\\n");
                 break;
             case '\v':
-                ff_printf("\\v");
+                output_string("\\v");
                 break;
             case '\f':
-                ff_printf("\\f");
+                output_string("\\f");
                 break;
             case '\r':
-                ff_printf("\\r");
+                output_string("\\r");
                 break;
             case '\\':
-                ff_printf("\\\\");
+                output_string("\\\\");
                 break;
             default:
                 if (c >= 32 && c <= 126)
                 {
-                    ff_printf("%c", c);
+                    output_char(c);
                 }
                 else
                 {
-                    ff_printf("\\%03o", (int)(unsigned char)c);
+                    output_printf("\\%03o", (int)(unsigned char)c);
                 }
         }
     }
@@ -137,7 +109,8 @@ static void print_data(coda_cursor *cursor, int depth)
         {
             handle_coda_error();
         }
-        fi_printf("{attributes}\n");
+        indent();
+        output_string("{attributes}\n");
         INDENT++;
         print_data(cursor, depth);
         INDENT--;
@@ -189,7 +162,10 @@ static void print_data(coda_cursor *cursor, int depth)
                         {
                             handle_coda_error();
                         }
-                        fi_printf("[%s]", field_name);
+                        indent();
+                        output_char('[');
+                        output_string(field_name);
+                        output_char(']');
                         if (print_offsets)
                         {
                             int64_t offset;
@@ -200,17 +176,16 @@ static void print_data(coda_cursor *cursor, int depth)
                             }
                             if (offset >= 0)
                             {
-                                char s[21];
-
-                                coda_str64(offset >> 3, s);
-                                ff_printf(":%s", s);
+                                output_char(':');
+                                output_int64(offset >> 3);
                                 if ((offset & 0x7) != 0)
                                 {
-                                    ff_printf(":%d", (int)(offset & 0x7));
+                                    output_char(':');
+                                    output_int64(offset & 0x7);
                                 }
                             }
                         }
-                        ff_printf("\n");
+                        output_char('\n');
                         INDENT++;
                         if (max_depth < 0 || depth < max_depth)
                         {
@@ -218,7 +193,8 @@ static void print_data(coda_cursor *cursor, int depth)
                         }
                         else
                         {
-                            fi_printf("...\n");
+                            indent();
+                            output_string("...\n");
                         }
                         INDENT--;
                         coda_cursor_goto_parent(cursor);
@@ -237,7 +213,10 @@ static void print_data(coda_cursor *cursor, int depth)
                             {
                                 handle_coda_error();
                             }
-                            fi_printf("[%s]", field_name);
+                            indent();
+                            output_char('[');
+                            output_string(field_name);
+                            output_char(']');
                             if (print_offsets)
                             {
                                 int64_t offset;
@@ -248,17 +227,16 @@ static void print_data(coda_cursor *cursor, int depth)
                                 }
                                 if (offset >= 0)
                                 {
-                                    char s[21];
-
-                                    coda_str64(offset >> 3, s);
-                                    ff_printf(":%s", s);
+                                    output_char(':');
+                                    output_int64(offset >> 3);
                                     if ((offset & 0x7) != 0)
                                     {
-                                        ff_printf(":%d", (int)(offset & 0x7));
+                                        output_char(':');
+                                        output_int64(offset & 0x7);
                                     }
                                 }
                             }
-                            ff_printf("\n");
+                            output_char('\n');
                             INDENT++;
                             if (max_depth < 0 || depth < max_depth)
                             {
@@ -266,7 +244,8 @@ static void print_data(coda_cursor *cursor, int depth)
                             }
                             else
                             {
-                                fi_printf("...\n");
+                                indent();
+                                output_string("...\n");
                             }
                             INDENT--;
                             if (i < num_fields - 1)
@@ -313,16 +292,17 @@ static void print_data(coda_cursor *cursor, int depth)
                         {
                             int k;
 
-                            fi_printf("(");
+                            indent();
+                            output_char('(');
                             for (k = 0; k < num_dims; k++)
                             {
-                                ff_printf("%d", index[k]);
+                                output_int64(index[k]);
                                 if (k < num_dims - 1)
                                 {
-                                    ff_printf(",");
+                                    output_char(',');
                                 }
                             }
-                            ff_printf(")");
+                            output_char(')');
                             if (print_offsets)
                             {
                                 int64_t offset;
@@ -333,17 +313,16 @@ static void print_data(coda_cursor *cursor, int depth)
                                 }
                                 if (offset >= 0)
                                 {
-                                    char s[21];
-
-                                    coda_str64(offset >> 3, s);
-                                    ff_printf(":%s", s);
+                                    output_char(':');
+                                    output_int64(offset >> 3);
                                     if ((offset & 0x7) != 0)
                                     {
-                                        ff_printf(":%d", (int)(offset & 0x7));
+                                        output_char(':');
+                                        output_int64(offset & 0x7);
                                     }
                                 }
                             }
-                            ff_printf("\n");
+                            output_char('\n');
                             INDENT++;
                             if (max_depth < 0 || depth < max_depth)
                             {
@@ -351,7 +330,8 @@ static void print_data(coda_cursor *cursor, int depth)
                             }
                             else
                             {
-                                fi_printf("...\n");
+                                indent();
+                                output_string("...\n");
                             }
                             INDENT--;
 
@@ -415,9 +395,12 @@ static void print_data(coda_cursor *cursor, int depth)
                         handle_coda_error();
                     }
 
-                    fi_printf("\"");
+                    indent();
+                    output_char('"');
                     print_escaped(data, length);
-                    ff_printf("\" (length=%ld)\n", length);
+                    output_string("\" (length=");
+                    output_int64(length);
+                    output_string(")\n");
                     free(data);
                 }
 
@@ -432,7 +415,6 @@ static void print_data(coda_cursor *cursor, int depth)
                             int64_t bit_size;
                             int64_t byte_size;
                             uint8_t *data;
-                            char s[21];
 
                             if (coda_cursor_get_bit_size(cursor, &bit_size) != 0)
                             {
@@ -452,16 +434,17 @@ static void print_data(coda_cursor *cursor, int depth)
                                 handle_coda_error();
                             }
 
-                            fi_printf("\"");
+                            indent();
+                            output_char('"');
                             print_escaped((char *)data, (long)byte_size);
-                            ff_printf("\" (size=");
-                            coda_str64(bit_size >> 3, s);
-                            ff_printf("%s", s);
+                            output_string("\" (size=");
+                            output_int64(bit_size >> 3);
                             if ((bit_size & 0x7) != 0)
                             {
-                                ff_printf(":%d", (int)(bit_size & 0x7));
+                                output_char(':');
+                                output_int64(bit_size & 0x7);
                             }
-                            ff_printf(")\n");
+                            output_string(")\n");
 
                             free(data);
                         }
@@ -477,7 +460,9 @@ static void print_data(coda_cursor *cursor, int depth)
                                 handle_coda_error();
                             }
 
-                            fi_printf("%ld\n", (long)data);
+                            indent();
+                            output_int64(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_native_type_uint8:
@@ -491,38 +476,53 @@ static void print_data(coda_cursor *cursor, int depth)
                                 handle_coda_error();
                             }
 
-                            fi_printf("%lu\n", (unsigned long)data);
+                            indent();
+                            output_uint64(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_native_type_int64:
                         {
                             int64_t data;
-                            char s[21];
 
                             if (coda_cursor_read_int64(cursor, &data) != 0)
                             {
                                 handle_coda_error();
                             }
 
-                            coda_str64(data, s);
-                            fi_printf("%s\n", s);
+                            indent();
+                            output_int64(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_native_type_uint64:
                         {
                             uint64_t data;
-                            char s[21];
 
                             if (coda_cursor_read_uint64(cursor, &data) != 0)
                             {
                                 handle_coda_error();
                             }
 
-                            coda_str64u(data, s);
-                            fi_printf("%s\n", s);
+                            indent();
+                            output_uint64(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_native_type_float:
+                        {
+                            float data;
+
+                            if (coda_cursor_read_float(cursor, &data) != 0)
+                            {
+                                handle_coda_error();
+                            }
+
+                            indent();
+                            output_float(data);
+                            output_char('\n');
+                        }
+                        break;
                     case coda_native_type_double:
                         {
                             double data;
@@ -532,14 +532,9 @@ static void print_data(coda_cursor *cursor, int depth)
                                 handle_coda_error();
                             }
 
-                            if (read_type == coda_native_type_float)
-                            {
-                                fi_printf("%.7g\n", data);
-                            }
-                            else
-                            {
-                                fi_printf("%.16g\n", data);
-                            }
+                            indent();
+                            output_double(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_native_type_char:
@@ -570,11 +565,14 @@ static void print_data(coda_cursor *cursor, int depth)
                     print_data(&base_cursor, depth);
                 }
 
-                fi_printf("<%s>", coda_type_get_special_type_name(special_type));
+                indent();
+                output_char('<');
+                output_string(coda_type_get_special_type_name(special_type));
+                output_char('>');
                 switch (special_type)
                 {
                     case coda_special_no_data:
-                        ff_printf("\n");
+                        output_char('\n');
                         break;
                     case coda_special_vsf_integer:
                         {
@@ -585,7 +583,8 @@ static void print_data(coda_cursor *cursor, int depth)
                                 handle_coda_error();
                             }
 
-                            ff_printf("%.16g\n", data);
+                            output_double(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_special_time:
@@ -599,17 +598,21 @@ static void print_data(coda_cursor *cursor, int depth)
                             }
                             if (coda_isNaN(data) || coda_isInf(data))
                             {
-                                ff_printf(" %.16g\n", data);
+                                output_char(' ');
+                                output_double(data);
+                                output_char('\n');
                             }
                             else
                             {
                                 if (coda_time_double_to_string(data, "yyyy-MM-dd HH:mm:ss.SSSSSS", str) != 0)
                                 {
-                                    ff_printf(" {--invalid time value--}\n");
+                                    output_string(" {--invalid time value--}\n");
                                 }
                                 else
                                 {
-                                    ff_printf(" %s\n", str);
+                                    output_char(' ');
+                                    output_string(str);
+                                    output_char('\n');
                                 }
                             }
                         }
@@ -623,7 +626,7 @@ static void print_data(coda_cursor *cursor, int depth)
                                 handle_coda_error();
                             }
 
-                            ff_printf(" %g + %gi\n", re, im);
+                            output_printf(" %g + %gi\n", re, im);
                         }
                         break;
                 }
@@ -689,6 +692,7 @@ void print_debug_data(const char *product_class, const char *product_type, int f
 
     coda_set_option_perform_boundary_checks(0);
     print_data(&cursor, 0);
+    output_flush();
 
     coda_close(pf);
 }
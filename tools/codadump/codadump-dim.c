@@ -31,6 +31,10 @@
 
 #include "codadump.h"
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 void dim_info_init()
 {
     dim_info.num_dims = 0;
@@ -93,13 +97,335 @@ void print_all_distinct_dims(int dim_id)
     free(dims);
 }
 
-static void get_all_dims_for_array(int depth, int array_depth, int record_depth)
+/* state of a (partial) traversal that determines the sizes of variable sized dimensions */
+typedef struct dim_scan_struct
+{
+    coda_cursor *cursor;
+    int32_t global_index[CODA_CURSOR_MAXDEPTH]; /* cumulative index within all elements for each parent array */
+    int32_t *dim;       /* maximum dimension found so far (-1 if none found yet) */
+    int32_t *min_dim;   /* minimum dimension found so far */
+} dim_scan;
+
+static int get_all_dims_for_array(dim_scan *scan, int depth, int array_depth, int record_depth);
+
+static void update_dim(dim_scan *scan, int dim_id, int32_t value)
+{
+    if (scan->dim[dim_id] == -1)
+    {
+        scan->dim[dim_id] = value;
+        scan->min_dim[dim_id] = value;
+    }
+    else
+    {
+        if (scan->dim[dim_id] < value)
+        {
+            scan->dim[dim_id] = value;
+        }
+        if (scan->min_dim[dim_id] > value)
+        {
+            scan->min_dim[dim_id] = value;
+        }
+    }
+}
+
+#ifdef HAVE_PTHREAD
+
+/* minimum number of elements that a top-level array should have before it is traversed in parallel */
+#define MIN_PARALLEL_ARRAY_ELEMENTS 64
+/* number of element ranges per thread in which a top-level array is split (to balance the load over threads) */
+#define RANGES_PER_THREAD 4
+
+typedef struct dim_range_struct
+{
+    coda_cursor cursor; /* cursor positioned at the first element of the range */
+    long num_elements;
+    dim_scan scan;
+    int32_t dim[MAX_NUM_DIMS];
+    int32_t min_dim[MAX_NUM_DIMS];
+} dim_range;
+
+/* CODA options are thread local, so the worker threads need to set the same options as the main thread */
+typedef struct coda_options_struct
+{
+    long auto_prefetch;
+    long bit_size_cache_max_entries;
+    long block_cache_block_size;
+    long block_cache_num_blocks;
+    int bypass_special_types;
+    int decompress_gzip;
+    long gzip_checkpoint_distance;
+    int gzip_use_index_file;
+    int perform_boundary_checks;
+    int perform_conversions;
+    int profile_expressions;
+    int use_fast_size_expressions;
+    int use_mmap;
+} coda_options;
+
+typedef struct dim_range_queue_struct
+{
+    dim_range *range;
+    int num_ranges;
+    int next_range;
+    int depth;
+    int record_depth;
+    coda_options options;
+    pthread_mutex_t mutex;
+
+    /* the first error that occurred (it is reported by the main thread once all threads are finished) */
+    int error;
+    char *error_message;
+} dim_range_queue;
+
+static void get_coda_options(coda_options *options)
+{
+    options->auto_prefetch = coda_get_option_auto_prefetch();
+    options->bit_size_cache_max_entries = coda_get_option_bit_size_cache();
+    coda_get_option_block_cache(&options->block_cache_block_size, &options->block_cache_num_blocks);
+    options->bypass_special_types = coda_get_option_bypass_special_types();
+    options->decompress_gzip = coda_get_option_decompress_gzip();
+    coda_get_option_gzip_index(&options->gzip_checkpoint_distance, &options->gzip_use_index_file);
+    options->perform_boundary_checks = coda_get_option_perform_boundary_checks();
+    options->perform_conversions = coda_get_option_perform_conversions();
+    options->profile_expressions = coda_get_option_profile_expressions();
+    options->use_fast_size_expressions = coda_get_option_use_fast_size_expressions();
+    options->use_mmap = coda_get_option_use_mmap();
+}
+
+static int init_coda_with_options(const coda_options *options)
+{
+    if (set_definition_path() != 0)
+    {
+        return -1;
+    }
+    /* this needs to be set before coda_init(), since that already reads the detection rules */
+    coda_set_option_profile_expressions(options->profile_expressions);
+    if (coda_init() != 0)
+    {
+        return -1;
+    }
+    coda_set_option_auto_prefetch(options->auto_prefetch);
+    coda_set_option_bit_size_cache(options->bit_size_cache_max_entries);
+    coda_set_option_block_cache(options->block_cache_block_size, options->block_cache_num_blocks);
+    coda_set_option_bypass_special_types(options->bypass_special_types);
+    coda_set_option_decompress_gzip(options->decompress_gzip);
+    coda_set_option_gzip_index(options->gzip_checkpoint_distance, options->gzip_use_index_file);
+    coda_set_option_perform_boundary_checks(options->perform_boundary_checks);
+    coda_set_option_perform_conversions(options->perform_conversions);
+    coda_set_option_use_fast_size_expressions(options->use_fast_size_expressions);
+    coda_set_option_use_mmap(options->use_mmap);
+
+    return 0;
+}
+
+/* store the current CODA error of this thread as error of the queue (unless an error was already stored) */
+static void set_queue_error(dim_range_queue *queue)
+{
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->error == 0)
+    {
+        queue->error = coda_errno;
+        queue->error_message = strdup(coda_errno_to_string(coda_errno));
+    }
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+static void process_dim_ranges(dim_range_queue *queue)
+{
+    pthread_mutex_lock(&queue->mutex);
+    while (queue->next_range < queue->num_ranges && queue->error == 0)
+    {
+        dim_range *range = &queue->range[queue->next_range];
+        long i;
+
+        queue->next_range++;
+        pthread_mutex_unlock(&queue->mutex);
+
+        for (i = 0; i < range->num_elements; i++)
+        {
+            if (get_all_dims_for_array(&range->scan, queue->depth + 1, 1, queue->record_depth) != 0)
+            {
+                set_queue_error(queue);
+                break;
+            }
+            if (i < range->num_elements - 1)
+            {
+                if (coda_cursor_goto_next_array_element(&range->cursor) != 0)
+                {
+                    set_queue_error(queue);
+                    break;
+                }
+                range->scan.global_index[1]++;
+            }
+        }
+
+        pthread_mutex_lock(&queue->mutex);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+static void *dim_range_worker(void *userdata)
+{
+    dim_range_queue *queue = (dim_range_queue *)userdata;
+
+    /* the product is shared with the main thread, but each thread needs to initialize CODA itself */
+    if (init_coda_with_options(&queue->options) != 0)
+    {
+        /* the ranges are then processed by the other threads */
+        return NULL;
+    }
+
+    process_dim_ranges(queue);
+
+    coda_done();
+
+    return NULL;
+}
+
+/* traverse the elements of the top-level array (at which scan->cursor is positioned) by dividing them in ranges that
+ * are processed in parallel.
+ */
+static int get_all_dims_for_array_parallel(dim_scan *scan, int depth, int record_depth, long number_of_elements)
+{
+    array_info_t *array_info;
+    dim_range_queue queue;
+    pthread_t *thread;
+    coda_cursor cursor;
+    int num_running_threads = 0;
+    long range_size;
+    long index;
+    int i;
+    int k;
+
+    array_info = &traverse_info.array_info[0];
+
+    queue.num_ranges = num_threads * RANGES_PER_THREAD;
+    if (queue.num_ranges > number_of_elements)
+    {
+        queue.num_ranges = (int)number_of_elements;
+    }
+    queue.range = (dim_range *)malloc(queue.num_ranges * sizeof(dim_range));
+    if (queue.range == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       queue.num_ranges * sizeof(dim_range), __FILE__, __LINE__);
+        return -1;
+    }
+    thread = (pthread_t *)malloc((num_threads - 1) * sizeof(pthread_t));
+    if (thread == NULL)
+    {
+        coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                       (num_threads - 1) * sizeof(pthread_t), __FILE__, __LINE__);
+        free(queue.range);
+        return -1;
+    }
+
+    /* locate the first element of each range with a single walk over the array (for variable sized elements, going
+     * to an element by index would require a walk from the start of the array for each range)
+     */
+    range_size = number_of_elements / queue.num_ranges;
+    cursor = *scan->cursor;
+    if (coda_cursor_goto_first_array_element(&cursor) != 0)
+    {
+        free(thread);
+        free(queue.range);
+        return -1;
+    }
+    index = 0;
+    for (i = 0; i < queue.num_ranges; i++)
+    {
+        dim_range *range = &queue.range[i];
+
+        while (index < i * range_size)
+        {
+            if (coda_cursor_goto_next_array_element(&cursor) != 0)
+            {
+                free(thread);
+                free(queue.range);
+                return -1;
+            }
+            index++;
+        }
+        range->cursor = cursor;
+        range->num_elements = (i == queue.num_ranges - 1 ? number_of_elements - i * range_size : range_size);
+        range->scan = *scan;
+        range->scan.cursor = &range->cursor;
+        range->scan.global_index[1] = scan->global_index[0] * array_info->num_elements + (int32_t)index;
+        range->scan.dim = range->dim;
+        range->scan.min_dim = range->min_dim;
+        for (k = 0; k < MAX_NUM_DIMS; k++)
+        {
+            range->dim[k] = -1;
+            range->min_dim[k] = -1;
+        }
+    }
+
+    queue.next_range = 0;
+    queue.depth = depth;
+    queue.record_depth = record_depth;
+    get_coda_options(&queue.options);
+    queue.error = 0;
+    queue.error_message = NULL;
+    pthread_mutex_init(&queue.mutex, NULL);
+
+    for (i = 0; i < num_threads - 1; i++)
+    {
+        if (pthread_create(&thread[num_running_threads], NULL, dim_range_worker, &queue) == 0)
+        {
+            num_running_threads++;
+        }
+    }
+    /* the calling thread also takes part in the processing */
+    process_dim_ranges(&queue);
+    for (i = 0; i < num_running_threads; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+    pthread_mutex_destroy(&queue.mutex);
+    free(thread);
+
+    if (queue.error != 0)
+    {
+        if (queue.error_message != NULL)
+        {
+            coda_set_error(queue.error, "%s", queue.error_message);
+            free(queue.error_message);
+        }
+        else
+        {
+            coda_set_error(queue.error, NULL);
+        }
+        free(queue.range);
+        return -1;
+    }
+
+    /* merge the dimensions that were found for each range */
+    for (i = 0; i < queue.num_ranges; i++)
+    {
+        for (k = 0; k < MAX_NUM_DIMS; k++)
+        {
+            if (queue.range[i].dim[k] != -1)
+            {
+                update_dim(scan, k, queue.range[i].dim[k]);
+                update_dim(scan, k, queue.range[i].min_dim[k]);
+            }
+        }
+    }
+
+    free(queue.range);
+
+    return 0;
+}
+
+#endif
+
+static int get_all_dims_for_array(dim_scan *scan, int depth, int array_depth, int record_depth)
 {
     coda_type_class type_class;
 
-    if (coda_cursor_get_type_class(&traverse_info.cursor, &type_class) != 0)
+    if (coda_cursor_get_type_class(scan->cursor, &type_class) != 0)
     {
-        handle_coda_error();
+        return -1;
     }
 
     switch (type_class)
@@ -118,32 +444,17 @@ static void get_all_dims_for_array(int depth, int array_depth, int record_depth)
                     int num_dims;
                     int i;
 
-                    if (coda_cursor_get_array_dim(&traverse_info.cursor, &num_dims, var_dim) != 0)
+                    if (coda_cursor_get_array_dim(scan->cursor, &num_dims, var_dim) != 0)
                     {
-                        handle_coda_error();
+                        return -1;
                     }
                     assert(num_dims == array_info->num_dims);
                     for (i = 0; i < array_info->num_dims; i++)
                     {
                         if (array_info->dim[i] == -1)   /* variable sized dimension? */
                         {
-                            dim_info.var_dim[dim_id + i][array_info->global_index] = var_dim[i];
-                            if (dim_info.dim[dim_id + i] == -1)
-                            {
-                                dim_info.dim[dim_id + i] = var_dim[i];
-                                dim_info.min_dim[dim_id + i] = var_dim[i];
-                            }
-                            else
-                            {
-                                if (dim_info.dim[dim_id + i] < var_dim[i])
-                                {
-                                    dim_info.dim[dim_id + i] = var_dim[i];
-                                }
-                                if (dim_info.min_dim[dim_id + i] > var_dim[i])
-                                {
-                                    dim_info.min_dim[dim_id + i] = var_dim[i];
-                                }
-                            }
+                            dim_info.var_dim[dim_id + i][scan->global_index[array_depth]] = var_dim[i];
+                            update_dim(scan, dim_id + i, (int32_t)var_dim[i]);
                         }
                     }
                 }
@@ -155,44 +466,56 @@ static void get_all_dims_for_array(int depth, int array_depth, int record_depth)
 
                     if (array_depth == 0)
                     {
-                        array_info->global_index = 0;
+                        scan->global_index[0] = 0;
                     }
-                    traverse_info.array_info[array_depth + 1].global_index =
-                        array_info->global_index * array_info->num_elements;
+                    scan->global_index[array_depth + 1] = scan->global_index[array_depth] * array_info->num_elements;
 
                     number_of_elements = 1;
                     for (i = dim_id; i < dim_id + array_info->num_dims; i++)
                     {
                         if (dim_info.is_var_size_dim[i])
                         {
-                            number_of_elements *= dim_info.var_dim[i][array_info->global_index];
+                            number_of_elements *= dim_info.var_dim[i][scan->global_index[array_depth]];
                         }
                         else
                         {
                             number_of_elements *= dim_info.dim[i];
                         }
                     }
+#ifdef HAVE_PTHREAD
+                    if (array_depth == 0 && num_threads > 1 && number_of_elements >= MIN_PARALLEL_ARRAY_ELEMENTS)
+                    {
+                        if (get_all_dims_for_array_parallel(scan, depth, record_depth, number_of_elements) != 0)
+                        {
+                            return -1;
+                        }
+                        break;
+                    }
+#endif
                     if (number_of_elements > 0)
                     {
                         int i;
 
-                        if (coda_cursor_goto_first_array_element(&traverse_info.cursor) != 0)
+                        if (coda_cursor_goto_first_array_element(scan->cursor) != 0)
                         {
-                            handle_coda_error();
+                            return -1;
                         }
                         for (i = 0; i < number_of_elements; i++)
                         {
-                            get_all_dims_for_array(depth + 1, array_depth + 1, record_depth);
+                            if (get_all_dims_for_array(scan, depth + 1, array_depth + 1, record_depth) != 0)
+                            {
+                                return -1;
+                            }
                             if (i < number_of_elements - 1)
                             {
-                                if (coda_cursor_goto_next_array_element(&traverse_info.cursor) != 0)
+                                if (coda_cursor_goto_next_array_element(scan->cursor) != 0)
                                 {
-                                    handle_coda_error();
+                                    return -1;
                                 }
-                                traverse_info.array_info[array_depth + 1].global_index++;
+                                scan->global_index[array_depth + 1]++;
                             }
                         }
-                        coda_cursor_goto_parent(&traverse_info.cursor);
+                        coda_cursor_goto_parent(scan->cursor);
                     }
                 }
             }
@@ -201,21 +524,24 @@ static void get_all_dims_for_array(int depth, int array_depth, int record_depth)
             {
                 int available;
 
-                if (coda_cursor_get_record_field_available_status(&traverse_info.cursor,
+                if (coda_cursor_get_record_field_available_status(scan->cursor,
                                                                   traverse_info.parent_index[record_depth],
                                                                   &available) != 0)
                 {
-                    handle_coda_error();
+                    return -1;
                 }
                 if (available)
                 {
-                    if (coda_cursor_goto_record_field_by_index(&traverse_info.cursor,
+                    if (coda_cursor_goto_record_field_by_index(scan->cursor,
                                                                traverse_info.parent_index[record_depth]) != 0)
                     {
-                        handle_coda_error();
+                        return -1;
                     }
-                    get_all_dims_for_array(depth + 1, array_depth, record_depth + 1);
-                    coda_cursor_goto_parent(&traverse_info.cursor);
+                    if (get_all_dims_for_array(scan, depth + 1, array_depth, record_depth + 1) != 0)
+                    {
+                        return -1;
+                    }
+                    coda_cursor_goto_parent(scan->cursor);
                 }
                 else
                 {
@@ -231,12 +557,8 @@ static void get_all_dims_for_array(int depth, int array_depth, int record_depth)
                     {
                         if (array_info->dim[i] == -1)   /* variable sized dimension? */
                         {
-                            dim_info.var_dim[dim_id + i][array_info->global_index] = 0;
-                            if (dim_info.dim[dim_id + i] == -1)
-                            {
-                                dim_info.dim[dim_id + i] = 0;
-                            }
-                            dim_info.min_dim[dim_id + i] = 0;
+                            dim_info.var_dim[dim_id + i][scan->global_index[traverse_info.num_arrays]] = 0;
+                            update_dim(scan, dim_id + i, 0);
                         }
                     }
                 }
@@ -255,45 +577,32 @@ static void get_all_dims_for_array(int depth, int array_depth, int record_depth)
                 {
                     long length;
 
-                    if (coda_cursor_get_string_length(&traverse_info.cursor, &length) != 0)
+                    if (coda_cursor_get_string_length(scan->cursor, &length) != 0)
                     {
-                        handle_coda_error();
+                        return -1;
                     }
                     size = length;
                 }
                 else
                 {
-                    if (coda_cursor_get_byte_size(&traverse_info.cursor, &size) != 0)
+                    if (coda_cursor_get_byte_size(scan->cursor, &size) != 0)
                     {
-                        handle_coda_error();
+                        return -1;
                     }
                 }
 
                 array_info = &traverse_info.array_info[array_depth];
                 dim_id = array_info->dim_id;
-                dim_info.var_dim[dim_id][array_info->global_index] = (int)size;
-                if (dim_info.dim[dim_id] == -1)
-                {
-                    dim_info.dim[dim_id] = (int)size;
-                    dim_info.min_dim[dim_id] = (int)size;
-                }
-                else
-                {
-                    if (dim_info.dim[dim_id] < size)
-                    {
-                        dim_info.dim[dim_id] = (int)size;
-                    }
-                    if (dim_info.min_dim[dim_id] > size)
-                    {
-                        dim_info.min_dim[dim_id] = (int)size;
-                    }
-                }
+                dim_info.var_dim[dim_id][scan->global_index[array_depth]] = (int)size;
+                update_dim(scan, dim_id, (int32_t)size);
             }
             break;
         default:
             assert(0);
             exit(1);
     }
+
+    return 0;
 }
 
 void dim_enter_array()
@@ -302,6 +611,7 @@ void dim_enter_array()
     array_info_t *array_info;
     int64_t array_count;        /* maximum possible number of these arrays in the product */
     int64_t filled_array_count; /* real count of number of these arrays in the product */
+    dim_scan scan;
     int dd_var_size;    /* is the array variable sized according to the data dictionary */
     int is_var_size;    /* is the array really variable sized */
     int dim_id;
@@ -467,8 +777,14 @@ void dim_enter_array()
                 dim_info.var_dim[dim_id + i] = NULL;
             }
         }
-        array_info->global_index = 0;
-        get_all_dims_for_array(0, 0, 0);
+        scan.cursor = &traverse_info.cursor;
+        scan.global_index[0] = 0;
+        scan.dim = dim_info.dim;
+        scan.min_dim = dim_info.min_dim;
+        if (get_all_dims_for_array(&scan, 0, 0, 0) != 0)
+        {
+            handle_coda_error();
+        }
 
         /* check whether array is really variable sized (and clear var_dim if not) */
         for (i = 0; i < array_info->num_dims; i++)
@@ -578,6 +894,12 @@ void dim_leave_array()
 
     assert(traverse_info.num_arrays >= 0);
 
+    if (!calc_dim)
+    {
+        /* dim_enter_array() did not update the dim_info struct */
+        return;
+    }
+
     array_info = &traverse_info.array_info[traverse_info.num_arrays];
     dim_id = array_info->dim_id;
 
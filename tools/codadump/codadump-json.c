@@ -31,22 +31,8 @@
 
 #include "codadump.h"
 
-#include <stdarg.h>
-
 static int show_attributes = 0;
 
-static int ff_printf(const char *templ, ...)
-{
-    int result;
-    va_list ap;
-
-    va_start(ap, templ);
-    result = vfprintf(ascii_output, templ, ap);
-    va_end(ap);
-
-    return result;
-}
-
 static void print_escaped(const char *data, long length)
 {
     long i;
@@ -59,34 +45,34 @@ static void print_escaped(const char *data, long length)
         switch (c)
         {
             case '\b':
-                ff_printf("\\b");
+                output_string("\\b");
                 break;
             case '\f':
-                ff_printf("\\f");
+                output_string("\\f");
                 break;
             case '\n':
-                ff_printf("\\n");
+                output_string("\\n");
                 break;
             case '\r':
-                ff_printf("\\r");
+                output_string("\\r");
                 break;
             case '\t':
-                ff_printf("\\t");
+                output_string("\\t");
                 break;
             case '"':
-                ff_printf("\\\"");
+                output_string("\\\"");
                 break;
             case '\\':
-                ff_printf("\\\\");
+                output_string("\\\\");
                 break;
             default:
                 if (c >= 32 && c <= 126)
                 {
-                    ff_printf("%c", c);
+                    output_char(c);
                 }
                 else
                 {
-                    ff_printf("\\u%02x", (int)(unsigned char)c);
+                    output_printf("\\u%02x", (int)(unsigned char)c);
                 }
         }
     }
@@ -105,14 +91,14 @@ static void print_data(coda_cursor *cursor)
         }
         if (has_attributes)
         {
-            ff_printf("{\"attr\":");
+            output_string("{\"attr\":");
             if (coda_cursor_goto_attributes(cursor) != 0)
             {
                 handle_coda_error();
             }
             print_data(cursor);
             coda_cursor_goto_parent(cursor);
-            ff_printf(",\"data\":");
+            output_string(",\"data\":");
         }
     }
 
@@ -127,7 +113,7 @@ static void print_data(coda_cursor *cursor)
             {
                 long num_fields;
 
-                ff_printf("{");
+                output_char('{');
                 if (coda_cursor_get_num_elements(cursor, &num_fields) != 0)
                 {
                     handle_coda_error();
@@ -163,7 +149,9 @@ static void print_data(coda_cursor *cursor)
                         {
                             handle_coda_error();
                         }
-                        ff_printf("\"%s\":", field_name);
+                        output_char('"');
+                        output_string(field_name);
+                        output_string("\":");
                         print_data(cursor);
                         coda_cursor_goto_parent(cursor);
                     }
@@ -188,7 +176,7 @@ static void print_data(coda_cursor *cursor)
                             {
                                 if (!first_field)
                                 {
-                                    ff_printf(",");
+                                    output_char(',');
                                 }
                                 else
                                 {
@@ -198,7 +186,9 @@ static void print_data(coda_cursor *cursor)
                                 {
                                     handle_coda_error();
                                 }
-                                ff_printf("\"%s\":", field_name);
+                                output_char('"');
+                                output_string(field_name);
+                                output_string("\":");
                                 print_data(cursor);
                             }
                             if (i < num_fields - 1)
@@ -212,7 +202,7 @@ static void print_data(coda_cursor *cursor)
                         coda_cursor_goto_parent(cursor);
                     }
                 }
-                ff_printf("}");
+                output_char('}');
             }
             break;
         case coda_array_class:
@@ -221,7 +211,7 @@ static void print_data(coda_cursor *cursor)
                 int num_dims;
                 long num_elements;
 
-                ff_printf("[");
+                output_char('[');
                 if (coda_cursor_get_array_dim(cursor, &num_dims, dim) != 0)
                 {
                     handle_coda_error();
@@ -235,7 +225,7 @@ static void print_data(coda_cursor *cursor)
                     {
                         num_elements *= dim[i];
                     }
-                    if (num_elements > 0)
+                    if (num_elements > 0 && !output_numeric_array(cursor, num_elements, show_attributes, "", ","))
                     {
                         if (coda_cursor_goto_first_array_element(cursor) != 0)
                         {
@@ -246,7 +236,7 @@ static void print_data(coda_cursor *cursor)
                             print_data(cursor);
                             if (i < num_elements - 1)
                             {
-                                ff_printf(",");
+                                output_char(',');
                                 if (coda_cursor_goto_next_array_element(cursor) != 0)
                                 {
                                     handle_coda_error();
@@ -256,7 +246,7 @@ static void print_data(coda_cursor *cursor)
                         coda_cursor_goto_parent(cursor);
                     }
                 }
-                ff_printf("]");
+                output_char(']');
             }
             break;
         case coda_integer_class:
@@ -281,9 +271,9 @@ static void print_data(coda_cursor *cursor)
                                 handle_coda_error();
                             }
 
-                            ff_printf("\"");
+                            output_char('"');
                             print_escaped(&data, 1);
-                            ff_printf("\"");
+                            output_char('"');
                         }
                         break;
                     case coda_native_type_string:
@@ -308,9 +298,9 @@ static void print_data(coda_cursor *cursor)
                                 handle_coda_error();
                             }
 
-                            ff_printf("\"");
+                            output_char('"');
                             print_escaped(data, length);
-                            ff_printf("\"", length);
+                            output_char('"');
 
                             free(data);
                         }
@@ -339,9 +329,9 @@ static void print_data(coda_cursor *cursor)
                                 handle_coda_error();
                             }
 
-                            ff_printf("\"");
+                            output_char('"');
                             print_escaped((char *)data, (long)byte_size);
-                            ff_printf("\"");
+                            output_char('"');
 
                             free(data);
                         }
@@ -357,7 +347,7 @@ static void print_data(coda_cursor *cursor)
                                 handle_coda_error();
                             }
 
-                            ff_printf("%ld", (long)data);
+                            output_int64(data);
                         }
                         break;
                     case coda_native_type_uint8:
@@ -371,38 +361,45 @@ static void print_data(coda_cursor *cursor)
                                 handle_coda_error();
                             }
 
-                            ff_printf("%lu", (unsigned long)data);
+                            output_uint64(data);
                         }
                         break;
                     case coda_native_type_int64:
                         {
                             int64_t data;
-                            char s[21];
 
                             if (coda_cursor_read_int64(cursor, &data) != 0)
                             {
                                 handle_coda_error();
                             }
 
-                            coda_str64(data, s);
-                            ff_printf("%s", s);
+                            output_int64(data);
                         }
                         break;
                     case coda_native_type_uint64:
                         {
                             uint64_t data;
-                            char s[21];
 
                             if (coda_cursor_read_uint64(cursor, &data) != 0)
                             {
                                 handle_coda_error();
                             }
 
-                            coda_str64u(data, s);
-                            ff_printf("%s", s);
+                            output_uint64(data);
                         }
                         break;
                     case coda_native_type_float:
+                        {
+                            float data;
+
+                            if (coda_cursor_read_float(cursor, &data) != 0)
+                            {
+                                handle_coda_error();
+                            }
+
+                            output_float(data);
+                        }
+                        break;
                     case coda_native_type_double:
                         {
                             double data;
@@ -412,18 +409,11 @@ static void print_data(coda_cursor *cursor)
                                 handle_coda_error();
                             }
 
-                            if (read_type == coda_native_type_float)
-                            {
-                                ff_printf("%.7g", data);
-                            }
-                            else
-                            {
-                                ff_printf("%.16g", data);
-                            }
+                            output_double(data);
                         }
                         break;
                     case coda_native_type_not_available:
-                        ff_printf("null");
+                        output_string("null");
                         break;
                 }
             }
@@ -440,7 +430,7 @@ static void print_data(coda_cursor *cursor)
                 switch (special_type)
                 {
                     case coda_special_no_data:
-                        ff_printf("null");
+                        output_string("null");
                         break;
                     case coda_special_vsf_integer:
                         {
@@ -451,7 +441,7 @@ static void print_data(coda_cursor *cursor)
                                 handle_coda_error();
                             }
 
-                            ff_printf("%.16g", data);
+                            output_double(data);
                         }
                         break;
                     case coda_special_time:
@@ -465,17 +455,19 @@ static void print_data(coda_cursor *cursor)
                             }
                             if (coda_isNaN(data) || coda_isInf(data))
                             {
-                                ff_printf("%.16g", data);
+                                output_double(data);
                             }
                             else
                             {
                                 if (coda_time_double_to_string(data, "yyyy-MM-dd'T'HH:mm:ss.SSSSSS", str) != 0)
                                 {
-                                    ff_printf("\"{--invalid time value--}\"");
+                                    output_string("\"{--invalid time value--}\"");
                                 }
                                 else
                                 {
-                                    ff_printf("\"%s\"", str);
+                                    output_char('"');
+                                    output_string(str);
+                                    output_char('"');
                                 }
                             }
                         }
@@ -489,7 +481,7 @@ static void print_data(coda_cursor *cursor)
                                 handle_coda_error();
                             }
 
-                            ff_printf("\"%g + %gi\"", re, im);
+                            output_printf("\"%g + %gi\"", re, im);
                         }
                         break;
                 }
@@ -499,7 +491,7 @@ static void print_data(coda_cursor *cursor)
 
     if (has_attributes)
     {
-        ff_printf("}");
+        output_char('}');
     }
 }
 
@@ -541,7 +533,8 @@ void print_json_data(int include_attributes)
 
     coda_set_option_perform_boundary_checks(0);
     print_data(&cursor);
-    ff_printf("\n");
+    output_char('\n');
+    output_flush();
 
     coda_close(pf);
 }
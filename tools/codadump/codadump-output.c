@@ -0,0 +1,725 @@
+/*
+ * Copyright (C) 2007-2019 S[&]T, The Netherlands.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "codadump.h"
+
+#include <stdarg.h>
+
+/* All text output of the ascii, json, yaml, and debug exporters goes through the functions in this file.
+ * Output is collected in a large buffer that is written to ascii_output in big blocks, and numbers are formatted
+ * without using the printf family of functions.
+ */
+
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+/* number of array elements that output_numeric_array() reads at once */
+#define ARRAY_BLOCK_SIZE 4096
+
+/* floating point values are printed in exponential notation if the decimal exponent is outside [-4, precision) (as
+ * with the %g format of printf)
+ */
+#define DOUBLE_PRECISION 16
+#define FLOAT_PRECISION 7
+
+static char output_buffer[OUTPUT_BUFFER_SIZE];
+static long output_length = 0;
+
+void output_flush(void)
+{
+    if (output_length > 0)
+    {
+        fwrite(output_buffer, 1, output_length, ascii_output);
+        output_length = 0;
+    }
+}
+
+void output_data(const char *data, long length)
+{
+    if (output_length + length > OUTPUT_BUFFER_SIZE)
+    {
+        output_flush();
+        if (length > OUTPUT_BUFFER_SIZE)
+        {
+            fwrite(data, 1, length, ascii_output);
+            return;
+        }
+    }
+    memcpy(&output_buffer[output_length], data, length);
+    output_length += length;
+}
+
+void output_string(const char *str)
+{
+    output_data(str, (long)strlen(str));
+}
+
+void output_char(char c)
+{
+    if (output_length == OUTPUT_BUFFER_SIZE)
+    {
+        output_flush();
+    }
+    output_buffer[output_length++] = c;
+}
+
+int output_printf(const char *templ, ...)
+{
+    va_list ap;
+    int length;
+
+    va_start(ap, templ);
+    length = vsnprintf(NULL, 0, templ, ap);
+    va_end(ap);
+    if (length < 0)
+    {
+        return length;
+    }
+    if (output_length + length + 1 > OUTPUT_BUFFER_SIZE)
+    {
+        output_flush();
+        if (length + 1 > OUTPUT_BUFFER_SIZE)
+        {
+            va_start(ap, templ);
+            length = vfprintf(ascii_output, templ, ap);
+            va_end(ap);
+            return length;
+        }
+    }
+    va_start(ap, templ);
+    vsnprintf(&output_buffer[output_length], length + 1, templ, ap);
+    va_end(ap);
+    output_length += length;
+
+    return length;
+}
+
+void output_uint64(uint64_t value)
+{
+    char str[20];
+    int i = 20;
+
+    do
+    {
+        str[--i] = (char)('0' + (int)(value % 10));
+        value /= 10;
+    } while (value != 0);
+    output_data(&str[i], 20 - i);
+}
+
+void output_int64(int64_t value)
+{
+    if (value < 0)
+    {
+        output_char('-');
+        /* negate as unsigned value, such that the minimum int64 value is also handled */
+        output_uint64(~(uint64_t)value + 1);
+    }
+    else
+    {
+        output_uint64((uint64_t)value);
+    }
+}
+
+/* Shortest representation of floating point values that reads back to the same value, using the Grisu2 algorithm of
+ * Florian Loitsch ("Printing Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010).
+ */
+
+typedef struct diy_fp_struct
+{
+    uint64_t f;
+    int e;
+} diy_fp;
+
+/* normalized 64-bit approximations of the powers of ten 10^-348, 10^-340, ..., 10^340 (high and low 32 bits of the
+ * significand and the binary exponent)
+ */
+static const struct
+{
+    uint32_t high;
+    uint32_t low;
+    int16_t e;
+} cached_power[] = {
+    {0xfa8fd5a0, 0x081c0288, -1220},
+    {0xbaaee17f, 0xa23ebf76, -1193},
+    {0x8b16fb20, 0x3055ac76, -1166},
+    {0xcf42894a, 0x5dce35ea, -1140},
+    {0x9a6bb0aa, 0x55653b2d, -1113},
+    {0xe61acf03, 0x3d1a45df, -1087},
+    {0xab70fe17, 0xc79ac6ca, -1060},
+    {0xff77b1fc, 0xbebcdc4f, -1034},
+    {0xbe5691ef, 0x416bd60c, -1007},
+    {0x8dd01fad, 0x907ffc3c, -980},
+    {0xd3515c28, 0x31559a83, -954},
+    {0x9d71ac8f, 0xada6c9b5, -927},
+    {0xea9c2277, 0x23ee8bcb, -901},
+    {0xaecc4991, 0x4078536d, -874},
+    {0x823c1279, 0x5db6ce57, -847},
+    {0xc2109436, 0x4dfb5637, -821},
+    {0x9096ea6f, 0x3848984f, -794},
+    {0xd77485cb, 0x25823ac7, -768},
+    {0xa086cfcd, 0x97bf97f4, -741},
+    {0xef340a98, 0x172aace5, -715},
+    {0xb23867fb, 0x2a35b28e, -688},
+    {0x84c8d4df, 0xd2c63f3b, -661},
+    {0xc5dd4427, 0x1ad3cdba, -635},
+    {0x936b9fce, 0xbb25c996, -608},
+    {0xdbac6c24, 0x7d62a584, -582},
+    {0xa3ab6658, 0x0d5fdaf6, -555},
+    {0xf3e2f893, 0xdec3f126, -529},
+    {0xb5b5ada8, 0xaaff80b8, -502},
+    {0x87625f05, 0x6c7c4a8b, -475},
+    {0xc9bcff60, 0x34c13053, -449},
+    {0x964e858c, 0x91ba2655, -422},
+    {0xdff97724, 0x70297ebd, -396},
+    {0xa6dfbd9f, 0xb8e5b88f, -369},
+    {0xf8a95fcf, 0x88747d94, -343},
+    {0xb9447093, 0x8fa89bcf, -316},
+    {0x8a08f0f8, 0xbf0f156b, -289},
+    {0xcdb02555, 0x653131b6, -263},
+    {0x993fe2c6, 0xd07b7fac, -236},
+    {0xe45c10c4, 0x2a2b3b06, -210},
+    {0xaa242499, 0x697392d3, -183},
+    {0xfd87b5f2, 0x8300ca0e, -157},
+    {0xbce50864, 0x92111aeb, -130},
+    {0x8cbccc09, 0x6f5088cc, -103},
+    {0xd1b71758, 0xe219652c, -77},
+    {0x9c400000, 0x00000000, -50},
+    {0xe8d4a510, 0x00000000, -24},
+    {0xad78ebc5, 0xac620000, 3},
+    {0x813f3978, 0xf8940984, 30},
+    {0xc097ce7b, 0xc90715b3, 56},
+    {0x8f7e32ce, 0x7bea5c70, 83},
+    {0xd5d238a4, 0xabe98068, 109},
+    {0x9f4f2726, 0x179a2245, 136},
+    {0xed63a231, 0xd4c4fb27, 162},
+    {0xb0de6538, 0x8cc8ada8, 189},
+    {0x83c7088e, 0x1aab65db, 216},
+    {0xc45d1df9, 0x42711d9a, 242},
+    {0x924d692c, 0xa61be758, 269},
+    {0xda01ee64, 0x1a708dea, 295},
+    {0xa26da399, 0x9aef774a, 322},
+    {0xf209787b, 0xb47d6b85, 348},
+    {0xb454e4a1, 0x79dd1877, 375},
+    {0x865b8692, 0x5b9bc5c2, 402},
+    {0xc83553c5, 0xc8965d3d, 428},
+    {0x952ab45c, 0xfa97a0b3, 455},
+    {0xde469fbd, 0x99a05fe3, 481},
+    {0xa59bc234, 0xdb398c25, 508},
+    {0xf6c69a72, 0xa3989f5c, 534},
+    {0xb7dcbf53, 0x54e9bece, 561},
+    {0x88fcf317, 0xf22241e2, 588},
+    {0xcc20ce9b, 0xd35c78a5, 614},
+    {0x98165af3, 0x7b2153df, 641},
+    {0xe2a0b5dc, 0x971f303a, 667},
+    {0xa8d9d153, 0x5ce3b396, 694},
+    {0xfb9b7cd9, 0xa4a7443c, 720},
+    {0xbb764c4c, 0xa7a44410, 747},
+    {0x8bab8eef, 0xb6409c1a, 774},
+    {0xd01fef10, 0xa657842c, 800},
+    {0x9b10a4e5, 0xe9913129, 827},
+    {0xe7109bfb, 0xa19c0c9d, 853},
+    {0xac2820d9, 0x623bf429, 880},
+    {0x80444b5e, 0x7aa7cf85, 907},
+    {0xbf21e440, 0x03acdd2d, 933},
+    {0x8e679c2f, 0x5e44ff8f, 960},
+    {0xd433179d, 0x9c8cb841, 986},
+    {0x9e19db92, 0xb4e31ba9, 1013},
+    {0xeb96bf6e, 0xbadf77d9, 1039},
+    {0xaf87023b, 0x9bf0ee6b, 1066}
+};
+
+static const uint32_t pow10_32[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static diy_fp diy_fp_multiply(diy_fp x, diy_fp y)
+{
+    uint64_t a = x.f >> 32;
+    uint64_t b = x.f & 0xFFFFFFFF;
+    uint64_t c = y.f >> 32;
+    uint64_t d = y.f & 0xFFFFFFFF;
+    uint64_t ac = a * c;
+    uint64_t bc = b * c;
+    uint64_t ad = a * d;
+    uint64_t bd = b * d;
+    uint64_t tmp;
+    diy_fp result;
+
+    tmp = (bd >> 32) + (ad & 0xFFFFFFFF) + (bc & 0xFFFFFFFF);
+    tmp += (uint64_t)1 << 31;   /* round */
+    result.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+    result.e = x.e + y.e + 64;
+
+    return result;
+}
+
+static diy_fp diy_fp_normalize(diy_fp x)
+{
+    while (!(x.f & ((uint64_t)1 << 63)))
+    {
+        x.f <<= 1;
+        x.e--;
+    }
+
+    return x;
+}
+
+/* returns c_k = 10^-k such that the binary exponent of x * c_k is in a range that allows digit generation with 64-bit
+ * integers
+ */
+static diy_fp get_cached_power(int e, int *k)
+{
+    double dk = (-61 - e) * 0.30102999566398114 + 347;
+    diy_fp result;
+    int index;
+
+    index = (int)dk;
+    if (dk - index > 0.0)
+    {
+        index++;
+    }
+    index = (index >> 3) + 1;
+    *k = -(-348 + index * 8);
+    result.f = ((uint64_t)cached_power[index].high << 32) | cached_power[index].low;
+    result.e = cached_power[index].e;
+
+    return result;
+}
+
+static void grisu_round(char *digits, int length, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+    {
+        digits[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static void generate_digits(diy_fp w, diy_fp mp, uint64_t delta, char *digits, int *length, int *k)
+{
+    uint64_t one_f = (uint64_t)1 << -mp.e;
+    uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> -mp.e);
+    uint64_t p2 = mp.f & (one_f - 1);
+    int kappa = 1;
+    int d;
+
+    while (kappa < 10 && p1 >= pow10_32[kappa])
+    {
+        kappa++;
+    }
+    *length = 0;
+    while (kappa > 0)
+    {
+        uint64_t rest;
+
+        d = (int)(p1 / pow10_32[kappa - 1]);
+        p1 %= pow10_32[kappa - 1];
+        if (d != 0 || *length != 0)
+        {
+            digits[(*length)++] = (char)('0' + d);
+        }
+        kappa--;
+        rest = ((uint64_t)p1 << -mp.e) + p2;
+        if (rest <= delta)
+        {
+            *k += kappa;
+            grisu_round(digits, *length, delta, rest, (uint64_t)pow10_32[kappa] << -mp.e, wp_w);
+            return;
+        }
+    }
+    for (;;)
+    {
+        p2 *= 10;
+        delta *= 10;
+        d = (int)(p2 >> -mp.e);
+        if (d != 0 || *length != 0)
+        {
+            digits[(*length)++] = (char)('0' + d);
+        }
+        p2 &= one_f - 1;
+        kappa--;
+        if (p2 < delta)
+        {
+            *k += kappa;
+            grisu_round(digits, *length, delta, p2, one_f, -kappa < 10 ? wp_w * pow10_32[-kappa] : 0);
+            return;
+        }
+    }
+}
+
+/* Determine the shortest digits such that digits * 10^k reads back as the (positive, finite, non-zero) value
+ * f * 2^e, where 'hidden_bit' is the implicit leading bit of a normalized value of the source type.
+ */
+static void grisu2(uint64_t f, int e, uint64_t hidden_bit, char *digits, int *length, int *k)
+{
+    diy_fp v, w, mp, mm;
+    diy_fp c_mk;
+
+    v.f = f;
+    v.e = e;
+
+    /* boundaries of the interval of values that read back as v */
+    mp.f = (f << 1) + 1;
+    mp.e = e - 1;
+    mp = diy_fp_normalize(mp);
+    if (f == hidden_bit)
+    {
+        /* the lower boundary is closer for powers of two */
+        mm.f = (f << 2) - 1;
+        mm.e = e - 2;
+    }
+    else
+    {
+        mm.f = (f << 1) - 1;
+        mm.e = e - 1;
+    }
+    mm.f <<= mm.e - mp.e;
+    mm.e = mp.e;
+
+    c_mk = get_cached_power(mp.e, k);
+    w = diy_fp_multiply(diy_fp_normalize(v), c_mk);
+    mp = diy_fp_multiply(mp, c_mk);
+    mm = diy_fp_multiply(mm, c_mk);
+    mm.f++;
+    mp.f--;
+    generate_digits(w, mp, mp.f - mm.f, digits, length, k);
+}
+
+/* print digits * 10^k in the same layout as the %g format of printf would use for the given precision */
+static void output_digits(char *digits, int length, int k, int precision)
+{
+    char str[64];
+    int exponent;
+    int n = 0;
+    int i;
+
+    while (length > 1 && digits[length - 1] == '0')
+    {
+        length--;
+        k++;
+    }
+    exponent = k + length - 1;
+    if (exponent < -4 || exponent >= precision)
+    {
+        str[n++] = digits[0];
+        if (length > 1)
+        {
+            str[n++] = '.';
+            memcpy(&str[n], &digits[1], length - 1);
+            n += length - 1;
+        }
+        str[n++] = 'e';
+        if (exponent < 0)
+        {
+            str[n++] = '-';
+            exponent = -exponent;
+        }
+        else
+        {
+            str[n++] = '+';
+        }
+        if (exponent >= 100)
+        {
+            str[n++] = (char)('0' + exponent / 100);
+            exponent %= 100;
+        }
+        str[n++] = (char)('0' + exponent / 10);
+        str[n++] = (char)('0' + exponent % 10);
+    }
+    else if (k >= 0)
+    {
+        memcpy(str, digits, length);
+        n = length;
+        for (i = 0; i < k; i++)
+        {
+            str[n++] = '0';
+        }
+    }
+    else if (exponent >= 0)
+    {
+        memcpy(str, digits, exponent + 1);
+        n = exponent + 1;
+        str[n++] = '.';
+        memcpy(&str[n], &digits[exponent + 1], length - exponent - 1);
+        n += length - exponent - 1;
+    }
+    else
+    {
+        str[n++] = '0';
+        str[n++] = '.';
+        for (i = exponent + 1; i < 0; i++)
+        {
+            str[n++] = '0';
+        }
+        memcpy(&str[n], digits, length);
+        n += length;
+    }
+    output_data(str, n);
+}
+
+/* print the shortest representation that reads back as the same double value */
+void output_double(double value)
+{
+    char digits[20];
+    uint64_t bits;
+    uint64_t f;
+    int biased_e;
+    int length;
+    int k;
+
+    memcpy(&bits, &value, sizeof(double));
+    f = bits & (((uint64_t)1 << 52) - 1);
+    biased_e = (int)((bits >> 52) & 0x7FF);
+    if (biased_e == 0x7FF)
+    {
+        if (f != 0)
+        {
+            output_string(bits >> 63 ? "-nan" : "nan");
+        }
+        else
+        {
+            output_string(bits >> 63 ? "-inf" : "inf");
+        }
+        return;
+    }
+    if (bits >> 63)
+    {
+        output_char('-');
+    }
+    if (biased_e == 0 && f == 0)
+    {
+        output_char('0');
+        return;
+    }
+    if (biased_e != 0)
+    {
+        f |= (uint64_t)1 << 52;
+    }
+    else
+    {
+        /* denormalized value */
+        biased_e = 1;
+    }
+    grisu2(f, biased_e - 1075, (uint64_t)1 << 52, digits, &length, &k);
+    output_digits(digits, length, k, DOUBLE_PRECISION);
+}
+
+/* print the shortest representation that reads back as the same single precision floating point value */
+void output_float(float value)
+{
+    char digits[20];
+    uint32_t bits;
+    uint64_t f;
+    int biased_e;
+    int length;
+    int k;
+
+    memcpy(&bits, &value, sizeof(float));
+    f = bits & ((1 << 23) - 1);
+    biased_e = (int)((bits >> 23) & 0xFF);
+    if (biased_e == 0xFF)
+    {
+        if (f != 0)
+        {
+            output_string(bits >> 31 ? "-nan" : "nan");
+        }
+        else
+        {
+            output_string(bits >> 31 ? "-inf" : "inf");
+        }
+        return;
+    }
+    if (bits >> 31)
+    {
+        output_char('-');
+    }
+    if (biased_e == 0 && f == 0)
+    {
+        output_char('0');
+        return;
+    }
+    if (biased_e != 0)
+    {
+        f |= 1 << 23;
+    }
+    else
+    {
+        /* denormalized value */
+        biased_e = 1;
+    }
+    grisu2(f, biased_e - 150, 1 << 23, digits, &length, &k);
+    output_digits(digits, length, k, FLOAT_PRECISION);
+}
+
+/* Print all elements of the array at the cursor, if these are plain integer or floating point values, using block
+ * reads instead of reading each element separately.
+ * Each element is preceded by 'prefix' and successive elements are separated by 'separator'.
+ * Returns 1 if the elements were printed, or 0 if the array elements are not plain numeric values (in which case
+ * nothing was printed and the caller should traverse the elements itself).
+ */
+int output_numeric_array(coda_cursor *cursor, long num_elements, int include_attributes, const char *prefix,
+                         const char *separator)
+{
+    static uint64_t buffer[ARRAY_BLOCK_SIZE];
+    coda_type_class type_class;
+    coda_native_type read_type;
+    coda_type *type;
+    long prefix_length = (long)strlen(prefix);
+    long separator_length = (long)strlen(separator);
+    long offset;
+
+    if (coda_cursor_get_type(cursor, &type) != 0)
+    {
+        handle_coda_error();
+    }
+    if (coda_type_get_array_base_type(type, &type) != 0)
+    {
+        handle_coda_error();
+    }
+    if (coda_type_get_class(type, &type_class) != 0)
+    {
+        handle_coda_error();
+    }
+    if (type_class != coda_integer_class && type_class != coda_real_class)
+    {
+        return 0;
+    }
+    if (include_attributes)
+    {
+        int has_attributes;
+
+        if (coda_type_has_attributes(type, &has_attributes) != 0)
+        {
+            handle_coda_error();
+        }
+        if (has_attributes)
+        {
+            return 0;
+        }
+    }
+    if (coda_type_get_read_type(type, &read_type) != 0)
+    {
+        handle_coda_error();
+    }
+
+    for (offset = 0; offset < num_elements; offset += ARRAY_BLOCK_SIZE)
+    {
+        long length = num_elements - offset;
+        long i;
+
+        if (length > ARRAY_BLOCK_SIZE)
+        {
+            length = ARRAY_BLOCK_SIZE;
+        }
+        switch (read_type)
+        {
+            case coda_native_type_int8:
+            case coda_native_type_int16:
+            case coda_native_type_int32:
+                if (coda_cursor_read_int32_partial_array(cursor, offset, length, (int32_t *)buffer) != 0)
+                {
+                    handle_coda_error();
+                }
+                break;
+            case coda_native_type_uint8:
+            case coda_native_type_uint16:
+            case coda_native_type_uint32:
+                if (coda_cursor_read_uint32_partial_array(cursor, offset, length, (uint32_t *)buffer) != 0)
+                {
+                    handle_coda_error();
+                }
+                break;
+            case coda_native_type_int64:
+                if (coda_cursor_read_int64_partial_array(cursor, offset, length, (int64_t *)buffer) != 0)
+                {
+                    handle_coda_error();
+                }
+                break;
+            case coda_native_type_uint64:
+                if (coda_cursor_read_uint64_partial_array(cursor, offset, length, buffer) != 0)
+                {
+                    handle_coda_error();
+                }
+                break;
+            case coda_native_type_float:
+                if (coda_cursor_read_float_partial_array(cursor, offset, length, (float *)buffer) != 0)
+                {
+                    handle_coda_error();
+                }
+                break;
+            case coda_native_type_double:
+                if (coda_cursor_read_double_partial_array(cursor, offset, length, (double *)buffer) != 0)
+                {
+                    handle_coda_error();
+                }
+                break;
+            default:
+                return 0;
+        }
+        for (i = 0; i < length; i++)
+        {
+            if (offset + i > 0)
+            {
+                output_data(separator, separator_length);
+            }
+            output_data(prefix, prefix_length);
+            switch (read_type)
+            {
+                case coda_native_type_int8:
+                case coda_native_type_int16:
+                case coda_native_type_int32:
+                    output_int64(((int32_t *)buffer)[i]);
+                    break;
+                case coda_native_type_uint8:
+                case coda_native_type_uint16:
+                case coda_native_type_uint32:
+                    output_uint64(((uint32_t *)buffer)[i]);
+                    break;
+                case coda_native_type_int64:
+                    output_int64(((int64_t *)buffer)[i]);
+                    break;
+                case coda_native_type_uint64:
+                    output_uint64(buffer[i]);
+                    break;
+                case coda_native_type_float:
+                    output_float(((float *)buffer)[i]);
+                    break;
+                default:
+                    output_double(((double *)buffer)[i]);
+                    break;
+            }
+        }
+    }
+
+    return 1;
+}
@@ -282,6 +282,10 @@ static void handle_data_element()
     {
         export_data_element_to_ascii();
     }
+    else if (run_mode == RUN_MODE_ARROW)
+    {
+        export_data_element_to_arrow();
+    }
 #ifdef HAVE_HDF4
     else if (run_mode == RUN_MODE_HDF4)
     {
@@ -295,6 +299,7 @@ static void handle_data_element()
  */
 static void traverse_record(int index, int traverse_hidden)
 {
+    int available;
     int hidden;
 
     traverse_info.parent_index[traverse_info.num_records - 1] = index;
@@ -310,28 +315,23 @@ static void traverse_record(int index, int traverse_hidden)
         return;
     }
 
-    if (calc_dim)
+    if (coda_type_get_record_field_available_status(traverse_info.type[traverse_info.current_depth - 1], index,
+                                                    &available) != 0)
+    {
+        handle_coda_error();
+    }
+    if (calc_dim && available == -1)
     {
-        int available;
-
         /* we do not traverse records that are globally not available
          * (i.e. not available for every element of our parent array(s))
+         * so traverse all occurrences of this field to check whether at least one is available
          */
-        if (coda_type_get_record_field_available_status(traverse_info.type[traverse_info.current_depth - 1], index,
-                                                        &available) != 0)
-        {
-            handle_coda_error();
-        }
-        if (available == -1)
+        if (!dim_record_field_available())
         {
-            /* traverse all occurrences of this field to check whether at least one is available */
-            if (!dim_record_field_available())
-            {
-                return;
-            }
+            return;
         }
-        traverse_info.field_available_status[traverse_info.current_depth - 1] = available;
     }
+    traverse_info.field_available_status[traverse_info.current_depth - 1] = available;
 
     if (coda_type_get_record_field_name(traverse_info.type[traverse_info.current_depth - 1], index,
                                         &traverse_info.field_name[traverse_info.num_records - 1]) != 0)
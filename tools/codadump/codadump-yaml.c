@@ -31,8 +31,6 @@
 
 #include "codadump.h"
 
-#include <stdarg.h>
-
 static int INDENT = 0;
 
 static int show_attributes = 0;
@@ -44,36 +42,10 @@ static void indent(void)
     assert(INDENT >= 0);
     for (i = INDENT; i > 0; i--)
     {
-        fprintf(ascii_output, "  ");
+        output_string("  ");
     }
 }
 
-static int ff_printf(const char *templ, ...)
-{
-    int result;
-    va_list ap;
-
-    va_start(ap, templ);
-    result = vfprintf(ascii_output, templ, ap);
-    va_end(ap);
-
-    return result;
-}
-
-static int fi_printf(const char *templ, ...)
-{
-    int result;
-    va_list ap;
-
-    indent();
-
-    va_start(ap, templ);
-    result = vfprintf(ascii_output, templ, ap);
-    va_end(ap);
-
-    return result;
-}
-
 static void print_escaped(const char *data, long length)
 {
     long i;
@@ -86,34 +58,34 @@ static void print_escaped(const char *data, long length)
         switch (c)
         {
             case '\b':
-                ff_printf("\\b");
+                output_string("\\b");
                 break;
             case '\f':
-                ff_printf("\\f");
+                output_string("\\f");
                 break;
             case '\n':
-                ff_printf("\\n");
+                output_string("\\n");
                 break;
             case '\r':
-                ff_printf("\\r");
+                output_string("\\r");
                 break;
             case '\t':
-                ff_printf("\\t");
+                output_string("\\t");
                 break;
             case '"':
-                ff_printf("\\\"");
+                output_string("\\\"");
                 break;
             case '\\':
-                ff_printf("\\\\");
+                output_string("\\\\");
                 break;
             default:
                 if (c >= 32 && c <= 126)
                 {
-                    ff_printf("%c", c);
+                    output_char(c);
                 }
                 else
                 {
-                    ff_printf("\\u%02x", (int)(unsigned char)c);
+                    output_printf("\\u%02x", (int)(unsigned char)c);
                 }
         }
     }
@@ -134,10 +106,10 @@ static void print_data(coda_cursor *cursor, int compound_newline)
         {
             if (compound_newline)
             {
-                ff_printf("\n");
+                output_char('\n');
                 indent();
             }
-            ff_printf("attr: ");
+            output_string("attr: ");
             if (coda_cursor_goto_attributes(cursor) != 0)
             {
                 handle_coda_error();
@@ -146,7 +118,8 @@ static void print_data(coda_cursor *cursor, int compound_newline)
             print_data(cursor, 1);
             INDENT--;
             coda_cursor_goto_parent(cursor);
-            fi_printf("data: ");
+            indent();
+            output_string("data: ");
             INDENT++;
         }
     }
@@ -174,7 +147,7 @@ static void print_data(coda_cursor *cursor, int compound_newline)
 
                     if (compound_newline)
                     {
-                        ff_printf("\n");
+                        output_char('\n');
                     }
                     if (coda_cursor_get_type(cursor, &record_type) != 0)
                     {
@@ -205,7 +178,8 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                         {
                             indent();
                         }
-                        ff_printf("%s: ", field_name);
+                        output_string(field_name);
+                        output_string(": ");
                         INDENT++;
                         print_data(cursor, 1);
                         INDENT--;
@@ -242,7 +216,8 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                                 {
                                     first_field = 0;
                                 }
-                                ff_printf("%s: ", field_name);
+                                output_string(field_name);
+                                output_string(": ");
                                 INDENT++;
                                 print_data(cursor, 1);
                                 INDENT--;
@@ -260,7 +235,7 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                 }
                 else
                 {
-                    ff_printf("{}\n");
+                    output_string("{}\n");
                 }
             }
             break;
@@ -285,35 +260,55 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                     }
                     if (num_elements > 0)
                     {
-                        ff_printf("\n");
-                        if (coda_cursor_goto_first_array_element(cursor) != 0)
+                        char *prefix;
+
+                        output_char('\n');
+                        prefix = (char *)malloc(2 * INDENT + 3);
+                        if (prefix == NULL)
                         {
+                            coda_set_error(CODA_ERROR_OUT_OF_MEMORY,
+                                           "out of memory (could not allocate %lu bytes) (%s:%u)",
+                                           (long)(2 * INDENT + 3), __FILE__, __LINE__);
                             handle_coda_error();
                         }
-                        for (i = 0; i < num_elements; i++)
+                        memset(prefix, ' ', 2 * INDENT);
+                        strcpy(&prefix[2 * INDENT], "- ");
+                        if (output_numeric_array(cursor, num_elements, show_attributes, prefix, "\n"))
                         {
-                            fi_printf("- ");
-                            INDENT++;
-                            print_data(cursor, 0);
-                            INDENT--;
-                            if (i < num_elements - 1)
+                            output_char('\n');
+                        }
+                        else
+                        {
+                            if (coda_cursor_goto_first_array_element(cursor) != 0)
                             {
-                                if (coda_cursor_goto_next_array_element(cursor) != 0)
+                                handle_coda_error();
+                            }
+                            for (i = 0; i < num_elements; i++)
+                            {
+                                output_string(prefix);
+                                INDENT++;
+                                print_data(cursor, 0);
+                                INDENT--;
+                                if (i < num_elements - 1)
                                 {
-                                    handle_coda_error();
+                                    if (coda_cursor_goto_next_array_element(cursor) != 0)
+                                    {
+                                        handle_coda_error();
+                                    }
                                 }
                             }
+                            coda_cursor_goto_parent(cursor);
                         }
-                        coda_cursor_goto_parent(cursor);
+                        free(prefix);
                     }
                     else
                     {
-                        ff_printf("[]\n");
+                        output_string("[]\n");
                     }
                 }
                 else
                 {
-                    ff_printf("[]\n");
+                    output_string("[]\n");
                 }
             }
             break;
@@ -339,9 +334,9 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                                 handle_coda_error();
                             }
 
-                            ff_printf("\"");
+                            output_char('"');
                             print_escaped(&data, 1);
-                            ff_printf("\"\n");
+                            output_string("\"\n");
                         }
                         break;
                     case coda_native_type_string:
@@ -366,9 +361,9 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                                 handle_coda_error();
                             }
 
-                            ff_printf("\"");
+                            output_char('"');
                             print_escaped(data, length);
-                            ff_printf("\"\n", length);
+                            output_string("\"\n");
 
                             free(data);
                         }
@@ -397,9 +392,9 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                                 handle_coda_error();
                             }
 
-                            ff_printf("\"");
+                            output_char('"');
                             print_escaped((char *)data, (long)byte_size);
-                            ff_printf("\"\n");
+                            output_string("\"\n");
 
                             free(data);
                         }
@@ -415,7 +410,8 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                                 handle_coda_error();
                             }
 
-                            ff_printf("%ld\n", (long)data);
+                            output_int64(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_native_type_uint8:
@@ -429,38 +425,49 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                                 handle_coda_error();
                             }
 
-                            ff_printf("%lu\n", (unsigned long)data);
+                            output_uint64(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_native_type_int64:
                         {
                             int64_t data;
-                            char s[21];
 
                             if (coda_cursor_read_int64(cursor, &data) != 0)
                             {
                                 handle_coda_error();
                             }
 
-                            coda_str64(data, s);
-                            ff_printf("%s\n", s);
+                            output_int64(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_native_type_uint64:
                         {
                             uint64_t data;
-                            char s[21];
 
                             if (coda_cursor_read_uint64(cursor, &data) != 0)
                             {
                                 handle_coda_error();
                             }
 
-                            coda_str64u(data, s);
-                            ff_printf("%s\n", s);
+                            output_uint64(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_native_type_float:
+                        {
+                            float data;
+
+                            if (coda_cursor_read_float(cursor, &data) != 0)
+                            {
+                                handle_coda_error();
+                            }
+
+                            output_float(data);
+                            output_char('\n');
+                        }
+                        break;
                     case coda_native_type_double:
                         {
                             double data;
@@ -470,18 +477,12 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                                 handle_coda_error();
                             }
 
-                            if (read_type == coda_native_type_float)
-                            {
-                                ff_printf("%.7g\n", data);
-                            }
-                            else
-                            {
-                                ff_printf("%.16g\n", data);
-                            }
+                            output_double(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_native_type_not_available:
-                        ff_printf("null\n");
+                        output_string("null\n");
                         break;
                 }
             }
@@ -498,7 +499,7 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                 switch (special_type)
                 {
                     case coda_special_no_data:
-                        ff_printf("null\n");
+                        output_string("null\n");
                         break;
                     case coda_special_vsf_integer:
                         {
@@ -509,7 +510,8 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                                 handle_coda_error();
                             }
 
-                            ff_printf("%.16g\n", data);
+                            output_double(data);
+                            output_char('\n');
                         }
                         break;
                     case coda_special_time:
@@ -523,17 +525,19 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                             }
                             if (coda_isNaN(data) || coda_isInf(data))
                             {
-                                ff_printf("%.16g\n", data);
+                                output_double(data);
+                                output_char('\n');
                             }
                             else
                             {
                                 if (coda_time_double_to_string(data, "yyyy-MM-dd'T'HH:mm:ss.SSSSSS", str) != 0)
                                 {
-                                    ff_printf("\"{--invalid time value--}\"");
+                                    output_string("\"{--invalid time value--}\"");
                                 }
                                 else
                                 {
-                                    ff_printf("%s\n", str);
+                                    output_string(str);
+                                    output_char('\n');
                                 }
                             }
                         }
@@ -547,7 +551,7 @@ static void print_data(coda_cursor *cursor, int compound_newline)
                                 handle_coda_error();
                             }
 
-                            ff_printf("%g + %gi\n", re, im);
+                            output_printf("%g + %gi\n", re, im);
                         }
                         break;
                 }
@@ -599,6 +603,7 @@ void print_yaml_data(int include_attributes)
 
     coda_set_option_perform_boundary_checks(0);
     print_data(&cursor, 0);
+    output_flush();
 
     coda_close(pf);
 }
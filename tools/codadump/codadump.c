@@ -44,6 +44,7 @@ char *output_file_name;
 char *starting_path;
 int verbosity;
 int calc_dim;
+int num_threads;
 int max_depth = -1;
 int show_dim_vals;
 int show_index;
@@ -54,6 +55,9 @@ int show_type;
 int show_unit;
 int show_description;
 
+static const char *program_path;
+static const char *option_definition_path;
+
 static void print_version()
 {
     printf("codadump version %s\n", libcoda_version);
@@ -73,6 +77,9 @@ static void print_help()
     printf("                    do not perform unit/value conversions\n");
     printf("            -f, --filter '<filter expression>'\n");
     printf("                    restrict the output to data that matches the filter\n");
+    printf("            -j, --jobs <N>\n");
+    printf("                    use N threads to determine the sizes of variable sized\n");
+    printf("                    arrays\n");
     printf("            -t, --type\n");
     printf("                    show basic data type\n");
     printf("            -u, --unit\n");
@@ -96,6 +103,9 @@ static void print_help()
     printf("                    restrict the output to data that matches the filter\n");
     printf("            -i, --index\n");
     printf("                    print the array index for each array element\n");
+    printf("            -j, --jobs <N>\n");
+    printf("                    use N threads to determine the sizes of variable sized\n");
+    printf("                    arrays\n");
     printf("            -l, --label\n");
     printf("                    print the full name and array dims for each data block\n");
     printf("            -o, --output <filename>\n");
@@ -111,6 +121,25 @@ static void print_help()
     printf("                    data with a special type is treated using its non-special\n");
     printf("                    base type\n");
     printf("\n");
+    printf("    codadump [-D definitionpath] arrow [<arrow options>] <product file>\n");
+    printf("        Convert a product file to an Apache Arrow IPC file\n");
+    printf("        Arrow options:\n");
+    printf("            -d, --disable_conversions\n");
+    printf("                    do not perform unit/value conversions\n");
+    printf("            -f '<filter expression>', --filter '<filter expression>'\n");
+    printf("                    restrict the output to data that matches the filter\n");
+    printf("            -j, --jobs <N>\n");
+    printf("                    use N threads to determine the sizes of variable sized\n");
+    printf("                    arrays\n");
+    printf("            -o, --output <filename>\n");
+    printf("                    write output to specified file\n");
+    printf("            -s, --silent\n");
+    printf("                    run in silent mode\n");
+    printf("            --no_special_types\n");
+    printf("                    bypass special data types from the CODA format definition -\n");
+    printf("                    data with a special type is treated using its non-special\n");
+    printf("                    base type\n");
+    printf("\n");
 #ifdef HAVE_HDF4
     printf("    codadump [-D definitionpath] hdf4 [<hdf4 options>] <product file>\n");
     printf("        Convert a product file to a HDF4 file\n");
@@ -119,6 +148,9 @@ static void print_help()
     printf("                    do not perform unit/value conversions\n");
     printf("            -f '<filter expression>', --filter '<filter expression>'\n");
     printf("                    restrict the output to data that matches the filter\n");
+    printf("            -j, --jobs <N>\n");
+    printf("                    use N threads to determine the sizes of variable sized\n");
+    printf("                    arrays\n");
     printf("            -o, --output <filename>\n");
     printf("                    write output to specified file\n");
     printf("            -s, --silent\n");
@@ -201,8 +233,24 @@ static void print_help()
     printf("\n");
 }
 
+/* set the definition path for the current thread (just as all other CODA state, it is kept per thread) */
+int set_definition_path(void)
+{
+    if (option_definition_path != NULL)
+    {
+        return coda_set_definition_path(option_definition_path);
+    }
+    else
+    {
+        const char *definition_path = "../share/" PACKAGE "/definitions";
+
+        return coda_set_definition_path_conditional(program_path, NULL, definition_path);
+    }
+}
+
 void handle_coda_error()
 {
+    output_flush();
     fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
     fflush(stderr);
     exit(1);
@@ -216,6 +264,7 @@ static void handle_list_run_mode(int argc, char *argv[])
 
     traverse_info.file_name = NULL;
     traverse_info.filter[0] = NULL;
+    num_threads = 1;
     verbosity = 1;
     calc_dim = 0;
     use_special_types = 1;
@@ -264,6 +313,17 @@ static void handle_list_run_mode(int argc, char *argv[])
             calc_dim = 1;
             show_dim_vals = 1;
         }
+        else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc &&
+                 argv[i + 1][0] != '-')
+        {
+            num_threads = atoi(argv[i + 1]);
+            if (num_threads < 1)
+            {
+                fprintf(stderr, "ERROR: invalid number of jobs '%s'\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
         else if (strcmp(argv[i], "--no_special_types") == 0)
         {
             use_special_types = 0;
@@ -316,6 +376,7 @@ static void handle_ascii_run_mode(int argc, char *argv[])
     output_file_name = NULL;
     ascii_col_sep = " ";
     ascii_output = stdout;
+    num_threads = 1;
     verbosity = 1;
     calc_dim = 1;
     use_special_types = 1;
@@ -371,6 +432,17 @@ static void handle_ascii_run_mode(int argc, char *argv[])
         {
             show_time_as_string = 1;
         }
+        else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc &&
+                 argv[i + 1][0] != '-')
+        {
+            num_threads = atoi(argv[i + 1]);
+            if (num_threads < 1)
+            {
+                fprintf(stderr, "ERROR: invalid number of jobs '%s'\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
         else if (strcmp(argv[i], "--no_special_types") == 0)
         {
             use_special_types = 0;
@@ -387,6 +459,11 @@ static void handle_ascii_run_mode(int argc, char *argv[])
         }
     }
 
+    /* array sizes only need to be determined up front if we print them in the labels; otherwise they are taken from
+     * the product while writing the data, so the product only needs to be traversed once
+     */
+    calc_dim = show_label;
+
     if (traverse_info.file_name == NULL || traverse_info.file_name[0] == '\0')
     {
         fprintf(stderr, "ERROR: invalid arguments\n");
@@ -415,6 +492,7 @@ static void handle_ascii_run_mode(int argc, char *argv[])
     }
 
     traverse_product();
+    output_flush();
 
     if (output_file_name != NULL)
     {
@@ -425,6 +503,129 @@ static void handle_ascii_run_mode(int argc, char *argv[])
     coda_done();
 }
 
+static void handle_arrow_run_mode(int argc, char *argv[])
+{
+    int own_output_file_name = 0;
+    int use_special_types;
+    int perform_conversions;
+    int i;
+
+    traverse_info.file_name = NULL;
+    traverse_info.filter[0] = NULL;
+    output_file_name = NULL;
+    num_threads = 1;
+    verbosity = 1;
+    calc_dim = 1;
+    use_special_types = 1;
+    perform_conversions = 1;
+
+    for (i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--disable_conversions") == 0)
+        {
+            perform_conversions = 0;
+        }
+        else if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--filter") == 0) &&
+                 i + 1 < argc && argv[i + 1][0] != '-')
+        {
+            traverse_info.filter[0] = codadump_filter_create(argv[i + 1]);
+            if (traverse_info.filter[0] == NULL)
+            {
+                fprintf(stderr, "ERROR: incorrect filter or empty filter\n");
+                print_help();
+                exit(1);
+            }
+            i++;
+        }
+        else if ((strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) &&
+                 i + 1 < argc && argv[i + 1][0] != '-')
+        {
+            output_file_name = argv[i + 1];
+            i++;
+        }
+        else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--silent") == 0)
+        {
+            verbosity = 0;
+        }
+        else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc &&
+                 argv[i + 1][0] != '-')
+        {
+            num_threads = atoi(argv[i + 1]);
+            if (num_threads < 1)
+            {
+                fprintf(stderr, "ERROR: invalid number of jobs '%s'\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--no_special_types") == 0)
+        {
+            use_special_types = 0;
+        }
+        else if (i == argc - 1 && argv[i][0] != '-')
+        {
+            traverse_info.file_name = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: invalid arguments\n");
+            print_help();
+            exit(1);
+        }
+    }
+
+    if (traverse_info.file_name == NULL)
+    {
+        fprintf(stderr, "ERROR: invalid arguments\n");
+        print_help();
+        exit(1);
+    }
+
+    if ((traverse_info.file_name != NULL) && (output_file_name == NULL))
+    {
+        own_output_file_name = 1;
+        output_file_name = malloc(strlen(traverse_info.file_name) + 7);
+        if (output_file_name == NULL)
+        {
+            coda_set_error(CODA_ERROR_OUT_OF_MEMORY, "out of memory (could not allocate %lu bytes) (%s:%u)",
+                           strlen(traverse_info.file_name) + 7, __FILE__, __LINE__);
+            handle_coda_error();
+        }
+        sprintf(output_file_name, "%s.arrow", traverse_info.file_name);
+    }
+
+    if ((traverse_info.file_name[0] == '\0') || (output_file_name[0] == '\0'))
+    {
+        fprintf(stderr, "ERROR: invalid arguments\n");
+        print_help();
+        exit(1);
+    }
+
+    if (coda_init() != 0)
+    {
+        fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+        exit(1);
+    }
+    coda_set_option_bypass_special_types(!use_special_types);
+    coda_set_option_perform_boundary_checks(0);
+    coda_set_option_perform_conversions(perform_conversions);
+    traverse_info_init();
+    dim_info_init();
+    arrow_info_init();
+
+    traverse_product();
+
+    arrow_info_done();
+    dim_info_done();
+    traverse_info_done();
+    coda_done();
+
+    if (own_output_file_name)
+    {
+        free(output_file_name);
+    }
+}
+
 #ifdef HAVE_HDF4
 static void handle_hdf4_run_mode(int argc, char *argv[])
 {
@@ -436,6 +637,7 @@ static void handle_hdf4_run_mode(int argc, char *argv[])
     traverse_info.file_name = NULL;
     traverse_info.filter[0] = NULL;
     output_file_name = NULL;
+    num_threads = 1;
     verbosity = 1;
     calc_dim = 1;
     use_special_types = 1;
@@ -469,6 +671,17 @@ static void handle_hdf4_run_mode(int argc, char *argv[])
         {
             verbosity = 0;
         }
+        else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc &&
+                 argv[i + 1][0] != '-')
+        {
+            num_threads = atoi(argv[i + 1]);
+            if (num_threads < 1)
+            {
+                fprintf(stderr, "ERROR: invalid number of jobs '%s'\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
         else if (strcmp(argv[i], "--no_special_types") == 0)
         {
             use_special_types = 0;
@@ -816,21 +1029,18 @@ int main(int argc, char *argv[])
         exit(0);
     }
 
+    program_path = argv[0];
+    option_definition_path = NULL;
     i = 1;
     if (i + 1 < argc && strcmp(argv[i], "-D") == 0)
     {
-        coda_set_definition_path(argv[i + 1]);
+        option_definition_path = argv[i + 1];
         i += 2;
     }
-    else
+    if (set_definition_path() != 0)
     {
-        const char *definition_path = "../share/" PACKAGE "/definitions";
-
-        if (coda_set_definition_path_conditional(argv[0], NULL, definition_path) != 0)
-        {
-            fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
-            exit(1);
-        }
+        fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+        exit(1);
     }
 
     if (strcmp(argv[i], "list") == 0)
@@ -845,6 +1055,12 @@ int main(int argc, char *argv[])
         i++;
         handle_ascii_run_mode(argc - i, &argv[i]);
     }
+    else if (strcmp(argv[i], "arrow") == 0)
+    {
+        run_mode = RUN_MODE_ARROW;
+        i++;
+        handle_arrow_run_mode(argc - i, &argv[i]);
+    }
 #ifdef HAVE_HDF4
     else if (strcmp(argv[i], "hdf4") == 0)
     {
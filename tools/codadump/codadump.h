@@ -58,6 +58,7 @@ typedef enum run_mode
     RUN_MODE_LIST,
     RUN_MODE_ASCII,
     RUN_MODE_HDF4,
+    RUN_MODE_ARROW,
     RUN_MODE_JSON,
     RUN_MODE_YAML,
     RUN_MODE_DEBUG
@@ -70,6 +71,7 @@ extern char *output_file_name;
 extern char *starting_path;
 extern int verbosity;
 extern int calc_dim;
+extern int num_threads;
 extern int max_depth;
 extern int show_dim_vals;
 extern int show_index;
@@ -164,6 +166,7 @@ extern hdf4_info_t hdf4_info;
 #endif
 
 /* codadump.c functions */
+int set_definition_path(void);
 void handle_coda_error();
 
 /* codadump-ascii.c functions */
@@ -179,6 +182,11 @@ void clear_array_info();
 int dim_record_field_available();
 
 
+/* codadump-arrow.c functions */
+void arrow_info_init();
+void arrow_info_done();
+void export_data_element_to_arrow();
+
 /* codadump-hdf4.c functions */
 #ifdef HAVE_HDF4
 void hdf4_info_init();
@@ -190,6 +198,19 @@ void hdf4_leave_array();
 void export_data_element_to_hdf4();
 #endif
 
+/* codadump-output.c functions */
+void output_flush(void);
+void output_data(const char *data, long length);
+void output_string(const char *str);
+void output_char(char c);
+int output_printf(const char *templ, ...);
+void output_int64(int64_t value);
+void output_uint64(uint64_t value);
+void output_double(double value);
+void output_float(float value);
+int output_numeric_array(coda_cursor *cursor, long num_elements, int include_attributes, const char *prefix,
+                         const char *separator);
+
 /* codadump-json.c functions */
 void print_json_data(int include_attributes);
 
@@ -35,12 +35,49 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 #include "coda.h"
 
+#ifndef THREAD_LOCAL
+#define THREAD_LOCAL
+#endif
+
+/* internal CODA functions */
+int coda_match_filefilter_parallel(const char *filefilter, int num_filepaths, const char **filepathlist,
+                                   int num_threads, int ordered,
+                                   int (*callbackfunc) (const char *, coda_filefilter_status, const char *, void *),
+                                   void *userdata);
+
+const char *program_path;
+const char *option_definition_path;
+int option_perform_conversions;
+int option_num_threads;
+int option_profile;
+
+/* output of the evaluation for a single file (when evaluating files in parallel the output is buffered per file) */
+typedef struct output_buffer_struct
+{
+    char *data;
+    long length;
+    long size;
+    char *error;        /* error that should stop all processing */
+    int done;
+} output_buffer;
+
+/* buffer that all output of the current thread is written to (if NULL, output is written directly to stdout) */
+static THREAD_LOCAL output_buffer *thread_output = NULL;
+
+/* files that matched (when evaluating files in parallel the files are collected first) */
+static char **matched_file = NULL;
+static int num_matched_files = 0;
+
 /* Expression to be evaluated. */
 static coda_expression *eval_expr = NULL;
 static coda_expression_type expr_type;
@@ -48,6 +85,55 @@ static coda_expression_type expr_type;
 /* Node expression to identify the node on which to evaluate the expression. */
 static coda_expression *node_expr = NULL;
 
+static int print_output(const char *format, ...)
+{
+    va_list ap;
+    int length;
+
+    if (thread_output == NULL)
+    {
+        va_start(ap, format);
+        length = vprintf(format, ap);
+        va_end(ap);
+        return length;
+    }
+
+    va_start(ap, format);
+    length = vsnprintf(NULL, 0, format, ap);
+    va_end(ap);
+    if (length < 0)
+    {
+        return length;
+    }
+    if (thread_output->length + length + 1 > thread_output->size)
+    {
+        long new_size = 2 * thread_output->size;
+        char *new_data;
+
+        if (new_size < thread_output->length + length + 1)
+        {
+            new_size = thread_output->length + length + 1;
+        }
+        if (new_size < 1024)
+        {
+            new_size = 1024;
+        }
+        new_data = realloc(thread_output->data, new_size);
+        if (new_data == NULL)
+        {
+            return -1;
+        }
+        thread_output->data = new_data;
+        thread_output->size = new_size;
+    }
+    va_start(ap, format);
+    vsnprintf(&thread_output->data[thread_output->length], length + 1, format, ap);
+    va_end(ap);
+    thread_output->length += length;
+
+    return length;
+}
+
 static void generate_escaped_string(const char *str, int length)
 {
     int i = 0;
@@ -67,43 +153,43 @@ static void generate_escaped_string(const char *str, int length)
         switch (str[i])
         {
             case '\033':       /* windows does not recognize '\e' */
-                printf("\\e");
+                print_output("\\e");
                 break;
             case '\a':
-                printf("\\a");
+                print_output("\\a");
                 break;
             case '\b':
-                printf("\\b");
+                print_output("\\b");
                 break;
             case '\f':
-                printf("\\f");
+                print_output("\\f");
                 break;
             case '\n':
-                printf("\\n");
+                print_output("\\n");
                 break;
             case '\r':
-                printf("\\r");
+                print_output("\\r");
                 break;
             case '\t':
-                printf("\\t");
+                print_output("\\t");
                 break;
             case '\v':
-                printf("\\v");
+                print_output("\\v");
                 break;
             case '\\':
-                printf("\\\\");
+                print_output("\\\\");
                 break;
             case '"':
-                printf("\\\"");
+                print_output("\\\"");
                 break;
             default:
                 if (!isprint(str[i]))
                 {
-                    printf("\\%03o", (int)(unsigned char)str[i]);
+                    print_output("\\%03o", (int)(unsigned char)str[i]);
                 }
                 else
                 {
-                    printf("%c", str[i]);
+                    print_output("%c", str[i]);
                 }
                 break;
         }
@@ -140,6 +226,16 @@ static void print_help()
     printf("                    evaluated\n");
     printf("                    if no path is provided the expression will be evaluated\n");
     printf("                    at the root of the product\n");
+    printf("            -j, --jobs <N>\n");
+    printf("                    use N threads to search directories and evaluate the\n");
+    printf("                    expression on multiple files concurrently (results are\n");
+    printf("                    still printed in the order of the files)\n");
+    printf("            --profile\n");
+    printf("                    after evaluating the expression on all files, print how\n");
+    printf("                    often each expression from the product definitions was\n");
+    printf("                    evaluated and how much time this took (sorted on time,\n");
+    printf("                    most expensive first); files are then always evaluated\n");
+    printf("                    using a single thread\n");
     printf("\n");
     printf("    A description of the syntax of CODA expression language can be found in the\n");
     printf("    CODA documentation\n");
@@ -175,7 +271,7 @@ static int eval_expression(coda_cursor *cursor)
                                    coda_errno_to_string(coda_errno));
                     return -1;
                 }
-                printf("%s\n", (value ? "true" : "false"));
+                print_output("%s\n", (value ? "true" : "false"));
             }
             break;
         case coda_expression_integer:  /* integer */
@@ -190,7 +286,7 @@ static int eval_expression(coda_cursor *cursor)
                     return -1;
                 }
                 coda_str64(value, s);
-                printf("%s\n", s);
+                print_output("%s\n", s);
             }
             break;
         case coda_expression_float:    /* floating point */
@@ -203,7 +299,7 @@ static int eval_expression(coda_cursor *cursor)
                                    coda_errno_to_string(coda_errno));
                     return -1;
                 }
-                printf("%.16g\n", value);
+                print_output("%.16g\n", value);
             }
             break;
         case coda_expression_string:   /* string */
@@ -218,7 +314,7 @@ static int eval_expression(coda_cursor *cursor)
                     return -1;
                 }
                 generate_escaped_string(value, length);
-                printf("\n");
+                print_output("\n");
                 if (value != NULL)
                 {
                     free(value);
@@ -296,19 +392,189 @@ int callback(const char *filepath, coda_filefilter_status status, const char *er
     }
     if (status == coda_ffs_match)
     {
+        if (option_num_threads > 1)
+        {
+            /* evaluate the expression later, such that the files can be divided over the threads */
+            if (num_matched_files % 1024 == 0)
+            {
+                matched_file = realloc(matched_file, (num_matched_files + 1024) * sizeof(char *));
+                assert(matched_file != NULL);
+            }
+            matched_file[num_matched_files] = strdup(filepath);
+            assert(matched_file[num_matched_files] != NULL);
+            num_matched_files++;
+            return 0;
+        }
         return eval_expression_for_file(filepath);
     }
 
     return 0;
 }
 
+/* initialize CODA for the current thread (all CODA settings are thread local) */
+static int init_coda(void)
+{
+    if (option_definition_path != NULL)
+    {
+        coda_set_definition_path(option_definition_path);
+    }
+    else
+    {
+        const char *definition_path = "../share/" PACKAGE "/definitions";
+
+        if (coda_set_definition_path_conditional(program_path, NULL, definition_path) != 0)
+        {
+            return -1;
+        }
+    }
+
+    if (option_profile)
+    {
+        /* this needs to be set before coda_init(), since that already reads the detection rules */
+        coda_set_option_profile_expressions(1);
+    }
+
+    if (coda_init() != 0)
+    {
+        return -1;
+    }
+
+    coda_set_option_perform_conversions(option_perform_conversions);
+
+    return 0;
+}
+
+#ifdef HAVE_PTHREAD
+typedef struct file_queue_struct
+{
+    int num_files;
+    char **filename;
+    output_buffer *output;
+    int next_file;
+    pthread_mutex_t mutex;
+    pthread_cond_t file_done;
+} file_queue;
+
+static void *eval_worker(void *userdata)
+{
+    file_queue *queue = (file_queue *)userdata;
+    int initialized;
+
+    initialized = (init_coda() == 0);
+
+    pthread_mutex_lock(&queue->mutex);
+    while (queue->next_file < queue->num_files)
+    {
+        output_buffer *output = &queue->output[queue->next_file];
+        const char *filename = queue->filename[queue->next_file];
+
+        queue->next_file++;
+        pthread_mutex_unlock(&queue->mutex);
+
+        thread_output = output;
+        if (!initialized || eval_expression_for_file(filename) != 0)
+        {
+            output->error = strdup(coda_errno_to_string(coda_errno));
+            assert(output->error != NULL);
+        }
+        thread_output = NULL;
+
+        pthread_mutex_lock(&queue->mutex);
+        output->done = 1;
+        pthread_cond_broadcast(&queue->file_done);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+
+    if (initialized)
+    {
+        coda_done();
+    }
+
+    return NULL;
+}
+
+/* evaluate the expression for the files concurrently using option_num_threads threads and print the results in the
+ * order of the files
+ */
+static void eval_files_parallel(int num_files, char **filename)
+{
+    file_queue queue;
+    pthread_t *thread;
+    int num_running_threads = 0;
+    int i;
+
+    queue.num_files = num_files;
+    queue.filename = filename;
+    queue.next_file = 0;
+    queue.output = calloc(num_files, sizeof(output_buffer));
+    thread = malloc(option_num_threads * sizeof(pthread_t));
+    if (queue.output == NULL || thread == NULL)
+    {
+        fprintf(stderr, "ERROR: out of memory\n");
+        exit(1);
+    }
+    pthread_mutex_init(&queue.mutex, NULL);
+    pthread_cond_init(&queue.file_done, NULL);
+
+    for (i = 0; i < option_num_threads && i < num_files; i++)
+    {
+        if (pthread_create(&thread[num_running_threads], NULL, eval_worker, &queue) == 0)
+        {
+            num_running_threads++;
+        }
+    }
+    if (num_running_threads == 0)
+    {
+        fprintf(stderr, "ERROR: could not create threads\n");
+        exit(1);
+    }
+
+    for (i = 0; i < num_files; i++)
+    {
+        pthread_mutex_lock(&queue.mutex);
+        while (!queue.output[i].done)
+        {
+            pthread_cond_wait(&queue.file_done, &queue.mutex);
+        }
+        pthread_mutex_unlock(&queue.mutex);
+        if (queue.output[i].length > 0)
+        {
+            fwrite(queue.output[i].data, 1, queue.output[i].length, stdout);
+        }
+        fflush(NULL);
+        if (queue.output[i].error != NULL)
+        {
+            /* same behaviour as a sequential evaluation, which stops at the first file that could not be opened */
+            fprintf(stderr, "ERROR: %s\n", queue.output[i].error);
+            exit(1);
+        }
+        if (queue.output[i].data != NULL)
+        {
+            free(queue.output[i].data);
+        }
+    }
+
+    for (i = 0; i < num_running_threads; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+    pthread_cond_destroy(&queue.file_done);
+    pthread_mutex_destroy(&queue.mutex);
+    free(thread);
+    free(queue.output);
+}
+#endif
+
 int main(int argc, char *argv[])
 {
-    int perform_conversions;
     int check_only;
     int i;
 
-    perform_conversions = 1;
+    program_path = argv[0];
+    option_definition_path = NULL;
+    option_perform_conversions = 1;
+    option_num_threads = 1;
+    option_profile = 0;
     check_only = 0;
 
     if (argc == 1 || strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)
@@ -326,19 +592,9 @@ int main(int argc, char *argv[])
     i = 1;
     if (i + 1 < argc && strcmp(argv[i], "-D") == 0)
     {
-        coda_set_definition_path(argv[i + 1]);
+        option_definition_path = argv[i + 1];
         i += 2;
     }
-    else
-    {
-        const char *definition_path = "../share/" PACKAGE "/definitions";
-
-        if (coda_set_definition_path_conditional(argv[0], NULL, definition_path) != 0)
-        {
-            fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
-            exit(1);
-        }
-    }
 
     while (i < argc)
     {
@@ -348,7 +604,7 @@ int main(int argc, char *argv[])
         }
         else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--disable_conversions") == 0)
         {
-            perform_conversions = 0;
+            option_perform_conversions = 0;
         }
         else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc && argv[i + 1][0] != '-')
         {
@@ -359,6 +615,21 @@ int main(int argc, char *argv[])
             }
             i++;
         }
+        else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc &&
+                 argv[i + 1][0] != '-')
+        {
+            option_num_threads = atoi(argv[i + 1]);
+            if (option_num_threads < 1)
+            {
+                fprintf(stderr, "ERROR: invalid number of jobs '%s'\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--profile") == 0)
+        {
+            option_profile = 1;
+        }
         else if (argv[i][0] != '-')
         {
             /* assume all arguments from here on are the expression and the optional list of files/directories */
@@ -411,19 +682,54 @@ int main(int argc, char *argv[])
 
     if (i < argc)
     {
-        if (coda_init() != 0)
+        if (init_coda() != 0)
         {
             fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
             exit(1);
         }
 
-        coda_set_option_perform_conversions(perform_conversions);
-
-        if (coda_match_filefilter(NULL, argc - i, (const char **)&argv[i], &callback, NULL) != 0)
+        if (coda_match_filefilter_parallel(NULL, argc - i, (const char **)&argv[i], option_num_threads, 1, &callback,
+                                           NULL) != 0)
         {
             fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
             exit(1);
         }
+        if (num_matched_files > 0)
+        {
+#ifdef HAVE_PTHREAD
+            /* the expression profile is kept per thread, so the files are then evaluated by this thread */
+            if (!option_profile)
+            {
+                eval_files_parallel(num_matched_files, matched_file);
+            }
+            else
+#endif
+            {
+                for (i = 0; i < num_matched_files; i++)
+                {
+                    if (eval_expression_for_file(matched_file[i]) != 0)
+                    {
+                        fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+                        exit(1);
+                    }
+                }
+            }
+            for (i = 0; i < num_matched_files; i++)
+            {
+                free(matched_file[i]);
+            }
+            free(matched_file);
+        }
+
+        if (option_profile)
+        {
+            printf("\n");
+            if (coda_expression_print_profile(printf) != 0)
+            {
+                fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
+                exit(1);
+            }
+        }
 
         coda_done();
     }
@@ -40,6 +40,12 @@
 
 #include "coda.h"
 
+/* internal CODA functions */
+int coda_match_filefilter_parallel(const char *filefilter, int num_filepaths, const char **filepathlist,
+                                   int num_threads, int ordered,
+                                   int (*callbackfunc) (const char *, coda_filefilter_status, const char *, void *),
+                                   void *userdata);
+
 static int verbosity;
 
 static void print_version()
@@ -65,6 +71,13 @@ static void print_help()
     printf("                    can be opened with CODA\n");
     printf("            -V, --verbose\n");
     printf("                    show the match result for each file\n");
+    printf("            -j, --jobs <N>\n");
+    printf("                    use N threads to search directories and match files\n");
+    printf("                    concurrently (results are still reported in the order\n");
+    printf("                    of a sequential search)\n");
+    printf("            --unordered\n");
+    printf("                    when using multiple threads, report each file as soon as\n");
+    printf("                    it has been matched\n");
     printf("\n");
     printf("    codafind -h, --help\n");
     printf("        Show help (this text)\n");
@@ -135,10 +148,14 @@ int main(int argc, char *argv[])
 {
     char *filter = NULL;
     int perform_conversions;
+    int num_threads;
+    int ordered;
     int i;
 
     verbosity = 0;
     perform_conversions = 1;
+    num_threads = 1;
+    ordered = 1;
 
     if (argc == 1 || strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)
     {
@@ -185,6 +202,21 @@ int main(int argc, char *argv[])
         {
             verbosity = 1;
         }
+        else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc &&
+                 argv[i + 1][0] != '-')
+        {
+            num_threads = atoi(argv[i + 1]);
+            if (num_threads < 1)
+            {
+                fprintf(stderr, "ERROR: invalid number of jobs '%s'\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--unordered") == 0)
+        {
+            ordered = 0;
+        }
         else if (argv[i][0] != '-')
         {
             /* assume all arguments from here on are files */
@@ -215,7 +247,8 @@ int main(int argc, char *argv[])
 
     coda_set_option_perform_conversions(perform_conversions);
 
-    if (coda_match_filefilter(filter, argc - i, (const char **)&argv[i], &callback, NULL) != 0)
+    if (coda_match_filefilter_parallel(filter, argc - i, (const char **)&argv[i], num_threads, ordered, &callback,
+                                       NULL) != 0)
     {
         fprintf(stderr, "ERROR: %s\n", coda_errno_to_string(coda_errno));
         exit(1);